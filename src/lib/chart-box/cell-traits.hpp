@@ -0,0 +1,48 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace chartbox {
+
+/// \brief What the values of each cell type mean: which values are clear, which block, and which are unknown
+///
+/// Byte-cells (and 16-bit unsigned cells, e.g. costs) are occupancy-like: zero is clear, and anything at or above
+/// the threshold blocks.  The 16-bit threshold is the byte threshold, widened the way 8-bit gray widens to 16-bit
+/// (x257); so a byte layer widened to 16 bits -- or either, written to a PNG -- keeps the same blocked cells.
+///
+/// Signed and floating-point cells are heights -- e.g. the contour layer's depths, as negative elevations -- so
+/// anything at or above the datum (zero) blocks; and the lowest value is the clear value.
+///
+/// For every type, the unknown (default) value is the highest value; so it blocks.
+template<typename cell_t>
+struct CellTraits {
+    constexpr static cell_t clear_value = 0;
+    constexpr static cell_t blocking_threshold = 'A';
+    constexpr static cell_t default_value = std::numeric_limits<cell_t>::max();
+};
+
+template<>
+struct CellTraits<uint16_t> {
+    constexpr static uint16_t clear_value = 0;
+    constexpr static uint16_t blocking_threshold = 'A' * 257;
+    constexpr static uint16_t default_value = std::numeric_limits<uint16_t>::max();
+};
+
+template<>
+struct CellTraits<int16_t> {
+    constexpr static int16_t clear_value = std::numeric_limits<int16_t>::lowest();
+    constexpr static int16_t blocking_threshold = 0;
+    constexpr static int16_t default_value = std::numeric_limits<int16_t>::max();
+};
+
+template<>
+struct CellTraits<float> {
+    constexpr static float clear_value = std::numeric_limits<float>::lowest();
+    constexpr static float blocking_threshold = 0;
+    constexpr static float default_value = std::numeric_limits<float>::max();
+};
+
+} // namespace chartbox
@@ -23,7 +23,7 @@ ChartBox::ChartBox()
     boundary_layer_.fill( boundary_layer_.default_value );
     boundary_layer_.name("BoundaryLayerGrid");
     
-    contour_layer_.fill( boundary_layer_.default_value );
+    contour_layer_.fill( contour_layer_.default_value );
     contour_layer_.name("ContourLayerGrid");
 }
 
@@ -19,7 +19,8 @@ namespace chartbox {
 class ChartBox {
 public:
     typedef chartbox::layer::FixedGridLayer boundary_layer_t;
-    typedef chartbox::layer::FixedGridLayer contour_layer_t;
+    /// \brief holds real depths
+    typedef chartbox::layer::FixedGridFloatLayer contour_layer_t;
     
 public:
     ChartBox();
@@ -11,6 +11,7 @@
 #include <ogr_spatialref.h>
 
 #include "chart-frame-mapping.hpp"
+#include "probe/probe.hpp"
 
 
 using chartbox::FrameMapping;
@@ -54,6 +55,7 @@ FrameMapping::FrameMapping()
 }
 
 bool FrameMapping::move_local_bounds( const Eigen::Vector2d& min_lon_lat, const Eigen::Vector2d& max_lon_lat ){
+    CHARTBOX_PROBE_SCOPE( "frame.move_local_bounds" );
     if( (nullptr== global_to_utm_transform_) || (nullptr==utm_to_global_transform_) ){
         printf("XXX null transformations.  aborting.\n");
         return false;
@@ -110,6 +112,7 @@ constexpr size_t FrameMapping::snap_power_2(const size_t target){
 }
 
 OGRPoint* FrameMapping::to_utm( const double longitude, const double latitude ){
+    CHARTBOX_PROBE_SCOPE( "frame.to_utm" );
     // WGS-84 and other Latitude-Longitude Frames use a non-intuitive axis order
     // -- and this order gets the correct answers.
     double xs[] = { latitude };
@@ -123,6 +126,7 @@ OGRPoint* FrameMapping::to_utm( const double longitude, const double latitude ){
 }
 
 OGRPoint* FrameMapping::to_global( const double easting, const double northing ){
+    CHARTBOX_PROBE_SCOPE( "frame.to_global" );
     double xs[] = { easting + utm_bounds_.min().x() };
     double ys[] = { northing + utm_bounds_.min().y() };
 
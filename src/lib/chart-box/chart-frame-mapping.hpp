@@ -22,6 +22,7 @@ public:
 
     inline const Eigen::AlignedBox2d& global_bounds() const { return global_bounds_; }
     inline const Eigen::AlignedBox2d& utm_bounds() const { return utm_bounds_; }
+    inline const OGRSpatialReference& utm_frame() const { return utm_frame_; }
 
 
     bool move_local_bounds( const Eigen::Vector2d& min_lon_lat, const Eigen::Vector2d& max_lon_lat );
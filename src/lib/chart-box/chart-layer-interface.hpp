@@ -3,10 +3,14 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include <gdal.h>
 #include <ogr_geometry.h>
 
+#include "cell-traits.hpp"
+#include "index/cell-index.hpp"
+
 namespace chartbox {
 
 // base class of a CRTP pattern, as described here:
@@ -23,7 +27,7 @@ public:
 
     /// \brief how wide each cell is, in real-world navigation units
     constexpr static cell_t block_value = 0;
-    constexpr static cell_t clear_value = 0;
+    constexpr static cell_t clear_value = CellTraits<cell_t>::clear_value;
     
 public:
     // /// \brief Retrieve the value at an (x, y) Eigen::Vector2d
@@ -34,10 +38,57 @@ public:
     // cell_t classify(const Eigen::Vector2d& p) const {
     //     return static_cast<chart_t*>(this)->classify(p); }
 
-    // /// \brief Test if this data structer contains this index-point
-    // /// \param The 2d-index to test
-    // /// \return true if this data structure contains this index
-    // bool contains(const index::Index2u& index) const {
+    // ====== Index-Space Access ======
+    // Cells addressed by integer indices, from the layer's (0,0) corner.  Loops over cells should stay in
+    // index-space: convert a location once, on the way in (`to_index`), and once on the way out (`to_location`).
+
+    /// \brief cells per unit of distance: the reciprocal of `precision()`
+    ///
+    /// Derived from the layer's current bounds -- which may move -- so hoist this out of loops.
+    double inverse_precision() const {
+        return 1.0 / layer().precision(); }
+
+    /// \brief Test if this layer contains this cell
+    bool contains( const index::Index2u& cell ) const;
+
+    /// \brief convert a location into the index of the cell containing it
+    ///
+    /// \param location - in the layer's frame
+    /// \param cell - set to the cell's indices; only if the location is inside the layer
+    /// \return false if the location is outside of the layer
+    bool to_index( const Eigen::Vector2d& location, index::Index2u& cell ) const;
+
+    /// \brief location of the center of the given cell
+    Eigen::Vector2d to_location( const index::Index2u& cell ) const {
+        const double precision = layer().precision();
+        return { (cell.i + 0.5) * precision, (cell.j + 0.5) * precision }; }
+
+    /// \brief Retrieve the value of a cell, by index
+    /// \warning does not check bounds
+    cell_t get( const index::Index2u& cell ) const {
+        return layer().get( cell.i, cell.j ); }
+
+    /// \brief Retrieve the value of a cell, by index
+    /// \return the cell value; or the layer's `default_value`, for cells outside the layer
+    cell_t get_checked( const index::Index2u& cell ) const {
+        return layer().contains(cell) ? layer().get( cell.i, cell.j ) : layer_t::default_value; }
+
+    /// \brief store a value into a cell, by index
+    /// \warning does not check bounds
+    bool store( const index::Index2u& cell, const cell_t value ){
+        return layer().store( cell.i, cell.j, value ); }
+
+    /// \brief store a value into a cell, by index
+    /// \return false for cells outside the layer
+    bool store_checked( const index::Index2u& cell, const cell_t value ){
+        return layer().contains(cell) && layer().store( cell.i, cell.j, value ); }
+
+    /// \brief pointer to the first cell of row j; whose cells follow contiguously, in order
+    /// \note only layers with contiguous rows -- e.g. row-major grids -- provide this
+    /// \warning does not check bounds
+    const cell_t* row_ptr( const uint32_t j ) const {
+        return layer().row_ptr( j ); }
+
 
     /// \brief sets the entire grid to the given value
     /// \param fill_value - fill value for entire grid
@@ -56,6 +107,12 @@ public:
     /// \param fill_value - fill value for polygon interior
     bool fill( std::unique_ptr<OGRPolygon> source, cell_t value );
 
+    /// \brief Fill cells [i_begin, i_end) of row j with the given value.
+    ///
+    /// Both area- and polygon-fills reduce to row-spans; so a layer may override this with a bulk write.
+    /// \warning does not check bounds
+    bool fill_span( const uint32_t j, const uint32_t i_begin, const uint32_t i_end, const cell_t value );
+
     ///! \brief load a .shp file into this chart.
     // bool load_from_shape_file(target_t& chart, const std::string& filepath);
 
@@ -65,12 +122,42 @@ public:
     /// \return the cell value
     cell_t get(const Eigen::Vector2d& p) const { return layer().get(p); }
 
-    /// \brief Access the value at an (x, y) Eigen::Vector2d
-    ///!
-    /// \param Eigen::Vector2d - the x,y coordinates to search at:
-    /// \return reference to the cell value
-    cell_t& get( const Eigen::Vector2d& point ){
-        return layer().get(point); }
+    /// \brief count the blocked cells which overlap the given area
+    ///
+    /// \param area - region to count, in the layer's frame
+    /// \return number of cells at-or-above the layer's blocking threshold
+    size_t count_blocked( const Eigen::AlignedBox2d& area ) const {
+        return layer().count_blocked(area); }
+
+    /// \brief test if any cell overlapping the given area is blocked
+    bool any_blocked( const Eigen::AlignedBox2d& area ) const {
+        return 0 < layer().count_blocked(area); }
+
+    /// \brief Find the first blocked cell along a segment
+    ///
+    /// This default is a plain Amanatides & Woo voxel traversal, testing one cell at a time through `get(...)`.
+    /// A cell is crossed if the segment overlaps its interior with non-zero length; touching a corner does not
+    /// count.  Portions of the segment outside of the layer are ignored.
+    ///
+    /// ### See Also:
+    ///   - Amanatides, Woo; "A Fast Voxel Traversal Algorithm for Ray Tracing" (1987)
+    ///
+    /// \param from, to - segment endpoints, in the layer's frame
+    /// \param hit - set to the point where the segment enters the first blocked cell
+    /// \return true if the segment crosses a blocked cell; false if it is clear
+    bool raycast( const Eigen::Vector2d& from, const Eigen::Vector2d& to, Eigen::Vector2d& hit ) const;
+
+    /// \brief test if a segment crosses no blocked cells
+    bool segment_free( const Eigen::Vector2d& from, const Eigen::Vector2d& to ) const {
+        Eigen::Vector2d hit;
+        return ! layer().raycast( from, to, hit ); }
+
+    /// \brief `raycast(...)` many segments -- e.g. the beams of one simulated sensor sweep
+    ///
+    /// \param from, to - segment endpoints; must be the same length
+    /// \param ranges - set to the distance from each `from` to its hit; or infinity, if that segment is clear
+    /// \return the number of blocked segments
+    size_t raycast_batch( const std::vector<Eigen::Vector2d>& from, const std::vector<Eigen::Vector2d>& to, std::vector<double>& ranges ) const;
 
     std::string name() const { return name_; }
 
@@ -106,6 +193,12 @@ protected:
 
     ~ChartLayerInterface() = default;
 
+    /// \brief cells sampled at `first`, `first + precision`, ... while less than `end`; clipped to [0, cell_count)
+    ///
+    /// \param begin, finish - set to the sampled cell indices: [begin, finish)
+    /// \return false if no cell is sampled
+    bool sample_span( const double first, const double end, const double cell_count, uint32_t& begin, uint32_t& finish ) const;
+
 protected:
 
     /// \brief the data layout this grid represents
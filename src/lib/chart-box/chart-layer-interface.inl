@@ -1,8 +1,11 @@
 // GPL v3 (c) 2021, Daniel Williams 
 
 // standard library includes
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <cstdio>
+#include <limits>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -13,6 +16,8 @@
 
 #include <fmt/core.h>
 
+#include "probe/probe.hpp"
+
 using chartbox::ChartLayerInterface;
 
 
@@ -24,72 +29,261 @@ ChartLayerInterface<cell_t, layer_t>::ChartLayerInterface( const Eigen::AlignedB
 
 template<typename cell_t, typename layer_t>
 bool ChartLayerInterface<cell_t, layer_t>::fill(const Eigen::AlignedBox2d& area, const cell_t value) {
-    const double x_max = area.max().x();
-    const double x_min = area.min().x();
-    const double y_max = area.max().y();
-    const double y_min = area.min().y();
+    CHARTBOX_PROBE_SCOPE( "layer.fill.area" );
     const double incr = layer().precision();
+    const Eigen::Vector2d cells = bounds_.sizes() / incr;
+
+    // sample the cells whose centers fall inside the area
+    uint32_t i_begin, i_end, j_begin, j_end;
+    if( (! sample_span( area.min().x() + incr/2, area.max().x(), cells.x(), i_begin, i_end ))
+     || (! sample_span( area.min().y() + incr/2, area.max().y(), cells.y(), j_begin, j_end )) ){
+        return true;
+    }
 
     // Loop through the rows of the image.
-    for( double y = y_min + incr/2; y < y_max; y += incr ){
-        for( double x = x_min + incr/2; x < x_max; x += incr ){
-            this->store({x,y}, value);
-        }
+    for( uint32_t j = j_begin; j < j_end; ++j ){
+        layer().fill_span( j, i_begin, i_end, value );
+    }
+    CHARTBOX_PROBE_COUNT( "layer.fill.area.cells", (j_end - j_begin) * (i_end - i_begin) );
+    return true;
+}
+
+template<typename cell_t, typename layer_t>
+bool ChartLayerInterface<cell_t, layer_t>::fill_span( const uint32_t j, const uint32_t i_begin, const uint32_t i_end, const cell_t value ){
+    for( uint32_t i = i_begin; i < i_end; ++i ){
+        layer().store( i, j, value );
+    }
+    return true;
+}
+
+template<typename cell_t, typename layer_t>
+bool ChartLayerInterface<cell_t, layer_t>::contains( const index::Index2u& cell ) const {
+    const Eigen::Vector2d cells = bounds_.sizes() * layer().inverse_precision();
+    return (cell.i < cells.x()) && (cell.j < cells.y());
+}
+
+template<typename cell_t, typename layer_t>
+bool ChartLayerInterface<cell_t, layer_t>::to_index( const Eigen::Vector2d& location, index::Index2u& cell ) const {
+    constexpr double limit = std::numeric_limits<uint32_t>::max();
+    const double scale = layer().inverse_precision();
+    const double x = location.x() * scale;
+    const double y = location.y() * scale;
+    // written to also reject NaN
+    if( !( (0 <= x) && (x < limit) && (0 <= y) && (y < limit) ) ){
+        return false;
+    }
+    const index::Index2u candidate( static_cast<uint32_t>(x), static_cast<uint32_t>(y) );
+    if( ! layer().contains(candidate) ){
+        return false;
     }
+    cell = candidate;
     return true;
 }
 
+template<typename cell_t, typename layer_t>
+bool ChartLayerInterface<cell_t, layer_t>::sample_span( const double first, const double end, const double cell_count, uint32_t& begin, uint32_t& finish ) const {
+    if( end <= first ){
+        return false;
+    }
+    const double incr = layer().precision();
+    const double first_cell = std::floor( first / incr );
+    const double last_cell = first_cell + std::ceil( (end - first) / incr );   // exclusive
+    if( (last_cell <= 0) || (cell_count <= first_cell) ){
+        return false;
+    }
+    begin = static_cast<uint32_t>( std::max( 0.0, first_cell ) );
+    finish = static_cast<uint32_t>( std::min( cell_count, last_cell ) );
+    return begin < finish;
+}
+
+template<typename cell_t, typename layer_t>
+bool ChartLayerInterface<cell_t, layer_t>::raycast( const Eigen::Vector2d& from, const Eigen::Vector2d& to, Eigen::Vector2d& hit ) const {
+    const double precision = layer().precision();
+    const Eigen::Vector2d start = from / precision;
+    const Eigen::Vector2d delta = (to - from) / precision;
+    const Eigen::Vector2d cells = bounds_.sizes() / precision;
+
+    // clip the segment to the layer (Liang-Barsky)
+    double t_enter = 0;
+    double t_exit = 1;
+    for( int axis = 0; axis < 2; ++axis ){
+        if( 0 == delta[axis] ){
+            if( (start[axis] < 0) || (cells[axis] < start[axis]) ){
+                return false;
+            }
+            continue;
+        }
+        const double t_low = (0 - start[axis]) / delta[axis];
+        const double t_high = (cells[axis] - start[axis]) / delta[axis];
+        t_enter = std::max( t_enter, std::min(t_low, t_high) );
+        t_exit = std::min( t_exit, std::max(t_low, t_high) );
+    }
+    if( t_exit < t_enter ){
+        return false;
+    }
+
+    // traversal state, per axis
+    const Eigen::Vector2d entry = start + t_enter * delta;
+    int64_t index[2];
+    int64_t step[2];
+    double t_next[2];
+    double t_delta[2];
+    for( int axis = 0; axis < 2; ++axis ){
+        index[axis] = std::clamp<int64_t>( static_cast<int64_t>(std::floor(entry[axis])), 0, static_cast<int64_t>(cells[axis]) - 1 );
+        if( 0 < delta[axis] ){
+            step[axis] = 1;
+            t_next[axis] = (index[axis] + 1 - start[axis]) / delta[axis];
+            t_delta[axis] = 1 / delta[axis];
+        }else if( delta[axis] < 0 ){
+            step[axis] = -1;
+            t_next[axis] = (index[axis] - start[axis]) / delta[axis];
+            t_delta[axis] = -1 / delta[axis];
+        }else{
+            step[axis] = 0;
+            t_next[axis] = std::numeric_limits<double>::infinity();
+            t_delta[axis] = std::numeric_limits<double>::infinity();
+        }
+    }
+
+    double t = t_enter;
+    while( true ){
+        const Eigen::Vector2d center( (index[0] + 0.5) * precision, (index[1] + 0.5) * precision );
+        if( layer_t::blocking_threshold <= layer().get(center) ){
+            hit = from + t * (to - from);
+            return true;
+        }
+
+        // step to the next cell; through a corner, step both axes at once
+        t = std::min( t_next[0], t_next[1] );
+        if( t_exit <= t ){
+            return false;
+        }
+        const bool step_x = ( t_next[0] <= t_next[1] );
+        const bool step_y = ( t_next[1] <= t_next[0] );
+        if( step_x ){
+            index[0] += step[0];
+            t_next[0] += t_delta[0];
+        }
+        if( step_y ){
+            index[1] += step[1];
+            t_next[1] += t_delta[1];
+        }
+        if( (index[0] < 0) || (cells[0] <= index[0]) || (index[1] < 0) || (cells[1] <= index[1]) ){
+            return false;
+        }
+    }
+}
+
+template<typename cell_t, typename layer_t>
+size_t ChartLayerInterface<cell_t, layer_t>::raycast_batch( const std::vector<Eigen::Vector2d>& from, const std::vector<Eigen::Vector2d>& to, std::vector<double>& ranges ) const {
+    const size_t count = std::min( from.size(), to.size() );
+    ranges.resize( count );
+
+    size_t blocked = 0;
+    Eigen::Vector2d hit;
+    for( size_t k = 0; k < count; ++k ){
+        if( layer().raycast( from[k], to[k], hit ) ){
+            ranges[k] = (hit - from[k]).norm();
+            ++blocked;
+        }else{
+            ranges[k] = std::numeric_limits<double>::infinity();
+        }
+    }
+    return blocked;
+}
+
 template<typename cell_t, typename layer_t>
 bool ChartLayerInterface<cell_t, layer_t>::fill( std::unique_ptr<OGRPolygon> poly, cell_t value ){
     // adapted from:
     //  Public-domain code by Darel Rex Finley, 2007:  "Efficient Polygon Fill Algorithm With C Code Sample"
     //  Retrieved: (https://alienryderflex.com/polygon_fill/); 2019-09-07
+    CHARTBOX_PROBE_SCOPE( "layer.fill.polygon" );
+    CHARTBOX_PROBE_TALLY( spans, "layer.fill.polygon.spans" );
 
     const size_t vertex_count = poly->getExteriorRing()->getNumPoints();
-    const double x_max = layer().bounds_.sizes().x();
-    const double x_min = 0;
-    const double x_incr = layer().precision();  // == y_incr.  This is a square grid.
-    const double y_max = layer().bounds_.sizes().y();
-    const double y_min = 0;
-    const double y_incr = layer().precision();  // == x_incr.  This is a square grid.
+    CHARTBOX_PROBE_COUNT( "layer.fill.polygon.vertices", vertex_count );
+    if( vertex_count < 2 ){
+        return true;
+    }
 
-    // Loop through the rows of the image.
+    // everything below is in cell units; so each row's crossings are a multiply-add per edge, and
+    // each span's bounds are a floor & ceil
+    const double scale = layer().inverse_precision();  // This is a square grid.
+    const double column_count = layer().bounds_.sizes().x() * scale;
+    const double row_count = layer().bounds_.sizes().y() * scale;
+
+    // convert each edge, once:  x = x0 + (y - y0) * dx/dy;  for y in [y_low, y_high)
+    struct Edge { double x0; double y0; double dx; double dy; double y_low; double y_high; };
+    std::vector<Edge> edges;
+    edges.reserve( vertex_count - 1 );
+    double y_low = std::numeric_limits<double>::infinity();
+    double y_high = -std::numeric_limits<double>::infinity();
     const OGRLinearRing * exterior = poly->getExteriorRing();
-    for( double y = y_min + y_incr/2; y < y_max; y += y_incr ){
+    auto iter = exterior->begin();
+    for( size_t k = 0; k < (vertex_count-1); ++k ){
+        const OGRPoint segment_start = *iter;
+        ++iter;
+        const OGRPoint segment_end = *iter;
+
+        const double x0 = segment_start.getX() * scale;
+        const double y0 = segment_start.getY() * scale;
+        const double x1 = segment_end.getX() * scale;
+        const double y1 = segment_end.getY() * scale;
+        if( y0 == y1 ){
+            // horizontal edges never cross a row's center-line
+            continue;
+        }
+        edges.push_back({ x0, y0, x1 - x0, y1 - y0, std::min(y0, y1), std::max(y0, y1) });
+        y_low = std::min( y_low, std::min(y0, y1) );
+        y_high = std::max( y_high, std::max(y0, y1) );
+    }
+    if( edges.empty() ){
+        return true;
+    }
+
+    // only the rows whose centers fall within the polygon's vertical extent can cross it
+    const uint32_t j_begin = static_cast<uint32_t>( std::clamp( std::floor(y_low - 0.5), 0.0, std::ceil(row_count) ) );
+    const uint32_t j_end = static_cast<uint32_t>( std::clamp( std::ceil(y_high), 0.0, std::ceil(row_count) ) );
+
+    // Loop through the rows of the image.
+    std::vector<double> crossings;
+    for( uint32_t j = j_begin; (j < j_end) && (j < row_count); ++j ){
+        const double y = j + 0.5;
 
         // generate a list of line-segment crossings from the polygon
-        std::vector<double> crossings;
-        auto iter = exterior->begin();
-        for (size_t i=0; i < (vertex_count-1); ++i) {
-            const OGRPoint segment_start = *iter;
-            ++iter;
-            const OGRPoint segment_end = *iter;
-
-            const double segment_y_min = std::min( segment_start.getY(), segment_end.getY());
-            const double segment_y_max = std::max( segment_start.getY(), segment_end.getY());
-
-            // if y is in range:
-            if( (segment_y_min <= y) && (y < segment_y_max) ){
-                // construct x-coordinate that crosses this line:
-                const double x_crossing = segment_start.getX() + (y - segment_start.getY()) * (segment_end.getX()-segment_start.getX())/(segment_end.getY() - segment_start.getY());
-                crossings.emplace_back(x_crossing);
+        crossings.clear();
+        for( const Edge& edge : edges ){
+            if( (edge.y_low <= y) && (y < edge.y_high) ){
+                // (not a precomputed slope: this rounds the same as the crossing's exact value, on cell boundaries)
+                crossings.push_back( edge.x0 + (y - edge.y0) * edge.dx / edge.dy );
             }
         }
 
         // early exit
-        if( 0 == crossings.size()){
+        if( crossings.empty() ){
             continue;
         }
-        
+
         // Sort the crossings:
         std::sort(crossings.begin(), crossings.end());
 
-        //  Fill the pixels between node pairs.
-        for( size_t crossing_index = 0; crossing_index < crossings.size(); crossing_index += 2){
-            const double start_x = std::max( x_min, crossings[crossing_index]) + x_incr/2;
-            const double end_x = std::min( x_max, crossings[crossing_index+1] + x_incr/2);
-            for( double x = start_x; x < end_x; x += x_incr ){
-                layer().store( {x,y}, value);
+        //  Fill the cells between node pairs: those sampled at `start`, `start + 1`, ... while less than `end`
+        for( size_t crossing_index = 0; (crossing_index + 1) < crossings.size(); crossing_index += 2){
+            const double start = std::max( 0.0, crossings[crossing_index]) + 0.5;
+            const double end = std::min( column_count, crossings[crossing_index+1] + 0.5);
+            if( end <= start ){
+                continue;
+            }
+            const double first_cell = std::floor( start );
+            const double last_cell = first_cell + std::ceil( end - start );   // exclusive
+            if( (last_cell <= 0) || (column_count <= first_cell) ){
+                continue;
+            }
+            const uint32_t i_begin = static_cast<uint32_t>( first_cell );
+            const uint32_t i_end = static_cast<uint32_t>( std::min( column_count, last_cell ) );
+            if( i_begin < i_end ){
+                CHARTBOX_PROBE_INCREMENT( spans );
+                layer().fill_span( j, i_begin, i_end, value );
             }
         }
     }
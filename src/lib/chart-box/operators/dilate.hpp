@@ -0,0 +1,57 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace chartbox::operators {
+
+enum KernelShape : uint8_t {
+    Square=0,    // every cell within `radius` along both axes (Chebyshev distance)
+    Circle=1,    // every cell whose center lies within `radius` (Euclidean distance)
+};
+
+/// \brief Inflate the obstacles of `source` into `sink` -- i.e. compute the configuration-space layer
+///
+/// Both layers must share a type (and therefore a dimension); `sink` may alias `source`.
+/// The output is a plain layer of the same type, so it can be handed directly to a planner.
+///
+/// ## Implementation Specifics
+///   - Square kernels perform a grayscale max-filter (cell values are preserved) with the separable
+///     van Herk / Gil-Werman algorithm: three max-operations per cell, independent of the radius.
+///     Each pass operates on entire rows at a time, so the inner loop is a vectorized uint8 `max`.
+///   - Layers which are not stored in row-major order are staged through a row-major copy.
+///   - Circle kernels threshold an exact euclidean distance transform (Meijster et al., 2000) of the
+///     blocked cells; every clear cell within `radius` of a blocked cell is overwritten with `inflate_value`.
+///   - Cells are written through `data()`; afterwards, the sink's blocked-cell counts are rebuilt, and the
+///     whole sink is recorded as changed -- where the layer type keeps either.
+///
+/// ### See Also:
+///   - https://doi.org/10.1016/0167-8655(92)90069-C   (van Herk, 1992)
+///   - https://doi.org/10.1109/34.134043   (Gil & Werman, 1993)
+///   - https://doi.org/10.1007/0-306-47025-X_36   (Meijster, Roerdink, Hesselink; 2000)
+///
+/// \param source - layer to read obstacles from
+/// \param sink - layer to write the inflated obstacles to
+/// \param radius - inflation radius, in real-world units (meters).  Rounded up to whole cells, for square kernels.
+/// \param shape - kernel to inflate with
+/// \return true for success; else false
+template<typename layer_t>
+bool dilate( const layer_t& source, layer_t& sink, double radius, KernelShape shape );
+
+/// \brief grayscale max-filter with a (2*radius+1)^2 square kernel
+/// \param radius - kernel half-width, in cells
+template<typename layer_t>
+bool dilate_square( const layer_t& source, layer_t& sink, uint32_t radius );
+
+/// \brief marks every clear cell within `radius` of a blocked cell with `inflate_value`
+/// \param radius - kernel radius, in cells. (may be fractional)
+/// \param inflate_value - value of inflated cells; by default, the lowest blocked value
+template<typename layer_t>
+bool dilate_circle( const layer_t& source, layer_t& sink, double radius,
+                    typename layer_t::cell_t inflate_value = layer_t::blocking_threshold );
+
+} // namespace chartbox::operators
+
+#include "dilate.inl"
@@ -0,0 +1,323 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// NOTE: This is the template-class implementation --
+//       It is not compiled until referenced, even though it contains the
+//       function implementations.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace chartbox::operators {
+
+namespace detail {
+
+/// \brief dst[i] = max( a[i], b[i] ) across an entire row
+template<typename cell_t>
+inline void max_rows( cell_t* dst, const cell_t* a, const cell_t* b, const size_t count ){
+    for( size_t i = 0; i < count; ++i ){
+        dst[i] = std::max( a[i], b[i] );
+    }
+}
+
+inline void max_rows( uint8_t* dst, const uint8_t* a, const uint8_t* b, const size_t count ){
+    size_t i = 0;
+#ifdef __SSE2__
+    for( ; (i + 16) <= count; i += 16 ){
+        const __m128i va = _mm_loadu_si128( reinterpret_cast<const __m128i*>(a + i) );
+        const __m128i vb = _mm_loadu_si128( reinterpret_cast<const __m128i*>(b + i) );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>(dst + i), _mm_max_epu8(va, vb) );
+    }
+#endif
+    for( ; i < count; ++i ){
+        dst[i] = std::max( a[i], b[i] );
+    }
+}
+
+/// \brief copy a layer's cells into a row-major buffer, whatever its cell-ordering
+template<typename layer_t>
+void gather_rows( const layer_t& layer, typename layer_t::cell_t* to ){
+    constexpr uint32_t dimension = layer_t::dimension;
+    const typename layer_t::cell_t* from = layer.data();
+    for( uint32_t j = 0; j < dimension; ++j ){
+        for( uint32_t i = 0; i < dimension; ++i ){
+            to[ i + j*dimension ] = from[ layer.lookup(i, j) ];
+        }
+    }
+}
+
+/// \brief inverse of `gather_rows`
+template<typename layer_t>
+void scatter_rows( const typename layer_t::cell_t* from, layer_t& layer ){
+    constexpr uint32_t dimension = layer_t::dimension;
+    typename layer_t::cell_t* to = layer.data();
+    for( uint32_t j = 0; j < dimension; ++j ){
+        for( uint32_t i = 0; i < dimension; ++i ){
+            to[ layer.lookup(i, j) ] = from[ i + j*dimension ];
+        }
+    }
+}
+
+/// \brief true for layers which keep derived occupancy state -- e.g. blocked-cell counts -- beside their cells
+template<typename layer_t, typename = void>
+struct has_occupancy : std::false_type {};
+
+template<typename layer_t>
+struct has_occupancy<layer_t, std::void_t<decltype(std::declval<layer_t&>().rebuild_occupancy())>> : std::true_type {};
+
+/// \brief true for layers which record the areas written to -- e.g. for `collect_changes(...)`
+template<typename layer_t, typename = void>
+struct has_change_tracking : std::false_type {};
+
+template<typename layer_t>
+struct has_change_tracking<layer_t, std::void_t<decltype(std::declval<layer_t&>().mark_dirty(std::declval<Eigen::AlignedBox2d>()))>> : std::true_type {};
+
+/// \brief bring a layer's derived state up to date, after its cells were written through `data()`
+template<typename layer_t>
+void finish_writes( layer_t& layer ){
+    if constexpr ( has_occupancy<layer_t>::value ){
+        layer.rebuild_occupancy();
+    }
+    if constexpr ( has_change_tracking<layer_t>::value ){
+        // any cell may have changed
+        layer.mark_dirty( Eigen::AlignedBox2d(Eigen::Vector2d::Zero(), Eigen::Vector2d::Constant(layer.width())) );
+    }
+}
+
+/// \brief transposes a square, row-major, `dimension` x `dimension` buffer
+template<typename cell_t>
+void transpose( const cell_t* from, cell_t* to, const size_t dimension ){
+    constexpr size_t block = 16;
+    for( size_t jb = 0; jb < dimension; jb += block ){
+        for( size_t ib = 0; ib < dimension; ib += block ){
+            const size_t j_end = std::min( jb + block, dimension );
+            const size_t i_end = std::min( ib + block, dimension );
+            for( size_t j = jb; j < j_end; ++j ){
+                for( size_t i = ib; i < i_end; ++i ){
+                    to[ i*dimension + j ] = from[ j*dimension + i ];
+                }
+            }
+        }
+    }
+}
+
+/// \brief van Herk / Gil-Werman max-filter along the y-axis, of window 2*radius+1
+///
+/// Operates on whole rows, so each step is a row-wide (vectorized) max.
+/// `from` and `to` are `dimension` x `dimension` row-major buffers, and must not alias.
+template<typename cell_t>
+void max_filter_columns( const cell_t* from, cell_t* to, const size_t dimension, const size_t radius ){
+    const size_t window = 2*radius + 1;
+    const size_t padded = dimension + 2*radius;
+
+    // pad above and below by `radius` rows of the identity-element for 'max'
+    std::vector<cell_t> source( padded * dimension, std::numeric_limits<cell_t>::lowest() );
+    std::memcpy( source.data() + radius*dimension, from, sizeof(cell_t) * dimension * dimension );
+
+    std::vector<cell_t> prefix( padded * dimension );   // running max, from the start of each window-block
+    std::vector<cell_t> suffix( padded * dimension );   // running max, to the end of each window-block
+
+    for( size_t row = 0; row < padded; ++row ){
+        cell_t* write = prefix.data() + row*dimension;
+        const cell_t* read = source.data() + row*dimension;
+        if( 0 == (row % window) ){
+            std::memcpy( write, read, sizeof(cell_t) * dimension );
+        }else{
+            max_rows( write, write - dimension, read, dimension );
+        }
+    }
+
+    for( size_t row = padded - 1; row < padded; --row ){
+        cell_t* write = suffix.data() + row*dimension;
+        const cell_t* read = source.data() + row*dimension;
+        if( (window - 1 == (row % window)) || (padded - 1 == row) ){
+            std::memcpy( write, read, sizeof(cell_t) * dimension );
+        }else{
+            max_rows( write, write + dimension, read, dimension );
+        }
+    }
+
+    // output row `j` covers padded rows [j, j + window - 1]
+    for( size_t row = 0; row < dimension; ++row ){
+        max_rows( to + row*dimension,
+                  suffix.data() + row*dimension,
+                  prefix.data() + (row + window - 1)*dimension,
+                  dimension );
+    }
+}
+
+/// \brief result of `distance_transform(...)` for every cell, when no cell is blocked
+constexpr int64_t no_blocked_cell = std::numeric_limits<int64_t>::max();
+
+/// \brief squared euclidean distance transform of the blocked cells, in units of cells^2
+///
+/// Cells have `no_blocked_cell`, rather than a distance, if nothing in the layer is blocked.
+///
+/// Implements the linear-time algorithm from:
+///     Meijster, Roerdink, Hesselink; "A General Algorithm for Computing Distance Transforms in Linear Time"
+template<typename cell_t>
+std::vector<int64_t> distance_transform( const cell_t* from, const size_t dimension, const cell_t threshold ){
+    const int64_t n = static_cast<int64_t>(dimension);
+    // farther than any cell; but only a placeholder for columns without a blocked cell
+    const int64_t infinity = 2*n + 1;
+
+    // phase 1: distance to the nearest blocked cell within each column
+    std::vector<int64_t> g( dimension * dimension );
+    for( int64_t x = 0; x < n; ++x ){
+        g[x] = ( threshold <= from[x] ) ? 0 : infinity;
+        for( int64_t y = 1; y < n; ++y ){
+            g[y*n + x] = ( threshold <= from[y*n + x] ) ? 0 : std::min( infinity, 1 + g[(y-1)*n + x] );
+        }
+        for( int64_t y = n - 2; 0 <= y; --y ){
+            if( g[(y+1)*n + x] < g[y*n + x] ){
+                g[y*n + x] = 1 + g[(y+1)*n + x];
+            }
+        }
+    }
+
+    // phase 2: lower envelope of the parabolas along each row
+    std::vector<int64_t> result( dimension * dimension );
+    std::vector<int64_t> s( dimension );
+    std::vector<int64_t> t( dimension );
+    for( int64_t y = 0; y < n; ++y ){
+        const int64_t* gy = g.data() + y*n;
+        auto f = [gy]( int64_t x, int64_t i ){ return (x-i)*(x-i) + gy[i]*gy[i]; };
+        auto sep = [gy]( int64_t i, int64_t u ){ return (u*u - i*i + gy[u]*gy[u] - gy[i]*gy[i]) / (2*(u - i)); };
+
+        int64_t q = 0;
+        s[0] = 0;
+        t[0] = 0;
+        for( int64_t u = 1; u < n; ++u ){
+            while( (0 <= q) && (f(t[q], s[q]) > f(t[q], u)) ){
+                --q;
+            }
+            if( q < 0 ){
+                q = 0;
+                s[0] = u;
+            }else{
+                const int64_t w = 1 + sep( s[q], u );
+                if( w < n ){
+                    ++q;
+                    s[q] = u;
+                    t[q] = w;
+                }
+            }
+        }
+        for( int64_t u = n - 1; 0 <= u; --u ){
+            // a placeholder parabola is only the lowest if no column has a blocked cell
+            result[y*n + u] = ( infinity == gy[s[q]] ) ? no_blocked_cell : f( u, s[q] );
+            if( u == t[q] ){
+                --q;
+            }
+        }
+    }
+
+    return result;
+}
+
+} // namespace detail
+
+template<typename layer_t>
+bool dilate( const layer_t& source, layer_t& sink, const double radius, const KernelShape shape ){
+    if( std::isnan(radius) || (radius < 0) ){
+        return false;
+    }
+
+    const double radius_cells = radius / source.precision();
+    if( Square == shape ){
+        return dilate_square( source, sink, static_cast<uint32_t>(std::ceil(radius_cells)) );
+    }else if( Circle == shape ){
+        return dilate_circle( source, sink, radius_cells );
+    }
+
+    return false;
+}
+
+template<typename layer_t>
+bool dilate_square( const layer_t& source, layer_t& sink, const uint32_t radius ){
+    typedef typename layer_t::cell_t cell_t;
+    constexpr size_t dimension = layer_t::dimension;
+
+    if( 0 == radius ){
+        if( &source != &sink ){
+            std::memcpy( sink.data(), source.data(), sizeof(cell_t) * dimension * dimension );
+            detail::finish_writes( sink );
+        }
+        return true;
+    }
+
+    // the filters below operate on whole rows; other cell-orderings are staged through a row-major copy
+    std::vector<cell_t> rows;
+    const cell_t* read = source.data();
+    cell_t* write = sink.data();
+    if constexpr ( ! layer_t::index_t::row_major ){
+        rows.resize( dimension * dimension );
+        detail::gather_rows( source, rows.data() );
+        read = rows.data();
+        write = rows.data();
+    }
+
+    // the kernel is separable: filter along columns, then along rows (as columns of the transpose)
+    std::vector<cell_t> scratch( dimension * dimension );
+    std::vector<cell_t> transposed( dimension * dimension );
+    detail::max_filter_columns( read, scratch.data(), dimension, radius );
+    detail::transpose( scratch.data(), transposed.data(), dimension );
+    detail::max_filter_columns( transposed.data(), scratch.data(), dimension, radius );
+    detail::transpose( scratch.data(), write, dimension );
+
+    if constexpr ( ! layer_t::index_t::row_major ){
+        detail::scatter_rows( rows.data(), sink );
+    }
+    detail::finish_writes( sink );
+
+    return true;
+}
+
+template<typename layer_t>
+bool dilate_circle( const layer_t& source, layer_t& sink, const double radius, const typename layer_t::cell_t inflate_value ){
+    typedef typename layer_t::cell_t cell_t;
+    constexpr size_t dimension = layer_t::dimension;
+
+    std::vector<cell_t> rows;
+    const cell_t* read = source.data();
+    cell_t* write = sink.data();
+    if constexpr ( ! layer_t::index_t::row_major ){
+        rows.resize( dimension * dimension );
+        detail::gather_rows( source, rows.data() );
+        read = rows.data();
+        write = rows.data();
+    }
+
+    const std::vector<int64_t> distance = detail::distance_transform( read, dimension, layer_t::blocking_threshold );
+    const double radius_squared = radius * radius;
+
+    for( size_t offset = 0; offset < (dimension * dimension); ++offset ){
+        const cell_t value = read[offset];
+        if( (value < layer_t::blocking_threshold) && (detail::no_blocked_cell != distance[offset])
+                && (static_cast<double>(distance[offset]) <= radius_squared) ){
+            write[offset] = inflate_value;
+        }else{
+            write[offset] = value;
+        }
+    }
+
+    if constexpr ( ! layer_t::index_t::row_major ){
+        detail::scatter_rows( rows.data(), sink );
+    }
+    detail::finish_writes( sink );
+
+    return true;
+}
+
+} // namespace chartbox::operators
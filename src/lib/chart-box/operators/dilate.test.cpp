@@ -0,0 +1,278 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include "index/hilbert-index.hpp"
+#include "index/z-order-index.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+
+#include "dilate.hpp"
+
+using Eigen::Vector2d;
+
+using chartbox::layer::FixedGrid;
+using chartbox::layer::FixedGridLayer;
+
+namespace chartbox::operators {
+
+static const Eigen::AlignedBox2d bounds( Vector2d(0,0), Vector2d(128,128) );
+
+TEST( Dilate, SquareSingleCell ){
+    FixedGridLayer source( bounds );
+    FixedGridLayer sink( bounds );
+    source.fill( FixedGridLayer::clear_value );
+    source.store( {64.5, 64.5}, 0x99 );
+
+    ASSERT_TRUE( dilate(source, sink, 2.0, Square) );
+
+    for( uint32_t j = 60; j < 69; ++j ){
+        for( uint32_t i = 60; i < 69; ++i ){
+            const bool inside = (62 <= i) && (i <= 66) && (62 <= j) && (j <= 66);
+            EXPECT_EQ( sink.data()[sink.lookup(i,j)], inside ? 0x99 : 0 ) << "@ " << i << ", " << j;
+        }
+    }
+}
+
+TEST( Dilate, SquareClampsAtEdges ){
+    FixedGridLayer source( bounds );
+    source.fill( FixedGridLayer::clear_value );
+    source.store( {0.5, 127.5}, 0x99 );
+
+    // in-place operation is permitted
+    ASSERT_TRUE( dilate_square(source, source, 3) );
+
+    EXPECT_EQ( source.get({0.5, 127.5}), 0x99 );
+    EXPECT_EQ( source.get({3.5, 124.5}), 0x99 );
+    EXPECT_EQ( source.get({4.5, 124.5}), 0 );
+    EXPECT_EQ( source.get({3.5, 123.5}), 0 );
+}
+
+TEST( Dilate, SquareMatchesBruteForce ){
+    std::mt19937 generator(55);
+    std::uniform_int_distribution<int> value_distribution(0, 255);
+    std::bernoulli_distribution sparse(0.01);
+
+    FixedGridLayer source( bounds );
+    FixedGridLayer sink( bounds );
+    for( size_t offset = 0; offset < FixedGridLayer::dimension * FixedGridLayer::dimension; ++offset ){
+        source.data()[offset] = sparse(generator) ? value_distribution(generator) : 0;
+    }
+
+    constexpr int radius = 5;
+    ASSERT_TRUE( dilate_square(source, sink, radius) );
+
+    constexpr int n = FixedGridLayer::dimension;
+    for( int j = 0; j < n; ++j ){
+        for( int i = 0; i < n; ++i ){
+            uint8_t expected = 0;
+            for( int dj = std::max(0, j - radius); dj <= std::min(n - 1, j + radius); ++dj ){
+                for( int di = std::max(0, i - radius); di <= std::min(n - 1, i + radius); ++di ){
+                    expected = std::max( expected, source.data()[source.lookup(di, dj)] );
+                }
+            }
+            ASSERT_EQ( sink.data()[sink.lookup(i,j)], expected ) << "@ " << i << ", " << j;
+        }
+    }
+}
+
+TEST( Dilate, CircleSingleCell ){
+    FixedGridLayer source( bounds );
+    FixedGridLayer sink( bounds );
+    source.fill( FixedGridLayer::clear_value );
+    source.store( {64.5, 64.5}, 0x99 );
+
+    ASSERT_TRUE( dilate(source, sink, 2.0, Circle) );
+
+    size_t inflated_count = 0;
+    for( size_t offset = 0; offset < FixedGridLayer::dimension * FixedGridLayer::dimension; ++offset ){
+        if( FixedGridLayer::blocking_threshold == sink.data()[offset] ){
+            ++inflated_count;
+        }
+    }
+    // 13 cells within r=2 of the center, excluding the (unmodified) center cell
+    EXPECT_EQ( inflated_count, 12 );
+    EXPECT_EQ( sink.get({64.5, 64.5}), 0x99 );
+    EXPECT_EQ( sink.get({66.5, 64.5}), FixedGridLayer::blocking_threshold );
+    EXPECT_EQ( sink.get({65.5, 65.5}), FixedGridLayer::blocking_threshold );
+    EXPECT_EQ( sink.get({66.5, 65.5}), 0 );
+}
+
+TEST( Dilate, CircleWithoutObstacles ){
+    FixedGridLayer source( bounds );
+    FixedGridLayer sink( bounds );
+    source.fill( FixedGridLayer::clear_value );
+
+    // farther than any two cells are apart
+    ASSERT_TRUE( dilate_circle(source, sink, 1000.0) );
+
+    for( size_t offset = 0; offset < FixedGridLayer::dimension * FixedGridLayer::dimension; ++offset ){
+        ASSERT_EQ( sink.data()[offset], FixedGridLayer::clear_value ) << "@ " << offset;
+    }
+}
+
+TEST( Dilate, CircleMatchesBruteForce ){
+    std::mt19937 generator(55);
+    std::bernoulli_distribution sparse(0.005);
+
+    FixedGridLayer source( bounds );
+    FixedGridLayer sink( bounds );
+    for( size_t offset = 0; offset < FixedGridLayer::dimension * FixedGridLayer::dimension; ++offset ){
+        source.data()[offset] = sparse(generator) ? 0x99 : 0;
+    }
+
+    constexpr double radius = 4.5;
+    ASSERT_TRUE( dilate_circle(source, sink, radius) );
+
+    constexpr int n = FixedGridLayer::dimension;
+    for( int j = 0; j < n; ++j ){
+        for( int i = 0; i < n; ++i ){
+            const uint8_t original = source.data()[source.lookup(i,j)];
+            bool near = false;
+            for( int dj = 0; dj < n; ++dj ){
+                for( int di = 0; di < n; ++di ){
+                    if( (0 < source.data()[source.lookup(di,dj)]) && (std::hypot(di - i, dj - j) <= radius) ){
+                        near = true;
+                    }
+                }
+            }
+            const uint8_t expected = (0 < original) ? original : (near ? FixedGridLayer::blocking_threshold : 0);
+            ASSERT_EQ( sink.data()[sink.lookup(i,j)], expected ) << "@ " << i << ", " << j;
+        }
+    }
+}
+
+TEST( Dilate, IndependentOfCellOrder ){
+    typedef FixedGrid< index::ZOrderIndex<FixedGridLayer::dimension> > ZOrderGrid;
+    typedef FixedGrid< index::HilbertIndex<FixedGridLayer::dimension> > HilbertGrid;
+
+    std::mt19937 generator(55);
+    std::uniform_int_distribution<int> index_distribution(0, 127);
+
+    FixedGridLayer reference( bounds );
+    ZOrderGrid z_order( bounds );
+    HilbertGrid hilbert( bounds );
+    reference.fill( FixedGridLayer::clear_value );
+    z_order.fill( FixedGridLayer::clear_value );
+    hilbert.fill( FixedGridLayer::clear_value );
+    for( size_t count = 0; count < 40; ++count ){
+        const Vector2d p( index_distribution(generator) + 0.5, index_distribution(generator) + 0.5 );
+        reference.store( p, 0x99 );
+        z_order.store( p, 0x99 );
+        hilbert.store( p, 0x99 );
+    }
+
+    for( const KernelShape shape : {Square, Circle} ){
+        FixedGridLayer expected( bounds );
+        ZOrderGrid z_sink( bounds );
+        HilbertGrid hilbert_sink( bounds );
+        ASSERT_TRUE( dilate(reference, expected, 3.0, shape) );
+        ASSERT_TRUE( dilate(z_order, z_sink, 3.0, shape) );
+        ASSERT_TRUE( dilate(hilbert, hilbert_sink, 3.0, shape) );
+
+        for( uint32_t j = 0; j < FixedGridLayer::dimension; ++j ){
+            for( uint32_t i = 0; i < FixedGridLayer::dimension; ++i ){
+                const Vector2d p( i + 0.5, j + 0.5 );
+                ASSERT_EQ( z_sink.get(p), expected.get(p) ) << "@ " << i << ", " << j;
+                ASSERT_EQ( hilbert_sink.get(p), expected.get(p) ) << "@ " << i << ", " << j;
+            }
+        }
+    }
+}
+
+TEST( Dilate, UpdatesBlockedCounts ){
+    typedef FixedGrid< index::ZOrderIndex<FixedGridLayer::dimension> > ZOrderGrid;
+
+    const auto check = []( auto& source, auto& sink, const KernelShape shape, const size_t expected ){
+        source.fill( FixedGridLayer::clear_value );
+        source.store( {64.5, 64.5}, 0x99 );
+        ASSERT_TRUE( dilate(source, sink, 2.0, shape) );
+
+        EXPECT_EQ( sink.count_blocked(bounds), expected );
+        // newly-inflated cells
+        EXPECT_TRUE( sink.any_blocked( Eigen::AlignedBox2d(Vector2d(66.2, 64.2), Vector2d(66.8, 64.8)) ) );
+        EXPECT_TRUE( sink.any_blocked( Eigen::AlignedBox2d(Vector2d(64.2, 62.2), Vector2d(64.8, 62.8)) ) );
+        EXPECT_FALSE( sink.any_blocked( Eigen::AlignedBox2d(Vector2d(67.2, 64.2), Vector2d(70.8, 70.8)) ) );
+    };
+
+    // into a separate sink, and in-place; square and circle kernels (5 x 5 cells, and 13 cells)
+    for( const auto& [shape, expected] : { std::pair<KernelShape, size_t>(Square, 25), std::pair<KernelShape, size_t>(Circle, 13) } ){
+        FixedGridLayer source( bounds );
+        FixedGridLayer sink( bounds );
+        check( source, sink, shape, expected );
+        check( source, source, shape, expected );
+
+        ZOrderGrid z_source( bounds );
+        ZOrderGrid z_sink( bounds );
+        check( z_source, z_sink, shape, expected );
+        check( z_source, z_source, shape, expected );
+    }
+}
+
+TEST( Dilate, InflatedCellsBlockRaycasts ){
+    typedef FixedGrid< index::ZOrderIndex<FixedGridLayer::dimension> > ZOrderGrid;
+
+    const auto check = []( auto& source, auto& sink ){
+        source.fill( FixedGridLayer::clear_value );
+        source.store( {64.5, 64.5}, 0x99 );
+        ASSERT_TRUE( dilate(source, sink, 2.0, Square) );
+
+        // stops at the inflated edge, not at the original obstacle
+        Vector2d hit;
+        ASSERT_TRUE( sink.raycast({10.5, 64.5}, {120.5, 64.5}, hit) );
+        EXPECT_NEAR( hit.x(), 62, 1e-9 );
+        EXPECT_NEAR( hit.y(), 64.5, 1e-9 );
+        ASSERT_TRUE( sink.raycast({64.5, 120.5}, {64.5, 10.5}, hit) );
+        EXPECT_NEAR( hit.y(), 67, 1e-9 );
+
+        EXPECT_FALSE( sink.segment_free({10.5, 66.5}, {120.5, 66.5}) );
+        EXPECT_TRUE( sink.segment_free({10.5, 67.5}, {120.5, 67.5}) );
+    };
+
+    FixedGridLayer source( bounds );
+    FixedGridLayer sink( bounds );
+    check( source, sink );
+    check( source, source );
+
+    ZOrderGrid z_source( bounds );
+    ZOrderGrid z_sink( bounds );
+    check( z_source, z_sink );
+    check( z_source, z_source );
+}
+
+TEST( Dilate, RecordsChanges ){
+    FixedGridLayer source( bounds );
+    FixedGridLayer sink( bounds );
+    source.fill( FixedGridLayer::clear_value );
+    source.store( {64.5, 64.5}, 0x99 );
+
+    for( const KernelShape shape : {Square, Circle} ){
+        uint64_t since = sink.version();
+        ASSERT_TRUE( dilate(source, sink, 2.0, shape) );
+
+        std::vector<Eigen::AlignedBox2d> areas;
+        sink.collect_changes( since, areas );
+        ASSERT_FALSE( areas.empty() );
+        const auto covers = [&areas]( const Vector2d& p ){
+            return std::any_of( areas.begin(), areas.end(), [&p]( const Eigen::AlignedBox2d& area ){ return area.contains(p); } ); };
+        EXPECT_TRUE( covers({66.5, 64.5}) );
+        EXPECT_TRUE( covers({64.5, 62.5}) );
+        EXPECT_EQ( since, sink.version() );
+    }
+
+    // in-place
+    uint64_t since = source.version();
+    ASSERT_TRUE( dilate_square(source, source, 1) );
+    std::vector<Eigen::AlignedBox2d> areas;
+    source.collect_changes( since, areas );
+    EXPECT_FALSE( areas.empty() );
+}
+
+} // namespace chartbox::operators
@@ -0,0 +1,42 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace chartbox::index {
+
+/// \brief Cell-ordering policy: square blocks, each stored contiguously in row-major order.  The blocks are
+///        themselves stored in row-major order.
+///
+/// With the default 8x8 blocks of byte-cells, each block is exactly one 64-byte cache line, so any
+/// 3x3 neighborhood touches at most four lines.
+template<size_t dimension_, size_t block_dimension = 8>
+struct BlockedIndex {
+    constexpr static size_t dimension = dimension_;
+    constexpr static bool row_major = false;
+
+    constexpr static char name[] = "Blocked";
+
+    static_assert( 0 == (block_dimension & (block_dimension - 1)), "Block dimension must be a power of two!" );
+    static_assert( 0 == (dimension % block_dimension), "Blocks must evenly divide the grid!" );
+
+    constexpr static size_t blocks_per_side = dimension / block_dimension;
+    constexpr static size_t block_size = block_dimension * block_dimension;
+
+    constexpr static size_t lookup( const uint32_t i, const uint32_t j ){
+        const size_t block = (i / block_dimension) + (j / block_dimension) * blocks_per_side;
+        const size_t inner = (i % block_dimension) + (j % block_dimension) * block_dimension;
+        return block * block_size + inner;
+    }
+
+    constexpr static void decode( const size_t offset, uint32_t& i, uint32_t& j ){
+        const size_t block = offset / block_size;
+        const size_t inner = offset % block_size;
+        i = static_cast<uint32_t>( (block % blocks_per_side) * block_dimension + (inner % block_dimension) );
+        j = static_cast<uint32_t>( (block / blocks_per_side) * block_dimension + (inner / block_dimension) );
+    }
+};
+
+} // namespace chartbox::index
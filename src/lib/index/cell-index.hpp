@@ -0,0 +1,33 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+namespace chartbox::index {
+
+/// \brief integer indices of one cell: column `i`, row `j`; from the layer's (0,0) corner
+///
+/// Cells are addressed in index-space -- rather than by their location -- wherever code iterates over cells:
+/// search, rasterization and dilation all step by whole cells, so need no floating-point at all.
+struct Index2u {
+    uint32_t i;
+    uint32_t j;
+
+    constexpr Index2u() : i(0), j(0) {}
+
+    /// \note only unsigned indices convert; so a braced location -- e.g. `layer.get({3, 3})` -- is never taken for a cell
+    template<typename index_t, typename = std::enable_if_t<std::is_unsigned_v<index_t>>>
+    constexpr Index2u( const index_t _i, const index_t _j )
+        : i(static_cast<uint32_t>(_i)), j(static_cast<uint32_t>(_j))
+    {}
+
+    constexpr bool operator==( const Index2u& other ) const {
+        return (i == other.i) && (j == other.j); }
+
+    constexpr bool operator!=( const Index2u& other ) const {
+        return ! (*this == other); }
+};
+
+} // namespace chartbox::index
@@ -0,0 +1,135 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+namespace chartbox::index {
+
+/// \brief Per-tile modification versions of a grid -- i.e. which parts of a layer changed, and when
+///
+/// Each write stamps the tiles it touches with the next value of a monotonic version counter.  A consumer
+/// (export, replanning, a pyramid, ...) remembers the last version it processed, and asks only for the
+/// tiles stamped after that.  Any number of consumers may follow the same layer independently; and
+/// "clearing" a consumer's dirty regions is simply advancing its version.
+///
+/// \param dimension - number of cells along each side of the grid
+/// \param tile_dimension - number of cells along each side of a tile; a power of two
+template<size_t dimension, size_t tile_dimension = 16>
+class DirtyTiles {
+public:
+    static_assert( 0 == (tile_dimension & (tile_dimension - 1)), "Tiles must be a power-of-two wide!" );
+
+    /// \brief the last tile of each row / column may be partial
+    constexpr static size_t tiles_per_side = (dimension + tile_dimension - 1) / tile_dimension;
+
+    /// \brief a rectangle of cells: [i_begin, i_end) x [j_begin, j_end)
+    struct Region {
+        uint32_t i_begin;
+        uint32_t j_begin;
+        uint32_t i_end;
+        uint32_t j_end;
+    };
+
+public:
+    DirtyTiles()
+        : stamps_( tiles_per_side * tiles_per_side, 0 )
+    {}
+
+    /// \brief version of the most recent write; zero if nothing has been written
+    inline uint64_t version() const { return version_; }
+
+    /// \brief record a write to cell (i,j)
+    /// \warning does not check bounds
+    inline void mark( const uint32_t i, const uint32_t j ){
+        stamps_[ (j / tile_dimension) * tiles_per_side + (i / tile_dimension) ] = ++version_;
+    }
+
+    /// \brief record a write to every cell in [i_begin, i_end) x [j_begin, j_end); as a single version
+    void mark( const uint32_t i_begin, const uint32_t i_end, const uint32_t j_begin, const uint32_t j_end ){
+        if( (i_end <= i_begin) || (j_end <= j_begin) ){
+            return;
+        }
+        ++version_;
+        for( size_t tile_j = j_begin / tile_dimension; tile_j <= (j_end - 1) / tile_dimension; ++tile_j ){
+            for( size_t tile_i = i_begin / tile_dimension; tile_i <= (i_end - 1) / tile_dimension; ++tile_i ){
+                stamps_[ tile_j * tiles_per_side + tile_i ] = version_;
+            }
+        }
+    }
+
+    /// \brief record a write to every cell overlapping the given area; as a single version
+    ///
+    /// \param area - in the layer's frame; clipped to the grid
+    /// \param precision - width of one cell
+    void mark( const Eigen::AlignedBox2d& area, const double precision ){
+        if( area.isEmpty() ){
+            return;
+        }
+        const auto clip_cell = []( const double cell ){
+            return static_cast<uint32_t>( std::clamp(cell, 0.0, static_cast<double>(dimension)) ); };
+        mark( clip_cell(std::floor(area.min().x() / precision)), clip_cell(std::ceil(area.max().x() / precision)),
+              clip_cell(std::floor(area.min().y() / precision)), clip_cell(std::ceil(area.max().y() / precision)) );
+    }
+
+    /// \brief record a write to every cell
+    inline void mark_all(){
+        mark( 0, dimension, 0, dimension );
+    }
+
+    /// \brief Find the tiles modified after the given version
+    ///
+    /// \param since - report tiles stamped with a later version than this
+    /// \param regions - appended with one region per run of adjacent modified tiles, along each row of tiles
+    /// \return the number of regions appended
+    size_t changed_since( const uint64_t since, std::vector<Region>& regions ) const {
+        const size_t initial = regions.size();
+        for( uint32_t tile_j = 0; tile_j < tiles_per_side; ++tile_j ){
+            const uint64_t* row = stamps_.data() + tile_j * tiles_per_side;
+            for( uint32_t tile_i = 0; tile_i < tiles_per_side; ++tile_i ){
+                if( row[tile_i] <= since ){
+                    continue;
+                }
+                const uint32_t run_begin = tile_i;
+                while( (tile_i + 1 < tiles_per_side) && (since < row[tile_i + 1]) ){
+                    ++tile_i;
+                }
+                regions.push_back({ clip(run_begin * tile_dimension), clip(tile_j * tile_dimension),
+                                    clip((tile_i + 1) * tile_dimension), clip((tile_j + 1) * tile_dimension) });
+            }
+        }
+        return regions.size() - initial;
+    }
+
+    /// \brief as above; but as areas in the layer's frame
+    ///
+    /// \param precision - width of one cell
+    size_t changed_since( const uint64_t since, const double precision, std::vector<Eigen::AlignedBox2d>& areas ) const {
+        std::vector<Region> regions;
+        changed_since( since, regions );
+        for( const Region& region : regions ){
+            areas.emplace_back( Eigen::Vector2d(region.i_begin, region.j_begin) * precision,
+                                Eigen::Vector2d(region.i_end, region.j_end) * precision );
+        }
+        return regions.size();
+    }
+
+private:
+    inline static uint32_t clip( const size_t cell ){
+        return static_cast<uint32_t>( (cell < dimension) ? cell : dimension );
+    }
+
+private:
+    uint64_t version_ = 0;
+
+    /// \brief `stamps_[tile_i + tile_j*tiles_per_side]` is the version of the last write to that tile
+    std::vector<uint64_t> stamps_;
+};
+
+} // namespace chartbox::index
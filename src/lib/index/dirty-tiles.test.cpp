@@ -0,0 +1,117 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include "layer/bit-grid/bit-grid.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+
+#include "dirty-tiles.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+using chartbox::layer::BitGridLayer;
+using chartbox::layer::FixedGridLayer;
+
+namespace chartbox::index {
+
+static const AlignedBox2d bounds( Vector2d(0,0), Vector2d(128,128) );
+
+TEST( DirtyTiles, StartsClean ){
+    const DirtyTiles<64> tiles;
+    std::vector<DirtyTiles<64>::Region> regions;
+    EXPECT_EQ( tiles.version(), 0 );
+    EXPECT_EQ( tiles.changed_since(0, regions), 0 );
+}
+
+TEST( DirtyTiles, MergesAdjacentTilesAlongRows ){
+    DirtyTiles<64> tiles;
+    tiles.mark( 3, 5 );
+    tiles.mark( 20, 40, 0, 20 );       // tiles (1,0), (2,0), (1,1), (2,1)
+    EXPECT_EQ( tiles.version(), 2 );
+
+    std::vector<DirtyTiles<64>::Region> regions;
+    ASSERT_EQ( tiles.changed_since(0, regions), 2 );
+    // tile row 0: tiles 0..2 merge into one run
+    EXPECT_EQ( regions[0].i_begin, 0 );
+    EXPECT_EQ( regions[0].j_begin, 0 );
+    EXPECT_EQ( regions[0].i_end, 48 );
+    EXPECT_EQ( regions[0].j_end, 16 );
+    // tile row 1: tiles 1..2
+    EXPECT_EQ( regions[1].i_begin, 16 );
+    EXPECT_EQ( regions[1].j_begin, 16 );
+    EXPECT_EQ( regions[1].i_end, 48 );
+    EXPECT_EQ( regions[1].j_end, 32 );
+
+    // only the later write remains after the first version
+    regions.clear();
+    ASSERT_EQ( tiles.changed_since(1, regions), 2 );
+    EXPECT_EQ( regions[0].i_begin, 16 );
+    regions.clear();
+    EXPECT_EQ( tiles.changed_since(2, regions), 0 );
+}
+
+TEST( DirtyTiles, ClipsPartialTiles ){
+    DirtyTiles<40> tiles;
+    tiles.mark_all();
+
+    std::vector<DirtyTiles<40>::Region> regions;
+    ASSERT_EQ( tiles.changed_since(0, regions), 3 );
+    EXPECT_EQ( regions[2].i_begin, 0 );
+    EXPECT_EQ( regions[2].j_begin, 32 );
+    EXPECT_EQ( regions[2].i_end, 40 );
+    EXPECT_EQ( regions[2].j_end, 40 );
+}
+
+TEST( DirtyTiles, FixedGridRecordsChangedWrites ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    uint64_t since = layer.version();
+
+    // rewriting the same value is not a change
+    layer.store( {5.5, 5.5}, FixedGridLayer::clear_value );
+    EXPECT_EQ( layer.version(), since );
+
+    layer.fill( AlignedBox2d(Vector2d(40, 70), Vector2d(50, 74)), 0x99 );
+    std::vector<AlignedBox2d> areas;
+    layer.collect_changes( since, areas );
+    EXPECT_EQ( since, layer.version() );
+    ASSERT_EQ( areas.size(), 1 );
+    EXPECT_TRUE( areas[0].isApprox(AlignedBox2d(Vector2d(32, 64), Vector2d(64, 80))) );
+
+    // a second consumer, which never collected, still sees the changes
+    areas.clear();
+    layer.collect_changes( since, areas );
+    EXPECT_TRUE( areas.empty() );
+
+    // writes through `data()` must be recorded by the writer
+    layer.data()[ layer.lookup(100, 2) ] = 0x99;
+    layer.mark_dirty( AlignedBox2d(Vector2d(100, 2), Vector2d(101, 3)) );
+    layer.collect_changes( since, areas );
+    ASSERT_EQ( areas.size(), 1 );
+    EXPECT_TRUE( areas[0].isApprox(AlignedBox2d(Vector2d(96, 0), Vector2d(112, 16))) );
+}
+
+TEST( DirtyTiles, BitGridRecordsSpansAndStores ){
+    BitGridLayer layer( bounds );
+    layer.fill( BitGridLayer::clear_value );
+    uint64_t since = layer.version();
+
+    layer.store( {5.5, 5.5}, BitGridLayer::clear_value );
+    EXPECT_EQ( layer.version(), since );
+
+    layer.store( {5.5, 5.5}, 0x99 );
+    layer.fill( AlignedBox2d(Vector2d(100, 120), Vector2d(128, 128)), 0x99 );
+
+    std::vector<AlignedBox2d> areas;
+    layer.collect_changes( since, areas );
+    ASSERT_EQ( areas.size(), 2 );
+    EXPECT_TRUE( areas[0].isApprox(AlignedBox2d(Vector2d(0, 0), Vector2d(16, 16))) );
+    EXPECT_TRUE( areas[1].isApprox(AlignedBox2d(Vector2d(96, 112), Vector2d(128, 128))) );
+}
+
+} // namespace chartbox::index
@@ -0,0 +1,122 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace chartbox::index {
+
+namespace detail {
+
+/// \brief Descend one level of the Hilbert curve.
+///
+/// Each level's rotation only ever swaps and/or reflects the lower-order bits; so the accumulated
+/// orientation is tracked as two flags, instead of transforming both coordinates at every level.
+///
+/// \param state - orientation: bit 0 => swap axes; bit 1 => reflect both axes
+/// \param i, j - the bit of each coordinate, at this level
+/// \return the two bits of the curve offset, at this level
+constexpr uint32_t hilbert_step( uint32_t& state, const uint32_t i, const uint32_t j ){
+    const uint32_t swap = state & 1;
+    const uint32_t flip = state >> 1;
+    uint32_t ri = i ^ flip;
+    uint32_t rj = j ^ flip;
+    const uint32_t swapped = (ri ^ rj) & swap;
+    ri ^= swapped;
+    rj ^= swapped;
+
+    const uint32_t rotate = 1 ^ rj;
+    state = (swap ^ rotate) | ((flip ^ (rotate & ri)) << 1);
+    return (3 * ri) ^ rj;
+}
+
+constexpr uint32_t hilbert_levels_per_step = 4;
+
+/// \brief indexed by `(state << 8) | (i-nibble << 4) | (j-nibble)`; holds `(next-state << 8) | offset-byte`
+constexpr std::array<uint16_t, 4 << 8> make_hilbert_table(){
+    std::array<uint16_t, 4 << 8> table = {};
+    for( uint32_t entry = 0; entry < table.size(); ++entry ){
+        uint32_t state = entry >> 8;
+        uint32_t offset = 0;
+        for( uint32_t bit = hilbert_levels_per_step; 0 < bit; --bit ){
+            const uint32_t i = (entry >> (4 + bit - 1)) & 1;
+            const uint32_t j = (entry >> (bit - 1)) & 1;
+            offset = (offset << 2) | hilbert_step( state, i, j );
+        }
+        table[entry] = static_cast<uint16_t>( (state << 8) | offset );
+    }
+    return table;
+}
+
+inline constexpr std::array<uint16_t, 4 << 8> hilbert_table = make_hilbert_table();
+
+} // namespace detail
+
+/// \brief Cell-ordering policy: Hilbert curve.
+///
+/// Like Z-order, every aligned power-of-two square is contiguous; unlike Z-order, consecutive offsets
+/// are always adjacent cells, so long walks have the best locality of any policy here.  The price is
+/// a loop over the levels of the curve, for each lookup; four levels are resolved per table-lookup.
+///
+/// ### See Also:
+///   - (https://en.wikipedia.org/wiki/Hilbert_curve)
+template<size_t dimension_>
+struct HilbertIndex {
+    constexpr static size_t dimension = dimension_;
+    constexpr static bool row_major = false;
+
+    constexpr static char name[] = "Hilbert";
+
+    static_assert( 0 == (dimension & (dimension - 1)), "Hilbert dimension must be a power of two!" );
+
+    /// \brief log2( dimension )
+    constexpr static uint32_t order = __builtin_ctzll( dimension );
+
+    /// \brief `order`, rounded up to a whole number of table-steps
+    constexpr static uint32_t padded_order = ((order + detail::hilbert_levels_per_step - 1) / detail::hilbert_levels_per_step) * detail::hilbert_levels_per_step;
+
+    constexpr static size_t lookup( const uint32_t i, const uint32_t j ){
+        // each (all-zero) padding level swaps the axes; so start from the orientation which cancels them out
+        uint32_t state = (padded_order - order) & 1;
+        size_t offset = 0;
+        for( uint32_t shift = padded_order; 0 < shift; shift -= detail::hilbert_levels_per_step ){
+            const uint32_t nibble_i = (i >> (shift - detail::hilbert_levels_per_step)) & 0xF;
+            const uint32_t nibble_j = (j >> (shift - detail::hilbert_levels_per_step)) & 0xF;
+            const uint32_t entry = detail::hilbert_table[ (state << 8) | (nibble_i << 4) | nibble_j ];
+            offset = (offset << 8) | (entry & 0xFF);
+            state = entry >> 8;
+        }
+        return offset;
+    }
+
+    constexpr static void decode( const size_t offset, uint32_t& i, uint32_t& j ){
+        size_t t = offset;
+        i = 0;
+        j = 0;
+        for( uint32_t s = 1; s < dimension; s *= 2 ){
+            const uint32_t ri = 1 & static_cast<uint32_t>(t / 2);
+            const uint32_t rj = 1 & static_cast<uint32_t>(t ^ ri);
+            rotate( s, i, j, ri, rj );
+            i += s * ri;
+            j += s * rj;
+            t /= 4;
+        }
+    }
+
+private:
+    constexpr static void rotate( const size_t n, uint32_t& i, uint32_t& j, const uint32_t ri, const uint32_t rj ){
+        if( 0 == rj ){
+            if( 1 == ri ){
+                i = static_cast<uint32_t>(n - 1 - i);
+                j = static_cast<uint32_t>(n - 1 - j);
+            }
+            const uint32_t swap = i;
+            i = j;
+            j = swap;
+        }
+    }
+};
+
+} // namespace chartbox::index
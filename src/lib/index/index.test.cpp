@@ -0,0 +1,67 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <cstdlib>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "blocked-index.hpp"
+#include "hilbert-index.hpp"
+#include "row-major-index.hpp"
+#include "z-order-index.hpp"
+
+namespace chartbox::index {
+
+// every policy must be usable at compile time
+static_assert( 5 + 3*16 == RowMajorIndex<16>::lookup(5, 3) );
+static_assert( 0b1011 == ZOrderIndex<16>::lookup(0b01, 0b11) );
+static_assert( 3 == HilbertIndex<2>::lookup(1, 0) );
+static_assert( 64 + 9 == BlockedIndex<16>::lookup(9, 1) );
+
+template<typename index_t>
+class CellIndex : public ::testing::Test {};
+
+typedef ::testing::Types< RowMajorIndex<64>, ZOrderIndex<64>, HilbertIndex<64>, HilbertIndex<256>, HilbertIndex<512>, BlockedIndex<64>, BlockedIndex<64,16> > Policies;
+TYPED_TEST_SUITE( CellIndex, Policies );
+
+TYPED_TEST( CellIndex, LookupIsBijective ){
+    constexpr size_t dimension = TypeParam::dimension;
+    std::vector<bool> seen( dimension * dimension, false );
+
+    for( uint32_t j = 0; j < dimension; ++j ){
+        for( uint32_t i = 0; i < dimension; ++i ){
+            const size_t offset = TypeParam::lookup( i, j );
+            ASSERT_LT( offset, seen.size() );
+            ASSERT_FALSE( seen[offset] ) << "    @ (" << i << ", " << j << ")";
+            seen[offset] = true;
+
+            uint32_t di = 0, dj = 0;
+            TypeParam::decode( offset, di, dj );
+            ASSERT_EQ( di, i );
+            ASSERT_EQ( dj, j );
+        }
+    }
+}
+
+TEST( CellIndex, HilbertStepsAreAdjacent ){
+    typedef HilbertIndex<64> index_t;
+    uint32_t last_i = 0, last_j = 0;
+    index_t::decode( 0, last_i, last_j );
+    for( size_t offset = 1; offset < 64*64; ++offset ){
+        uint32_t i = 0, j = 0;
+        index_t::decode( offset, i, j );
+        ASSERT_EQ( 1, std::abs(static_cast<int>(i) - static_cast<int>(last_i)) + std::abs(static_cast<int>(j) - static_cast<int>(last_j)) );
+        last_i = i;
+        last_j = j;
+    }
+}
+
+TEST( CellIndex, ZOrderQuadrantsAreContiguous ){
+    typedef ZOrderIndex<64> index_t;
+    EXPECT_EQ( index_t::lookup(31, 31), 32*32 - 1 );
+    EXPECT_EQ( index_t::lookup(32, 0), 32*32 );
+    EXPECT_EQ( index_t::lookup(0, 32), 2*32*32 );
+    EXPECT_EQ( index_t::lookup(63, 63), 64*64 - 1 );
+}
+
+} // namespace chartbox::index
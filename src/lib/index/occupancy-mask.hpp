@@ -0,0 +1,204 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace chartbox::index {
+
+/// \brief Bit-packed copy of a per-cell flag -- e.g. "is this cell blocked?" -- for fast line-of-sight tests
+///
+/// Two copies are kept: one in rows, and one in columns.  A segment crosses each line (row or column)
+/// of its minor axis in a single contiguous run of cells; so each run is tested 64 cells per word,
+/// whichever way the segment points.
+template<size_t dimension>
+class OccupancyMask {
+public:
+    OccupancyMask()
+        : rows_( dimension * words_per_line, 0 )
+        , columns_( dimension * words_per_line, 0 )
+    {}
+
+    /// \warning does not check bounds
+    inline bool get( const uint32_t i, const uint32_t j ) const {
+        return 0 != (rows_[ j * words_per_line + (i >> 6) ] & (uint64_t(1) << (i & 63)));
+    }
+
+    /// \warning does not check bounds
+    inline void set( const uint32_t i, const uint32_t j, const bool value ){
+        assign( rows_[ j * words_per_line + (i >> 6) ], i & 63, value );
+        assign( columns_[ i * words_per_line + (j >> 6) ], j & 63, value );
+    }
+
+    /// \param test - callable `bool(uint32_t i, uint32_t j)`; true if the cell is flagged
+    template<typename test_t>
+    void rebuild( const test_t& test ){
+        std::fill( rows_.begin(), rows_.end(), 0 );
+        std::fill( columns_.begin(), columns_.end(), 0 );
+        for( uint32_t j = 0; j < dimension; ++j ){
+            for( uint32_t i = 0; i < dimension; ++i ){
+                if( test(i, j) ){
+                    set( i, j, true );
+                }
+            }
+        }
+    }
+
+    /// \brief Find the first flagged cell along a segment
+    ///
+    /// A cell counts as crossed if the segment overlaps its interior with non-zero length; touching a
+    /// corner, or ending exactly on an edge, does not count.  Portions outside the mask are ignored.
+    ///
+    /// \param x0, y0, x1, y1 - segment endpoints, in cell units (i.e. cell (i,j) covers [i, i+1) x [j, j+1))
+    /// \param i, j - set to the first flagged cell, from (x0, y0)
+    /// \return true if a flagged cell was found
+    bool first_set( const double x0, const double y0, const double x1, const double y1, uint32_t& i, uint32_t& j ) const {
+        // runs follow the major axis; lines are indexed by the minor axis
+        if( std::abs(x1 - x0) < std::abs(y1 - y0) ){
+            return first_set_in_lines( columns_.data(), y0, x0, y1, x1, j, i );
+        }
+        return first_set_in_lines( rows_.data(), x0, y0, x1, y1, i, j );
+    }
+
+    /// \brief `first_set(...)`, over a single bit-packed copy: bit (a%64) of word `b*words_per_line + a/64` is cell (a,b)
+    ///
+    /// Correct for any segment; but fastest when it runs along the lines: |x1 - x0| >= |y1 - y0|
+    static bool first_set_in_lines( const uint64_t* lines, const double x0, const double y0, const double x1, const double y1, uint32_t& a, uint32_t& b ){
+        // clip to the mask (Liang-Barsky)
+        double t_enter = 0;
+        double t_exit = 1;
+        if( ! ( clip(-(x1 - x0), x0, t_enter, t_exit) && clip(x1 - x0, dimension - x0, t_enter, t_exit)
+             && clip(-(y1 - y0), y0, t_enter, t_exit) && clip(y1 - y0, dimension - y0, t_enter, t_exit) ) ){
+            return false;
+        }
+
+        const double da = x1 - x0;
+        const double db = y1 - y0;
+        const double a_low = std::min( x0 + t_enter * da, x0 + t_exit * da );
+        const double a_high = std::max( x0 + t_enter * da, x0 + t_exit * da );
+        const double b_low = std::min( y0 + t_enter * db, y0 + t_exit * db );
+        const double b_high = std::max( y0 + t_enter * db, y0 + t_exit * db );
+
+        uint32_t first_line, last_line;
+        span( b_low, b_high, first_line, last_line );
+
+        // change in the major axis, per unit of the minor axis
+        const double slope = (0 != db) ? (da / db) : 0;
+        const bool forward = (0 <= da);
+        const int32_t line_step = (0 <= db) ? 1 : -1;
+        const int64_t line_end = (0 <= db) ? int64_t(last_line) + 1 : int64_t(first_line) - 1;
+        for( int64_t line = (0 <= db) ? first_line : last_line; line != line_end; line += line_step ){
+            double run_low = a_low;
+            double run_high = a_high;
+            if( 0 != db ){
+                // the span of the major axis, while the segment is inside this line
+                const double a_enter = x0 + (std::max<double>(line, b_low) - y0) * slope;
+                const double a_leave = x0 + (std::min<double>(line + 1, b_high) - y0) * slope;
+                run_low = std::clamp( std::min(a_enter, a_leave), a_low, a_high );
+                run_high = std::clamp( std::max(a_enter, a_leave), a_low, a_high );
+            }
+
+            uint32_t low, high, found;
+            span( run_low, run_high, low, high );
+            if( scan( lines + line * words_per_line, low, high, forward, found ) ){
+                a = found;
+                b = static_cast<uint32_t>(line);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// \brief the fraction of the segment (x0,y0) => (x1,y1) before it enters cell (i,j); in [0, 1]
+    ///
+    /// The segment enters the cell when it has crossed both of the cell's near edges.
+    static double entry( const double x0, const double y0, const double x1, const double y1, const uint32_t i, const uint32_t j ){
+        const double start[2] = { x0, y0 };
+        const double delta[2] = { x1 - x0, y1 - y0 };
+        const uint32_t cell[2] = { i, j };
+        double t = 0;
+        for( int axis = 0; axis < 2; ++axis ){
+            if( 0 < delta[axis] ){
+                t = std::max( t, (cell[axis] - start[axis]) / delta[axis] );
+            }else if( delta[axis] < 0 ){
+                t = std::max( t, (cell[axis] + 1 - start[axis]) / delta[axis] );
+            }
+        }
+        return t;
+    }
+
+public:
+    constexpr static size_t words_per_line = (dimension + 63) / 64;
+
+private:
+
+    static inline void assign( uint64_t& word, const uint32_t bit, const bool value ){
+        word = (word & ~(uint64_t(1) << bit)) | (uint64_t(value ? 1 : 0) << bit);
+    }
+
+    /// \brief one Liang-Barsky boundary test
+    static inline bool clip( const double p, const double q, double& t_enter, double& t_exit ){
+        if( 0 == p ){
+            return ( 0 <= q );
+        }
+        const double t = q / p;
+        if( p < 0 ){
+            t_enter = std::max( t_enter, t );
+        }else{
+            t_exit = std::min( t_exit, t );
+        }
+        return ( t_enter <= t_exit );
+    }
+
+    /// \brief the (inclusive) range of cells with non-zero overlap of [low, high]
+    static inline void span( const double low, const double high, uint32_t& first, uint32_t& last ){
+        const double floor_low = std::floor( low );
+        const double ceil_high = std::max( floor_low, std::ceil(high) - 1 );
+        first = static_cast<uint32_t>( std::clamp<double>( floor_low, 0, dimension - 1 ) );
+        last = static_cast<uint32_t>( std::clamp<double>( ceil_high, 0, dimension - 1 ) );
+    }
+
+    /// \brief find the first set bit in [low, high] of one line, 64 cells at a time
+    static inline bool scan( const uint64_t* line, const uint32_t low, const uint32_t high, const bool forward, uint32_t& found ){
+        const uint32_t first_word = low >> 6;
+        const uint32_t last_word = high >> 6;
+        const uint64_t first_mask = ~uint64_t(0) << (low & 63);
+        const uint64_t last_mask = ~uint64_t(0) >> (63 - (high & 63));
+        if( forward ){
+            for( uint32_t w = first_word; w <= last_word; ++w ){
+                uint64_t word = line[w];
+                word &= (w == first_word) ? first_mask : ~uint64_t(0);
+                word &= (w == last_word) ? last_mask : ~uint64_t(0);
+                if( 0 != word ){
+                    found = (w << 6) + __builtin_ctzll(word);
+                    return true;
+                }
+            }
+        }else{
+            for( uint32_t w = last_word + 1; first_word < w; --w ){
+                uint64_t word = line[w - 1];
+                word &= (w - 1 == first_word) ? first_mask : ~uint64_t(0);
+                word &= (w - 1 == last_word) ? last_mask : ~uint64_t(0);
+                if( 0 != word ){
+                    found = ((w - 1) << 6) + 63 - __builtin_clzll(word);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+    /// \brief bit (i%64) of word `j*words_per_line + i/64` is cell (i,j)
+    std::vector<uint64_t> rows_;
+
+    /// \brief bit (j%64) of word `i*words_per_line + j/64` is cell (i,j)
+    std::vector<uint64_t> columns_;
+};
+
+} // namespace chartbox::index
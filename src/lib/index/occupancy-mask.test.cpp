@@ -0,0 +1,142 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include "layer/fixed-grid/fixed-grid.hpp"
+
+#include "occupancy-mask.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+using chartbox::layer::FixedGrid;
+using chartbox::layer::FixedGridLayer;
+
+namespace chartbox::index {
+
+static const AlignedBox2d bounds( Vector2d(0,0), Vector2d(128,128) );
+
+TEST( OccupancyMask, SetAndGet ){
+    OccupancyMask<128> mask;
+    EXPECT_FALSE( mask.get(70, 3) );
+    mask.set( 70, 3, true );
+    EXPECT_TRUE( mask.get(70, 3) );
+    EXPECT_FALSE( mask.get(3, 70) );
+
+    uint32_t i = 0, j = 0;
+    ASSERT_TRUE( mask.first_set( 0.5, 3.5, 127.5, 3.5, i, j ) );
+    EXPECT_EQ( i, 70 );
+    EXPECT_EQ( j, 3 );
+    // ... and through the column-wise copy
+    ASSERT_TRUE( mask.first_set( 70.5, 100.5, 70.9, 0.5, i, j ) );
+    EXPECT_EQ( i, 70 );
+    EXPECT_EQ( j, 3 );
+
+    mask.set( 70, 3, false );
+    EXPECT_FALSE( mask.first_set( 0.5, 3.5, 127.5, 3.5, i, j ) );
+}
+
+TEST( OccupancyMask, LayerRaycast ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    // wall along x = [64, 65)
+    layer.fill( AlignedBox2d(Vector2d(64, 0), Vector2d(65, 128)), 0x99 );
+
+    Vector2d hit;
+    ASSERT_TRUE( layer.raycast( {10.5, 10.5}, {100.5, 19.5}, hit ) );
+    EXPECT_NEAR( hit.x(), 64.0, 1e-9 );
+    EXPECT_NEAR( hit.y(), 15.85, 1e-9 );
+    EXPECT_FALSE( layer.segment_free( {10.5, 10.5}, {100.5, 19.5} ) );
+
+    // ... and back the other way
+    ASSERT_TRUE( layer.raycast( {100.5, 19.5}, {10.5, 10.5}, hit ) );
+    EXPECT_NEAR( hit.x(), 65.0, 1e-9 );
+
+    EXPECT_TRUE( layer.segment_free( {10.5, 10.5}, {63.5, 120.5} ) );
+    // ending exactly on the wall's edge does not enter it
+    EXPECT_TRUE( layer.segment_free( {10.5, 10.5}, {64.0, 10.5} ) );
+
+    // starting inside the wall
+    ASSERT_TRUE( layer.raycast( {64.5, 2.5}, {10.5, 2.5}, hit ) );
+    EXPECT_DOUBLE_EQ( hit.x(), 64.5 );
+
+    // segments are clipped to the layer
+    EXPECT_TRUE( layer.segment_free( {-100, -100}, {-10, 500} ) );
+    ASSERT_TRUE( layer.raycast( {-100, 50.5}, {500, 50.5}, hit ) );
+    EXPECT_NEAR( hit.x(), 64.0, 1e-9 );
+}
+
+TEST( OccupancyMask, CornersDoNotBlock ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    layer.store( {1.5, 0.5}, 0x99 );
+    layer.store( {0.5, 1.5}, 0x99 );
+
+    // exactly diagonal: only touches the corners of the blocked cells
+    EXPECT_TRUE( layer.segment_free( {0.5, 0.5}, {2.5, 2.5} ) );
+    // ... but any deviation crosses one of them
+    EXPECT_FALSE( layer.segment_free( {0.5, 0.5}, {2.5, 2.4} ) );
+    EXPECT_FALSE( layer.segment_free( {0.5, 0.5}, {2.4, 2.5} ) );
+}
+
+TEST( OccupancyMask, MatchesAmanatidesWoo ){
+    typedef FixedGrid< RowMajorIndex<256> > layer_t;
+    typedef chartbox::ChartLayerInterface< uint8_t, layer_t > interface_t;
+    static const AlignedBox2d wide( Vector2d(0,0), Vector2d(512,512) );
+
+    std::mt19937 generator(7);
+    std::bernoulli_distribution blocked( 0.01 );
+    std::uniform_real_distribution<double> coordinate( -64, 576 );
+
+    layer_t layer( wide );
+    layer.fill( layer_t::clear_value );
+    for( uint32_t j = 0; j < layer_t::dimension; ++j ){
+        for( uint32_t i = 0; i < layer_t::dimension; ++i ){
+            if( blocked(generator) ){
+                layer.store( {2*i + 1.0, 2*j + 1.0}, 0x99 );
+            }
+        }
+    }
+
+    size_t blocked_count = 0;
+    std::vector<Vector2d> from, to;
+    for( size_t trial = 0; trial < 2000; ++trial ){
+        const Vector2d start( coordinate(generator), coordinate(generator) );
+        // mix long & short segments
+        const double scale = (0 == (trial % 2)) ? 1.0 : 0.05;
+        const Vector2d end = start + scale * (Vector2d(coordinate(generator), coordinate(generator)) - start);
+        from.push_back( start );
+        to.push_back( end );
+
+        Vector2d fast_hit, reference_hit;
+        const bool fast = layer.raycast( start, end, fast_hit );
+        const bool reference = static_cast<const interface_t&>(layer).raycast( start, end, reference_hit );
+        ASSERT_EQ( fast, reference ) << "    @ " << start.transpose() << " => " << end.transpose();
+        if( fast ){
+            ASSERT_NEAR( fast_hit.x(), reference_hit.x(), 1e-6 );
+            ASSERT_NEAR( fast_hit.y(), reference_hit.y(), 1e-6 );
+            ++blocked_count;
+        }
+    }
+    EXPECT_LT( 100, blocked_count );
+
+    std::vector<double> ranges;
+    EXPECT_EQ( layer.raycast_batch( from, to, ranges ), blocked_count );
+    ASSERT_EQ( ranges.size(), from.size() );
+    for( size_t k = 0; k < from.size(); ++k ){
+        if( layer.segment_free(from[k], to[k]) ){
+            EXPECT_EQ( ranges[k], std::numeric_limits<double>::infinity() );
+        }else{
+            EXPECT_LE( ranges[k], (to[k] - from[k]).norm() + 1e-9 );
+        }
+    }
+}
+
+} // namespace chartbox::index
@@ -0,0 +1,35 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace chartbox::index {
+
+/// \brief Cell-ordering policy: conventional row-major order.  Cell (i,j) is stored at `i + j*dimension`
+///
+/// Best for random point lookups, and for whole-row scans.
+template<size_t dimension_>
+struct RowMajorIndex {
+    constexpr static size_t dimension = dimension_;
+
+    /// \brief true iff each row of cells is contiguous in memory, in order
+    constexpr static bool row_major = true;
+
+    constexpr static char name[] = "RowMajor";
+
+    /// \brief convert cell indices into a storage offset
+    /// \warning does not check bounds
+    constexpr static size_t lookup( const uint32_t i, const uint32_t j ){
+        return static_cast<size_t>(i) + static_cast<size_t>(j) * dimension;
+    }
+
+    /// \brief convert a storage offset back into cell indices
+    constexpr static void decode( const size_t offset, uint32_t& i, uint32_t& j ){
+        i = static_cast<uint32_t>( offset % dimension );
+        j = static_cast<uint32_t>( offset / dimension );
+    }
+};
+
+} // namespace chartbox::index
@@ -0,0 +1,176 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace chartbox::index {
+
+/// \brief Summed-area table (integral image) of a per-cell flag -- e.g. "is this cell blocked?"
+///
+/// Answers "how many flagged cells are in this rectangle" in constant time, regardless of its size.
+///
+/// The table is kept in two levels, so that flipping a single flag stays cheap.  The grid is cut into square
+/// tiles, about sqrt(dimension) cells on a side; and each prefix-count -- of [0, x) x [0, y) -- is the sum of
+/// four parts: the whole tiles below-and-left; the whole tile-columns of the partial tile-row; the whole
+/// tile-rows of the partial tile-column; and the partial tile itself.  So a count is 16 reads, and a flip adds
+/// to about `4 * dimension` entries, instead of to every entry above-and-right of the cell.
+///
+/// Bulk writes should still `pause()` the table, and `rebuild(...)` it once, afterwards.
+template<size_t dimension>
+class SummedAreaTable {
+public:
+    /// \brief cells along each side of a tile: the smallest power of two whose square covers `dimension`
+    constexpr static size_t tile_dimension = []{
+        size_t width = 1;
+        while( width * width < dimension ){
+            width *= 2;
+        }
+        return width; }();
+
+    static_assert( tile_dimension <= 256, "in-tile counts are stored in 16 bits" );
+
+public:
+    SummedAreaTable()
+        : tiles_( tile_stride * tile_stride, 0 )
+        , rows_( tile_stride * stride, 0 )
+        , columns_( stride * tile_stride, 0 )
+        , cells_( stride * stride, 0 )
+    {}
+
+    /// \brief count the flagged cells in [i_min, i_max] x [j_min, j_max]  (inclusive)
+    /// \warning does not check bounds
+    inline uint32_t count( const uint32_t i_min, const uint32_t j_min, const uint32_t i_max, const uint32_t j_max ) const {
+        return prefix( i_max + 1, j_max + 1 ) - prefix( i_min, j_max + 1 )
+             - prefix( i_max + 1, j_min ) + prefix( i_min, j_min );
+    }
+
+    /// \brief stop tracking individual flips, until the next `rebuild(...)`
+    inline void pause() { paused_ = true; }
+
+    inline bool paused() const { return paused_; }
+
+    /// \brief record that the flag of cell (i,j) was set (+1) or cleared (-1)
+    void flip( const uint32_t i, const uint32_t j, const int32_t delta ){
+        if( paused_ ){
+            return;
+        }
+        // unsigned wrap-around is exact for a -1 delta
+        const uint32_t step = static_cast<uint32_t>( delta );
+        const uint16_t cell_step = static_cast<uint16_t>( delta );
+
+        // every prefix past the cell -- but still within its tile -- along each axis
+        const size_t tile_i = i / tile_dimension;
+        const size_t tile_j = j / tile_dimension;
+        const size_t x_end = std::min( (tile_i + 1) * tile_dimension, stride );
+        const size_t y_end = std::min( (tile_j + 1) * tile_dimension, stride );
+
+        for( size_t tile_y = tile_j + 1; tile_y < tile_stride; ++tile_y ){
+            uint32_t* row = tiles_.data() + tile_y * tile_stride;
+            for( size_t tile_x = tile_i + 1; tile_x < tile_stride; ++tile_x ){
+                row[tile_x] += step;
+            }
+        }
+        for( size_t y = j + 1; y < y_end; ++y ){
+            uint32_t* row = rows_.data() + y * tile_stride;
+            for( size_t tile_x = tile_i + 1; tile_x < tile_stride; ++tile_x ){
+                row[tile_x] += step;
+            }
+        }
+        for( size_t tile_y = tile_j + 1; tile_y < tile_stride; ++tile_y ){
+            uint32_t* row = columns_.data() + tile_y * stride;
+            for( size_t x = i + 1; x < x_end; ++x ){
+                row[x] += step;
+            }
+        }
+        for( size_t y = j + 1; y < y_end; ++y ){
+            uint16_t* row = cells_.data() + y * stride;
+            for( size_t x = i + 1; x < x_end; ++x ){
+                row[x] += cell_step;
+            }
+        }
+    }
+
+    /// \brief recompute every entry, and resume tracking flips
+    /// \param test - callable `bool(uint32_t i, uint32_t j)`; true if the cell is flagged
+    template<typename test_t>
+    void rebuild( const test_t& test ){
+        // counts from the start of the current tile-row, up to row `y`: by cell-column within each tile, and
+        // by whole tile-column.  i.e. row `y` of `cells_`, and of `rows_`
+        std::vector<uint16_t> in_tile( stride, 0 );
+        std::vector<uint32_t> before_tile( tile_stride, 0 );
+
+        for( size_t y = 0; y <= dimension; ++y ){
+            if( 0 == (y % tile_dimension) ){
+                // close the previous tile-row
+                const size_t tile_y = y / tile_dimension;
+                for( size_t tile_x = 0; tile_x < tile_stride; ++tile_x ){
+                    tiles_[ tile_x + tile_y * tile_stride ] = (0 == tile_y) ? 0 : tiles_[ tile_x + (tile_y - 1) * tile_stride ] + before_tile[tile_x];
+                }
+                for( size_t x = 0; x <= dimension; ++x ){
+                    columns_[ x + tile_y * stride ] = (0 == tile_y) ? 0 : columns_[ x + (tile_y - 1) * stride ] + in_tile[x];
+                }
+                std::fill( in_tile.begin(), in_tile.end(), 0 );
+                std::fill( before_tile.begin(), before_tile.end(), 0 );
+            }
+
+            std::copy( in_tile.begin(), in_tile.end(), cells_.begin() + y * stride );
+            std::copy( before_tile.begin(), before_tile.end(), rows_.begin() + y * tile_stride );
+
+            if( y < dimension ){
+                uint32_t total = 0;
+                for( size_t tile_x = 0; tile_x < tile_stride; ++tile_x ){
+                    before_tile[tile_x] += total;
+                    const size_t x_begin = tile_x * tile_dimension;
+                    const size_t x_end = std::min( x_begin + tile_dimension, dimension );
+                    uint16_t running = 0;
+                    for( size_t x = x_begin; x < x_end; ++x ){
+                        running += test( static_cast<uint32_t>(x), static_cast<uint32_t>(y) ) ? 1 : 0;
+                        in_tile[x + 1] += running;
+                    }
+                    total += running;
+                }
+                // the last cell of each tile also wrote to the first entry of the next; which is always empty
+                for( size_t x = tile_dimension; x <= dimension; x += tile_dimension ){
+                    in_tile[x] = 0;
+                }
+            }
+        }
+        paused_ = false;
+    }
+
+private:
+    /// \brief count of flagged cells in [0, x) x [0, y); for x, y in [0, dimension]
+    inline uint32_t prefix( const size_t x, const size_t y ) const {
+        const size_t tile_x = x / tile_dimension;
+        const size_t tile_y = y / tile_dimension;
+        return tiles_[ tile_x + tile_y * tile_stride ] + rows_[ tile_x + y * tile_stride ]
+             + columns_[ x + tile_y * stride ] + cells_[ x + y * stride ];
+    }
+
+private:
+    /// \brief prefix indices run from 0 to `dimension`, inclusive
+    constexpr static size_t stride = dimension + 1;
+    constexpr static size_t tile_stride = dimension / tile_dimension + 1;
+
+    // where X = x / tile_dimension, and Y = y / tile_dimension:
+
+    /// \brief `tiles_[X + Y*tile_stride]` is the count in [0, X*tile_dimension) x [0, Y*tile_dimension)
+    std::vector<uint32_t> tiles_;
+
+    /// \brief `rows_[X + y*tile_stride]` is the count in [0, X*tile_dimension) x [Y*tile_dimension, y)
+    std::vector<uint32_t> rows_;
+
+    /// \brief `columns_[x + Y*stride]` is the count in [X*tile_dimension, x) x [0, Y*tile_dimension)
+    std::vector<uint32_t> columns_;
+
+    /// \brief `cells_[x + y*stride]` is the count in [X*tile_dimension, x) x [Y*tile_dimension, y)
+    std::vector<uint16_t> cells_;
+
+    bool paused_ = false;
+};
+
+} // namespace chartbox::index
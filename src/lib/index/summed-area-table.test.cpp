@@ -0,0 +1,156 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include "index/z-order-index.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+
+#include "summed-area-table.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+using chartbox::layer::FixedGrid;
+using chartbox::layer::FixedGridLayer;
+
+namespace chartbox::index {
+
+static const AlignedBox2d bounds( Vector2d(0,0), Vector2d(128,128) );
+
+template<typename layer_t>
+static size_t scan( const layer_t& layer, uint32_t i_min, uint32_t j_min, uint32_t i_max, uint32_t j_max ){
+    size_t count = 0;
+    for( uint32_t j = j_min; j <= j_max; ++j ){
+        for( uint32_t i = i_min; i <= i_max; ++i ){
+            count += (layer_t::blocking_threshold <= layer.get({i + 0.5, j + 0.5})) ? 1 : 0;
+        }
+    }
+    return count;
+}
+
+TEST( SummedAreaTable, CountFlags ){
+    SummedAreaTable<8> table;
+    table.rebuild( []( uint32_t i, uint32_t j ){ return (i == j); } );
+    EXPECT_EQ( table.count(0, 0, 7, 7), 8 );
+    EXPECT_EQ( table.count(2, 2, 4, 4), 3 );
+    EXPECT_EQ( table.count(0, 4, 3, 7), 0 );
+    EXPECT_EQ( table.count(5, 5, 5, 5), 1 );
+
+    table.flip( 0, 7, 1 );
+    EXPECT_EQ( table.count(0, 4, 3, 7), 1 );
+    table.flip( 5, 5, -1 );
+    EXPECT_EQ( table.count(5, 5, 5, 5), 0 );
+    EXPECT_EQ( table.count(0, 0, 7, 7), 8 );
+
+    // paused tables ignore flips
+    table.pause();
+    table.flip( 0, 0, -1 );
+    EXPECT_EQ( table.count(0, 0, 7, 7), 8 );
+}
+
+TEST( SummedAreaTable, FlipsMatchBruteForce ){
+    // not a multiple of the tile width; so the last row & column of tiles are partial
+    constexpr size_t dimension = 100;
+    static_assert( 0 != (dimension % SummedAreaTable<dimension>::tile_dimension) );
+
+    std::mt19937 generator(17);
+    std::uniform_int_distribution<uint32_t> index( 0, dimension - 1 );
+    std::bernoulli_distribution flagged( 0.4 );
+
+    std::vector<bool> flags( dimension * dimension );
+    for( size_t k = 0; k < flags.size(); ++k ){
+        flags[k] = flagged(generator);
+    }
+    SummedAreaTable<dimension> table;
+    table.rebuild( [&flags]( uint32_t i, uint32_t j ){ return flags[i + j * dimension]; } );
+
+    const auto brute_force = [&flags]( uint32_t i0, uint32_t j0, uint32_t i1, uint32_t j1 ){
+        uint32_t count = 0;
+        for( uint32_t j = j0; j <= j1; ++j ){
+            for( uint32_t i = i0; i <= i1; ++i ){
+                count += flags[i + j * dimension] ? 1 : 0;
+            }
+        }
+        return count; };
+
+    EXPECT_EQ( table.count(0, 0, dimension - 1, dimension - 1), brute_force(0, 0, dimension - 1, dimension - 1) );
+    for( size_t trial = 0; trial < 2000; ++trial ){
+        const uint32_t i = index(generator);
+        const uint32_t j = index(generator);
+        flags[i + j * dimension] = ! flags[i + j * dimension];
+        table.flip( i, j, flags[i + j * dimension] ? 1 : -1 );
+
+        uint32_t i0 = index(generator), i1 = index(generator);
+        uint32_t j0 = index(generator), j1 = index(generator);
+        if( i1 < i0 ){ std::swap(i0, i1); }
+        if( j1 < j0 ){ std::swap(j0, j1); }
+        ASSERT_EQ( table.count(i0, j0, i1, j1), brute_force(i0, j0, i1, j1) ) << "    @@ trial: " << trial;
+    }
+    EXPECT_EQ( table.count(0, 0, dimension - 1, dimension - 1), brute_force(0, 0, dimension - 1, dimension - 1) );
+}
+
+TEST( SummedAreaTable, LayerCountBlocked ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    EXPECT_EQ( layer.count_blocked(bounds), 0 );
+    EXPECT_FALSE( layer.any_blocked(bounds) );
+
+    layer.fill( AlignedBox2d(Vector2d(10, 20), Vector2d(20, 25)), 0x99 );
+    EXPECT_EQ( layer.count_blocked(bounds), 50 );
+    EXPECT_EQ( layer.count_blocked( AlignedBox2d(Vector2d(0, 0), Vector2d(15, 128)) ), 25 );
+    EXPECT_TRUE( layer.any_blocked( AlignedBox2d(Vector2d(19.5, 24.5), Vector2d(19.5, 24.5)) ) );
+    EXPECT_FALSE( layer.any_blocked( AlignedBox2d(Vector2d(20, 0), Vector2d(128, 128)) ) );
+
+    // partially-outside areas are clipped
+    EXPECT_EQ( layer.count_blocked( AlignedBox2d(Vector2d(-50, -50), Vector2d(11, 21)) ), 1 );
+    EXPECT_EQ( layer.count_blocked( AlignedBox2d(Vector2d(200, 200), Vector2d(300, 300)) ), 0 );
+
+    // single stores keep the counts current
+    layer.store( {100.5, 100.5}, 0x99 );
+    EXPECT_EQ( layer.count_blocked(bounds), 51 );
+    layer.store( {10.5, 20.5}, FixedGridLayer::clear_value );
+    layer.store( {10.5, 20.5}, 0x42 );
+    EXPECT_EQ( layer.count_blocked(bounds), 51 );
+    layer.store( {10.5, 20.5}, FixedGridLayer::clear_value );
+    EXPECT_EQ( layer.count_blocked(bounds), 50 );
+
+    layer.fill( FixedGridLayer::default_value );
+    EXPECT_EQ( layer.count_blocked(bounds), 128*128 );
+}
+
+TEST( SummedAreaTable, MatchesBruteForce ){
+    typedef FixedGrid< ZOrderIndex<FixedGridLayer::dimension> > ZOrderGrid;
+
+    std::mt19937 generator(31);
+    std::uniform_int_distribution<uint32_t> index( 0, 127 );
+    std::bernoulli_distribution blocked( 0.3 );
+
+    ZOrderGrid layer( bounds );
+    for( uint32_t j = 0; j < ZOrderGrid::dimension; ++j ){
+        for( uint32_t i = 0; i < ZOrderGrid::dimension; ++i ){
+            layer.data()[ layer.lookup(i, j) ] = blocked(generator) ? 0x99 : 0;
+        }
+    }
+    layer.rebuild_occupancy();
+
+    for( size_t trial = 0; trial < 300; ++trial ){
+        // interleave writes and queries
+        layer.store( {index(generator) + 0.5, index(generator) + 0.5}, blocked(generator) ? 0x99 : 0 );
+
+        uint32_t i0 = index(generator), i1 = index(generator);
+        uint32_t j0 = index(generator), j1 = index(generator);
+        if( i1 < i0 ){ std::swap(i0, i1); }
+        if( j1 < j0 ){ std::swap(j0, j1); }
+        const AlignedBox2d area( Vector2d(i0, j0), Vector2d(i1 + 1, j1 + 1) );
+        ASSERT_EQ( layer.count_blocked(area), scan(layer, i0, j0, i1, j1) );
+    }
+}
+
+} // namespace chartbox::index
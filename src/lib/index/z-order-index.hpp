@@ -0,0 +1,73 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace chartbox::index {
+
+/// \brief Cell-ordering policy: Z-order (Morton) curve.  The bits of `i` and `j` are interleaved: `...j1 i1 j0 i0`
+///
+/// Every aligned power-of-two square is contiguous in memory.  When compiled for BMI2, the runtime
+/// path uses a single `pdep` / `pext` per coordinate; the portable bit-twiddling path remains
+/// available for constant-evaluation.
+template<size_t dimension_>
+struct ZOrderIndex {
+    constexpr static size_t dimension = dimension_;
+    constexpr static bool row_major = false;
+
+    constexpr static char name[] = "ZOrder";
+
+    static_assert( 0 == (dimension & (dimension - 1)), "Z-Order dimension must be a power of two!" );
+    static_assert( dimension <= (size_t(1) << 16), "Z-Order coordinates are limited to 16 bits!" );
+
+    constexpr static uint64_t even_bits = 0x5555555555555555ull;
+
+    /// \brief spread the low 32 bits of `value` into the even bits of the result
+    constexpr static uint64_t spread( const uint32_t value ){
+#if defined(__BMI2__)
+        if( ! __builtin_is_constant_evaluated() ){
+            return _pdep_u64( value, even_bits );
+        }
+#endif
+        uint64_t x = value;
+        x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+        x = (x | (x <<  8)) & 0x00FF00FF00FF00FFull;
+        x = (x | (x <<  4)) & 0x0F0F0F0F0F0F0F0Full;
+        x = (x | (x <<  2)) & 0x3333333333333333ull;
+        x = (x | (x <<  1)) & even_bits;
+        return x;
+    }
+
+    /// \brief inverse of `spread`: gather the even bits of `value`
+    constexpr static uint32_t compact( const uint64_t value ){
+#if defined(__BMI2__)
+        if( ! __builtin_is_constant_evaluated() ){
+            return static_cast<uint32_t>( _pext_u64( value, even_bits ) );
+        }
+#endif
+        uint64_t x = value & even_bits;
+        x = (x | (x >>  1)) & 0x3333333333333333ull;
+        x = (x | (x >>  2)) & 0x0F0F0F0F0F0F0F0Full;
+        x = (x | (x >>  4)) & 0x00FF00FF00FF00FFull;
+        x = (x | (x >>  8)) & 0x0000FFFF0000FFFFull;
+        x = (x | (x >> 16)) & 0x00000000FFFFFFFFull;
+        return static_cast<uint32_t>(x);
+    }
+
+    constexpr static size_t lookup( const uint32_t i, const uint32_t j ){
+        return static_cast<size_t>( spread(i) | (spread(j) << 1) );
+    }
+
+    constexpr static void decode( const size_t offset, uint32_t& i, uint32_t& j ){
+        i = compact( offset );
+        j = compact( offset >> 1 );
+    }
+};
+
+} // namespace chartbox::index
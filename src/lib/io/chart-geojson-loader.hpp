@@ -23,7 +23,10 @@ template< typename layer_t >
 class GeoJSONLoader : ChartBaseLoader<layer_t, GeoJSONLoader<layer_t> > {
 public:
 
-    GeoJSONLoader( FrameMapping& _mapping, layer_t& _layer );
+    /// \param _fill_value - written inside the boundary polygon
+    /// \param _move_bounds - if true, move the mapping to the document's "bbox"; else, load into the mapping as-is
+    GeoJSONLoader( FrameMapping& _mapping, layer_t& _layer,
+                   const typename layer_t::cell_t _fill_value = layer_t::clear_value, const bool _move_bounds = true );
 
     bool load_file(const std::string& filename);
     bool load_text(const std::string& source);
@@ -41,6 +44,9 @@ private:
     FrameMapping& mapping_;
     layer_t& layer_;
 
+    const typename layer_t::cell_t fill_value_;
+    const bool move_bounds_;
+
 };
 
 } // namespace chart::io
@@ -16,12 +16,16 @@
 #include <gdal.h>
 #include <ogr_geometry.h>
 
+#include "probe/probe.hpp"
+
 using chartbox::io::GeoJSONLoader;
 
 template<typename layer_t>
-GeoJSONLoader<layer_t>::GeoJSONLoader( FrameMapping& _mapping, layer_t& _destination_layer )
+GeoJSONLoader<layer_t>::GeoJSONLoader( FrameMapping& _mapping, layer_t& _destination_layer, const typename layer_t::cell_t _fill_value, const bool _move_bounds )
     : mapping_(_mapping)
     , layer_(_destination_layer)
+    , fill_value_(_fill_value)
+    , move_bounds_(_move_bounds)
 {}
 
 template<typename layer_t>
@@ -56,7 +60,8 @@ bool GeoJSONLoader<layer_t>::load_text( const std::string& source_text ){
 
 template<typename layer_t>
 bool GeoJSONLoader<layer_t>::load_json( const CPLJSONObject& root ){
-    if( load_json_boundary_box(root) ){
+    CHARTBOX_PROBE_SCOPE( "geojson.load_json" );
+    if( (! move_bounds_) || load_json_boundary_box(root) ){
         return load_json_boundary_polygon(root);
     }else{
         std::cerr << "!! Could not load GeoJSON bounding box: !!!" << std::endl;
@@ -125,14 +130,12 @@ bool GeoJSONLoader<layer_t>::load_json_boundary_polygon( const CPLJSONObject& ro
                 to_ring->addPoint( to_coord );
             }
 
+            CHARTBOX_PROBE_COUNT( "geojson.polygon.vertices", to_ring->getNumPoints() );
             to_ring->closeRings();
             local_frame_polygon->addRing( to_ring );
-        
-            // not really sure where this should live, yet.
-            // for the boundary layer, this value should simply be 0 == clear == 0% probability of collision
-            constexpr auto fill_value = layer_.clear_value;
 
-            return layer_.fill( std::move(std::unique_ptr<OGRPolygon>(local_frame_polygon)), fill_value );
+            // for the boundary layer, this value defaults to 0 == clear == 0% probability of collision
+            return layer_.fill( std::move(std::unique_ptr<OGRPolygon>(local_frame_polygon)), fill_value_ );
         }
     }
     std::cerr << "    << no boundary polygon found -- defaulting to boundary box.\n" << std::endl;
@@ -8,6 +8,12 @@
 
 namespace chartbox::io {
 
+/// \brief writes a layer's cells as a single-band grayscale image
+///
+/// `uint8_t` and `uint16_t` cells are written as 8- or 16-bit PNGs.  PNG has no signed or floating-point
+/// gray; so `int16_t` and `float` cells are written as a GeoTIFF instead -- to the same path -- at full precision.
+///
+/// Any layer with a fixed `dimension`, and `get(i,j)`, may be written; row-major grids are copied a whole row at a time.
 template< typename layer_t >
 class PNGWriter : ChartBaseWriter<layer_t, PNGWriter<layer_t> > {
 public:
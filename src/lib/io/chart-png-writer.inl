@@ -5,14 +5,47 @@
 //       function implementations.
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "gdal_priv.h"
 
 using chartbox::io::PNGWriter;
 
+namespace chartbox::io::detail {
+
+/// \brief GDAL's raster type for each cell type
+template<typename cell_t>
+constexpr GDALDataType gdal_type(){
+    if constexpr ( std::is_same_v<cell_t, uint8_t> ){
+        return GDT_Byte;
+    }else if constexpr ( std::is_same_v<cell_t, uint16_t> ){
+        return GDT_UInt16;
+    }else if constexpr ( std::is_same_v<cell_t, int16_t> ){
+        return GDT_Int16;
+    }else{
+        static_assert( std::is_same_v<cell_t, float>, "no GDAL raster type for this cell type" );
+        return GDT_Float32;
+    }
+}
+
+/// \brief true if the layer's rows are contiguous in memory -- i.e. it provides `row_ptr(j)`
+template<typename layer_t, typename = void>
+struct contiguous_rows : std::false_type {};
+
+template<typename layer_t>
+struct contiguous_rows<layer_t, std::enable_if_t<layer_t::index_t::row_major>> : std::true_type {};
+
+} // namespace chartbox::io::detail
+
 template< typename layer_t >
 bool PNGWriter<layer_t>::write_to_path( const std::string& filepath ){
+    typedef typename layer_t::cell_t cell_t;
+    constexpr GDALDataType cell_type = detail::gdal_type<cell_t>();
+    // PNG holds 8- and 16-bit unsigned gray; anything else is written as a GeoTIFF, at full precision
+    constexpr bool as_png = (GDT_Byte == cell_type) || (GDT_UInt16 == cell_type);
 
     // not a guaranteed property of the layer; not all of them have this...
     const size_t dimension = layer_.dimension;
@@ -26,7 +59,7 @@ bool PNGWriter<layer_t>::write_to_path( const std::string& filepath ){
         fmt::print( stderr, "!! error allocating memory driver !! (did you initialize GDAL?)" );
         return false;
     }
-    GDALDataset* p_grid_dataset = p_memory_driver->Create( "", dimension, dimension, 1, GDT_Byte, nullptr);
+    GDALDataset* p_grid_dataset = p_memory_driver->Create( "", dimension, dimension, 1, cell_type, nullptr);
     if (nullptr == p_grid_dataset) {
         fmt::print( stderr, "!! error allocating grid dataset ?!" );
         return false;
@@ -39,27 +72,35 @@ bool PNGWriter<layer_t>::write_to_path( const std::string& filepath ){
         return false;
     }
 
-    // optional property of layers... also: yes, it's a hack
-    std::byte* layer_start_p = reinterpret_cast<std::byte*>( layer_.data() );
+    // rows are only contiguous in row-major layers; otherwise, gather each row into this buffer, by cell index
+    std::vector<cell_t> line( dimension );
 
     // copy one line at a time, reading from the bottom-up, but writing top-down (i.e. Raster-Order) 
     for( size_t line_index = 0; line_index < dimension; ++line_index ){
-        void* read_p = layer_start_p + ((dimension-line_index) * dimension);
-        if (CE_Failure == p_gray_band->RasterIO(GF_Write, 0, line_index, dimension, 1, read_p, dimension, dimension, GDT_Byte, 1, 0)) {
+        const uint32_t j = dimension - 1 - line_index;
+        const cell_t* read_p = line.data();
+        if constexpr ( detail::contiguous_rows<layer_t>::value ){
+            read_p = layer_.row_ptr( j );
+        }else{
+            for( uint32_t i = 0; i < dimension; ++i ){
+                line[i] = layer_.get( i, j );
+            }
+        }
+        if (CE_Failure == p_gray_band->RasterIO(GF_Write, 0, line_index, dimension, 1, const_cast<cell_t*>(read_p), dimension, 1, cell_type, 0, 0)) {
             fmt::print( stderr, "?? Could not copy into the RasterIO buffer.\n" );
             GDALClose(p_grid_dataset);
             return false;
         }
     }
 
-    // Use the png driver to copy the source dataset
-    GDALDriver* p_png_driver = GetGDALDriverManager()->GetDriverByName("PNG");
-    GDALDataset* p_png_dataset = p_png_driver->CreateCopy(filepath.c_str(), p_grid_dataset, false, nullptr, nullptr, nullptr);
+    // Use the png (or tiff) driver to copy the source dataset
+    GDALDriver* p_file_driver = GetGDALDriverManager()->GetDriverByName( as_png ? "PNG" : "GTiff" );
+    GDALDataset* p_file_dataset = p_file_driver->CreateCopy(filepath.c_str(), p_grid_dataset, false, nullptr, nullptr, nullptr);
 
-    if (p_png_dataset) {
-        GDALClose(p_grid_dataset);
-        GDALClose(p_png_dataset);
+    GDALClose(p_grid_dataset);
+    if( nullptr == p_file_dataset ){
+        return false;
     }
-
+    GDALClose(p_file_dataset);
     return true;
 }
@@ -0,0 +1,139 @@
+// GPL v3 (c) 2021, Daniel Williams
+#pragma once
+
+// standard library includes
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+// GDAL
+#include <gdal_priv.h>
+
+#include "chart-box.hpp"
+#include "chart-base-loader.hpp"
+
+namespace chartbox::io {
+
+/// \brief how source pixels combine into each destination cell
+enum class Resample {
+    /// the source pixel under the cell's center
+    Nearest,
+    /// the four source pixels around the cell's center, weighted by distance
+    Bilinear,
+    /// the lowest value of the source pixels under the cell's footprint
+    Minimum,
+    /// the highest value of the source pixels under the cell's footprint
+    ///
+    /// For bathymetry -- depths as negative elevations (see `CellTraits`) -- this is the shallowest sounding;
+    /// so it is the conservative choice for a navigation chart.
+    Maximum
+};
+
+/// \brief Load a single-band raster (e.g. a bathymetry GeoTIFF, or a DEM) into a layer
+///
+/// ## Implementation Specifics
+/// Only the source window under the mapping's `utm_bounds()` is read: each destination cell's center is
+/// projected into the source's frame and pixel grid, and the window covers those pixels (plus whatever
+/// margin the resampling method needs).
+///
+/// The window is read in two parallel passes:
+///   1. each worker claims whole source blocks -- aligned to the band's natural block size -- and reads
+///      them through its own dataset handle; so each block is decompressed exactly once.
+///   2. each worker claims destination rows, and resamples them from the (now complete) window.
+///
+/// The destination layer is written once, at the end, through `fill( std::vector<cell_t> )`.
+///
+/// Source pixels equal to the band's no-data value, and cells outside the source, load as the layer's
+/// `default_value`.  The footprint of `Minimum` and `Maximum` is taken at the center of the chart; which
+/// is accurate while the chart is small compared to the source's projection.
+///
+/// \warning the window is buffered as 32-bit floats; so reading a very fine source into a very wide
+///          chart may take a lot of memory.
+///
+/// References:
+///   - https://gdal.org/drivers/raster/gtiff.html
+///   - https://gdal.org/user/raster_data_model.html
+///   - https://gdal.org/user/multithreading.html
+template< typename layer_t >
+class RasterLoader : ChartBaseLoader<layer_t, RasterLoader<layer_t> > {
+public:
+
+    RasterLoader( FrameMapping& _mapping, layer_t& _layer, const Resample _method = Resample::Bilinear,
+                  const size_t _thread_count = std::thread::hardware_concurrency() );
+
+    bool load_file(const std::string& filename);
+
+    /// \brief load a raster from its (binary) file contents; e.g. a whole GeoTIFF
+    bool load_text(const std::string& source);
+
+    /// \brief number of source blocks read by the most recent load
+    size_t blocks_read() const { return blocks_read_; }
+
+private:
+    /// \brief a rectangle of source pixels: [x, x + width) x [y, y + height)
+    struct Window {
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    /// \brief project each destination cell's center into the source's pixel grid
+    bool map_cells( GDALDataset& dataset );
+
+    /// \brief the source pixels needed to resample every mapped cell; clipped to the source
+    bool find_window( const int raster_width, const int raster_height );
+
+    /// \brief read every source block which intersects the window; each through its worker's own dataset handle
+    bool read_blocks( const std::string& filename, GDALRasterBand& band );
+
+    /// \brief resample each destination row from the window
+    void resample_rows( std::vector<typename layer_t::cell_t>& cells ) const;
+
+    /// \brief resample one destination cell; NaN if the source has no data there
+    double resample( const double px, const double py ) const;
+
+    /// \brief run `work` on up to `thread_count_` threads -- including this one -- and wait for all of them
+    ///
+    /// \param job_count - no more threads than this are started
+    /// \param work - each copy claims its own jobs, until none are left
+    template<typename work_t>
+    void run_workers( const size_t job_count, const work_t& work ) const;
+
+    /// \brief the window pixel at the given source pixel; NaN if outside the window
+    inline double pixel( const int column, const int row ) const {
+        const int u = column - window_.x;
+        const int v = row - window_.y;
+        if( (u < 0) || (v < 0) || (window_.width <= u) || (window_.height <= v) ){
+            return NAN;
+        }
+        return window_pixels_[ static_cast<size_t>(v) * window_.width + u ];
+    }
+
+private:
+    FrameMapping& mapping_;
+    layer_t& layer_;
+
+    const Resample method_;
+    const size_t thread_count_;
+
+    /// source pixel coordinates of each destination cell's center, in row-major order; NaN if unmapped
+    std::vector<double> source_x_;
+    std::vector<double> source_y_;
+
+    /// half-extent of one destination cell, in source pixels
+    double footprint_x_ = 0.5;
+    double footprint_y_ = 0.5;
+
+    Window window_ = {0, 0, 0, 0};
+    std::vector<float> window_pixels_;
+
+    size_t blocks_read_ = 0;
+
+};
+
+} // namespace chartbox::io
+
+#include "chart-raster-loader.inl"
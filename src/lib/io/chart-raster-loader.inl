@@ -0,0 +1,371 @@
+// GPL v3 (c) 2021, Daniel Williams
+//
+// NOTE: This is not an independent compilation unit!
+//       It is a template-class implementation, and should only be included from its header.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <cpl_vsi.h>
+#include <gdal_priv.h>
+#include <ogr_spatialref.h>
+
+#include "probe/probe.hpp"
+
+using chartbox::io::RasterLoader;
+using chartbox::io::Resample;
+
+namespace chartbox::io::detail {
+
+/// \brief convert a resampled value to a cell: rounded and saturated, for integer cells
+template<typename cell_t>
+inline cell_t to_cell( const double value, const cell_t fallback ){
+    if( std::isnan(value) ){
+        return fallback;
+    }
+    if constexpr ( std::is_floating_point_v<cell_t> ){
+        return static_cast<cell_t>( value );
+    }else{
+        constexpr double lowest = static_cast<double>( std::numeric_limits<cell_t>::lowest() );
+        constexpr double highest = static_cast<double>( std::numeric_limits<cell_t>::max() );
+        return static_cast<cell_t>( std::clamp(std::round(value), lowest, highest) );
+    }
+}
+
+} // namespace chartbox::io::detail
+
+template<typename layer_t>
+RasterLoader<layer_t>::RasterLoader( FrameMapping& _mapping, layer_t& _destination_layer, const Resample _method, const size_t _thread_count )
+    : mapping_(_mapping)
+    , layer_(_destination_layer)
+    , method_(_method)
+    , thread_count_( std::max<size_t>(1, _thread_count) )
+{}
+
+template<typename layer_t>
+bool RasterLoader<layer_t>::load_file( const std::string& filename ){
+    CHARTBOX_PROBE_SCOPE( "raster.load_file" );
+    blocks_read_ = 0;
+
+    GDALAllRegister();
+    auto* dataset = static_cast<GDALDataset*>( GDALOpenEx(filename.c_str(), GDAL_OF_RASTER | GDAL_OF_READONLY, nullptr, nullptr, nullptr) );
+    if( nullptr == dataset ){
+        std::cerr << "!! Could not open raster !!: " << filename << std::endl;
+        return false;
+    }else if( dataset->GetRasterCount() < 1 ){
+        std::cerr << "!! Raster has no bands !!: " << filename << std::endl;
+        GDALClose( dataset );
+        return false;
+    }
+
+    const bool mapped = map_cells( *dataset )
+                     && find_window( dataset->GetRasterXSize(), dataset->GetRasterYSize() )
+                     && read_blocks( filename, *dataset->GetRasterBand(1) );
+    GDALClose( dataset );
+    if( ! mapped ){
+        return false;
+    }
+
+    std::vector<typename layer_t::cell_t> cells( layer_t::dimension * layer_t::dimension );
+    resample_rows( cells );
+
+    // the window may be large; and is only needed until the layer is written
+    std::vector<float>().swap( window_pixels_ );
+
+    return layer_.fill( cells );
+}
+
+template<typename layer_t>
+bool RasterLoader<layer_t>::load_text( const std::string& source ){
+    // GDAL reads (and shares between handles) in-memory files, under this prefix
+    const std::string path = "/vsimem/chartbox-raster-" + std::to_string( reinterpret_cast<uintptr_t>(this) );
+    VSILFILE* file = VSIFileFromMemBuffer( path.c_str(), reinterpret_cast<GByte*>(const_cast<char*>(source.data())), source.size(), FALSE );
+    if( nullptr == file ){
+        std::cerr << "?!?! Unknown failure while loading raster bytes into GDAL...\n";
+        return false;
+    }
+    VSIFCloseL( file );
+
+    const bool result = load_file( path );
+    VSIUnlink( path.c_str() );
+    return result;
+}
+
+template<typename layer_t>
+bool RasterLoader<layer_t>::map_cells( GDALDataset& dataset ){
+    CHARTBOX_PROBE_SCOPE( "raster.map_cells" );
+    double geo_transform[6];
+    double pixel_transform[6];
+    if( CE_None != dataset.GetGeoTransform(geo_transform) ){
+        std::cerr << "!! Raster is not georeferenced !!" << std::endl;
+        return false;
+    }else if( ! GDALInvGeoTransform(geo_transform, pixel_transform) ){
+        std::cerr << "!! Raster's geo-transform is not invertible !!" << std::endl;
+        return false;
+    }
+
+    // without a spatial reference, the source is assumed to already be in the chart's UTM frame
+    std::unique_ptr<OGRCoordinateTransformation, decltype(&OGRCoordinateTransformation::DestroyCT)> to_source( nullptr, &OGRCoordinateTransformation::DestroyCT );
+    const OGRSpatialReference* source_reference = dataset.GetSpatialRef();
+    if( nullptr != source_reference ){
+        OGRSpatialReference from( mapping_.utm_frame() );
+        OGRSpatialReference to( *source_reference );
+        // geo-transforms are always in (easting, northing) / (longitude, latitude) order
+        from.SetAxisMappingStrategy( OAMS_TRADITIONAL_GIS_ORDER );
+        to.SetAxisMappingStrategy( OAMS_TRADITIONAL_GIS_ORDER );
+        if( ! from.IsSame(&to) ){
+            to_source.reset( OGRCreateCoordinateTransformation(&from, &to) );
+            if( ! to_source ){
+                std::cerr << "!! Could not transform from the chart's frame to the raster's frame !!" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    constexpr size_t dimension = layer_t::dimension;
+    const double precision = layer_.precision();
+    const Eigen::Vector2d& origin = mapping_.utm_bounds().min();
+    source_x_.resize( dimension * dimension );
+    source_y_.resize( dimension * dimension );
+    std::vector<int> transformed( dimension, TRUE );
+
+    for( size_t j = 0; j < dimension; ++j ){
+        double* xs = source_x_.data() + j*dimension;
+        double* ys = source_y_.data() + j*dimension;
+        for( size_t i = 0; i < dimension; ++i ){
+            xs[i] = origin.x() + (i + 0.5) * precision;
+            ys[i] = origin.y() + (j + 0.5) * precision;
+        }
+        if( to_source ){
+            // per-point success flags are authoritative; the return value only reports if any point failed
+            to_source->Transform( static_cast<int>(dimension), xs, ys, nullptr, transformed.data() );
+        }
+        for( size_t i = 0; i < dimension; ++i ){
+            if( ! transformed[i] ){
+                xs[i] = ys[i] = NAN;
+                continue;
+            }
+            const double x = xs[i];
+            const double y = ys[i];
+            xs[i] = pixel_transform[0] + pixel_transform[1]*x + pixel_transform[2]*y;
+            ys[i] = pixel_transform[3] + pixel_transform[4]*x + pixel_transform[5]*y;
+        }
+    }
+
+    // half of one cell's extent, in source pixels: half the steps to the next cell, in each direction;
+    // so resample() reads the pixels within +/- this of each cell's center
+    const size_t center = (dimension / 2) * dimension + (dimension / 2);
+    const double dxi = source_x_[center + 1] - source_x_[center];
+    const double dxj = source_x_[center + dimension] - source_x_[center];
+    const double dyi = source_y_[center + 1] - source_y_[center];
+    const double dyj = source_y_[center + dimension] - source_y_[center];
+    footprint_x_ = 0.5 * (std::fabs(dxi) + std::fabs(dxj));
+    footprint_y_ = 0.5 * (std::fabs(dyi) + std::fabs(dyj));
+    if( ! std::isfinite(footprint_x_) || ! std::isfinite(footprint_y_) ){
+        footprint_x_ = footprint_y_ = 0.5;
+    }
+    return true;
+}
+
+template<typename layer_t>
+bool RasterLoader<layer_t>::find_window( const int raster_width, const int raster_height ){
+    int margin = 0;
+    if( Resample::Bilinear == method_ ){
+        margin = 1;
+    }else if( (Resample::Minimum == method_) || (Resample::Maximum == method_) ){
+        margin = 1 + static_cast<int>( std::ceil(std::max(footprint_x_, footprint_y_)) );
+    }
+
+    int min_column = std::numeric_limits<int>::max();
+    int min_row = std::numeric_limits<int>::max();
+    int max_column = std::numeric_limits<int>::lowest();
+    int max_row = std::numeric_limits<int>::lowest();
+    for( size_t k = 0; k < source_x_.size(); ++k ){
+        const double px = std::floor( source_x_[k] );
+        const double py = std::floor( source_y_[k] );
+        // cells outside the source (or unmapped) load as no-data; so they need no pixels
+        if( !(0 <= px) || !(0 <= py) || !(px < raster_width) || !(py < raster_height) ){
+            continue;
+        }
+        min_column = std::min( min_column, static_cast<int>(px) );
+        max_column = std::max( max_column, static_cast<int>(px) );
+        min_row = std::min( min_row, static_cast<int>(py) );
+        max_row = std::max( max_row, static_cast<int>(py) );
+    }
+    if( max_column < min_column ){
+        std::cerr << "!! Raster does not overlap the chart !!" << std::endl;
+        return false;
+    }
+
+    min_column = std::max( 0, min_column - margin );
+    min_row = std::max( 0, min_row - margin );
+    max_column = std::min( raster_width - 1, max_column + margin );
+    max_row = std::min( raster_height - 1, max_row + margin );
+    window_ = { min_column, min_row, max_column - min_column + 1, max_row - min_row + 1 };
+    return true;
+}
+
+template<typename layer_t>
+bool RasterLoader<layer_t>::read_blocks( const std::string& filename, GDALRasterBand& band ){
+    CHARTBOX_PROBE_SCOPE( "raster.read_blocks" );
+    int block_width = 0;
+    int block_height = 0;
+    band.GetBlockSize( &block_width, &block_height );
+    block_width = std::max( 1, block_width );
+    block_height = std::max( 1, block_height );
+
+    // whole source blocks, clipped to the window: so no two reads decompress the same block
+    std::vector<Window> blocks;
+    for( int row = window_.y / block_height; row * block_height < window_.y + window_.height; ++row ){
+        for( int column = window_.x / block_width; column * block_width < window_.x + window_.width; ++column ){
+            const int x = std::max( window_.x, column * block_width );
+            const int y = std::max( window_.y, row * block_height );
+            const int x_end = std::min( window_.x + window_.width, (column + 1) * block_width );
+            const int y_end = std::min( window_.y + window_.height, (row + 1) * block_height );
+            blocks.push_back({ x, y, x_end - x, y_end - y });
+        }
+    }
+    CHARTBOX_PROBE_COUNT( "raster.blocks", blocks.size() );
+
+    window_pixels_.assign( static_cast<size_t>(window_.width) * window_.height, NAN );
+
+    int has_no_data = FALSE;
+    const float no_data = static_cast<float>( band.GetNoDataValue(&has_no_data) );
+    const int band_index = band.GetBand();
+
+    std::atomic<size_t> next_block( 0 );
+    std::atomic<bool> failed( false );
+    const auto work = [&](){
+        // GDAL datasets may not be shared between threads; but each may open its own
+        auto* dataset = static_cast<GDALDataset*>( GDALOpenEx(filename.c_str(), GDAL_OF_RASTER | GDAL_OF_READONLY, nullptr, nullptr, nullptr) );
+        if( nullptr == dataset ){
+            failed = true;
+            return;
+        }
+        GDALRasterBand* source = dataset->GetRasterBand( band_index );
+        for( size_t index = next_block++; (index < blocks.size()) && (! failed); index = next_block++ ){
+            const Window& block = blocks[index];
+            float* destination = window_pixels_.data() + static_cast<size_t>(block.y - window_.y) * window_.width + (block.x - window_.x);
+            if( CE_None != source->RasterIO(GF_Read, block.x, block.y, block.width, block.height,
+                                             destination, block.width, block.height, GDT_Float32,
+                                             sizeof(float), sizeof(float) * window_.width, nullptr) ){
+                failed = true;
+                break;
+            }
+            if( has_no_data && ! std::isnan(no_data) ){
+                for( int v = 0; v < block.height; ++v ){
+                    float* row = destination + static_cast<size_t>(v) * window_.width;
+                    std::replace( row, row + block.width, no_data, static_cast<float>(NAN) );
+                }
+            }
+        }
+        GDALClose( dataset );
+    };
+    run_workers( blocks.size(), work );
+
+    if( failed ){
+        std::cerr << "!! Could not read raster blocks !!: " << filename << std::endl;
+        return false;
+    }
+    blocks_read_ = blocks.size();
+    return true;
+}
+
+template<typename layer_t>
+void RasterLoader<layer_t>::resample_rows( std::vector<typename layer_t::cell_t>& cells ) const {
+    CHARTBOX_PROBE_SCOPE( "raster.resample_rows" );
+    constexpr size_t dimension = layer_t::dimension;
+    std::atomic<size_t> next_row( 0 );
+    const auto work = [&](){
+        for( size_t j = next_row++; j < dimension; j = next_row++ ){
+            for( size_t k = j*dimension; k < (j + 1)*dimension; ++k ){
+                cells[k] = detail::to_cell( resample(source_x_[k], source_y_[k]), layer_t::default_value );
+            }
+        }
+    };
+    run_workers( dimension, work );
+}
+
+template<typename layer_t>
+double RasterLoader<layer_t>::resample( const double px, const double py ) const {
+    if( ! std::isfinite(px) || ! std::isfinite(py) ){
+        return NAN;
+    }
+
+    // a cell whose center has no data, has no data -- whichever method is used
+    const double nearest = pixel( static_cast<int>(std::floor(px)), static_cast<int>(std::floor(py)) );
+    if( std::isnan(nearest) ){
+        return NAN;
+    }
+
+    switch( method_ ){
+        case Resample::Nearest:
+            return nearest;
+
+        case Resample::Bilinear: {
+            // pixel values are at pixel centers; neighbors without data are left out of the weights
+            const double u = px - 0.5;
+            const double v = py - 0.5;
+            const int column = static_cast<int>( std::floor(u) );
+            const int row = static_cast<int>( std::floor(v) );
+            const double fu = u - column;
+            const double fv = v - row;
+            double sum = 0;
+            double weight = 0;
+            for( int dv = 0; dv < 2; ++dv ){
+                for( int du = 0; du < 2; ++du ){
+                    const double w = (du ? fu : 1 - fu) * (dv ? fv : 1 - fv);
+                    const double value = pixel( column + du, row + dv );
+                    if( (0 < w) && ! std::isnan(value) ){
+                        sum += w * value;
+                        weight += w;
+                    }
+                }
+            }
+            return (0 < weight) ? (sum / weight) : nearest;
+        }
+
+        case Resample::Minimum:
+        case Resample::Maximum: {
+            const int column_begin = static_cast<int>( std::floor(px - footprint_x_) );
+            const int column_end = std::max( column_begin + 1, static_cast<int>(std::ceil(px + footprint_x_)) );
+            const int row_begin = static_cast<int>( std::floor(py - footprint_y_) );
+            const int row_end = std::max( row_begin + 1, static_cast<int>(std::ceil(py + footprint_y_)) );
+            double result = nearest;
+            for( int row = row_begin; row < row_end; ++row ){
+                for( int column = column_begin; column < column_end; ++column ){
+                    const double value = pixel( column, row );
+                    if( std::isnan(value) ){
+                        continue;
+                    }
+                    result = (Resample::Minimum == method_) ? std::min(result, value) : std::max(result, value);
+                }
+            }
+            return result;
+        }
+    }
+    return NAN;
+}
+
+template<typename layer_t>
+template<typename work_t>
+void RasterLoader<layer_t>::run_workers( const size_t job_count, const work_t& work ) const {
+    const size_t worker_count = std::max<size_t>( 1, std::min(thread_count_, job_count) );
+    std::vector<std::thread> helpers;
+    for( size_t worker = 1; worker < worker_count; ++worker ){
+        helpers.emplace_back( work );
+    }
+    work();
+    for( auto& helper : helpers ){
+        helper.join();
+    }
+}
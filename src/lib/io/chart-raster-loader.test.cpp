@@ -0,0 +1,221 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include <cpl_string.h>
+#include <cpl_vsi.h>
+#include <gdal_priv.h>
+
+#include "index/row-major-index.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+
+#include "chart-raster-loader.hpp"
+
+using Eigen::Vector2d;
+
+using chartbox::FrameMapping;
+using chartbox::index::RowMajorIndex;
+using chartbox::layer::FixedGrid;
+
+namespace chartbox::io {
+
+typedef FixedGrid< RowMajorIndex<16>, float > DepthGrid;
+
+/// a 16m x 16m chart, at (1000, 2000) in its UTM frame; so each cell is 1m x 1m, and cell (i, j) is at (i + 0.5, j + 0.5) in the layer
+class TestMapping : public FrameMapping {
+public:
+    TestMapping(){
+        utm_bounds_ = Eigen::AlignedBox2d( Vector2d(1000, 2000), Vector2d(1016, 2016) );
+    }
+};
+
+constexpr int raster_size = 64;
+constexpr double no_data = -9999;
+
+/// \brief write a 64 x 64 float GeoTIFF, of 0.5m pixels, in 16 x 16 tiles, into GDAL's in-memory filesystem
+///
+/// \param west - easting of the raster's left edge; its top edge is always at 2016
+/// \param missing - (column, row) of each pixel to set to no-data; every other pixel is `column + 100*row`
+static std::string write_raster( const std::string& name, const double west, const std::vector<std::pair<int,int>>& missing = {} ){
+    GDALAllRegister();
+    const std::string path = "/vsimem/" + name + ".tif";
+
+    char** options = nullptr;
+    options = CSLSetNameValue( options, "TILED", "YES" );
+    options = CSLSetNameValue( options, "BLOCKXSIZE", "16" );
+    options = CSLSetNameValue( options, "BLOCKYSIZE", "16" );
+    GDALDriver* driver = GetGDALDriverManager()->GetDriverByName( "GTiff" );
+    GDALDataset* dataset = driver->Create( path.c_str(), raster_size, raster_size, 1, GDT_Float32, options );
+    CSLDestroy( options );
+    EXPECT_NE( dataset, nullptr );
+
+    // no spatial reference: so the loader takes the raster to be in the chart's frame
+    double geo_transform[6] = { west, 0.5, 0, 2016, 0, -0.5 };
+    dataset->SetGeoTransform( geo_transform );
+
+    std::vector<float> pixels( raster_size * raster_size );
+    for( int row = 0; row < raster_size; ++row ){
+        for( int column = 0; column < raster_size; ++column ){
+            pixels[row * raster_size + column] = static_cast<float>( column + 100*row );
+        }
+    }
+    for( const auto& [column, row] : missing ){
+        pixels[row * raster_size + column] = static_cast<float>( no_data );
+    }
+
+    GDALRasterBand* band = dataset->GetRasterBand(1);
+    band->SetNoDataValue( no_data );
+    EXPECT_EQ( CE_None, band->RasterIO(GF_Write, 0, 0, raster_size, raster_size, pixels.data(), raster_size, raster_size, GDT_Float32, 0, 0, nullptr) );
+    GDALClose( dataset );
+    return path;
+}
+
+/// \brief value of cell (i, j), loaded through `method` from the raster written at west == 1000
+///
+/// Cell (i, j)'s center is at source pixel (2i + 1, 31 - 2j); and it covers columns [2i, 2i + 2) and rows [30 - 2j, 32 - 2j).
+static double expected_value( const Resample method, const int i, const int j ){
+    switch( method ){
+        case Resample::Nearest:  return (2*i + 1) + 100*(31 - 2*j);
+        case Resample::Bilinear: return (2*i + 0.5) + 100*(30.5 - 2*j);
+        case Resample::Minimum:  return (2*i) + 100*(30 - 2*j);
+        case Resample::Maximum:  return (2*i + 1) + 100*(31 - 2*j);
+    }
+    return 0;
+}
+
+static const Resample all_methods[] = { Resample::Nearest, Resample::Bilinear, Resample::Minimum, Resample::Maximum };
+
+TEST( RasterLoader, EachResampleMethod ){
+    TestMapping mapping;
+    DepthGrid layer( mapping.utm_bounds() );
+    const std::string path = write_raster( "each-method", 1000 );
+
+    for( const Resample method : all_methods ){
+        for( const size_t thread_count : {1, 3} ){
+            RasterLoader<DepthGrid> loader( mapping, layer, method, thread_count );
+            ASSERT_TRUE( loader.load_file(path) );
+
+            for( int j = 0; j < 16; ++j ){
+                for( int i = 0; i < 16; ++i ){
+                    ASSERT_FLOAT_EQ( layer.get({0.5 + i, 0.5 + j}), expected_value(method, i, j) )
+                        << "method " << static_cast<int>(method) << " @ " << i << ", " << j;
+                }
+            }
+        }
+    }
+
+    // the chart covers the raster's top-left 32 x 32 pixels: so only its four top-left blocks are read
+    RasterLoader<DepthGrid> nearest( mapping, layer, Resample::Nearest, 1 );
+    ASSERT_TRUE( nearest.load_file(path) );
+    EXPECT_EQ( nearest.blocks_read(), 4 );
+
+    VSIUnlink( path.c_str() );
+}
+
+TEST( RasterLoader, FootprintIsOneCell ){
+    // only the pixels under each cell count toward its minimum or maximum; not its neighbors' pixels
+    TestMapping mapping;
+    DepthGrid layer( mapping.utm_bounds() );
+    const std::string path = write_raster( "footprint", 1000 );
+
+    RasterLoader<DepthGrid> lowest( mapping, layer, Resample::Minimum, 1 );
+    ASSERT_TRUE( lowest.load_file(path) );
+    EXPECT_FLOAT_EQ( layer.get({5.5, 5.5}), 10 + 100*20 );
+
+    RasterLoader<DepthGrid> highest( mapping, layer, Resample::Maximum, 1 );
+    ASSERT_TRUE( highest.load_file(path) );
+    EXPECT_FLOAT_EQ( layer.get({5.5, 5.5}), 11 + 100*21 );
+
+    VSIUnlink( path.c_str() );
+}
+
+TEST( RasterLoader, NoData ){
+    TestMapping mapping;
+    DepthGrid layer( mapping.utm_bounds() );
+    // (7, 23) is under the center of cell (3, 4); (10, 20) is under cell (5, 5), but not its center (11, 21)
+    const std::string path = write_raster( "no-data", 1000, {{7, 23}, {10, 20}} );
+
+    for( const Resample method : all_methods ){
+        RasterLoader<DepthGrid> loader( mapping, layer, method, 2 );
+        ASSERT_TRUE( loader.load_file(path) );
+
+        // a cell whose center has no data, has no data
+        EXPECT_FLOAT_EQ( layer.get({3.5, 4.5}), DepthGrid::default_value ) << "method " << static_cast<int>(method);
+
+        // the other methods leave the missing pixel out
+        const float partial = layer.get({5.5, 5.5});
+        switch( method ){
+            case Resample::Nearest:  EXPECT_FLOAT_EQ( partial, 11 + 100*21 ); break;
+            case Resample::Bilinear: EXPECT_FLOAT_EQ( partial, (2011.0 + 2110 + 2111) / 3 ); break;
+            case Resample::Minimum:  EXPECT_FLOAT_EQ( partial, 11 + 100*20 ); break;
+            case Resample::Maximum:  EXPECT_FLOAT_EQ( partial, 11 + 100*21 ); break;
+        }
+
+        // neighbors are unaffected
+        EXPECT_FLOAT_EQ( layer.get({4.5, 4.5}), expected_value(method, 4, 4) );
+    }
+
+    VSIUnlink( path.c_str() );
+}
+
+TEST( RasterLoader, PartialOverlap ){
+    // the raster starts 8m into the chart: so cell (i, j)'s center is at source pixel (2i - 15, 31 - 2j)
+    TestMapping mapping;
+    DepthGrid layer( mapping.utm_bounds() );
+    const std::string path = write_raster( "partial-overlap", 1008 );
+
+    for( const Resample method : all_methods ){
+        RasterLoader<DepthGrid> loader( mapping, layer, method, 2 );
+        ASSERT_TRUE( loader.load_file(path) );
+
+        for( int j = 0; j < 16; ++j ){
+            for( int i = 0; i < 8; ++i ){
+                ASSERT_FLOAT_EQ( layer.get({0.5 + i, 0.5 + j}), DepthGrid::default_value ) << "@ " << i << ", " << j;
+            }
+            for( int i = 8; i < 16; ++i ){
+                // same pixels as at west == 1000, shifted by 16 columns
+                ASSERT_FLOAT_EQ( layer.get({0.5 + i, 0.5 + j}), expected_value(method, i, j) - 16 ) << "@ " << i << ", " << j;
+            }
+        }
+    }
+
+    VSIUnlink( path.c_str() );
+}
+
+TEST( RasterLoader, NoOverlap ){
+    TestMapping mapping;
+    DepthGrid layer( mapping.utm_bounds() );
+    const std::string path = write_raster( "no-overlap", 2000 );
+
+    RasterLoader<DepthGrid> loader( mapping, layer, Resample::Nearest, 1 );
+    EXPECT_FALSE( loader.load_file(path) );
+    EXPECT_FALSE( loader.load_file("/vsimem/does-not-exist.tif") );
+
+    VSIUnlink( path.c_str() );
+}
+
+TEST( RasterLoader, LoadFromBytes ){
+    TestMapping mapping;
+    DepthGrid layer( mapping.utm_bounds() );
+    const std::string path = write_raster( "bytes", 1000 );
+
+    vsi_l_offset length = 0;
+    GByte* buffer = VSIGetMemFileBuffer( path.c_str(), &length, FALSE );
+    ASSERT_NE( buffer, nullptr );
+    const std::string contents( reinterpret_cast<const char*>(buffer), static_cast<size_t>(length) );
+    VSIUnlink( path.c_str() );
+
+    RasterLoader<DepthGrid> loader( mapping, layer, Resample::Bilinear, 2 );
+    ASSERT_TRUE( loader.load_text(contents) );
+    EXPECT_FLOAT_EQ( layer.get({0.5, 0.5}), expected_value(Resample::Bilinear, 0, 0) );
+    EXPECT_FLOAT_EQ( layer.get({15.5, 15.5}), expected_value(Resample::Bilinear, 15, 15) );
+}
+
+} // namespace chartbox::io
@@ -0,0 +1,11 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include "bit-grid.hpp"
+
+namespace chartbox::layer {
+
+// stock dimensions; others are instantiated on-demand, from the header
+template class BitGrid<BitGridLayer::dimension>;
+template class BitGrid<1024>;
+
+} // namespace chartbox::layer
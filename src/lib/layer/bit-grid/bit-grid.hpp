@@ -0,0 +1,168 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include "chart-box/chart-layer-interface.hpp"
+#include "index/cell-index.hpp"
+#include "index/dirty-tiles.hpp"
+#include "index/occupancy-mask.hpp"
+
+namespace chartbox::layer {
+
+/// \brief square grid of binary cells -- blocked or clear -- packed 64 cells to a word
+///
+/// Intended for layers which only ever hold two values, such as the boundary layer.  Stores 1 bit per cell,
+/// rather than 8, and so a 1024 x 1024 layer fits in 128 kB.  Reads return `clear_value` or `default_value`;
+/// writes store whether the value is at-or-above `blocking_threshold`.
+///
+/// Fills are applied a word at a time; `count_blocked(...)` is a popcount over the covered words; and
+/// `raycast(...)` tests each row's run of cells a word at a time.
+///
+/// \param dimension_ - number of cells along each side
+template<size_t dimension_>
+class BitGrid : public chartbox::ChartLayerInterface< uint8_t, BitGrid<dimension_>> {
+public:
+    typedef uint8_t cell_t;
+
+    /// \brief number of cells along each dimension of this grid
+    constexpr static size_t dimension = dimension_;
+
+    constexpr static cell_t default_value = 0xff;
+    constexpr static cell_t blocking_threshold = 'A';
+
+    /// \brief each row starts on a new word
+    constexpr static size_t words_per_row = index::OccupancyMask<dimension>::words_per_line;
+
+public:
+    BitGrid() = delete;
+
+    /// \brief construct a grid covering the given bounds; initially every cell is blocked
+    BitGrid( const Eigen::AlignedBox2d& _bounds );
+
+    /// \brief raw words: bit (i%64) of word `j*words_per_row + i/64` is set iff cell (i,j) is blocked
+    uint64_t* data() { return rows_.data(); }
+    const uint64_t* data() const { return rows_.data(); }
+
+    // override from ChartLayerInterface
+    bool fill( const cell_t value );
+
+    bool fill( const Eigen::AlignedBox2d& area, const cell_t value ){
+        return super().fill( area, value ); }
+
+    bool fill( std::unique_ptr<OGRPolygon> source, cell_t value ){
+        return super().fill( std::move(source), value ); }
+
+    /// \brief override from ChartLayerInterface: writes whole words at a time
+    bool fill_span( const uint32_t j, const uint32_t i_begin, const uint32_t i_end, const cell_t value );
+
+    cell_t get( const Eigen::Vector2d& p ) const;
+
+    /// \warning does not check bounds
+    inline cell_t get( const uint32_t i, const uint32_t j ) const {
+        return blocked(i, j) ? default_value : this->clear_value; }
+
+    /// \warning does not check bounds
+    inline cell_t get( const index::Index2u& cell ) const {
+        return get( cell.i, cell.j ); }
+
+    /// \brief override from ChartLayerInterface: compares against the fixed dimension
+    inline bool contains( const index::Index2u& cell ) const {
+        return (cell.i < dimension) && (cell.j < dimension); }
+
+    /// \warning does not check bounds
+    inline bool blocked( const uint32_t i, const uint32_t j ) const {
+        return 0 != ( (rows_[ j*words_per_row + (i >> 6) ] >> (i & 63)) & 1 ); }
+
+    /// \brief Test all 8 neighbors of a cell at once, from (usually) one word of each of the three rows they touch
+    ///
+    /// \return bit k is set if the k-th neighbor -- counter-clockwise, starting from east -- is blocked,
+    ///         or outside the grid
+    /// \warning does not check the bounds of (i,j) itself
+    uint8_t blocked_neighbors( const uint32_t i, const uint32_t j ) const;
+
+    /// \brief count the blocked cells overlapping the given area
+    ///
+    /// \param area - region to count, in the layer's frame; clipped to the layer's bounds
+    size_t count_blocked( const Eigen::AlignedBox2d& area ) const;
+
+    /// \brief Find the first blocked cell along a segment; scanning each row's run of cells 64 at a time
+    ///
+    /// Visits the same cells as `ChartLayerInterface::raycast(...)`.
+    bool raycast( const Eigen::Vector2d& from, const Eigen::Vector2d& to, Eigen::Vector2d& hit ) const;
+
+    double precision() const;
+
+    /// \brief override from ChartLayerInterface: cells per unit of distance
+    inline double inverse_precision() const { return dimension / width(); }
+
+    /// \brief version of the most recent write; increases with every write which changes a cell
+    inline uint64_t version() const { return dirty_tiles_.version(); }
+
+    /// \brief record a write to the given area
+    /// \note required after writing words through `data()`; other writes are recorded as they happen
+    inline void mark_dirty( const Eigen::AlignedBox2d& area ){
+        dirty_tiles_.mark( area, precision() ); }
+
+    /// \brief Collect the areas modified since a given version; and advance that version to the current one
+    ///
+    /// \param since - in: the version this consumer last processed; out: the current version
+    /// \param areas - appended with the modified areas -- runs of 16 x 16 tiles -- in the layer's frame
+    void collect_changes( uint64_t& since, std::vector<Eigen::AlignedBox2d>& areas ) const {
+        dirty_tiles_.changed_since( since, precision(), areas );
+        since = dirty_tiles_.version(); }
+
+    /// \brief Draws a simple debug representation of this grid to stdout
+    void print_contents() const;
+
+    void reset();
+
+    bool store( const Eigen::Vector2d& p, const cell_t value );
+
+    /// \warning does not check bounds
+    bool store( const uint32_t i, const uint32_t j, const cell_t value );
+
+    /// \warning does not check bounds
+    bool store( const index::Index2u& cell, const cell_t value ){
+        return store( cell.i, cell.j, value ); }
+
+    std::string type() const;
+
+    inline double width() const { return this->bounds_.sizes().maxCoeff(); }
+
+protected:
+    /// \brief name of this layer's type
+    constexpr static char type_[] = "BitGridLayer";
+
+    /// \brief three adjacent bits of one row -- cells (i-1, i, i+1) -- with out-of-bounds cells set
+    uint32_t triple( const int64_t j, const uint32_t i ) const;
+
+    /// \brief bits of word `w` which hold cells of this grid (only the last word of a row may be partial)
+    constexpr static uint64_t word_mask( const size_t w ){
+        return ( (w + 1 < words_per_row) || (0 == (dimension & 63)) ) ? ~uint64_t(0) : ((uint64_t(1) << (dimension & 63)) - 1); }
+
+    std::array<uint64_t, dimension*words_per_row> rows_;
+
+    /// \brief version of the last write to each tile; answers `collect_changes(...)`
+    index::DirtyTiles<dimension> dirty_tiles_;
+
+private:
+    chartbox::ChartLayerInterface< uint8_t, BitGrid<dimension>>& super() {
+        return *static_cast<chartbox::ChartLayerInterface< uint8_t, BitGrid<dimension>>*>(this);
+    }
+};
+
+/// \brief the default binary layer: 128 x 128 cells
+typedef BitGrid<128> BitGridLayer;
+
+} // namespace chartbox::layer
+
+#include "bit-grid.inl"
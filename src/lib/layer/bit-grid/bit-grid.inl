@@ -0,0 +1,198 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// NOTE: This is the template-class implementation -- which is included from the header file.
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include <Eigen/Geometry>
+#include <fmt/core.h>
+
+namespace chartbox::layer {
+
+template<size_t dimension>
+BitGrid<dimension>::BitGrid( const Eigen::AlignedBox2d& _bounds )
+    : chartbox::ChartLayerInterface< uint8_t, BitGrid<dimension>>(_bounds)
+{
+    reset();
+}
+
+template<size_t dimension>
+bool BitGrid<dimension>::fill( const cell_t value ){
+    const bool is_blocked = ( blocking_threshold <= value );
+    for( size_t j = 0; j < dimension; ++j ){
+        for( size_t w = 0; w < words_per_row; ++w ){
+            rows_[ j*words_per_row + w ] = is_blocked ? word_mask(w) : 0;
+        }
+    }
+    dirty_tiles_.mark_all();
+    return true;
+}
+
+template<size_t dimension>
+bool BitGrid<dimension>::fill_span( const uint32_t j, const uint32_t i_begin, const uint32_t i_end, const cell_t value ){
+    if( i_end <= i_begin ){
+        return true;
+    }
+
+    const bool is_blocked = ( blocking_threshold <= value );
+    uint64_t* row = rows_.data() + j*words_per_row;
+    const uint32_t first_word = i_begin >> 6;
+    const uint32_t last_word = (i_end - 1) >> 6;
+    for( uint32_t w = first_word; w <= last_word; ++w ){
+        uint64_t mask = ~uint64_t(0);
+        if( w == first_word ){
+            mask &= ~uint64_t(0) << (i_begin & 63);
+        }
+        if( w == last_word ){
+            mask &= ~uint64_t(0) >> (63 - ((i_end - 1) & 63));
+        }
+        row[w] = is_blocked ? (row[w] | mask) : (row[w] & ~mask);
+    }
+    dirty_tiles_.mark( i_begin, i_end, j, j + 1 );
+    return true;
+}
+
+template<size_t dimension>
+typename BitGrid<dimension>::cell_t BitGrid<dimension>::get( const Eigen::Vector2d& p ) const {
+    const double scale = inverse_precision();
+    return get( static_cast<uint32_t>(p.x()*scale), static_cast<uint32_t>(p.y()*scale) );
+}
+
+template<size_t dimension>
+uint32_t BitGrid<dimension>::triple( const int64_t j, const uint32_t i ) const {
+    if( (j < 0) || (static_cast<int64_t>(dimension) <= j) ){
+        return 0x7;
+    }
+
+    const uint32_t bit = i & 63;
+    if( (0 < bit) && (bit < 63) && (i + 1 < dimension) ){
+        return static_cast<uint32_t>( rows_[ j*words_per_row + (i >> 6) ] >> (bit - 1) ) & 0x7;
+    }
+
+    // straddles a word boundary, or the edge of the grid
+    const uint32_t west = (0 == i) ? 1 : blocked(i - 1, j);
+    const uint32_t east = (dimension <= i + 1) ? 1 : blocked(i + 1, j);
+    return west | (blocked(i, j) << 1) | (east << 2);
+}
+
+template<size_t dimension>
+uint8_t BitGrid<dimension>::blocked_neighbors( const uint32_t i, const uint32_t j ) const {
+    const uint32_t south = triple( static_cast<int64_t>(j) - 1, i );
+    const uint32_t center = triple( j, i );
+    const uint32_t north = triple( static_cast<int64_t>(j) + 1, i );
+
+    // E, NE, N, NW, W, SW, S, SE
+    return static_cast<uint8_t>( ((center >> 2) & 1)      | (((north >> 2) & 1) << 1)
+                               | (((north >> 1) & 1) << 2) | ((north & 1) << 3)
+                               | ((center & 1) << 4)       | ((south & 1) << 5)
+                               | (((south >> 1) & 1) << 6) | (((south >> 2) & 1) << 7) );
+}
+
+template<size_t dimension>
+size_t BitGrid<dimension>::count_blocked( const Eigen::AlignedBox2d& area ) const {
+    if( area.isEmpty() ){
+        return 0;
+    }
+
+    const double scale = inverse_precision();
+    const double x_min = std::floor( area.min().x() * scale );
+    const double y_min = std::floor( area.min().y() * scale );
+    // cells starting exactly on the maximum edge are excluded; but a degenerate area still counts its cell
+    const double x_max = std::max( x_min, std::ceil(area.max().x() * scale) - 1 );
+    const double y_max = std::max( y_min, std::ceil(area.max().y() * scale) - 1 );
+    if( (x_max < 0) || (y_max < 0) || (dimension <= x_min) || (dimension <= y_min) ){
+        return 0;
+    }
+
+    const uint32_t i_min = static_cast<uint32_t>( std::max(0.0, x_min) );
+    const uint32_t j_min = static_cast<uint32_t>( std::max(0.0, y_min) );
+    const uint32_t i_max = static_cast<uint32_t>( std::min<double>(dimension - 1, x_max) );
+    const uint32_t j_max = static_cast<uint32_t>( std::min<double>(dimension - 1, y_max) );
+
+    const uint32_t first_word = i_min >> 6;
+    const uint32_t last_word = i_max >> 6;
+    const uint64_t first_mask = ~uint64_t(0) << (i_min & 63);
+    const uint64_t last_mask = ~uint64_t(0) >> (63 - (i_max & 63));
+
+    size_t count = 0;
+    for( uint32_t j = j_min; j <= j_max; ++j ){
+        const uint64_t* row = rows_.data() + j*words_per_row;
+        for( uint32_t w = first_word; w <= last_word; ++w ){
+            uint64_t word = row[w];
+            word &= (w == first_word) ? first_mask : ~uint64_t(0);
+            word &= (w == last_word) ? last_mask : ~uint64_t(0);
+            count += __builtin_popcountll( word );
+        }
+    }
+    return count;
+}
+
+template<size_t dimension>
+bool BitGrid<dimension>::raycast( const Eigen::Vector2d& from, const Eigen::Vector2d& to, Eigen::Vector2d& hit ) const {
+    const double scale = inverse_precision();
+    const Eigen::Vector2d start = from * scale;
+    const Eigen::Vector2d end = to * scale;
+    uint32_t i, j;
+    if( ! index::OccupancyMask<dimension>::first_set_in_lines( rows_.data(), start.x(), start.y(), end.x(), end.y(), i, j ) ){
+        return false;
+    }
+
+    const double t = index::OccupancyMask<dimension>::entry( start.x(), start.y(), end.x(), end.y(), i, j );
+    hit = from + t * (to - from);
+    return true;
+}
+
+template<size_t dimension>
+double BitGrid<dimension>::precision() const {
+    return width() / dimension;
+}
+
+template<size_t dimension>
+void BitGrid<dimension>::print_contents() const {
+    fmt::print( "============ ============ Bit-Grid-Layer Contents ============ ============\n" );
+    for( size_t j = dimension - 1; j < dimension; --j ){
+        for( size_t i = 0; i < dimension; ++i ){
+            if( 0 == (i%8) ){
+                fmt::print(" ");
+            }
+            fmt::print( blocked(i, j) ? " XX" : " --" );
+        }
+        if( 0 == (j%8) ){
+            fmt::print("\n");
+        }
+        fmt::print("\n");
+    }
+    fmt::print( "============ ============ ============ ============ ============ ============\n" );
+}
+
+template<size_t dimension>
+void BitGrid<dimension>::reset() {
+    fill( default_value );
+}
+
+template<size_t dimension>
+bool BitGrid<dimension>::store( const Eigen::Vector2d& p, const cell_t value ){
+    const double scale = inverse_precision();
+    return store( static_cast<uint32_t>(p.x()*scale), static_cast<uint32_t>(p.y()*scale), value );
+}
+
+template<size_t dimension>
+bool BitGrid<dimension>::store( const uint32_t i, const uint32_t j, const cell_t value ){
+    uint64_t& word = rows_[ j*words_per_row + (i >> 6) ];
+    const uint64_t bit = uint64_t(1) << (i & 63);
+    const uint64_t updated = ( blocking_threshold <= value ) ? (word | bit) : (word & ~bit);
+    if( updated != word ){
+        word = updated;
+        dirty_tiles_.mark( i, j );
+    }
+    return true;
+}
+
+template<size_t dimension>
+std::string BitGrid<dimension>::type() const {
+    return type_;
+}
+
+} // namespace chartbox::layer
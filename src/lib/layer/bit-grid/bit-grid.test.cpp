@@ -0,0 +1,114 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include "layer/fixed-grid/fixed-grid.hpp"
+#include "layer/test-fixtures.hpp"
+#include "search/hpa-star.hpp"
+
+#include "bit-grid.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+namespace chartbox::layer {
+
+// not a multiple of 64; so rows end in a partial word
+typedef BitGrid<200> BitGrid200;
+typedef FixedGrid< index::RowMajorIndex<200> > FixedGrid200;
+
+static const AlignedBox2d bounds( Vector2d(0,0), Vector2d(200,200) );
+static const AlignedBox2d wide_bounds( Vector2d(0,0), Vector2d(256,256) );
+
+// the scattered boxes are either clear or blocked
+static const std::vector<uint8_t> clear_or_blocked = { 0x00, 0x99 };
+
+TEST( BitGrid, Construct ){
+    BitGridLayer layer( wide_bounds );
+    EXPECT_DOUBLE_EQ( layer.precision(), 2.0 );
+    EXPECT_EQ( layer.get({3, 3}), BitGridLayer::default_value );
+
+    // 8x smaller than the byte-grid
+    EXPECT_EQ( sizeof(uint64_t) * BitGridLayer::dimension * BitGridLayer::words_per_row, (128 * 128) / 8 );
+
+    layer.fill( BitGridLayer::clear_value );
+    EXPECT_EQ( layer.get({3, 3}), BitGridLayer::clear_value );
+    EXPECT_EQ( layer.count_blocked( wide_bounds ), 0 );
+
+    ASSERT_TRUE( layer.store( {101, 3}, 0x99 ) );
+    EXPECT_EQ( layer.get({101, 3}), BitGridLayer::default_value );
+    EXPECT_TRUE( layer.blocked( 50, 1 ) );
+    EXPECT_EQ( layer.count_blocked( wide_bounds ), 1 );
+}
+
+TEST( BitGrid, FillMatchesFixedGrid ){
+    BitGrid200 bits( bounds );
+    FixedGrid200 bytes( bounds );
+    scatter( bits, 3, 40, clear_or_blocked );
+    scatter( bytes, 3, 40, clear_or_blocked );
+
+    for( uint32_t j = 0; j < 200; ++j ){
+        for( uint32_t i = 0; i < 200; ++i ){
+            ASSERT_EQ( bits.blocked(i, j), bytes.blocked(i, j) ) << "    @ (" << i << ", " << j << ")";
+            ASSERT_EQ( bits.blocked_neighbors(i, j), bytes.blocked_neighbors(i, j) ) << "    @ (" << i << ", " << j << ")";
+        }
+    }
+
+    std::mt19937 generator( 7 );
+    std::uniform_real_distribution<double> coordinate( -10, 210 );
+    for( size_t trial = 0; trial < 200; ++trial ){
+        const AlignedBox2d area = AlignedBox2d( Vector2d(coordinate(generator), coordinate(generator)) ).extend( Vector2d(coordinate(generator), coordinate(generator)) );
+        ASSERT_EQ( bits.count_blocked(area), bytes.count_blocked(area) );
+    }
+}
+
+TEST( BitGrid, RaycastMatchesFixedGrid ){
+    BitGrid200 bits( bounds );
+    FixedGrid200 bytes( bounds );
+    scatter( bits, 11, 40, clear_or_blocked );
+    scatter( bytes, 11, 40, clear_or_blocked );
+
+    std::mt19937 generator( 5 );
+    std::uniform_real_distribution<double> coordinate( -10, 210 );
+    for( size_t trial = 0; trial < 1000; ++trial ){
+        const Vector2d from( coordinate(generator), coordinate(generator) );
+        const Vector2d to( coordinate(generator), coordinate(generator) );
+        Vector2d bit_hit, byte_hit;
+        const bool bit_blocked = bits.raycast( from, to, bit_hit );
+        ASSERT_EQ( bit_blocked, bytes.raycast(from, to, byte_hit) );
+        if( bit_blocked ){
+            ASSERT_NEAR( (bit_hit - byte_hit).norm(), 0, 1e-9 );
+        }
+    }
+}
+
+TEST( BitGrid, SearchMatchesFixedGrid ){
+    BitGrid200 bits( bounds );
+    FixedGrid200 bytes( bounds );
+    scatter( bits, 13, 12, clear_or_blocked );
+    scatter( bytes, 13, 12, clear_or_blocked );
+
+    search::HierarchicalAStar<BitGrid200, 40> bit_search( bits );
+    search::HierarchicalAStar<FixedGrid200, 40> byte_search( bytes );
+
+    std::mt19937 generator( 17 );
+    std::uniform_real_distribution<double> coordinate( 0, 200 );
+    size_t found = 0;
+    for( size_t trial = 0; trial < 20; ++trial ){
+        const Vector2d start( coordinate(generator), coordinate(generator) );
+        const Vector2d goal( coordinate(generator), coordinate(generator) );
+        const auto bit_path = bit_search.compute( start, goal );
+        const auto byte_path = byte_search.compute( start, goal );
+        ASSERT_EQ( bit_path.size(), byte_path.size() );
+        EXPECT_DOUBLE_EQ( bit_path.length(), byte_path.length() );
+        found += bit_path.empty() ? 0 : 1;
+    }
+    EXPECT_LT( 0, found );
+}
+
+} // namespace chartbox::layer
@@ -0,0 +1,134 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include "index/row-major-index.hpp"
+#include "index/z-order-index.hpp"
+
+#include "fixed-grid.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+namespace chartbox::layer {
+
+// not a multiple of any kernel's block size
+static const AlignedBox2d bounds( Vector2d(0,0), Vector2d(200,200) );
+
+template<typename cell_t>
+class FixedGridCellTypes : public ::testing::Test {};
+
+/// \brief a value `offset` above the type's blocking threshold; or below it, for negative offsets
+template<typename layer_t>
+typename layer_t::cell_t from_threshold( const int offset ){
+    return static_cast<typename layer_t::cell_t>( layer_t::blocking_threshold + offset );
+}
+
+typedef ::testing::Types<uint8_t, uint16_t, int16_t, float> CellTypes;
+TYPED_TEST_SUITE( FixedGridCellTypes, CellTypes );
+
+TYPED_TEST( FixedGridCellTypes, Fill ){
+    typedef FixedGrid< index::RowMajorIndex<200>, TypeParam > layer_t;
+    layer_t layer( bounds );
+    EXPECT_EQ( layer_t::default_value, std::numeric_limits<TypeParam>::max() );
+    EXPECT_LT( layer_t::clear_value, layer_t::blocking_threshold );
+    EXPECT_LE( layer_t::blocking_threshold, layer_t::default_value );
+
+    const TypeParam open = from_threshold<layer_t>( -7 );
+    const TypeParam blocked = from_threshold<layer_t>( 34 );
+    layer.fill( open );
+    for( size_t offset = 0; offset < 200 * 200; ++offset ){
+        ASSERT_EQ( layer.data()[offset], open ) << "    @ " << offset;
+    }
+    EXPECT_EQ( layer.count_blocked(bounds), 0 );
+
+    layer.reset();
+    EXPECT_EQ( layer.data()[0], layer_t::default_value );
+    EXPECT_EQ( layer.data()[200 * 200 - 1], layer_t::default_value );
+    EXPECT_EQ( layer.count_blocked(bounds), 200 * 200 );
+
+    // spans of every length, against every alignment
+    layer.fill( layer_t::clear_value );
+    layer.fill( AlignedBox2d(Vector2d(3, 10), Vector2d(180, 20)), blocked );
+    EXPECT_EQ( layer.count_blocked(bounds), 177 * 10 );
+    EXPECT_EQ( layer.get({2.5, 15.5}), layer_t::clear_value );
+    EXPECT_EQ( layer.get({3.5, 15.5}), blocked );
+    EXPECT_EQ( layer.get({179.5, 15.5}), blocked );
+    EXPECT_EQ( layer.get({180.5, 15.5}), layer_t::clear_value );
+    Vector2d hit;
+    EXPECT_TRUE( layer.raycast({100.5, 0.5}, {100.5, 100.5}, hit) );
+    EXPECT_NEAR( hit.y(), 10, 1e-9 );
+}
+
+TYPED_TEST( FixedGridCellTypes, ScanMatchesThreshold ){
+    typedef FixedGrid< index::RowMajorIndex<200>, TypeParam > layer_t;
+    layer_t layer( bounds );
+
+    // straddle the threshold; including negative values, where the type has them
+    std::mt19937 generator( 17 );
+    std::uniform_int_distribution<int> offset( std::is_signed_v<TypeParam> ? -100 : -static_cast<int>(layer_t::blocking_threshold), 130 );
+    std::vector<TypeParam> source( 200 * 200 );
+    for( auto& each : source ){
+        each = from_threshold<layer_t>( offset(generator) );
+    }
+    if constexpr ( std::is_floating_point_v<TypeParam> ){
+        source[5] = std::numeric_limits<TypeParam>::quiet_NaN();
+        source[6] = layer_t::blocking_threshold - 0.25f;
+        source[7] = layer_t::blocking_threshold;
+    }
+    ASSERT_TRUE( layer.fill(source) );
+
+    size_t expected = 0;
+    for( uint32_t j = 0; j < 200; ++j ){
+        for( uint32_t i = 0; i < 200; ++i ){
+            const bool blocked = ( layer_t::blocking_threshold <= source[j*200 + i] );
+            ASSERT_EQ( blocked, layer.blocked(i, j) ) << "    @ " << i << ", " << j;
+            const AlignedBox2d cell( Vector2d(i, j), Vector2d(i + 1, j + 1) );
+            ASSERT_EQ( blocked ? 1 : 0, layer.count_blocked(cell) ) << "    @ " << i << ", " << j;
+            expected += blocked ? 1 : 0;
+        }
+    }
+    EXPECT_EQ( layer.count_blocked(bounds), expected );
+}
+
+TYPED_TEST( FixedGridCellTypes, StoreAndSpans ){
+    typedef FixedGrid< index::RowMajorIndex<200>, TypeParam > layer_t;
+    layer_t layer( bounds );
+    layer.fill( layer_t::clear_value );
+
+    uint64_t since = layer.version();
+    std::vector<AlignedBox2d> areas;
+    ASSERT_TRUE( layer.store({20.5, 30.5}, from_threshold<layer_t>(35)) );
+    EXPECT_EQ( layer.get({20.5, 30.5}), from_threshold<layer_t>(35) );
+    EXPECT_EQ( layer.count_blocked(bounds), 1 );
+    layer.collect_changes( since, areas );
+    EXPECT_EQ( areas.size(), 1 );
+
+    // called directly, the counts stay live
+    layer.fill_span( 40, 10, 50, from_threshold<layer_t>(5) );
+    EXPECT_EQ( layer.count_blocked(bounds), 41 );
+    EXPECT_EQ( layer.get({49.5, 40.5}), from_threshold<layer_t>(5) );
+    EXPECT_EQ( layer.get({50.5, 40.5}), layer_t::clear_value );
+}
+
+TEST( FixedGridCellTypes, OtherLayouts ){
+    typedef FixedGrid< index::ZOrderIndex<128>, float > layer_t;
+    const AlignedBox2d small( Vector2d(0,0), Vector2d(128,128) );
+    layer_t layer( small );
+    // heights: below the datum is open water
+    layer.fill( -12.5f );
+    layer.fill( AlignedBox2d(Vector2d(10, 10), Vector2d(20, 20)), 3.25f );
+    EXPECT_EQ( layer.count_blocked(small), 100 );
+    EXPECT_FLOAT_EQ( layer.get({15.5, 15.5}), 3.25f );
+    EXPECT_FLOAT_EQ( layer.get({25.5, 15.5}), -12.5f );
+}
+
+} // namespace chartbox::layer
@@ -2,61 +2,199 @@
 
 #pragma once
 
+#include <array>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <cstdlib>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+#include <Eigen/Geometry>
+
 #include "chart-box/chart-layer-interface.hpp"
+#include "index/cell-index.hpp"
+#include "index/dirty-tiles.hpp"
+#include "index/occupancy-mask.hpp"
+#include "index/row-major-index.hpp"
+#include "index/summed-area-table.hpp"
 
 namespace chartbox::layer {
 
-class FixedGridLayer : public chartbox::ChartLayerInterface< uint8_t, FixedGridLayer> {
+/// \brief square grid of cells, of a fixed dimension
+///
+/// Bulk writes and scans go through per-type kernels (see `detail::fill_cells` and `detail::scan_at_or_above`):
+/// byte-cells are filled with `memset`, and wider cells with 16-byte broadcast stores.
+///
+/// \param index_t - cell-ordering policy; maps cell indices (i,j) to storage offsets. See `src/lib/index/`
+/// \param cell_t - cell type; instantiated for `uint8_t` (the default), `uint16_t`, `int16_t` and `float`.
+///                  Which values are clear and which block depends on the type; see `CellTraits`
+template<typename index_t_, typename cell_t_ = uint8_t>
+class FixedGrid : public chartbox::ChartLayerInterface< cell_t_, FixedGrid<index_t_, cell_t_>> {
 public:
-    typedef uint8_t cell_t;
+    typedef cell_t_ cell_t;
+    typedef index_t_ index_t;
     typedef Eigen::Matrix<uint32_t,2,1> Vector2u;
 
     /// \brief number of cells along each dimension of this grid
-    constexpr static size_t dimension = 128;//1024;
+    constexpr static size_t dimension = index_t::dimension;
 
-    constexpr static cell_t default_value = 0xff;
-    constexpr static cell_t blocking_threshold = 'A';
+    /// \brief per cell type; see `CellTraits`
+    constexpr static cell_t default_value = CellTraits<cell_t>::default_value;
+    constexpr static cell_t blocking_threshold = CellTraits<cell_t>::blocking_threshold;
 
 public:
 
-    FixedGridLayer() = delete;
+    FixedGrid() = delete;
     
-    FixedGridLayer( const Eigen::AlignedBox2d& _bounds);
+    FixedGrid( const Eigen::AlignedBox2d& _bounds);
 
     cell_t* data();
+    const cell_t* data() const;
 
     // override from ChartLayerInterface
     bool fill( const cell_t value );
 
+    /// \brief override from ChartLayerInterface
+    ///
+    /// Small areas update the occupancy counts as each cell changes; larger areas rebuild them once, afterwards.
     bool fill( const Eigen::AlignedBox2d& area, const cell_t value ){
-        return super().fill( area, value ); }
+        const double scale = inverse_precision();
+        if( area.sizes().prod() * scale * scale <= dimension ){
+            return super().fill( area, value );
+        }
+        occupancy_.pause();
+        const bool result = super().fill( area, value );
+        rebuild_occupancy();
+        return result; }
 
     bool fill( std::unique_ptr<OGRPolygon> source, cell_t value ){ 
-        return super().fill( std::move(source), value ); }
+        occupancy_.pause();
+        const bool result = super().fill( std::move(source), value );
+        rebuild_occupancy();
+        return result; }
     
+    /// \brief override from ChartLayerInterface: writes the whole span at once, in row-major layouts
+    ///
+    /// Other layouts -- and any write while the occupancy counts are live -- fall back to one `store(...)` per cell.
+    bool fill_span( const uint32_t j, const uint32_t i_begin, const uint32_t i_end, const cell_t value );
+
     /// \brief Fill the entire grid with values from the buffer
     /// 
-    /// \param source - values to fill.  This must be the same byte-count as this layer
+    /// \param source - values to fill, in row-major order.  This must be the same cell-count as this layer
     /// \param fill_value - value to write inside the area
     bool fill( const std::vector<cell_t>& source );
 
-    cell_t& get(const Eigen::Vector2d& p);
     cell_t get(const Eigen::Vector2d& p) const;
 
-    size_t lookup( const uint32_t x, const uint32_t y ) const;
-
-    size_t lookup( const Vector2u i ) const;
+    /// \warning does not check bounds
+    inline cell_t get( const uint32_t i, const uint32_t j ) const {
+        return grid[ index_t::lookup(i, j) ]; }
+
+    /// \warning does not check bounds
+    inline cell_t get( const index::Index2u& cell ) const {
+        return grid[ index_t::lookup(cell.i, cell.j) ]; }
+
+    /// \brief override from ChartLayerInterface: compares against the fixed dimension
+    inline bool contains( const index::Index2u& cell ) const {
+        return (cell.i < dimension) && (cell.j < dimension); }
+
+    /// \brief first cell of row j; the row's cells follow contiguously, in order
+    ///
+    /// Only declared for row-major layouts.
+    /// \warning does not check bounds
+    template<typename layout_t = index_t, typename = std::enable_if_t<layout_t::row_major>>
+    inline const cell_t* row_ptr( const uint32_t j ) const {
+        return grid.data() + index_t::lookup( 0, j ); }
+
+    /// \brief storage offset from a cell to each of its 8 neighbors: counter-clockwise, starting from east
+    ///
+    /// Only row-major layouts have constant offsets; so it is only declared for them.
+    /// \warning only valid for cells which are not on the edge of the grid
+    template<typename layout_t = index_t, typename = std::enable_if_t<layout_t::row_major>>
+    constexpr static std::array<ptrdiff_t, 8> neighbor_offsets(){
+        constexpr ptrdiff_t row = static_cast<ptrdiff_t>(dimension);
+        return {{ 1, 1 + row, row, row - 1, -1, -1 - row, -row, 1 - row }};
+    }
 
-    size_t lookup( const Eigen::Vector2d& p ) const;
+    /// \warning does not check bounds
+    inline bool blocked( const uint32_t i, const uint32_t j ) const {
+        return ( blocking_threshold <= grid[ index_t::lookup(i, j) ] ); }
+
+    /// \brief test all 8 neighbors of a cell
+    ///
+    /// \return bit k is set if the k-th neighbor -- counter-clockwise, starting from east -- is blocked,
+    ///         or outside the grid
+    /// \warning does not check the bounds of (i,j) itself
+    uint8_t blocked_neighbors( const uint32_t i, const uint32_t j ) const;
+
+    /// \brief count the blocked cells overlapping the given area, in O(1)
+    ///
+    /// \param area - region to count, in the layer's frame; clipped to the layer's bounds
+    size_t count_blocked( const Eigen::AlignedBox2d& area ) const;
+
+    /// \brief Find the first blocked cell along a segment; tests up to 64 cells at a time
+    ///
+    /// Visits the same cells as `ChartLayerInterface::raycast(...)`, but reads a bit-packed mask of the
+    /// blocked cells, instead of the cells themselves.
+    bool raycast( const Eigen::Vector2d& from, const Eigen::Vector2d& to, Eigen::Vector2d& hit ) const;
+
+    /// \brief Bilinearly interpolate the grid at many points; e.g. every depth check along a path
+    ///
+    /// Cell values are taken to lie at cell centers; points within half a cell of the edge take the edge's value.
+    /// Byte-cells are blended with fixed-point weights, with 8 fractional bits; so results are within one unit of
+    /// the exact interpolant.  Queries are processed in batches of 8; blended in parallel, where SSE2 is available.
+    /// Wider cells are blended one query at a time, in floating-point.
+    ///
+    /// \param points - query locations, in the layer's frame
+    /// \param count - number of points
+    /// \param values - output: one value per point; NaN for points outside the layer
+    void sample_bilinear( const Eigen::Vector2d* points, const size_t count, float* values ) const;
+
+    void sample_bilinear( const std::vector<Eigen::Vector2d>& points, std::vector<float>& values ) const {
+        values.resize( points.size() );
+        sample_bilinear( points.data(), points.size(), values.data() ); }
+
+    /// \brief recompute the blocked-cell counts & mask from scratch
+    /// \note required after writing cells through `data()`; other writes keep the counts current
+    void rebuild_occupancy();
+
+    /// \brief version of the most recent write; increases with every write which changes a cell
+    inline uint64_t version() const { return dirty_tiles_.version(); }
+
+    /// \brief record a write to the given area
+    /// \note required after writing cells through `data()`; other writes are recorded as they happen
+    inline void mark_dirty( const Eigen::AlignedBox2d& area ){
+        dirty_tiles_.mark( area, precision() ); }
+
+    /// \brief Collect the areas modified since a given version; and advance that version to the current one
+    ///
+    /// Changes are tracked per 16 x 16 tile of cells; so each area is a run of whole tiles.
+    ///
+    /// \param since - in: the version this consumer last processed; out: the current version
+    /// \param areas - appended with the modified areas, in the layer's frame
+    void collect_changes( uint64_t& since, std::vector<Eigen::AlignedBox2d>& areas ) const {
+        dirty_tiles_.changed_since( since, precision(), areas );
+        since = dirty_tiles_.version(); }
+
+    inline size_t lookup( const uint32_t i, const uint32_t j ) const {
+        return index_t::lookup( i, j ); }
+
+    inline size_t lookup( const Vector2u i ) const {
+        return index_t::lookup( i[0], i[1] ); }
+
+    inline size_t lookup( const Eigen::Vector2d& p ) const {
+        const double scale = inverse_precision();
+        return index_t::lookup( static_cast<uint32_t>(p.x()*scale), static_cast<uint32_t>(p.y()*scale) ); }
 
     double precision() const;
 
+    /// \brief override from ChartLayerInterface: cells per unit of distance
+    inline double inverse_precision() const { return dimension / width(); }
+
     /// \brief Draws a simple debug representation of this grid to stderr
     void print_contents() const;
 
@@ -68,11 +206,18 @@ public:
     /// \return reference to the cell value
     bool store(const Eigen::Vector2d& p, const cell_t new_value);
 
+    /// \warning does not check bounds
+    bool store( const uint32_t i, const uint32_t j, const cell_t value );
+
+    /// \warning does not check bounds
+    bool store( const index::Index2u& cell, const cell_t value ){
+        return store( cell.i, cell.j, value ); }
+
     std::string type() const;
 
-    inline double width() const { return bounds_.sizes().maxCoeff(); }
+    inline double width() const { return this->bounds_.sizes().maxCoeff(); }
 
-    ~FixedGridLayer();
+    ~FixedGrid();
 
     // /// \brief Retrieve the value at an (x, y) Eigen::Vector2d
     // ///
@@ -119,16 +264,33 @@ protected:
     // raw array:  2D addressing is performed through the index, below
     std::array<cell_t, dimension*dimension> grid;
 
+    /// \brief running counts of blocked cells; answers `count_blocked(...)`
+    index::SummedAreaTable<dimension> occupancy_;
+
+    /// \brief one bit per cell: set if blocked; answers `raycast(...)`
+    index::OccupancyMask<dimension> blocked_mask_;
+
+    /// \brief version of the last write to each tile; answers `collect_changes(...)`
+    index::DirtyTiles<dimension> dirty_tiles_;
+
 private:
 
-    chartbox::ChartLayerInterface< uint8_t, FixedGridLayer>& super() {
-        return *static_cast<chartbox::ChartLayerInterface< uint8_t, FixedGridLayer>*>(this);
+    chartbox::ChartLayerInterface< cell_t, FixedGrid<index_t, cell_t>>& super() {
+        return *static_cast<chartbox::ChartLayerInterface< cell_t, FixedGrid<index_t, cell_t>>*>(this);
     }
 
-    const chartbox::ChartLayerInterface< uint8_t, FixedGridLayer>& super() const {
-        return *static_cast<const chartbox::ChartLayerInterface< uint8_t, FixedGridLayer>*>(this);
+    const chartbox::ChartLayerInterface< cell_t, FixedGrid<index_t, cell_t>>& super() const {
+        return *static_cast<const chartbox::ChartLayerInterface< cell_t, FixedGrid<index_t, cell_t>>*>(this);
     }
 };
 
+/// \brief the default grid layer: 128 x 128 byte-cells, in row-major order
+typedef FixedGrid< index::RowMajorIndex<128> > FixedGridLayer;
+
+/// \brief 128 x 128 float-cells, in row-major order; e.g. depths
+typedef FixedGrid< index::RowMajorIndex<128>, float > FixedGridFloatLayer;
+
+
+} // namespace chartbox::layer
 
-} // namespace chartbox::grid
+#include "fixed-grid.inl"
@@ -0,0 +1,515 @@
+// GPL v3 (c) 2021, Daniel Williams 
+
+// NOTE: This is the template-class implementation -- which is included from the header file.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <fmt/core.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace chartbox::layer {
+
+namespace detail {
+
+/// \brief fractional bits of the bilinear weights
+constexpr uint32_t bilinear_bits = 8;
+constexpr uint32_t bilinear_one = 1 << bilinear_bits;
+
+/// \brief number of queries blended at once, by `blend_bilinear`
+constexpr size_t bilinear_lanes = 8;
+
+/// \brief blend 8 sets of corners: rows in 16-bit fixed-point, then columns in float
+inline void blend_bilinear( const uint16_t* c00, const uint16_t* c10, const uint16_t* c01, const uint16_t* c11,
+                            const uint16_t* wx, const uint16_t* wy, float* out )
+{
+    constexpr float scale = 1.0f / (bilinear_one * bilinear_one);
+#ifdef __SSE2__
+    const __m128i one = _mm_set1_epi16( bilinear_one );
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i vwx = _mm_loadu_si128( reinterpret_cast<const __m128i*>(wx) );
+    const __m128i vwy = _mm_loadu_si128( reinterpret_cast<const __m128i*>(wy) );
+    const __m128i vwx_ = _mm_sub_epi16( one, vwx );
+    const __m128i vwy_ = _mm_sub_epi16( one, vwy );
+
+    // at most 255 * 256: fits in 16 bits
+    const __m128i low = _mm_add_epi16( _mm_mullo_epi16( _mm_loadu_si128(reinterpret_cast<const __m128i*>(c00)), vwx_ ),
+                                       _mm_mullo_epi16( _mm_loadu_si128(reinterpret_cast<const __m128i*>(c10)), vwx ) );
+    const __m128i high = _mm_add_epi16( _mm_mullo_epi16( _mm_loadu_si128(reinterpret_cast<const __m128i*>(c01)), vwx_ ),
+                                        _mm_mullo_epi16( _mm_loadu_si128(reinterpret_cast<const __m128i*>(c11)), vwx ) );
+
+    auto blend = [&]( const __m128i l, const __m128i h, const __m128i w_, const __m128i w ){
+        return _mm_add_ps( _mm_mul_ps( _mm_cvtepi32_ps(l), _mm_cvtepi32_ps(w_) ),
+                           _mm_mul_ps( _mm_cvtepi32_ps(h), _mm_cvtepi32_ps(w) ) ); };
+    const __m128 first = blend( _mm_unpacklo_epi16(low, zero), _mm_unpacklo_epi16(high, zero),
+                                _mm_unpacklo_epi16(vwy_, zero), _mm_unpacklo_epi16(vwy, zero) );
+    const __m128 second = blend( _mm_unpackhi_epi16(low, zero), _mm_unpackhi_epi16(high, zero),
+                                 _mm_unpackhi_epi16(vwy_, zero), _mm_unpackhi_epi16(vwy, zero) );
+    _mm_storeu_ps( out, _mm_mul_ps(first, _mm_set1_ps(scale)) );
+    _mm_storeu_ps( out + 4, _mm_mul_ps(second, _mm_set1_ps(scale)) );
+#else
+    for( size_t k = 0; k < bilinear_lanes; ++k ){
+        const uint32_t low = c00[k] * (bilinear_one - wx[k]) + c10[k] * wx[k];
+        const uint32_t high = c01[k] * (bilinear_one - wx[k]) + c11[k] * wx[k];
+        out[k] = (static_cast<float>(low) * (bilinear_one - wy[k]) + static_cast<float>(high) * wy[k]) * scale;
+    }
+#endif
+}
+
+/// \brief write `count` copies of `value`: `memset` for byte-cells; 16-byte broadcast stores for wider cells
+template<typename cell_t>
+inline void fill_cells( cell_t* cells, const size_t count, const cell_t value ){
+    if constexpr ( 1 == sizeof(cell_t) ){
+        std::memset( cells, static_cast<unsigned char>(value), count );
+    }else{
+#ifdef __SSE2__
+        static_assert( (2 == sizeof(cell_t)) || (4 == sizeof(cell_t)), "no broadcast for this cell size" );
+        constexpr size_t lanes = 16 / sizeof(cell_t);
+        __m128i broadcast;
+        if constexpr ( 2 == sizeof(cell_t) ){
+            uint16_t bits;
+            std::memcpy( &bits, &value, sizeof(bits) );
+            broadcast = _mm_set1_epi16( static_cast<int16_t>(bits) );
+        }else{
+            uint32_t bits;
+            std::memcpy( &bits, &value, sizeof(bits) );
+            broadcast = _mm_set1_epi32( static_cast<int32_t>(bits) );
+        }
+        const size_t whole = count - (count % lanes);
+        for( size_t k = 0; k < whole; k += lanes ){
+            _mm_storeu_si128( reinterpret_cast<__m128i*>(cells + k), broadcast );
+        }
+        std::fill( cells + whole, cells + count, value );
+#else
+        std::fill_n( cells, count, value );
+#endif
+    }
+}
+
+/// \brief flag every cell at-or-above the threshold: bit (k % 64) of `flags[k / 64]` is set for `threshold <= cells[k]`
+///
+/// Compares 16 bytes of cells at a time, where SSE2 is available.  NaN cells are never flagged.
+/// \param flags - output: `ceil(count / 64)` words
+template<typename cell_t>
+inline void scan_at_or_above( const cell_t* cells, const size_t count, const cell_t threshold, uint64_t* flags ){
+    std::fill_n( flags, (count + 63) / 64, 0 );
+    size_t k = 0;
+#ifdef __SSE2__
+    constexpr size_t lanes = 16 / sizeof(cell_t);
+    // each 16-byte block yields `lanes` bits: the cells *below* the threshold
+    const auto below = [threshold]( const cell_t* block ) -> uint32_t {
+        if constexpr ( std::is_same_v<cell_t, uint8_t> ){
+            const __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i*>(block) );
+            // v >= t  <=>  max(v, t) == v
+            const __m128i at_or_above = _mm_cmpeq_epi8( _mm_max_epu8(v, _mm_set1_epi8(static_cast<char>(threshold))), v );
+            return 0xffffu & ~static_cast<uint32_t>( _mm_movemask_epi8(at_or_above) );
+        }else if constexpr ( std::is_same_v<cell_t, int16_t> || std::is_same_v<cell_t, uint16_t> ){
+            // unsigned lanes are biased into the signed range, which SSE2 can compare
+            const __m128i bias = _mm_set1_epi16( std::is_same_v<cell_t, uint16_t> ? static_cast<int16_t>(0x8000) : 0 );
+            const __m128i v = _mm_xor_si128( _mm_loadu_si128(reinterpret_cast<const __m128i*>(block)), bias );
+            const __m128i t = _mm_xor_si128( _mm_set1_epi16(static_cast<int16_t>(threshold)), bias );
+            return static_cast<uint32_t>( _mm_movemask_epi8(_mm_packs_epi16(_mm_cmpgt_epi16(t, v), _mm_setzero_si128())) );
+        }else{
+            static_assert( std::is_same_v<cell_t, float>, "no comparison kernel for this cell type" );
+            // NaN compares false: so it is neither at-or-above, nor counted here as below
+            const __m128 v = _mm_loadu_ps( block );
+            return static_cast<uint32_t>( _mm_movemask_ps(_mm_cmpge_ps(v, _mm_set1_ps(threshold))) ) ^ 0xfu;
+        }
+    };
+    constexpr uint32_t lane_mask = (1u << lanes) - 1;
+    for( const size_t whole = count - (count % lanes); k < whole; k += lanes ){
+        flags[k / 64] |= static_cast<uint64_t>( lane_mask & ~below(cells + k) ) << (k % 64);
+    }
+#endif
+    for( ; k < count; ++k ){
+        if( threshold <= cells[k] ){
+            flags[k / 64] |= uint64_t(1) << (k % 64);
+        }
+    }
+}
+
+} // namespace detail
+
+template<typename index_t, typename cell_t>
+FixedGrid<index_t,cell_t>::FixedGrid( const Eigen::AlignedBox2d& _bounds)
+    : chartbox::ChartLayerInterface< cell_t, FixedGrid<index_t,cell_t>>(_bounds)
+{
+    // start from the same state as `reset()`; without stamping a write
+    detail::fill_cells( grid.data(), grid.size(), default_value );
+    rebuild_occupancy();
+}
+
+template<typename index_t, typename cell_t>
+typename FixedGrid<index_t,cell_t>::cell_t* FixedGrid<index_t,cell_t>::data (){
+    return grid.data();
+}
+
+template<typename index_t, typename cell_t>
+const typename FixedGrid<index_t,cell_t>::cell_t* FixedGrid<index_t,cell_t>::data () const {
+    return grid.data();
+}
+
+template<typename index_t, typename cell_t>
+bool FixedGrid<index_t,cell_t>::fill( const cell_t value) {
+    detail::fill_cells( grid.data(), grid.size(), value );
+    rebuild_occupancy();
+    dirty_tiles_.mark_all();
+    return true;
+}
+
+template<typename index_t, typename cell_t>
+bool FixedGrid<index_t,cell_t>::fill_span( const uint32_t j, const uint32_t i_begin, const uint32_t i_end, const cell_t value ){
+    // live counts need one flip per changed cell; a paused table is rebuilt after the whole fill
+    if constexpr ( index_t::row_major ){
+        if( occupancy_.paused() ){
+            detail::fill_cells( grid.data() + index_t::lookup(i_begin, j), i_end - i_begin, value );
+            dirty_tiles_.mark( i_begin, i_end, j, j + 1 );
+            return true;
+        }
+    }
+    return super().fill_span( j, i_begin, i_end, value );
+}
+
+template<typename index_t, typename cell_t>
+bool FixedGrid<index_t,cell_t>::fill(const std::vector<cell_t>& source) {
+    if (source.size() != grid.size()) {
+        return false;
+    }
+    if constexpr ( index_t::row_major ){
+        memcpy(grid.data(), source.data(), sizeof(cell_t) * source.size());
+    }else{
+        for( uint32_t j = 0; j < dimension; ++j ){
+            for( uint32_t i = 0; i < dimension; ++i ){
+                grid[ index_t::lookup(i,j) ] = source[ i + j*dimension ];
+            }
+        }
+    }
+    rebuild_occupancy();
+    dirty_tiles_.mark_all();
+    return true;
+}
+
+template<typename index_t, typename cell_t>
+typename FixedGrid<index_t,cell_t>::cell_t FixedGrid<index_t,cell_t>::get(const Eigen::Vector2d& p) const {
+    return grid[ lookup(p) ];
+}
+
+template<typename index_t, typename cell_t>
+uint8_t FixedGrid<index_t,cell_t>::blocked_neighbors( const uint32_t i, const uint32_t j ) const {
+    // E, NE, N, NW, W, SW, S, SE
+    constexpr int32_t di[8] = { 1, 1, 0, -1, -1, -1,  0,  1 };
+    constexpr int32_t dj[8] = { 0, 1, 1,  1,  0, -1, -1, -1 };
+
+    if constexpr ( index_t::row_major ){
+        // off the edge, every neighbor is a constant offset away: no bounds checks, and no index arithmetic
+        if( (0 < i) && (0 < j) && (i + 1 < dimension) && (j + 1 < dimension) ){
+            constexpr auto offsets = neighbor_offsets();
+            const cell_t* center = grid.data() + index_t::lookup( i, j );
+            uint8_t mask = 0;
+            for( uint32_t k = 0; k < 8; ++k ){
+                mask |= static_cast<uint8_t>( (blocking_threshold <= center[offsets[k]]) << k );
+            }
+            return mask;
+        }
+    }
+
+    uint8_t mask = 0;
+    for( uint32_t k = 0; k < 8; ++k ){
+        const uint32_t ni = i + di[k];
+        const uint32_t nj = j + dj[k];
+        // negative indices wrap around to large values
+        if( (dimension <= ni) || (dimension <= nj) || blocked(ni, nj) ){
+            mask |= (1 << k);
+        }
+    }
+    return mask;
+}
+
+template<typename index_t, typename cell_t>
+size_t FixedGrid<index_t,cell_t>::count_blocked( const Eigen::AlignedBox2d& area ) const {
+    if( area.isEmpty() ){
+        return 0;
+    }
+
+    const double scale = inverse_precision();
+    const double x_min = std::floor( area.min().x() * scale );
+    const double y_min = std::floor( area.min().y() * scale );
+    // cells starting exactly on the maximum edge are excluded; but a degenerate area still counts its cell
+    const double x_max = std::max( x_min, std::ceil(area.max().x() * scale) - 1 );
+    const double y_max = std::max( y_min, std::ceil(area.max().y() * scale) - 1 );
+    if( (x_max < 0) || (y_max < 0) || (dimension <= x_min) || (dimension <= y_min) ){
+        return 0;
+    }
+
+    return occupancy_.count( static_cast<uint32_t>( std::max(0.0, x_min) ),
+                             static_cast<uint32_t>( std::max(0.0, y_min) ),
+                             static_cast<uint32_t>( std::min<double>(dimension - 1, x_max) ),
+                             static_cast<uint32_t>( std::min<double>(dimension - 1, y_max) ) );
+}
+
+template<typename index_t, typename cell_t>
+bool FixedGrid<index_t,cell_t>::raycast( const Eigen::Vector2d& from, const Eigen::Vector2d& to, Eigen::Vector2d& hit ) const {
+    const double scale = inverse_precision();
+    const Eigen::Vector2d start = from * scale;
+    const Eigen::Vector2d delta = (to - from) * scale;
+    uint32_t i, j;
+    if( ! blocked_mask_.first_set( start.x(), start.y(), start.x() + delta.x(), start.y() + delta.y(), i, j ) ){
+        return false;
+    }
+
+    const double t = index::OccupancyMask<dimension>::entry( start.x(), start.y(), start.x() + delta.x(), start.y() + delta.y(), i, j );
+    hit = from + t * (to - from);
+    return true;
+}
+
+template<typename index_t, typename cell_t>
+void FixedGrid<index_t,cell_t>::sample_bilinear( const Eigen::Vector2d* points, const size_t count, float* values ) const {
+    constexpr double last = dimension - 1;
+    const double scale = inverse_precision();
+
+    if constexpr ( ! std::is_same_v<cell_t, uint8_t> ){
+        // wider cells don't fit the 16-bit fixed-point blend
+        for( size_t k = 0; k < count; ++k ){
+            const Eigen::Vector2d cell = points[k] * scale;
+            if( (cell.x() < 0) || (dimension <= cell.x()) || (cell.y() < 0) || (dimension <= cell.y()) ){
+                values[k] = std::numeric_limits<float>::quiet_NaN();
+                continue;
+            }
+            const double u = std::clamp( cell.x() - 0.5, 0.0, last );
+            const double v = std::clamp( cell.y() - 0.5, 0.0, last );
+            const uint32_t i0 = static_cast<uint32_t>(u);
+            const uint32_t j0 = static_cast<uint32_t>(v);
+            const uint32_t i1 = std::min<uint32_t>( i0 + 1, dimension - 1 );
+            const uint32_t j1 = std::min<uint32_t>( j0 + 1, dimension - 1 );
+            const double wx = u - i0;
+            const double wy = v - j0;
+            const double low = grid[ index_t::lookup(i0, j0) ] * (1 - wx) + grid[ index_t::lookup(i1, j0) ] * wx;
+            const double high = grid[ index_t::lookup(i0, j1) ] * (1 - wx) + grid[ index_t::lookup(i1, j1) ] * wx;
+            values[k] = static_cast<float>( low * (1 - wy) + high * wy );
+        }
+    }else{
+        constexpr size_t lanes = detail::bilinear_lanes;
+
+        // structure-of-arrays staging for one batch
+        uint16_t c00[lanes], c10[lanes], c01[lanes], c11[lanes];
+        uint16_t wx[lanes], wy[lanes];
+        bool inside[lanes];
+        float blended[lanes];
+
+        for( size_t first = 0; first < count; first += lanes ){
+            const size_t batch = std::min( lanes, count - first );
+
+            // (1) cell indices, fixed-point weights, and the 2x2 gather
+            for( size_t k = 0; k < lanes; ++k ){
+                const Eigen::Vector2d cell = (k < batch) ? Eigen::Vector2d(points[first + k] * scale) : Eigen::Vector2d(0, 0);
+                inside[k] = (0 <= cell.x()) && (cell.x() < dimension) && (0 <= cell.y()) && (cell.y() < dimension);
+
+                // relative to the cell centers; clamped, so that the edges extend outwards
+                const double u = std::clamp( cell.x() - 0.5, 0.0, last );
+                const double v = std::clamp( cell.y() - 0.5, 0.0, last );
+                const uint32_t i0 = static_cast<uint32_t>(u);
+                const uint32_t j0 = static_cast<uint32_t>(v);
+                const uint32_t i1 = std::min<uint32_t>( i0 + 1, dimension - 1 );
+                const uint32_t j1 = std::min<uint32_t>( j0 + 1, dimension - 1 );
+                wx[k] = static_cast<uint16_t>( (u - i0) * detail::bilinear_one + 0.5 );
+                wy[k] = static_cast<uint16_t>( (v - j0) * detail::bilinear_one + 0.5 );
+
+                c00[k] = grid[ index_t::lookup(i0, j0) ];
+                c10[k] = grid[ index_t::lookup(i1, j0) ];
+                c01[k] = grid[ index_t::lookup(i0, j1) ];
+                c11[k] = grid[ index_t::lookup(i1, j1) ];
+            }
+
+            // (2) blend every lane at once
+            detail::blend_bilinear( c00, c10, c01, c11, wx, wy, blended );
+
+            for( size_t k = 0; k < batch; ++k ){
+                values[first + k] = inside[k] ? blended[k] : std::numeric_limits<float>::quiet_NaN();
+            }
+        }
+    }
+}
+
+template<typename index_t, typename cell_t>
+void FixedGrid<index_t,cell_t>::rebuild_occupancy() {
+    if constexpr ( index_t::row_major ){
+        // scan each (contiguous) row once; then both tables read the packed flags
+        constexpr size_t words_per_row = (dimension + 63) / 64;
+        std::vector<uint64_t> flags( dimension * words_per_row );
+        for( uint32_t j = 0; j < dimension; ++j ){
+            detail::scan_at_or_above( grid.data() + index_t::lookup(0, j), dimension, blocking_threshold, flags.data() + j * words_per_row );
+        }
+        const auto is_blocked = [&flags]( const uint32_t i, const uint32_t j ){
+            return 0 != ( (flags[ j * words_per_row + (i >> 6) ] >> (i & 63)) & 1 ); };
+        occupancy_.rebuild( is_blocked );
+        blocked_mask_.rebuild( is_blocked );
+    }else{
+        const auto is_blocked = [this]( const uint32_t i, const uint32_t j ){
+            return ( blocking_threshold <= grid[ index_t::lookup(i, j) ] ); };
+        occupancy_.rebuild( is_blocked );
+        blocked_mask_.rebuild( is_blocked );
+    }
+}
+
+template<typename index_t, typename cell_t>
+double FixedGrid<index_t,cell_t>::precision() const {
+    return  width() / dimension;
+}
+
+template<typename index_t, typename cell_t>
+void FixedGrid<index_t,cell_t>::print_contents() const {
+    fmt::print( "============ ============ Fixed-Grid-Layer Contents ============ ============\n" );
+    for (size_t j = dimension - 1; j < dimension; --j) {
+        for (size_t i = 0; i < dimension; ++i) {
+            const auto offset = lookup(i,j);
+            const auto value = grid[offset];
+            if( 0 == (i%8) ){
+                fmt::print(" ");
+            }
+            if( 0 < value ){
+                fmt::print(" {:2X}", static_cast<int>(value) );
+            }else{
+                fmt::print(" --");
+            }
+        }
+        if( 0 == (j%8) ){
+            fmt::print("\n");
+        }
+        fmt::print("\n");
+    }
+    fmt::print( "============ ============ ============ ============ ============ ============\n" );
+}
+
+template<typename index_t, typename cell_t>
+void FixedGrid<index_t,cell_t>::reset() {
+    fill( default_value );
+}
+
+template<typename index_t, typename cell_t>
+bool FixedGrid<index_t,cell_t>::store( const Eigen::Vector2d& p, const cell_t value) {
+    const double scale = inverse_precision();
+    return store( static_cast<uint32_t>(p.x()*scale), static_cast<uint32_t>(p.y()*scale), value );
+}
+
+template<typename index_t, typename cell_t>
+bool FixedGrid<index_t,cell_t>::store( const uint32_t i, const uint32_t j, const cell_t value) {
+    const auto offset = lookup( i, j );
+
+    if( value == grid[offset] ){
+        return true;
+    }
+
+    const bool was_blocked = ( blocking_threshold <= grid[offset] );
+    const bool is_blocked = ( blocking_threshold <= value );
+    grid[offset] = value;
+    dirty_tiles_.mark( i, j );
+    if( was_blocked != is_blocked ){
+        occupancy_.flip( i, j, is_blocked ? 1 : -1 );
+        blocked_mask_.set( i, j, is_blocked );
+    }
+    return true;
+}
+
+
+// template<typename cell_t, size_t dim>
+// Index2u FixedGridLayer<cell_t,dim>::as_index(const Eigen::Vector2d& location) const {
+//     auto local = bounds_.as_local(location);
+//     return Index2u( static_cast<uint32_t>(local.x() / precision )
+//                   , static_cast<uint32_t>(local.y() / precision ) );
+// }
+
+// template<typename cell_t, size_t dim>
+// Vector2d  FixedGridLayer<cell_t,dim>::as_location(const index::Index2u& index) const {
+//     const Vector2d p_local = { (static_cast<float>(index.i) + 0.5) * precision_
+//                              , (static_cast<float>(index.j) + 0.5) * precision_ };
+//     return bounds_.as_global(p_local);
+// }
+
+// template<typename cell_t, size_t dim>
+// bool FixedGridLayer<cell_t,dim>::blocked(const index::Index2u& at) const {
+//     return (blocking_threshold <= operator[](at));
+// }
+
+// template<typename cell_t, size_t dim>
+// bool FixedGridLayer<cell_t,dim>::contains(const Vector2d& p) const {
+//     return bounds_.contains(p);
+// }
+
+// template<typename cell_t, size_t dim>
+// bool FixedGridLayer<cell_t,dim>::contains(const Index2u& index) const {
+//     if (index.i < dim && index.j < dim ){
+//         return true;
+//     }
+//     return false;        
+// }
+
+// template<typename cell_t, size_t dim>
+// cell_t FixedGridLayer<cell_t,dim>::classify(const Vector2d& p) const {
+//     return classify(p, 0xFF);
+// }
+
+// template<typename cell_t, size_t dim>
+// cell_t FixedGridLayer<cell_t,dim>::classify(const Vector2d& p, const cell_t default_value) const {
+//     if(bounds_.contains(p)){
+//         size_t i = index.lookup(as_index(p));
+//         return grid[i];
+//     }
+
+//     return default_value;
+// }
+
+// template<typename cell_t, size_t dim>
+// cell_t& FixedGridLayer<cell_t,dim>::get_cell(const size_t xi, const size_t yi) {
+//     Index2u location(xi,yi);
+//     return grid[index.lookup(location)];
+// }
+
+// template<typename cell_t, size_t dim>
+// cell_t FixedGridLayer<cell_t,dim>::get_cell(const size_t xi, const size_t yi) const {
+//     Index2u location(xi,yi);
+//     return grid[index.lookup(location)];
+// }
+
+// template<typename cell_t, size_t dim>
+// cell_t& FixedGridLayer<cell_t,dim>::operator[](const index::Index2u& location) {
+//     return grid[index.lookup(location)];
+// }
+
+// template<typename cell_t, size_t dim>
+// cell_t FixedGridLayer<cell_t,dim>::operator[](const index::Index2u& location) const {
+//     return grid[index.lookup(location)];
+// }
+
+// template<typename cell_t, size_t dim>
+// bool FixedGridLayer<cell_t,dim>::store(const Vector2d& p, const cell_t new_value) {
+//     if(contains(p)){
+//         size_t i = index.lookup(as_index(p));
+//         grid[i] = new_value;
+//         return true;
+//     }
+
+//     return false;
+// }
+
+template<typename index_t, typename cell_t>
+std::string FixedGrid<index_t,cell_t>::type() const { 
+    return type_;
+}
+
+template<typename index_t, typename cell_t>
+FixedGrid<index_t,cell_t>::~FixedGrid(){}
+
+} // namespace chartbox::layer
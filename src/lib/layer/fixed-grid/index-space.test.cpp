@@ -0,0 +1,230 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include "index/cell-index.hpp"
+#include "index/row-major-index.hpp"
+#include "index/z-order-index.hpp"
+#include "layer/bit-grid/bit-grid.hpp"
+#include "layer/quad-tree/quad-tree-layer.hpp"
+
+#include "fixed-grid.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+using chartbox::index::Index2u;
+
+namespace chartbox::layer {
+
+typedef FixedGrid< index::RowMajorIndex<64> > RowGrid64;
+typedef FixedGrid< index::ZOrderIndex<64> > ZGrid64;
+
+static const AlignedBox2d bounds( Vector2d(0,0), Vector2d(32,32) );
+
+TEST( FixedGridIndexSpace, ConvertLocations ){
+    RowGrid64 grid( bounds );
+    EXPECT_DOUBLE_EQ( grid.precision(), 0.5 );
+    EXPECT_DOUBLE_EQ( grid.inverse_precision(), 2.0 );
+
+    Index2u cell;
+    EXPECT_TRUE( grid.to_index( Vector2d(3.2, 7.9), cell ) );
+    EXPECT_EQ( cell, Index2u(6u, 15u) );
+    EXPECT_TRUE( grid.to_location(cell).isApprox( Vector2d(3.25, 7.75) ) );
+
+    EXPECT_TRUE( grid.to_index( Vector2d(0, 31.99), cell ) );
+    EXPECT_EQ( cell, Index2u(0u, 63u) );
+
+    // outside: the cell is left unchanged
+    EXPECT_FALSE( grid.to_index( Vector2d(-0.1, 3), cell ) );
+    EXPECT_FALSE( grid.to_index( Vector2d(3, 32), cell ) );
+    EXPECT_FALSE( grid.to_index( Vector2d(NAN, 3), cell ) );
+    EXPECT_EQ( cell, Index2u(0u, 63u) );
+
+    EXPECT_TRUE( grid.contains( Index2u(63u, 63u) ) );
+    EXPECT_FALSE( grid.contains( Index2u(64u, 0u) ) );
+}
+
+TEST( FixedGridIndexSpace, GetAndStore ){
+    RowGrid64 grid( bounds );
+    grid.fill( 0 );
+
+    EXPECT_TRUE( grid.store( Index2u(6u, 15u), 0x99 ) );
+    EXPECT_EQ( grid.get( Index2u(6u, 15u) ), 0x99 );
+    EXPECT_EQ( grid.get( 6, 15 ), 0x99 );
+    EXPECT_EQ( grid.get( Vector2d(3.25, 7.75) ), 0x99 );
+    EXPECT_TRUE( grid.blocked( 6, 15 ) );
+    // index-space writes keep the occupancy counts current
+    EXPECT_EQ( grid.count_blocked( bounds ), 1 );
+
+    EXPECT_EQ( grid.get_checked( Index2u(6u, 15u) ), 0x99 );
+    EXPECT_EQ( grid.get_checked( Index2u(64u, 15u) ), RowGrid64::default_value );
+    EXPECT_FALSE( grid.store_checked( Index2u(6u, 64u), 0x99 ) );
+    EXPECT_TRUE( grid.store_checked( Index2u(6u, 15u), 0 ) );
+    EXPECT_EQ( grid.count_blocked( bounds ), 0 );
+}
+
+TEST( FixedGridIndexSpace, RowPointers ){
+    RowGrid64 grid( bounds );
+    grid.fill( 0 );
+    grid.fill_span( 20, 5, 9, 0x40 );
+
+    const uint8_t* row = grid.row_ptr( 20 );
+    EXPECT_EQ( row, grid.data() + 20 * 64 );
+    EXPECT_EQ( row[4], 0 );
+    EXPECT_EQ( row[5], 0x40 );
+    EXPECT_EQ( row[8], 0x40 );
+    EXPECT_EQ( row[9], 0 );
+}
+
+TEST( FixedGridIndexSpace, NeighborOffsetsMatchLayout ){
+    constexpr auto offsets = RowGrid64::neighbor_offsets();
+    // E, NE, N, NW, W, SW, S, SE
+    constexpr int32_t di[8] = { 1, 1, 0, -1, -1, -1,  0,  1 };
+    constexpr int32_t dj[8] = { 0, 1, 1,  1,  0, -1, -1, -1 };
+    for( size_t k = 0; k < 8; ++k ){
+        EXPECT_EQ( static_cast<ptrdiff_t>(RowGrid64::index_t::lookup(10 + di[k], 10 + dj[k])) - static_cast<ptrdiff_t>(RowGrid64::index_t::lookup(10, 10)), offsets[k] );
+    }
+
+    // the offset fast-path -- inside the row-major grid -- agrees with the checked path of the z-ordered grid
+    RowGrid64 rows( bounds );
+    ZGrid64 zorder( bounds );
+    std::mt19937 generator( 11 );
+    std::bernoulli_distribution blocked( 0.3 );
+    for( uint32_t j = 0; j < 64; ++j ){
+        for( uint32_t i = 0; i < 64; ++i ){
+            const uint8_t value = blocked(generator) ? 0x99 : 0;
+            rows.store( i, j, value );
+            zorder.store( i, j, value );
+        }
+    }
+    for( uint32_t j = 0; j < 64; ++j ){
+        for( uint32_t i = 0; i < 64; ++i ){
+            ASSERT_EQ( rows.blocked_neighbors(i, j), zorder.blocked_neighbors(i, j) ) << "    @@ (" << i << ", " << j << ")";
+        }
+    }
+}
+
+TEST( FixedGridIndexSpace, FillPolygon ){
+    const AlignedBox2d small( Vector2d(0,0), Vector2d(8,8) );
+    FixedGrid< index::RowMajorIndex<8> > grid( small );
+    grid.fill( 0x99 );
+
+    // a diamond, 6 wide, about the center
+    auto diamond = std::make_unique<OGRPolygon>();
+    OGRLinearRing ring;
+    ring.addPoint( 4, 1 );
+    ring.addPoint( 7, 4 );
+    ring.addPoint( 4, 7 );
+    ring.addPoint( 1, 4 );
+    ring.closeRings();
+    diamond->addRing( &ring );
+    EXPECT_TRUE( grid.fill( std::move(diamond), 0 ) );
+
+    EXPECT_EQ( grid.get(3, 7), 0x99 );
+    EXPECT_EQ( grid.get(3, 6), 0x99 );
+    EXPECT_EQ( grid.get(3, 5), 0 );
+    EXPECT_EQ( grid.get(3, 4), 0 );
+    EXPECT_EQ( grid.get(3, 3), 0 );
+    EXPECT_EQ( grid.get(3, 2), 0 );
+    EXPECT_EQ( grid.get(3, 1), 0x99 );
+    EXPECT_EQ( grid.get(3, 0), 0x99 );
+
+    EXPECT_EQ( grid.get(0, 5), 0x99 );
+    EXPECT_EQ( grid.get(1, 5), 0x99 );
+    EXPECT_EQ( grid.get(2, 5), 0x99 );
+    EXPECT_EQ( grid.get(3, 5), 0 );
+    EXPECT_EQ( grid.get(4, 5), 0 );
+    EXPECT_EQ( grid.get(5, 5), 0 );
+    EXPECT_EQ( grid.get(6, 5), 0x99 );
+    EXPECT_EQ( grid.get(7, 5), 0x99 );
+}
+
+// 100 m over 1024 cells: the cell-units filler multiplies by 10.24, which is inexact in binary
+TEST( FixedGridIndexSpace, FillPolygonAtInexactPrecision ){
+    typedef FixedGrid< index::RowMajorIndex<1024> > Grid1024;
+    static const AlignedBox2d hundred( Vector2d(0,0), Vector2d(100,100) );
+    auto grid = std::make_unique<Grid1024>( hundred );
+    ASSERT_DOUBLE_EQ( grid->inverse_precision(), 10.24 );
+
+    // vertices given in cells; placed in meters
+    const auto fill = [&grid]( std::initializer_list<Vector2d> cells ){
+        grid->fill( 0 );
+        auto polygon = std::make_unique<OGRPolygon>();
+        OGRLinearRing ring;
+        for( const Vector2d& cell : cells ){
+            ring.addPoint( cell.x() * 100 / 1024, cell.y() * 100 / 1024 );
+        }
+        ring.closeRings();
+        polygon->addRing( &ring );
+        EXPECT_TRUE( grid->fill( std::move(polygon), 0x99 ) );
+    };
+    // the filled cells of each row, as [begin, end); or (0, 0) for none
+    const auto row_span = [&grid]( const uint32_t j ){
+        uint32_t begin = 0;
+        while( (begin < Grid1024::dimension) && (0 == grid->get(begin, j)) ){ ++begin; }
+        uint32_t end = begin;
+        while( (end < Grid1024::dimension) && (0 != grid->get(end, j)) ){ ++end; }
+        for( uint32_t i = end; i < Grid1024::dimension; ++i ){
+            EXPECT_EQ( grid->get(i, j), 0 ) << "    @@ (" << i << ", " << j << ")";
+        }
+        return (begin < end) ? std::make_pair(begin, end) : std::make_pair(0u, 0u);
+    };
+
+    // edges on cell boundaries, at round meters (25 m, 50 m): exactly the cells inside
+    fill({ {256, 256}, {512, 256}, {512, 512}, {256, 512} });
+    EXPECT_EQ( row_span(255), std::make_pair(0u, 0u) );
+    for( uint32_t j = 256; j < 512; ++j ){
+        ASSERT_EQ( row_span(j), std::make_pair(256u, 512u) ) << "    @@ row " << j;
+    }
+    EXPECT_EQ( row_span(512), std::make_pair(0u, 0u) );
+
+    // edges through cell centers -- the ties:
+    // a row whose center is on the bottom edge is filled, and on the top edge is not;
+    // a column whose center is on the left edge is not filled, and on the right edge is.
+    fill({ {100.5, 100.5}, {200.5, 100.5}, {200.5, 200.5}, {100.5, 200.5} });
+    EXPECT_EQ( row_span(99), std::make_pair(0u, 0u) );
+    for( uint32_t j = 100; j < 200; ++j ){
+        ASSERT_EQ( row_span(j), std::make_pair(101u, 201u) ) << "    @@ row " << j;
+    }
+    EXPECT_EQ( row_span(200), std::make_pair(0u, 0u) );
+
+    // a diagonal through cell corners, with each vertex on a corner: every cell center on the diagonal is filled
+    fill({ {100, 100}, {200, 100}, {100, 200} });
+    EXPECT_EQ( row_span(99), std::make_pair(0u, 0u) );
+    for( uint32_t j = 100; j < 200; ++j ){
+        ASSERT_EQ( row_span(j), std::make_pair(100u, 300u - j) ) << "    @@ row " << j;
+    }
+    EXPECT_EQ( row_span(200), std::make_pair(0u, 0u) );
+    EXPECT_EQ( grid->get(100, 100), 0x99 );
+    EXPECT_EQ( grid->get(199, 100), 0x99 );
+    EXPECT_EQ( grid->get(100, 199), 0x99 );
+}
+
+TEST( FixedGridIndexSpace, OtherLayers ){
+    // the same index-space calls, through layers with other storage
+    BitGrid<64> bits( bounds );
+    bits.fill( 0 );
+    EXPECT_TRUE( bits.store( Index2u(6u, 15u), 0x99 ) );
+    EXPECT_EQ( bits.get( Index2u(6u, 15u) ), BitGrid<64>::default_value );
+    EXPECT_EQ( bits.get( Vector2d(3.25, 7.75) ), BitGrid<64>::default_value );
+    EXPECT_EQ( bits.get_checked( Index2u(7u, 15u) ), 0 );
+    EXPECT_EQ( bits.get_checked( Index2u(64u, 15u) ), BitGrid<64>::default_value );
+
+    QuadTree<64> tree( bounds );
+    tree.fill( 0 );
+    EXPECT_TRUE( tree.store( Index2u(6u, 15u), 0x99 ) );
+    EXPECT_EQ( tree.get( Index2u(6u, 15u) ), 0x99 );
+    EXPECT_EQ( tree.get( Vector2d(3.25, 7.75) ), 0x99 );
+    EXPECT_TRUE( tree.contains( Index2u(63u, 63u) ) );
+    EXPECT_FALSE( tree.contains( Index2u(63u, 64u) ) );
+}
+
+} // namespace chartbox::layer
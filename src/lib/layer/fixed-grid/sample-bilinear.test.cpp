@@ -0,0 +1,110 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include "index/hilbert-index.hpp"
+
+#include "fixed-grid.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+namespace chartbox::layer {
+
+static const AlignedBox2d bounds( Vector2d(0,0), Vector2d(256,256) );
+
+// reference: exact bilinear interpolation between cell centers, in double precision
+template<typename layer_t>
+static double exact( const layer_t& layer, const Vector2d& point ){
+    constexpr double last = layer_t::dimension - 1;
+    const double u = std::clamp( point.x() / layer.precision() - 0.5, 0.0, last );
+    const double v = std::clamp( point.y() / layer.precision() - 0.5, 0.0, last );
+    const uint32_t i0 = static_cast<uint32_t>(u);
+    const uint32_t j0 = static_cast<uint32_t>(v);
+    const uint32_t i1 = std::min<uint32_t>( i0 + 1, layer_t::dimension - 1 );
+    const uint32_t j1 = std::min<uint32_t>( j0 + 1, layer_t::dimension - 1 );
+    const double fx = u - i0;
+    const double fy = v - j0;
+    auto at = [&]( uint32_t i, uint32_t j ){ return static_cast<double>( layer.data()[layer.lookup(i, j)] ); };
+    return (at(i0, j0) * (1 - fx) + at(i1, j0) * fx) * (1 - fy) + (at(i0, j1) * (1 - fx) + at(i1, j1) * fx) * fy;
+}
+
+template<typename layer_t>
+static void expect_matches_exact(){
+    std::mt19937 generator( 31 );
+    std::uniform_int_distribution<int> value( 0, 255 );
+    std::uniform_real_distribution<double> coordinate( 0, 256 );
+
+    layer_t layer( bounds );
+    for( size_t offset = 0; offset < layer_t::dimension * layer_t::dimension; ++offset ){
+        layer.data()[offset] = static_cast<typename layer_t::cell_t>( value(generator) );
+    }
+
+    // not a multiple of the batch size
+    std::vector<Vector2d> points( 1003 );
+    for( auto& p : points ){
+        p = { coordinate(generator), coordinate(generator) };
+    }
+    points[0] = { 0, 0 };
+    points[1] = { 255.99, 255.99 };
+    points[2] = { 3.0, 99.0 };    // exactly on the center of cell (1, 49)
+
+    std::vector<float> values;
+    layer.sample_bilinear( points, values );
+    ASSERT_EQ( values.size(), points.size() );
+    for( size_t k = 0; k < points.size(); ++k ){
+        ASSERT_NEAR( values[k], exact(layer, points[k]), 1.0 ) << "    @ " << points[k].x() << ", " << points[k].y();
+    }
+    EXPECT_FLOAT_EQ( values[0], layer.data()[layer.lookup(0, 0)] );
+    EXPECT_FLOAT_EQ( values[2], layer.data()[layer.lookup(1, 49)] );
+}
+
+TEST( FixedGridSampleBilinear, MatchesExact ){
+    expect_matches_exact< FixedGridLayer >();
+}
+
+TEST( FixedGridSampleBilinear, MatchesExactOnHilbertLayout ){
+    expect_matches_exact< FixedGrid<index::HilbertIndex<128>> >();
+}
+
+TEST( FixedGridSampleBilinear, MatchesExactOnWiderCells ){
+    expect_matches_exact< FixedGrid<index::RowMajorIndex<128>, uint16_t> >();
+    expect_matches_exact< FixedGridFloatLayer >();
+}
+
+TEST( FixedGridSampleBilinear, Outside ){
+    FixedGridLayer layer( bounds );
+    layer.fill( 40 );
+
+    const std::vector<Vector2d> points = { {-1, 10}, {10, 10}, {10, 256}, {300, -5} };
+    std::vector<float> values;
+    layer.sample_bilinear( points, values );
+    EXPECT_TRUE( std::isnan(values[0]) );
+    EXPECT_FLOAT_EQ( values[1], 40 );
+    EXPECT_TRUE( std::isnan(values[2]) );
+    EXPECT_TRUE( std::isnan(values[3]) );
+}
+
+TEST( FixedGridSampleBilinear, Gradient ){
+    FixedGridLayer layer( bounds );
+    for( uint32_t j = 0; j < FixedGridLayer::dimension; ++j ){
+        for( uint32_t i = 0; i < FixedGridLayer::dimension; ++i ){
+            layer.data()[ layer.lookup(i, j) ] = static_cast<uint8_t>( i );
+        }
+    }
+
+    // halfway between the centers of cells 10 and 11
+    const Vector2d point( 22.0, 50.0 );
+    float value;
+    layer.sample_bilinear( &point, 1, &value );
+    EXPECT_FLOAT_EQ( value, 10.5 );
+}
+
+} // namespace chartbox::layer
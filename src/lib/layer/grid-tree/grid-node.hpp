@@ -0,0 +1,247 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace chartbox::node {
+
+namespace detail {
+
+constexpr uint32_t log2( const size_t value ){
+    return ( value <= 1 ) ? 0 : 1 + log2( value / 2 );
+}
+
+/// \brief cells compare by their bits; so that e.g. NaN cells still collapse
+template<typename cell_t>
+inline bool same_bits( const cell_t a, const cell_t b ){
+    return 0 == std::memcmp( &a, &b, sizeof(cell_t) );
+}
+
+} // namespace detail
+
+/// \brief leaf of a grid tree: n x n cells; stored densely while mixed, or as a single value while uniform
+///
+/// Cells are addressed by the low `shift` bits of the tree-wide cell indices; so callers pass the same
+/// (i,j) down through every level of the tree.
+template<typename cell_t, size_t n>
+class TileNode {
+public:
+    static_assert( 0 == (n & (n - 1)), "Tile width must be a power of two!" );
+
+    /// \brief width of this node, in cells
+    constexpr static size_t width = n;
+    constexpr static uint32_t shift = detail::log2(n);
+    /// \brief number of levels of nodes beneath this one
+    constexpr static size_t depth = 0;
+    constexpr static size_t size = n * n;
+
+public:
+    explicit TileNode( const cell_t _value )
+        : value_(_value)
+    {}
+
+    inline bool uniform() const { return ! cells_; }
+
+    /// \brief the value of every cell, while uniform; else the value the tile held when it split
+    inline cell_t value() const { return value_; }
+
+    inline cell_t get( const uint32_t i, const uint32_t j ) const {
+        return cells_ ? (*cells_)[ offset(i, j) ] : value_; }
+
+    void fill( const cell_t _value ){
+        cells_.reset();
+        value_ = _value;
+        mixed_ = 0;
+    }
+
+    /// \return true if the cell changed
+    bool store( const uint32_t i, const uint32_t j, const cell_t _value ){
+        if( ! cells_ ){
+            if( detail::same_bits(_value, value_) ){
+                return false;
+            }
+            cells_ = std::make_unique<std::array<cell_t, size>>();
+            cells_->fill( value_ );
+            mixed_ = 0;
+        }
+
+        cell_t& cell = (*cells_)[ offset(i, j) ];
+        if( detail::same_bits(cell, _value) ){
+            return false;
+        }else if( detail::same_bits(cell, value_) ){
+            ++mixed_;
+        }else if( detail::same_bits(_value, value_) ){
+            --mixed_;
+        }
+        cell = _value;
+
+        if( 0 == mixed_ ){
+            fill( value_ );
+        }else if( (size == mixed_) && every_cell(_value) ){
+            fill( _value );
+        }
+        return true;
+    }
+
+    inline size_t node_count() const { return 1; }
+
+    inline size_t memory_usage() const {
+        return sizeof(*this) + ( cells_ ? sizeof(*cells_) : 0 ); }
+
+private:
+    inline static size_t offset( const uint32_t i, const uint32_t j ){
+        return ( static_cast<size_t>(j & (n - 1)) << shift ) | (i & (n - 1)); }
+
+    bool every_cell( const cell_t _value ) const {
+        for( const cell_t cell : *cells_ ){
+            if( ! detail::same_bits(cell, _value) ){
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    cell_t value_;
+
+    /// \brief number of cells which differ from `value_`; while split
+    uint32_t mixed_ = 0;
+
+    /// \brief row-major; empty while uniform
+    std::unique_ptr<std::array<cell_t, size>> cells_;
+};
+
+/// \brief branch of a grid tree: n x n children; or a single value, while uniform
+///
+/// Each level selects its child by a constexpr shift and mask of the cell indices -- `child_shift` is the
+/// width of one child, in bits -- so descent involves neither division nor floating-point.
+///
+/// Each branch counts the children which differ from the value it held when it split; when that count
+/// returns to zero, or every child becomes the same uniform value, the children are released.
+template<size_t n, typename child_t, typename cell_t>
+class GridNode {
+public:
+    static_assert( 0 == (n & (n - 1)), "Grid width must be a power of two!" );
+
+    /// \brief width of this node, in cells
+    constexpr static size_t width = n * child_t::width;
+    constexpr static uint32_t child_shift = child_t::shift;
+    constexpr static uint32_t shift = child_shift + detail::log2(n);
+    /// \brief number of levels of nodes beneath this one
+    constexpr static size_t depth = child_t::depth + 1;
+    /// \brief number of children
+    constexpr static size_t size = n * n;
+
+public:
+    explicit GridNode( const cell_t _value )
+        : value_(_value)
+    {}
+
+    inline bool uniform() const { return children_.empty(); }
+
+    /// \brief the value of every cell, while uniform; else the value the node held when it split
+    inline cell_t value() const { return value_; }
+
+    inline cell_t get( const uint32_t i, const uint32_t j ) const {
+        return children_.empty() ? value_ : children_[ child_index(i, j) ].get( i, j ); }
+
+    void fill( const cell_t _value ){
+        std::vector<child_t>().swap( children_ );
+        value_ = _value;
+        mixed_ = 0;
+    }
+
+    /// \return true if the cell changed
+    bool store( const uint32_t i, const uint32_t j, const cell_t _value ){
+        if( children_.empty() ){
+            if( detail::same_bits(_value, value_) ){
+                return false;
+            }
+            children_.reserve( size );
+            for( size_t k = 0; k < size; ++k ){
+                children_.emplace_back( value_ );
+            }
+            mixed_ = 0;
+        }
+
+        child_t& child = children_[ child_index(i, j) ];
+        const bool was_plain = plain( child );
+        if( ! child.store(i, j, _value) ){
+            return false;
+        }
+        const bool is_plain = plain( child );
+        if( was_plain && (! is_plain) ){
+            ++mixed_;
+        }else if( (! was_plain) && is_plain ){
+            --mixed_;
+        }
+
+        if( 0 == mixed_ ){
+            fill( value_ );
+        }else if( (size == mixed_) && child.uniform() && every_child(child.value()) ){
+            fill( child.value() );
+        }
+        return true;
+    }
+
+    size_t node_count() const {
+        size_t count = 1;
+        for( const auto& child : children_ ){
+            count += child.node_count();
+        }
+        return count;
+    }
+
+    size_t memory_usage() const {
+        size_t bytes = sizeof(*this);
+        for( const auto& child : children_ ){
+            bytes += child.memory_usage();
+        }
+        return bytes;
+    }
+
+private:
+    inline static size_t child_index( const uint32_t i, const uint32_t j ){
+        return ( static_cast<size_t>((j >> child_shift) & (n - 1)) * n ) + ((i >> child_shift) & (n - 1)); }
+
+    /// \brief true if the child is uniform, with this node's value
+    inline bool plain( const child_t& child ) const {
+        return child.uniform() && detail::same_bits( child.value(), value_ ); }
+
+    bool every_child( const cell_t _value ) const {
+        for( const auto& child : children_ ){
+            if( (! child.uniform()) || (! detail::same_bits(child.value(), _value)) ){
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    cell_t value_;
+
+    /// \brief number of children which are not uniform with `value_`; while split
+    uint32_t mixed_ = 0;
+
+    /// \brief row-major; empty while uniform
+    std::vector<child_t> children_;
+};
+
+/// \brief the node type of a grid tree with `depth` levels of n-way branches, above n x n tiles
+template<size_t n, size_t depth, typename cell_t>
+struct GridHierarchy {
+    typedef GridNode< n, typename GridHierarchy<n, depth - 1, cell_t>::type, cell_t > type;
+};
+
+template<size_t n, typename cell_t>
+struct GridHierarchy<n, 0, cell_t> {
+    typedef TileNode<cell_t, n> type;
+};
+
+} // namespace chartbox::node
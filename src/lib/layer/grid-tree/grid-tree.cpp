@@ -0,0 +1,13 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <cstdint>
+
+#include "grid-tree.hpp"
+
+namespace chartbox::layer {
+
+// stock shapes; others are instantiated on-demand, from the header
+template class GridTree<16, 2>;
+template class GridTree<32, 1>;
+
+} // namespace chartbox::layer
@@ -0,0 +1,148 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include "chart-box/chart-layer-interface.hpp"
+#include "index/dirty-tiles.hpp"
+
+#include "grid-node.hpp"
+
+namespace chartbox::layer {
+
+/// \brief N-ary tree of square grids: `depth` levels of n x n branches (`GridNode`), above n x n tiles (`TileNode`)
+///
+/// A wide, shallow alternative to a quadtree: a 32-way tree spans 32768 cells in 3 levels, rather than 15;
+/// and a fully-split tree holds ~1/(n^2 - 1) as many nodes as cells, rather than ~1/3.  Uniform regions
+/// collapse into a single node, at any level.
+///
+/// The shape of the tree is fixed at compile-time; so each level's shift & mask are constants.
+///
+/// \param n - width of each node, in children (or, for tiles, cells); a power of two
+/// \param depth_ - number of levels of branches above the tiles
+/// \param cell_t_ - cell type
+template<size_t n, size_t depth_, typename cell_t_ = uint8_t>
+class GridTree : public chartbox::ChartLayerInterface< cell_t_, GridTree<n, depth_, cell_t_>> {
+public:
+    typedef cell_t_ cell_t;
+    typedef typename node::GridHierarchy<n, depth_, cell_t>::type root_t;
+
+    /// \brief number of levels of branches above the tiles
+    constexpr static size_t depth = depth_;
+
+    /// \brief number of cells along each dimension of this tree; n^(depth + 1)
+    constexpr static size_t dimension = root_t::width;
+
+    constexpr static cell_t default_value = CellTraits<cell_t>::default_value;
+    constexpr static cell_t blocking_threshold = CellTraits<cell_t>::blocking_threshold;
+
+public:
+    GridTree() = delete;
+
+    /// \brief construct a tree covering the given bounds; initially a single node of `default_value`
+    GridTree( const Eigen::AlignedBox2d& _bounds );
+
+    // override from ChartLayerInterface
+    bool fill( const cell_t value );
+
+    bool fill( const Eigen::AlignedBox2d& area, const cell_t value ){
+        return super().fill( area, value ); }
+
+    bool fill( std::unique_ptr<OGRPolygon> source, cell_t value ){
+        return super().fill( std::move(source), value ); }
+
+    cell_t get( const Eigen::Vector2d& p ) const;
+
+    /// \warning does not check bounds
+    inline cell_t get( const uint32_t i, const uint32_t j ) const {
+        return root_.get( i, j ); }
+
+    /// \warning does not check bounds
+    inline cell_t get( const index::Index2u& cell ) const {
+        return get( cell.i, cell.j ); }
+
+    /// \warning does not check bounds
+    inline bool blocked( const uint32_t i, const uint32_t j ) const {
+        return ( blocking_threshold <= root_.get(i, j) ); }
+
+    /// \brief number of nodes in the tree -- branches, tiles, and collapsed nodes of either
+    inline size_t node_count() const { return root_.node_count(); }
+
+    /// \brief bytes held by the tree's nodes and cells
+    inline size_t memory_usage() const { return root_.memory_usage(); }
+
+    double precision() const;
+
+    /// \brief override from ChartLayerInterface: cells per unit of distance
+    inline double inverse_precision() const { return dimension / width(); }
+
+    /// \brief Draws a simple debug representation of this tree to stderr
+    void print_contents() const;
+
+    /// \brief version of the most recent write; increases with every write which changes a cell
+    inline uint64_t version() const { return dirty_tiles_.version(); }
+
+    /// \brief Collect the areas modified since a given version; and advance that version to the current one
+    ///
+    /// Changes are tracked per tile -- n x n cells; so each area is a run of whole tiles.
+    ///
+    /// \param since - in: the version this consumer last processed; out: the current version
+    /// \param areas - appended with the modified areas, in the layer's frame
+    void collect_changes( uint64_t& since, std::vector<Eigen::AlignedBox2d>& areas ) const {
+        dirty_tiles_.changed_since( since, precision(), areas );
+        since = dirty_tiles_.version(); }
+
+    void reset();
+
+    bool store( const Eigen::Vector2d& p, const cell_t value );
+
+    /// \warning does not check bounds
+    inline bool store( const uint32_t i, const uint32_t j, const cell_t value ){
+        if( root_.store(i, j, value) ){
+            dirty_tiles_.mark( i, j );
+        }
+        return true; }
+
+    /// \warning does not check bounds
+    inline bool store( const index::Index2u& cell, const cell_t value ){
+        return store( cell.i, cell.j, value ); }
+
+    std::string type() const;
+
+    inline double width() const { return this->bounds_.sizes().maxCoeff(); }
+
+private:
+    /// \brief name of this layer's type
+    constexpr static char type_[] = "GridTreeLayer";
+
+    root_t root_;
+
+    /// \brief version of the last write to each tile; answers `collect_changes(...)`
+    index::DirtyTiles<dimension, n> dirty_tiles_;
+
+    chartbox::ChartLayerInterface< cell_t, GridTree<n, depth_, cell_t>>& super() {
+        return *static_cast<chartbox::ChartLayerInterface< cell_t, GridTree<n, depth_, cell_t>>*>(this);
+    }
+
+    const chartbox::ChartLayerInterface< cell_t, GridTree<n, depth_, cell_t>>& super() const {
+        return *static_cast<const chartbox::ChartLayerInterface< cell_t, GridTree<n, depth_, cell_t>>*>(this);
+    }
+};
+
+/// \brief 16-way tree: 16 x 16 branches above 16 x 16 tiles; 4096 x 4096 byte-cells
+typedef GridTree<16, 2> GridTree16Layer;
+
+/// \brief 32-way tree: 32 x 32 branches above 32 x 32 tiles; 1024 x 1024 byte-cells
+typedef GridTree<32, 1> GridTree32Layer;
+
+} // namespace chartbox::layer
+
+#include "grid-tree.inl"
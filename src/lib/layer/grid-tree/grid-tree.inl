@@ -0,0 +1,92 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// NOTE: This is the template-class implementation -- which is included from the header file.
+
+#include <string>
+
+#include <Eigen/Geometry>
+#include <fmt/core.h>
+
+namespace chartbox::layer {
+
+template<size_t n, size_t depth, typename cell_t>
+GridTree<n,depth,cell_t>::GridTree( const Eigen::AlignedBox2d& _bounds )
+    : chartbox::ChartLayerInterface< cell_t, GridTree<n, depth, cell_t>>(_bounds)
+    , root_(default_value)
+{}
+
+template<size_t n, size_t depth, typename cell_t>
+bool GridTree<n,depth,cell_t>::fill( const cell_t value ){
+    root_.fill( value );
+    dirty_tiles_.mark_all();
+    return true;
+}
+
+template<size_t n, size_t depth, typename cell_t>
+cell_t GridTree<n,depth,cell_t>::get( const Eigen::Vector2d& p ) const {
+    if( (p.x() < 0) || (p.y() < 0) ){
+        return default_value;
+    }
+    const double scale = inverse_precision();
+    const uint32_t i = static_cast<uint32_t>( p.x()*scale );
+    const uint32_t j = static_cast<uint32_t>( p.y()*scale );
+    if( (dimension <= i) || (dimension <= j) ){
+        return default_value;
+    }
+    return root_.get( i, j );
+}
+
+template<size_t n, size_t depth, typename cell_t>
+double GridTree<n,depth,cell_t>::precision() const {
+    return width() / dimension;
+}
+
+template<size_t n, size_t depth, typename cell_t>
+void GridTree<n,depth,cell_t>::print_contents() const {
+    fmt::print( "============ ============ Grid-Tree-Layer Contents ============ ============\n" );
+    fmt::print( "    {}-way; {} levels; {} nodes\n", n, depth + 1, node_count() );
+    for( size_t j = dimension - 1; j < dimension; --j ){
+        for( size_t i = 0; i < dimension; ++i ){
+            const auto value = get( static_cast<uint32_t>(i), static_cast<uint32_t>(j) );
+            if( 0 == (i%8) ){
+                fmt::print(" ");
+            }
+            if( 0 < value ){
+                fmt::print(" {:2X}", static_cast<int>(value) );
+            }else{
+                fmt::print(" --");
+            }
+        }
+        if( 0 == (j%8) ){
+            fmt::print("\n");
+        }
+        fmt::print("\n");
+    }
+    fmt::print( "============ ============ ============ ============ ============ ============\n" );
+}
+
+template<size_t n, size_t depth, typename cell_t>
+void GridTree<n,depth,cell_t>::reset() {
+    fill( default_value );
+}
+
+template<size_t n, size_t depth, typename cell_t>
+bool GridTree<n,depth,cell_t>::store( const Eigen::Vector2d& p, const cell_t value ){
+    if( (p.x() < 0) || (p.y() < 0) ){
+        return false;
+    }
+    const double scale = inverse_precision();
+    const uint32_t i = static_cast<uint32_t>( p.x()*scale );
+    const uint32_t j = static_cast<uint32_t>( p.y()*scale );
+    if( (dimension <= i) || (dimension <= j) ){
+        return false;
+    }
+    return store( i, j, value );
+}
+
+template<size_t n, size_t depth, typename cell_t>
+std::string GridTree<n,depth,cell_t>::type() const {
+    return type_;
+}
+
+} // namespace chartbox::layer
@@ -0,0 +1,161 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include "layer/fixed-grid/fixed-grid.hpp"
+#include "layer/test-fixtures.hpp"
+
+#include "grid-tree.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+namespace chartbox::layer {
+
+// 4-way branches, two levels above 4x4 tiles: 64 x 64 cells
+typedef GridTree<4, 2> GridTree64;
+typedef FixedGrid< index::RowMajorIndex<64> > FixedGrid64;
+
+static const AlignedBox2d bounds( Vector2d(0,0), Vector2d(64,64) );
+
+// every shade the scattered boxes are written with
+static const std::vector<uint8_t> shades = { 0x00, 0x40, 0x80, 0xC0 };
+
+TEST( GridTree, Shape ){
+    EXPECT_EQ( GridTree64::dimension, 64 );
+    EXPECT_EQ( GridTree64::root_t::child_shift, 4 );
+    EXPECT_EQ( GridTree64::root_t::shift, 6 );
+    EXPECT_EQ( GridTree64::root_t::depth, 2 );
+
+    EXPECT_EQ( GridTree16Layer::dimension, 4096 );
+    EXPECT_EQ( GridTree16Layer::root_t::child_shift, 8 );
+    EXPECT_EQ( GridTree32Layer::dimension, 1024 );
+    EXPECT_EQ( GridTree32Layer::root_t::child_shift, 5 );
+
+    // no branches: a single tile
+    EXPECT_EQ( (GridTree<8, 0>::dimension), 8 );
+}
+
+TEST( GridTree, Construct ){
+    GridTree64 tree( bounds );
+    EXPECT_DOUBLE_EQ( tree.precision(), 1.0 );
+    EXPECT_EQ( tree.node_count(), 1 );
+    EXPECT_EQ( tree.get({3, 3}), GridTree64::default_value );
+    EXPECT_EQ( tree.get({-3, 3}), GridTree64::default_value );
+    EXPECT_EQ( tree.get({3, 64.5}), GridTree64::default_value );
+    EXPECT_EQ( tree.type(), "GridTreeLayer" );
+}
+
+TEST( GridTree, StoreSplitsThenCollapses ){
+    GridTree64 tree( bounds );
+    tree.fill( 0 );
+    const size_t empty_bytes = tree.memory_usage();
+
+    EXPECT_TRUE( tree.store( Vector2d(10.5, 20.5), 0x99 ) );
+    EXPECT_EQ( tree.get({10.5, 20.5}), 0x99 );
+    EXPECT_EQ( tree.get({11.5, 20.5}), 0 );
+    EXPECT_TRUE( tree.blocked( 10, 20 ) );
+    EXPECT_FALSE( tree.blocked( 11, 20 ) );
+    // the root's 16 children, and one branch's 16 tiles
+    EXPECT_EQ( tree.node_count(), 1 + 16 + 16 );
+
+    // writing it back collapses every level
+    EXPECT_TRUE( tree.store( Vector2d(10.5, 20.5), 0 ) );
+    EXPECT_EQ( tree.node_count(), 1 );
+    EXPECT_EQ( tree.memory_usage(), empty_bytes );
+
+    EXPECT_FALSE( tree.store( Vector2d(64.5, 3.5), 0x99 ) );
+    EXPECT_FALSE( tree.store( Vector2d(-0.5, 3.5), 0x99 ) );
+}
+
+TEST( GridTree, OverwriteCollapses ){
+    GridTree64 tree( bounds );
+    tree.fill( 0 );
+    scatter( tree, 2, 40, shades );
+    EXPECT_LT( 1, tree.node_count() );
+
+    // every cell written to a new value, one at a time: each tile, then each branch, collapses once it is uniform
+    for( uint32_t j = 0; j < GridTree64::dimension; ++j ){
+        for( uint32_t i = 0; i < GridTree64::dimension; ++i ){
+            tree.store( i, j, 0x33 );
+        }
+    }
+    EXPECT_EQ( tree.node_count(), 1 );
+    EXPECT_EQ( tree.get(63, 63), 0x33 );
+}
+
+TEST( GridTree, RecordsChangedWrites ){
+    GridTree64 tree( bounds );
+    EXPECT_EQ( tree.version(), 0 );
+    tree.fill( 0 );
+    uint64_t since = tree.version();
+    EXPECT_LT( 0, since );
+
+    // rewriting the same value is not a change; even inside a collapsed node
+    tree.store( {5.5, 5.5}, 0 );
+    EXPECT_EQ( tree.version(), since );
+
+    // ... but writing a new value is; through either store
+    std::vector<AlignedBox2d> areas;
+    EXPECT_TRUE( tree.store( {5.5, 5.5}, 0x99 ) );
+    EXPECT_LT( since, tree.version() );
+    tree.collect_changes( since, areas );
+    ASSERT_EQ( areas.size(), 1 );
+    EXPECT_TRUE( areas[0].isApprox(AlignedBox2d(Vector2d(4, 4), Vector2d(8, 8))) );
+    tree.store( 5, 5, 0 );
+    areas.clear();
+    tree.collect_changes( since, areas );
+    EXPECT_EQ( areas.size(), 1 );
+
+    // changes are tracked per 4x4 tile
+    tree.fill( AlignedBox2d(Vector2d(10, 20), Vector2d(14, 22)), 0x99 );
+    areas.clear();
+    tree.collect_changes( since, areas );
+    EXPECT_EQ( since, tree.version() );
+    ASSERT_EQ( areas.size(), 1 );
+    EXPECT_TRUE( areas[0].isApprox(AlignedBox2d(Vector2d(8, 20), Vector2d(16, 24))) );
+
+    // a store which collapses the tree is still a change
+    tree.fill( AlignedBox2d(Vector2d(10, 20), Vector2d(14, 22)), 0 );
+    EXPECT_EQ( tree.node_count(), 1 );
+    areas.clear();
+    tree.collect_changes( since, areas );
+    ASSERT_EQ( areas.size(), 1 );
+    EXPECT_TRUE( areas[0].isApprox(AlignedBox2d(Vector2d(8, 20), Vector2d(16, 24))) );
+}
+
+TEST( GridTree, MatchesFixedGrid ){
+    for( uint32_t seed = 1; seed < 6; ++seed ){
+        GridTree64 tree( bounds );
+        FixedGrid64 grid( bounds );
+        scatter( tree, seed, 24, shades );
+        scatter( grid, seed, 24, shades );
+
+        for( uint32_t j = 0; j < GridTree64::dimension; ++j ){
+            for( uint32_t i = 0; i < GridTree64::dimension; ++i ){
+                ASSERT_EQ( tree.get(i, j), grid.data()[ grid.lookup(i, j) ] ) << "    @@ seed: " << seed << " (" << i << ", " << j << ")";
+            }
+        }
+        EXPECT_LT( tree.node_count(), 1 + 16 + 256 );
+    }
+}
+
+TEST( GridTree, FloatCells ){
+    GridTree<8, 1, float> tree( bounds );
+    tree.fill( 4.5f );
+    EXPECT_TRUE( tree.fill( AlignedBox2d(Vector2d(0,0), Vector2d(20,13)), -2.25f ) );
+    EXPECT_FLOAT_EQ( tree.get({3, 3}), -2.25f );
+    EXPECT_FLOAT_EQ( tree.get({30, 3}), 4.5f );
+
+    // aligned to whole tiles: no tile is split
+    tree.fill( 4.5f );
+    EXPECT_TRUE( tree.fill( AlignedBox2d(Vector2d(0,0), Vector2d(16,16)), -2.25f ) );
+    EXPECT_EQ( tree.node_count(), 1 + 64 );
+    EXPECT_EQ( tree.memory_usage(), sizeof(GridTree<8, 1, float>::root_t) + 64 * sizeof(node::TileNode<float, 8>) );
+}
+
+} // namespace chartbox::layer
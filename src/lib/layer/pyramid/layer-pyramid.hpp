@@ -0,0 +1,124 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+namespace chartbox::layer {
+
+/// \brief describes the contents of a region, as answered by the coarse levels of a `LayerPyramid`
+enum RegionStatus : uint8_t {
+    Clear=0,     // every cell in the region is below the blocking threshold
+    Blocked=1,   // every cell in the region is at-or-above the blocking threshold
+    Partial=2,   // the region contains both clear and blocked cells
+};
+
+/// \brief Multi-resolution (mip-map) pyramid of min/max-pooled copies of a grid layer
+///
+/// Level 0 is the source layer itself.  Each subsequent level halves the dimension; each of its cells
+/// holds the minimum and maximum of the 2x2 cells beneath it -- i.e. max-pooling for occupancy, and a
+/// min/max envelope for depths.  A coarse cell is uniform iff its minimum equals its maximum.
+///
+/// Writes made through the pyramid (`store`, `fill`) propagate upwards immediately, touching only the
+/// ancestors of the modified cells.  Writes made directly to the source layer are read back from the layer's
+/// own change-tracking (`collect_changes(...)`), and are propagated by the next `update()`.
+template<typename layer_t>
+class LayerPyramid {
+public:
+    typedef typename layer_t::cell_t cell_t;
+
+    LayerPyramid() = delete;
+
+    /// \brief allocates, and builds, the pyramid above the given layer
+    LayerPyramid( layer_t& layer );
+
+    /// \brief (re)compute every level from the source layer
+    ///
+    /// \param thread_count - split each level's rows across this many threads
+    void build( size_t thread_count = std::thread::hardware_concurrency() );
+
+    /// \brief write through to the source layer, and update the affected coarse cells
+    bool store( const Eigen::Vector2d& point, const cell_t value );
+
+    /// \brief fill an area of the source layer, and update the affected coarse cells
+    bool fill( const Eigen::AlignedBox2d& area, const cell_t value );
+
+    /// \brief record that the source layer was modified within the given area
+    /// \note only needed for writes the layer does not track itself; e.g. through `data()`
+    void mark_dirty( const Eigen::AlignedBox2d& area );
+
+    /// \brief propagate every change to the source layer -- since the last update -- up through the pyramid
+    void update();
+
+    /// \brief number of levels, including the source layer (level 0)
+    inline size_t levels() const { return dimensions_.size(); }
+
+    /// \brief the number of cells along each side, at the given level
+    inline size_t dimension( const size_t level ) const { return dimensions_[level]; }
+
+    /// \brief width of one cell at the given level, in real-world units
+    inline double precision( const size_t level ) const { return layer_.precision() * (1 << level); }
+
+    /// \brief largest value of any source-cell beneath this cell
+    cell_t maximum( const size_t level, const uint32_t i, const uint32_t j ) const;
+
+    /// \brief smallest value of any source-cell beneath this cell
+    cell_t minimum( const size_t level, const uint32_t i, const uint32_t j ) const;
+
+    /// \brief test if every source-cell beneath this cell has the same value
+    inline bool uniform( const size_t level, const uint32_t i, const uint32_t j ) const {
+        return minimum(level, i, j) == maximum(level, i, j); }
+
+    /// \brief Classify the given region, descending only into the coarse cells which are mixed.
+    ///
+    /// \param area - region to test, in the layer's frame. Clipped to the layer's bounds.
+    /// \return Clear / Blocked / Partial; areas entirely outside the layer are classified by its `default_value`
+    RegionStatus classify( const Eigen::AlignedBox2d& area ) const;
+
+    /// \brief minimum and maximum value within the given region; with early-outs on uniform coarse cells
+    ///
+    /// \return false if the area does not overlap the layer
+    bool range( const Eigen::AlignedBox2d& area, cell_t& low, cell_t& high ) const;
+
+private:
+    struct Level {
+        std::vector<cell_t> minimum;
+        std::vector<cell_t> maximum;
+
+        /// one flag per cell; plus a list of the set flags
+        std::vector<uint8_t> dirty;
+        std::vector<uint32_t> dirty_cells;
+    };
+
+    /// \brief clip the area to the layer, as inclusive cell indices at level 0
+    bool clip( const Eigen::AlignedBox2d& area, uint32_t& i_min, uint32_t& j_min, uint32_t& i_max, uint32_t& j_max ) const;
+
+    /// \brief recompute one cell at the given level (>0) from the level beneath it
+    void pool( const size_t level, const uint32_t i, const uint32_t j );
+
+    /// \brief recursive step of `range(...)`
+    void descend( const size_t level, const uint32_t i, const uint32_t j,
+                  const uint32_t i_min, const uint32_t j_min, const uint32_t i_max, const uint32_t j_max,
+                  cell_t& low, cell_t& high ) const;
+
+private:
+    layer_t& layer_;
+
+    std::vector<size_t> dimensions_;
+
+    /// \brief levels_[0] describes level 1, etc.  (level 0 is stored in the source layer)
+    std::vector<Level> levels_;
+
+    /// \brief the source layer's version, as of the last change propagated into the pyramid
+    uint64_t version_ = 0;
+
+}; // class LayerPyramid
+
+} // namespace chartbox::layer
+
+#include "layer-pyramid.inl"
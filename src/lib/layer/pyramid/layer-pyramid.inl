@@ -0,0 +1,296 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// NOTE: This is the template-class implementation -- which is included from the header file.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+namespace chartbox::layer {
+
+template<typename layer_t>
+LayerPyramid<layer_t>::LayerPyramid( layer_t& layer )
+    : layer_(layer)
+{
+    static_assert( 0 == (layer_t::dimension & (layer_t::dimension - 1)), "Layer dimension must be a power of two!" );
+
+    for( size_t dimension = layer_t::dimension; 0 < dimension; dimension /= 2 ){
+        dimensions_.push_back( dimension );
+    }
+
+    levels_.resize( dimensions_.size() - 1 );
+    for( size_t level = 1; level < dimensions_.size(); ++level ){
+        const size_t cell_count = dimensions_[level] * dimensions_[level];
+        Level& each = levels_[level - 1];
+        each.minimum.resize( cell_count );
+        each.maximum.resize( cell_count );
+        each.dirty.resize( cell_count, 0 );
+    }
+
+    build();
+}
+
+template<typename layer_t>
+void LayerPyramid<layer_t>::build( size_t thread_count ){
+    // not worth spawning a thread for fewer rows than this
+    constexpr size_t minimum_rows_per_thread = 32;
+
+    thread_count = std::max<size_t>( 1, thread_count );
+    version_ = layer_.version();
+
+    for( size_t level = 1; level < dimensions_.size(); ++level ){
+        const uint32_t dimension = dimensions_[level];
+        const size_t workers = std::min( thread_count, std::max<size_t>(1, dimension / minimum_rows_per_thread) );
+
+        auto pool_rows = [this, level, dimension]( const uint32_t j_begin, const uint32_t j_end ){
+            for( uint32_t j = j_begin; j < j_end; ++j ){
+                for( uint32_t i = 0; i < dimension; ++i ){
+                    pool( level, i, j );
+                }
+            }
+        };
+
+        if( 1 == workers ){
+            pool_rows( 0, dimension );
+        }else{
+            // each level depends on the one beneath it; so only the rows of one level are split
+            std::vector<std::thread> threads;
+            const uint32_t band = (dimension + workers - 1) / workers;
+            for( uint32_t j_begin = 0; j_begin < dimension; j_begin += band ){
+                threads.emplace_back( pool_rows, j_begin, std::min<uint32_t>(j_begin + band, dimension) );
+            }
+            for( auto& thread : threads ){
+                thread.join();
+            }
+        }
+
+        Level& each = levels_[level - 1];
+        std::fill( each.dirty.begin(), each.dirty.end(), 0 );
+        each.dirty_cells.clear();
+    }
+}
+
+template<typename layer_t>
+bool LayerPyramid<layer_t>::clip( const Eigen::AlignedBox2d& area, uint32_t& i_min, uint32_t& j_min, uint32_t& i_max, uint32_t& j_max ) const {
+    const double precision = layer_.precision();
+    const double dimension = static_cast<double>(layer_t::dimension);
+
+    const double x_min = std::floor( area.min().x() / precision );
+    const double y_min = std::floor( area.min().y() / precision );
+    // cells starting exactly on the maximum edge are excluded; but never clip a degenerate area to nothing
+    const double x_max = std::max( x_min, std::ceil(area.max().x() / precision) - 1 );
+    const double y_max = std::max( y_min, std::ceil(area.max().y() / precision) - 1 );
+
+    if( area.isEmpty() || (x_max < 0) || (y_max < 0) || (dimension <= x_min) || (dimension <= y_min) ){
+        return false;
+    }
+
+    i_min = static_cast<uint32_t>( std::max( 0.0, x_min ) );
+    j_min = static_cast<uint32_t>( std::max( 0.0, y_min ) );
+    i_max = static_cast<uint32_t>( std::min( dimension - 1, x_max ) );
+    j_max = static_cast<uint32_t>( std::min( dimension - 1, y_max ) );
+    return true;
+}
+
+template<typename layer_t>
+bool LayerPyramid<layer_t>::fill( const Eigen::AlignedBox2d& area, const cell_t value ){
+    if( ! layer_.fill( area, value ) ){
+        return false;
+    }
+    update();
+    return true;
+}
+
+template<typename layer_t>
+void LayerPyramid<layer_t>::mark_dirty( const Eigen::AlignedBox2d& area ){
+    uint32_t i_min, j_min, i_max, j_max;
+    if( levels_.empty() || ! clip( area, i_min, j_min, i_max, j_max ) ){
+        return;
+    }
+
+    // mark the level-1 parents; `update()` carries the marks upward from there
+    Level& first = levels_[0];
+    const uint32_t dimension = dimensions_[1];
+    for( uint32_t j = (j_min >> 1); j <= (j_max >> 1); ++j ){
+        for( uint32_t i = (i_min >> 1); i <= (i_max >> 1); ++i ){
+            const uint32_t offset = i + j * dimension;
+            if( 0 == first.dirty[offset] ){
+                first.dirty[offset] = 1;
+                first.dirty_cells.push_back( offset );
+            }
+        }
+    }
+}
+
+template<typename layer_t>
+typename LayerPyramid<layer_t>::cell_t LayerPyramid<layer_t>::maximum( const size_t level, const uint32_t i, const uint32_t j ) const {
+    if( 0 == level ){
+        return layer_.data()[ layer_.lookup(i, j) ];
+    }
+    return levels_[level - 1].maximum[ i + j * dimensions_[level] ];
+}
+
+template<typename layer_t>
+typename LayerPyramid<layer_t>::cell_t LayerPyramid<layer_t>::minimum( const size_t level, const uint32_t i, const uint32_t j ) const {
+    if( 0 == level ){
+        return layer_.data()[ layer_.lookup(i, j) ];
+    }
+    return levels_[level - 1].minimum[ i + j * dimensions_[level] ];
+}
+
+template<typename layer_t>
+void LayerPyramid<layer_t>::pool( const size_t level, const uint32_t i, const uint32_t j ){
+    const uint32_t i0 = 2 * i;
+    const uint32_t j0 = 2 * j;
+
+    Level& sink = levels_[level - 1];
+    const uint32_t offset = i + j * dimensions_[level];
+
+    sink.minimum[offset] = std::min( std::min( minimum(level - 1, i0, j0),     minimum(level - 1, i0 + 1, j0) ),
+                                     std::min( minimum(level - 1, i0, j0 + 1), minimum(level - 1, i0 + 1, j0 + 1) ) );
+    sink.maximum[offset] = std::max( std::max( maximum(level - 1, i0, j0),     maximum(level - 1, i0 + 1, j0) ),
+                                     std::max( maximum(level - 1, i0, j0 + 1), maximum(level - 1, i0 + 1, j0 + 1) ) );
+}
+
+template<typename layer_t>
+bool LayerPyramid<layer_t>::range( const Eigen::AlignedBox2d& area, cell_t& low, cell_t& high ) const {
+    uint32_t i_min, j_min, i_max, j_max;
+    if( ! clip( area, i_min, j_min, i_max, j_max ) ){
+        return false;
+    }
+
+    low = std::numeric_limits<cell_t>::max();
+    high = std::numeric_limits<cell_t>::lowest();
+    descend( levels() - 1, 0, 0, i_min, j_min, i_max, j_max, low, high );
+    return true;
+}
+
+template<typename layer_t>
+RegionStatus LayerPyramid<layer_t>::classify( const Eigen::AlignedBox2d& area ) const {
+    cell_t low, high;
+    if( ! range( area, low, high ) ){
+        return ( layer_t::default_value < layer_t::blocking_threshold ) ? Clear : Blocked;
+    }else if( high < layer_t::blocking_threshold ){
+        return Clear;
+    }else if( layer_t::blocking_threshold <= low ){
+        return Blocked;
+    }
+    return Partial;
+}
+
+template<typename layer_t>
+void LayerPyramid<layer_t>::descend( const size_t level, const uint32_t i, const uint32_t j,
+                                     const uint32_t i_min, const uint32_t j_min, const uint32_t i_max, const uint32_t j_max,
+                                     cell_t& low, cell_t& high ) const
+{
+    // extent of this cell, in level-0 indices (inclusive)
+    const uint32_t ci_min = i << level;
+    const uint32_t cj_min = j << level;
+    const uint32_t ci_max = ci_min + (1 << level) - 1;
+    const uint32_t cj_max = cj_min + (1 << level) - 1;
+
+    if( (ci_max < i_min) || (i_max < ci_min) || (cj_max < j_min) || (j_max < cj_min) ){
+        return;
+    }
+
+    const cell_t cell_min = minimum( level, i, j );
+    const cell_t cell_max = maximum( level, i, j );
+
+    // nothing beneath this cell can widen the current range
+    if( (low <= cell_min) && (cell_max <= high) ){
+        return;
+    }
+
+    const bool contained = (i_min <= ci_min) && (ci_max <= i_max) && (j_min <= cj_min) && (cj_max <= j_max);
+    if( contained || (cell_min == cell_max) ){
+        low = std::min( low, cell_min );
+        high = std::max( high, cell_max );
+        return;
+    }
+
+    for( uint32_t dj = 0; dj < 2; ++dj ){
+        for( uint32_t di = 0; di < 2; ++di ){
+            descend( level - 1, 2 * i + di, 2 * j + dj, i_min, j_min, i_max, j_max, low, high );
+        }
+    }
+}
+
+template<typename layer_t>
+bool LayerPyramid<layer_t>::store( const Eigen::Vector2d& point, const cell_t value ){
+    const double precision = layer_.precision();
+    const double x = point.x() / precision;
+    const double y = point.y() / precision;
+    if( (x < 0) || (layer_t::dimension <= x) || (y < 0) || (layer_t::dimension <= y) ){
+        return false;
+    }
+
+    // if nothing else is pending, the pyramid is still current after propagating this write
+    const bool current = ( version_ == layer_.version() );
+    if( ! layer_.store( point, value ) ){
+        return false;
+    }
+    if( current ){
+        version_ = layer_.version();
+    }
+
+    // walk straight up the ancestors; stop as soon as a level is unchanged
+    uint32_t i = static_cast<uint32_t>(x);
+    uint32_t j = static_cast<uint32_t>(y);
+    for( size_t level = 1; level < dimensions_.size(); ++level ){
+        i >>= 1;
+        j >>= 1;
+        const uint32_t offset = i + j * dimensions_[level];
+        const Level& each = levels_[level - 1];
+        const cell_t previous_min = each.minimum[offset];
+        const cell_t previous_max = each.maximum[offset];
+        pool( level, i, j );
+        if( (previous_min == each.minimum[offset]) && (previous_max == each.maximum[offset]) ){
+            break;
+        }
+    }
+    return true;
+}
+
+template<typename layer_t>
+void LayerPyramid<layer_t>::update(){
+    std::vector<Eigen::AlignedBox2d> areas;
+    layer_.collect_changes( version_, areas );
+    for( const auto& area : areas ){
+        mark_dirty( area );
+    }
+
+    for( size_t level = 1; level < dimensions_.size(); ++level ){
+        Level& each = levels_[level - 1];
+        if( each.dirty_cells.empty() ){
+            continue;
+        }
+
+        const uint32_t dimension = dimensions_[level];
+        Level* parent = ( level + 1 < dimensions_.size() ) ? &levels_[level] : nullptr;
+        for( const uint32_t offset : each.dirty_cells ){
+            const uint32_t i = offset % dimension;
+            const uint32_t j = offset / dimension;
+            each.dirty[offset] = 0;
+
+            const cell_t previous_min = each.minimum[offset];
+            const cell_t previous_max = each.maximum[offset];
+            pool( level, i, j );
+            const bool changed = (previous_min != each.minimum[offset]) || (previous_max != each.maximum[offset]);
+
+            if( changed && (nullptr != parent) ){
+                const uint32_t parent_offset = (i >> 1) + (j >> 1) * dimensions_[level + 1];
+                if( 0 == parent->dirty[parent_offset] ){
+                    parent->dirty[parent_offset] = 1;
+                    parent->dirty_cells.push_back( parent_offset );
+                }
+            }
+        }
+        each.dirty_cells.clear();
+    }
+}
+
+} // namespace chartbox::layer
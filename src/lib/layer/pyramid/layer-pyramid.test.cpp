@@ -0,0 +1,188 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <algorithm>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include "layer/fixed-grid/fixed-grid.hpp"
+
+#include "layer-pyramid.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+using chartbox::layer::FixedGridLayer;
+
+namespace chartbox::layer {
+
+static const AlignedBox2d bounds( Vector2d(0,0), Vector2d(128,128) );
+
+// brute-force reference for `LayerPyramid::range`
+static void scan( const FixedGridLayer& layer, uint32_t i_min, uint32_t j_min, uint32_t i_max, uint32_t j_max, uint8_t& low, uint8_t& high ){
+    low = 0xff;
+    high = 0;
+    for( uint32_t j = j_min; j <= j_max; ++j ){
+        for( uint32_t i = i_min; i <= i_max; ++i ){
+            low = std::min( low, layer.data()[layer.lookup(i,j)] );
+            high = std::max( high, layer.data()[layer.lookup(i,j)] );
+        }
+    }
+}
+
+TEST( LayerPyramid, BuildLevels ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    layer.store( {37.5, 90.5}, 0x99 );
+
+    LayerPyramid<FixedGridLayer> pyramid( layer );
+    ASSERT_EQ( pyramid.levels(), 8 );
+    EXPECT_EQ( pyramid.dimension(0), 128 );
+    EXPECT_EQ( pyramid.dimension(7), 1 );
+    EXPECT_DOUBLE_EQ( pyramid.precision(3), 8.0 );
+
+    // the single obstacle shows up in exactly one cell per level
+    for( size_t level = 0; level < pyramid.levels(); ++level ){
+        const uint32_t i = 37 >> level;
+        const uint32_t j = 90 >> level;
+        EXPECT_EQ( pyramid.maximum(level, i, j), 0x99 );
+        EXPECT_EQ( pyramid.minimum(level, i, j), ((0 == level) ? 0x99 : 0x00) );
+        EXPECT_EQ( pyramid.uniform(level, i, j), (0 == level) );
+    }
+    EXPECT_TRUE( pyramid.uniform(1, 0, 0) );
+    EXPECT_EQ( pyramid.maximum(1, 0, 0), 0 );
+}
+
+TEST( LayerPyramid, StorePropagates ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    LayerPyramid<FixedGridLayer> pyramid( layer );
+
+    EXPECT_EQ( pyramid.classify( bounds ), Clear );
+
+    ASSERT_TRUE( pyramid.store( {100.5, 3.5}, 0x99 ) );
+    EXPECT_EQ( layer.get({100.5, 3.5}), 0x99 );
+    EXPECT_EQ( pyramid.maximum(7, 0, 0), 0x99 );
+    EXPECT_EQ( pyramid.classify( bounds ), Partial );
+    EXPECT_EQ( pyramid.classify( AlignedBox2d(Vector2d(0,0), Vector2d(100,128)) ), Clear );
+    EXPECT_EQ( pyramid.classify( AlignedBox2d(Vector2d(100,3), Vector2d(101,4)) ), Blocked );
+
+    // ... and clearing it again
+    ASSERT_TRUE( pyramid.store( {100.5, 3.5}, FixedGridLayer::clear_value ) );
+    EXPECT_EQ( pyramid.maximum(7, 0, 0), 0 );
+    EXPECT_EQ( pyramid.classify( bounds ), Clear );
+
+    EXPECT_FALSE( pyramid.store( {-1, 3.5}, 0x99 ) );
+    EXPECT_FALSE( pyramid.store( {3.5, 128.5}, 0x99 ) );
+}
+
+TEST( LayerPyramid, FillAndMarkDirty ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    LayerPyramid<FixedGridLayer> pyramid( layer );
+
+    const AlignedBox2d block( Vector2d(32, 32), Vector2d(64, 64) );
+    ASSERT_TRUE( pyramid.fill( block, 0x99 ) );
+    EXPECT_TRUE( pyramid.uniform(5, 1, 1) );
+    EXPECT_EQ( pyramid.maximum(5, 1, 1), 0x99 );
+    EXPECT_EQ( pyramid.classify( block ), Blocked );
+
+    // writes made directly to the layer are only visible after `update()`; which reads the layer's changes
+    const AlignedBox2d corner( Vector2d(120, 120), Vector2d(124, 122) );
+    layer.fill( corner, 0x42 );
+    layer.store( {2.5, 126.5}, 0x42 );
+    EXPECT_EQ( pyramid.maximum(1, 60, 60), 0 );
+    pyramid.update();
+    EXPECT_EQ( pyramid.maximum(1, 60, 60), 0x42 );
+    EXPECT_EQ( pyramid.maximum(2, 30, 30), 0x42 );
+    EXPECT_EQ( pyramid.maximum(1, 1, 63), 0x42 );
+    EXPECT_EQ( pyramid.classify( corner ), Blocked );
+    EXPECT_EQ( pyramid.classify( AlignedBox2d(Vector2d(110, 110), Vector2d(128, 128)) ), Partial );
+
+    // ... except writes through `data()`, which the layer can't see
+    layer.data()[ layer.lookup(5, 5) ] = 0x42;
+    pyramid.update();
+    EXPECT_EQ( pyramid.maximum(1, 2, 2), 0 );
+    pyramid.mark_dirty( AlignedBox2d(Vector2d(5, 5), Vector2d(6, 6)) );
+    pyramid.update();
+    EXPECT_EQ( pyramid.maximum(1, 2, 2), 0x42 );
+}
+
+TEST( LayerPyramid, ClassifyOutsideLayer ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    LayerPyramid<FixedGridLayer> pyramid( layer );
+
+    // outside the layer is the layer's default: blocked
+    EXPECT_EQ( pyramid.classify( AlignedBox2d(Vector2d(200, 200), Vector2d(300, 300)) ), Blocked );
+    EXPECT_EQ( pyramid.classify( AlignedBox2d(Vector2d(-10, 0), Vector2d(-1, 128)) ), Blocked );
+    // partially-outside areas are clipped
+    EXPECT_EQ( pyramid.classify( AlignedBox2d(Vector2d(-10, -10), Vector2d(10, 10)) ), Clear );
+}
+
+TEST( LayerPyramid, RangeMatchesBruteForce ){
+    std::mt19937 generator(17);
+    std::uniform_int_distribution<uint32_t> index( 0, 127 );
+    std::uniform_int_distribution<int> value( 0, 255 );
+
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    // sparse blobs of data, so that many coarse cells are uniform
+    for( size_t blob = 0; blob < 30; ++blob ){
+        const double x = index(generator);
+        const double y = index(generator);
+        layer.fill( AlignedBox2d(Vector2d(x, y), Vector2d(x + 5, y + 3)), static_cast<uint8_t>(value(generator)) );
+    }
+
+    LayerPyramid<FixedGridLayer> pyramid( layer );
+    // exercise incremental updates as well as the initial build
+    for( size_t write = 0; write < 200; ++write ){
+        pyramid.store( Vector2d(index(generator) + 0.5, index(generator) + 0.5), static_cast<uint8_t>(value(generator)) );
+    }
+
+    for( size_t trial = 0; trial < 500; ++trial ){
+        uint32_t i0 = index(generator), i1 = index(generator);
+        uint32_t j0 = index(generator), j1 = index(generator);
+        if( i1 < i0 ){ std::swap(i0, i1); }
+        if( j1 < j0 ){ std::swap(j0, j1); }
+
+        uint8_t expected_low, expected_high;
+        scan( layer, i0, j0, i1, j1, expected_low, expected_high );
+
+        uint8_t low, high;
+        ASSERT_TRUE( pyramid.range( AlignedBox2d(Vector2d(i0, j0), Vector2d(i1 + 1, j1 + 1)), low, high ) );
+        ASSERT_EQ( low, expected_low ) << "    @ [" << i0 << ", " << j0 << "] => [" << i1 << ", " << j1 << "]";
+        ASSERT_EQ( high, expected_high ) << "    @ [" << i0 << ", " << j0 << "] => [" << i1 << ", " << j1 << "]";
+    }
+
+    uint8_t low, high;
+    EXPECT_FALSE( pyramid.range( AlignedBox2d(Vector2d(200, 200), Vector2d(300, 300)), low, high ) );
+}
+
+TEST( LayerPyramid, ThreadedBuildMatchesSerial ){
+    std::mt19937 generator(3);
+    std::uniform_int_distribution<int> value( 0, 255 );
+
+    FixedGridLayer layer( bounds );
+    for( size_t offset = 0; offset < FixedGridLayer::dimension * FixedGridLayer::dimension; ++offset ){
+        layer.data()[offset] = static_cast<uint8_t>(value(generator));
+    }
+
+    LayerPyramid<FixedGridLayer> serial( layer );
+    serial.build( 1 );
+    LayerPyramid<FixedGridLayer> threaded( layer );
+    threaded.build( 4 );
+
+    for( size_t level = 1; level < serial.levels(); ++level ){
+        for( uint32_t j = 0; j < serial.dimension(level); ++j ){
+            for( uint32_t i = 0; i < serial.dimension(level); ++i ){
+                ASSERT_EQ( serial.minimum(level, i, j), threaded.minimum(level, i, j) );
+                ASSERT_EQ( serial.maximum(level, i, j), threaded.maximum(level, i, j) );
+            }
+        }
+    }
+}
+
+} // namespace chartbox::layer
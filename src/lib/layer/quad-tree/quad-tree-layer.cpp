@@ -0,0 +1,13 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <cstdint>
+
+#include "quad-tree-layer.hpp"
+
+namespace chartbox::layer {
+
+// stock dimensions; others are instantiated on-demand, from the header
+template class QuadTree<QuadTreeLayer::dimension>;
+template class QuadTree<1024>;
+
+} // namespace chartbox::layer
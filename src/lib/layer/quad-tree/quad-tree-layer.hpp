@@ -0,0 +1,282 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include "chart-box/chart-layer-interface.hpp"
+#include "index/dirty-tiles.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+
+namespace chartbox::layer {
+
+/// \brief region quadtree over a square grid of cells; uniform regions are stored as a single leaf
+///
+/// Nodes live in one flat pool, rather than behind per-node pointers.  The four children of a node are
+/// stored consecutively, in z-order -- quadrant `q` covers bit 0 of `q` in `i`, and bit 1 in `j` -- so a
+/// lookup descends by integer shifts of the cell index alone.
+///
+/// The tree is kept pruned: `store(...)` splits leaves on the way down, and collapses four equal leaves
+/// on the way back up.  Freed groups of children are recycled by later splits.
+///
+/// \param dimension_ - number of cells along each side; a power of two
+/// \param cell_t_ - cell type
+template<size_t dimension_, typename cell_t_ = uint8_t>
+class QuadTree : public chartbox::ChartLayerInterface< cell_t_, QuadTree<dimension_, cell_t_>> {
+public:
+    typedef cell_t_ cell_t;
+
+    /// \brief number of cells along each dimension of this tree
+    constexpr static size_t dimension = dimension_;
+
+    /// \brief number of levels below the root; leaves at this depth are single cells
+    constexpr static uint32_t height = [](){
+        uint32_t levels = 0;
+        while( (size_t(1) << levels) < dimension_ ){ ++levels; }
+        return levels; }();
+
+    constexpr static cell_t default_value = CellTraits<cell_t>::default_value;
+    constexpr static cell_t blocking_threshold = CellTraits<cell_t>::blocking_threshold;
+
+    /// \brief while building from a grid, blocks this wide are tested for uniformity in one pass
+    constexpr static uint32_t block_size = ( 16 < dimension ) ? 16 : dimension;
+
+    /// \brief level of the nodes which cover one `block_size`-wide block
+    constexpr static uint32_t block_height = ( 4 < height ) ? 4 : height;
+
+    /// \brief leading bytes of the binary encoding; see `write(...)`
+    constexpr static char magic[4] = { 'C', 'B', 'Q', 'T' };
+    constexpr static uint8_t encoding_version = 1;
+
+    /// \brief one node of the tree; a leaf iff `first_child` is zero -- which is always the root
+    struct Node {
+        uint32_t first_child;
+        cell_t value;
+    };
+
+public:
+    QuadTree() = delete;
+
+    /// \brief construct a tree covering the given bounds; initially a single leaf of `default_value`
+    QuadTree( const Eigen::AlignedBox2d& _bounds );
+
+    /// \brief construct a pruned tree with the same contents as a grid, in one bottom-up pass
+    ///
+    /// Each `block_size`-wide block of the grid is tested for uniformity in one pass (16 bytes at a time,
+    /// where SSE2 is available), and four equal siblings are merged before their parent is written; so only
+    /// the nodes of the final tree are ever allocated.  Independent quadrants are built concurrently.
+    ///
+    /// \param _bounds - bounds of this tree; normally the same bounds as the grid
+    /// \param source - grid to copy; of the same dimension and cell type as this tree
+    /// \param thread_count - build up to this many subtrees at once
+    template<typename index_t>
+    QuadTree( const Eigen::AlignedBox2d& _bounds, const FixedGrid<index_t, cell_t>& source,
+              size_t thread_count = std::thread::hardware_concurrency() );
+
+    // override from ChartLayerInterface
+    bool fill( const cell_t value );
+
+    bool fill( const Eigen::AlignedBox2d& area, const cell_t value ){
+        return super().fill( area, value ); }
+
+    bool fill( std::unique_ptr<OGRPolygon> source, cell_t value ){
+        return super().fill( std::move(source), value ); }
+
+    cell_t get( const Eigen::Vector2d& p ) const;
+
+    /// \warning does not check bounds
+    cell_t get( const uint32_t i, const uint32_t j ) const;
+
+    /// \warning does not check bounds
+    inline cell_t get( const index::Index2u& cell ) const {
+        return get( cell.i, cell.j ); }
+
+    inline bool blocked( const uint32_t i, const uint32_t j ) const {
+        return ( blocking_threshold <= get(i, j) ); }
+
+    /// \brief number of nodes in the tree -- both leaves and branches
+    inline size_t node_count() const { return nodes_.size() - 4*free_.size(); }
+
+    size_t leaf_count() const;
+
+    /// \brief bytes held by the node pool; including recycled groups
+    inline size_t memory_usage() const { return nodes_.capacity() * sizeof(Node); }
+
+    inline const std::vector<Node>& nodes() const { return nodes_; }
+
+    double precision() const;
+
+    /// \brief override from ChartLayerInterface: cells per unit of distance
+    inline double inverse_precision() const { return dimension / width(); }
+
+    /// \brief Draws a simple debug representation of this tree to stderr
+    void print_contents() const;
+
+    /// \brief version of the most recent write; increases with every write which changes a cell
+    inline uint64_t version() const { return dirty_tiles_.version(); }
+
+    /// \brief Collect the areas modified since a given version; and advance that version to the current one
+    ///
+    /// Changes are tracked per 16 x 16 tile of cells; so each area is a run of whole tiles.
+    ///
+    /// \param since - in: the version this consumer last processed; out: the current version
+    /// \param areas - appended with the modified areas, in the layer's frame
+    void collect_changes( uint64_t& since, std::vector<Eigen::AlignedBox2d>& areas ) const {
+        dirty_tiles_.changed_since( since, precision(), areas );
+        since = dirty_tiles_.version(); }
+
+    void reset();
+
+    bool store( const Eigen::Vector2d& p, const cell_t value );
+
+    /// \warning does not check bounds
+    bool store( const uint32_t i, const uint32_t j, const cell_t value );
+
+    /// \warning does not check bounds
+    inline bool store( const index::Index2u& cell, const cell_t value ){
+        return store( cell.i, cell.j, value ); }
+
+    /// \brief Write this tree in a compact binary encoding
+    ///
+    /// The encoding is a short header; then one flag bit per node, in pre-order -- set for a branch -- and then
+    /// the leaf values, packed in the same order.  A mixed block whose subtree would take more space than its
+    /// cells is flagged by a second bit, and its `block_size` x `block_size` cells are written (row-major) in
+    /// place of its leaves.  Values are written in host byte order.
+    bool write( std::ostream& sink ) const;
+
+    /// \brief Replace this tree with one read from the encoding of `write(...)`
+    ///
+    /// The stream is read front-to-back, once; and the tree is built as it is read, bottom-up, without an
+    /// intermediate document.
+    /// \return false if the stream is truncated, malformed, or encodes another dimension or cell type; in which
+    ///         case this tree is unchanged
+    bool load( std::istream& source );
+
+    std::string type() const;
+
+    inline double width() const { return this->bounds_.sizes().maxCoeff(); }
+
+private:
+    /// \brief build the subtree over cells [i0, i0+size) x [j0, j0+size) of `cells`
+    ///
+    /// Branches are appended to `pool`; the subtree's root is returned, rather than appended -- so that
+    /// the caller may merge it into its parent.
+    template<typename index_t>
+    static Node build( const cell_t* cells, const uint32_t i0, const uint32_t j0, const uint32_t size, std::vector<Node>& pool );
+
+    /// \brief merge four sibling nodes into one leaf, if they are equal leaves; else append them to the pool
+    static Node join( const Node* children, std::vector<Node>& pool );
+
+    /// \brief append a subtree built into a separate pool, whose slot 0 is unused
+    Node splice( const Node root, const std::vector<Node>& pool );
+
+    /// \brief an encoding, as it is written: flag bits, packed least-significant bit first; and cell values
+    struct Encoder {
+        std::vector<uint8_t> flags;
+        uint64_t flag_count = 0;
+        std::vector<cell_t> values;
+
+        void flag( const bool set ){
+            if( 0 == (flag_count % 8) ){
+                flags.push_back( 0 );
+            }
+            flags.back() |= static_cast<uint8_t>( set ) << (flag_count % 8);
+            ++flag_count;
+        }
+    };
+
+    /// \brief an encoding, as it is read: the flag bits are read up-front; values are read as they are needed
+    ///
+    /// Values are read in chunks; but never past the count in the header, so the stream is left at the end of
+    /// the encoding.
+    struct Decoder {
+        std::istream& source;
+        std::vector<uint8_t> flags;
+        uint64_t flag_count;
+        uint64_t next_flag;
+        /// values not yet read from the stream
+        uint64_t unread;
+        std::vector<cell_t> chunk;
+        size_t chunk_end;
+        size_t next_value;
+
+        bool flag( bool& set ){
+            if( flag_count <= next_flag ){
+                return false;
+            }
+            set = 0 != ( (flags[next_flag / 8] >> (next_flag % 8)) & 1 );
+            ++next_flag;
+            return true;
+        }
+
+        bool values( cell_t* destination, size_t count ){
+            while( 0 < count ){
+                if( next_value == chunk_end ){
+                    chunk_end = static_cast<size_t>( std::min<uint64_t>(chunk.size(), unread) );
+                    next_value = 0;
+                    if( (0 == chunk_end) || (! source.read( reinterpret_cast<char*>(chunk.data()), chunk_end * sizeof(cell_t) )) ){
+                        return false;
+                    }
+                    unread -= chunk_end;
+                }
+                const size_t run = std::min( count, chunk_end - next_value );
+                std::copy_n( chunk.data() + next_value, run, destination );
+                next_value += run;
+                destination += run;
+                count -= run;
+            }
+            return true;
+        }
+    };
+
+    /// \brief append the subtree at node `at` -- at `level`, over cells from (i0, j0) -- in pre-order
+    void encode( const uint32_t at, const uint32_t level, const uint32_t i0, const uint32_t j0, Encoder& encoder ) const;
+
+    /// \brief read the next subtree, at `level`; branches are appended to `pool`, as in `build(...)`
+    static bool decode( Decoder& decoder, const uint32_t level, std::vector<Node>& pool, Node& node );
+
+    size_t subtree_size( const uint32_t at ) const;
+
+    uint32_t allocate( const cell_t value );
+
+    void release( const uint32_t first_child );
+
+private:
+    /// \brief name of this layer's type
+    constexpr static char type_[] = "QuadTreeLayer";
+
+    /// \brief node 0 is the root
+    std::vector<Node> nodes_;
+
+    /// \brief first index of each unused group of four nodes
+    std::vector<uint32_t> free_;
+
+    /// \brief version of the last write to each tile; answers `collect_changes(...)`
+    index::DirtyTiles<dimension> dirty_tiles_;
+
+    chartbox::ChartLayerInterface< cell_t, QuadTree<dimension, cell_t>>& super() {
+        return *static_cast<chartbox::ChartLayerInterface< cell_t, QuadTree<dimension, cell_t>>*>(this);
+    }
+
+    const chartbox::ChartLayerInterface< cell_t, QuadTree<dimension, cell_t>>& super() const {
+        return *static_cast<const chartbox::ChartLayerInterface< cell_t, QuadTree<dimension, cell_t>>*>(this);
+    }
+};
+
+/// \brief the default tree layer: 128 x 128 byte-cells
+typedef QuadTree<128> QuadTreeLayer;
+
+} // namespace chartbox::layer
+
+#include "quad-tree-layer.inl"
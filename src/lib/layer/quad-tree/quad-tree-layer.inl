@@ -0,0 +1,504 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// NOTE: This is the template-class implementation -- which is included from the header file.
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <fmt/core.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace chartbox::layer {
+
+namespace detail {
+
+/// \brief cells compare by their bits; so that e.g. NaN cells still merge
+template<typename cell_t>
+inline bool same_bits( const cell_t a, const cell_t b ){
+    return 0 == std::memcmp( &a, &b, sizeof(cell_t) );
+}
+
+/// \brief test if every cell of a contiguous run equals a value; 16 bytes at a time, where SSE2 is available
+template<typename cell_t>
+inline bool run_uniform( const cell_t* cells, const size_t count, const cell_t value ){
+    size_t k = 0;
+#ifdef __SSE2__
+    if constexpr ( 0 == (16 % sizeof(cell_t)) ){
+        constexpr size_t lanes = 16 / sizeof(cell_t);
+        alignas(16) cell_t pattern[lanes];
+        std::fill( pattern, pattern + lanes, value );
+        const __m128i expected = _mm_load_si128( reinterpret_cast<const __m128i*>(pattern) );
+        for( ; k + lanes <= count; k += lanes ){
+            const __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i*>(cells + k) );
+            if( 0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi8(v, expected)) ){
+                return false;
+            }
+        }
+    }
+#endif
+    for( ; k < count; ++k ){
+        if( ! same_bits(cells[k], value) ){
+            return false;
+        }
+    }
+    return true;
+}
+
+/// \brief test if every cell of the block [i0, i0+size) x [j0, j0+size) is the same
+/// \param value - output: the first cell of the block
+template<typename index_t, typename cell_t>
+inline bool uniform_block( const cell_t* grid, const uint32_t i0, const uint32_t j0, const uint32_t size, cell_t& value ){
+    value = grid[ index_t::lookup(i0, j0) ];
+    for( uint32_t j = j0; j < j0 + size; ++j ){
+        if constexpr ( index_t::row_major ){
+            if( ! run_uniform( grid + index_t::lookup(i0, j), size, value ) ){
+                return false;
+            }
+        }else{
+            for( uint32_t i = i0; i < i0 + size; ++i ){
+                if( ! same_bits(grid[ index_t::lookup(i, j) ], value) ){
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/// \brief which child of a node at `level + 1` contains cell (i,j)
+inline uint32_t quadrant( const uint32_t i, const uint32_t j, const uint32_t level ){
+    return ((i >> level) & 1) | (((j >> level) & 1) << 1);
+}
+
+} // namespace detail
+
+template<size_t dimension, typename cell_t>
+QuadTree<dimension,cell_t>::QuadTree( const Eigen::AlignedBox2d& _bounds )
+    : chartbox::ChartLayerInterface< cell_t, QuadTree<dimension, cell_t>>(_bounds)
+{
+    static_assert( 0 == (dimension & (dimension - 1)), "Tree dimension must be a power of two!" );
+    // start from the same state as `reset()`; without stamping a write
+    nodes_.assign( 1, Node{ 0, default_value } );
+}
+
+template<size_t dimension, typename cell_t>
+template<typename index_t>
+QuadTree<dimension,cell_t>::QuadTree( const Eigen::AlignedBox2d& _bounds, const FixedGrid<index_t, cell_t>& source, size_t thread_count )
+    : chartbox::ChartLayerInterface< cell_t, QuadTree<dimension, cell_t>>(_bounds)
+{
+    static_assert( 0 == (dimension & (dimension - 1)), "Tree dimension must be a power of two!" );
+    static_assert( index_t::dimension == dimension, "Source grid must match the dimension of the tree!" );
+
+    thread_count = std::max<size_t>( 1, thread_count );
+    nodes_.resize( 1 );
+
+    // subtrees are never split below the uniformity-tested blocks
+    uint32_t max_split = 0;
+    while( (dimension >> max_split) > block_size ){
+        ++max_split;
+    }
+
+    if( (1 == thread_count) || (0 == max_split) ){
+        nodes_[0] = build<index_t>( source.data(), 0, 0, dimension, nodes_ );
+        return;
+    }
+
+    // split the top of the tree into 4^split subtrees -- several per thread, to even out their loads
+    uint32_t split = 1;
+    while( (split < max_split) && ((size_t(1) << (2*split)) < 4*thread_count) ){
+        ++split;
+    }
+    const uint32_t side = 1u << split;
+    const uint32_t size = dimension >> split;
+
+    // each subtree builds into its own pool; whose slot 0 is unused, so that a zero `first_child` still marks a leaf
+    std::vector<Node> roots( side*side );
+    std::vector<std::vector<Node>> pools( side*side );
+    std::atomic<size_t> next( 0 );
+    auto build_subtrees = [&](){
+        for( size_t task = next++; task < roots.size(); task = next++ ){
+            pools[task].resize( 1 );
+            const uint32_t i0 = static_cast<uint32_t>(task % side) * size;
+            const uint32_t j0 = static_cast<uint32_t>(task / side) * size;
+            roots[task] = build<index_t>( source.data(), i0, j0, size, pools[task] );
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for( size_t t = 1; t < std::min<size_t>(thread_count, roots.size()); ++t ){
+        threads.emplace_back( build_subtrees );
+    }
+    build_subtrees();
+    for( auto& thread : threads ){
+        thread.join();
+    }
+
+    size_t total = 1;
+    for( const auto& pool : pools ){
+        total += pool.size() - 1;
+    }
+    nodes_.reserve( total + 4*(roots.size() - 1)/3 );
+
+    // join the top levels, serially; from the subtrees upwards
+    std::vector<Node> level( roots.size() );
+    for( size_t task = 0; task < roots.size(); ++task ){
+        level[task] = splice( roots[task], pools[task] );
+        std::vector<Node>().swap( pools[task] );
+    }
+    for( uint32_t width = side / 2; 0 < width; width /= 2 ){
+        std::vector<Node> parents( width*width );
+        for( uint32_t j = 0; j < width; ++j ){
+            for( uint32_t i = 0; i < width; ++i ){
+                const uint32_t below = 2*width;
+                const Node children[4] = { level[ (2*j)*below + 2*i ], level[ (2*j)*below + 2*i + 1 ],
+                                           level[ (2*j + 1)*below + 2*i ], level[ (2*j + 1)*below + 2*i + 1 ] };
+                parents[ j*width + i ] = join( children, nodes_ );
+            }
+        }
+        level.swap( parents );
+    }
+    nodes_[0] = level[0];
+}
+
+template<size_t dimension, typename cell_t>
+template<typename index_t>
+typename QuadTree<dimension,cell_t>::Node QuadTree<dimension,cell_t>::build( const cell_t* cells,
+                                                                             const uint32_t i0, const uint32_t j0, const uint32_t size,
+                                                                             std::vector<Node>& pool )
+{
+    cell_t value;
+    if( block_size == size ){
+        // a uniform block is one leaf; else, its cells are each read once more, below
+        if( detail::uniform_block<index_t>( cells, i0, j0, size, value ) ){
+            return { 0, value };
+        }
+    }else if( 1 == size ){
+        return { 0, cells[ index_t::lookup(i0, j0) ] };
+    }
+
+    const uint32_t half = size / 2;
+    const Node children[4] = { build<index_t>( cells, i0, j0, half, pool ),
+                               build<index_t>( cells, i0 + half, j0, half, pool ),
+                               build<index_t>( cells, i0, j0 + half, half, pool ),
+                               build<index_t>( cells, i0 + half, j0 + half, half, pool ) };
+    return join( children, pool );
+}
+
+template<size_t dimension, typename cell_t>
+typename QuadTree<dimension,cell_t>::Node QuadTree<dimension,cell_t>::join( const Node* children, std::vector<Node>& pool ){
+    bool uniform = true;
+    for( size_t q = 0; q < 4; ++q ){
+        uniform = uniform && (0 == children[q].first_child) && detail::same_bits( children[q].value, children[0].value );
+    }
+    if( uniform ){
+        return { 0, children[0].value };
+    }
+
+    const uint32_t first = static_cast<uint32_t>( pool.size() );
+    pool.insert( pool.end(), children, children + 4 );
+    return { first, cell_t() };
+}
+
+template<size_t dimension, typename cell_t>
+typename QuadTree<dimension,cell_t>::Node QuadTree<dimension,cell_t>::splice( const Node root, const std::vector<Node>& pool ){
+    if( 0 == root.first_child ){
+        return root;
+    }
+
+    // the pool's slot 0 is unused; so its slot k lands at `offset + k`
+    const uint32_t offset = static_cast<uint32_t>( nodes_.size() ) - 1;
+    for( auto each = pool.cbegin() + 1; each != pool.cend(); ++each ){
+        nodes_.push_back({ (0 == each->first_child) ? 0 : each->first_child + offset, each->value });
+    }
+    return { root.first_child + offset, root.value };
+}
+
+template<size_t dimension, typename cell_t>
+void QuadTree<dimension,cell_t>::encode( const uint32_t at, const uint32_t level, const uint32_t i0, const uint32_t j0, Encoder& encoder ) const {
+    const Node node = nodes_[at];
+    if( 0 == node.first_child ){
+        encoder.flag( false );
+        encoder.values.push_back( node.value );
+        return;
+    }
+
+    encoder.flag( true );
+    if( block_height == level ){
+        // raw cells, if they are smaller than the flags & values of the subtree beneath this node
+        const size_t descendants = subtree_size( at ) - 1;
+        const size_t leaves = 1 + 3*(descendants / 4);
+        const bool raw = ( 8*sizeof(cell_t)*block_size*block_size ) < ( descendants + 8*sizeof(cell_t)*leaves );
+        encoder.flag( raw );
+        if( raw ){
+            for( uint32_t j = j0; j < j0 + block_size; ++j ){
+                for( uint32_t i = i0; i < i0 + block_size; ++i ){
+                    encoder.values.push_back( get(i, j) );
+                }
+            }
+            return;
+        }
+    }
+
+    const uint32_t half = 1u << (level - 1);
+    for( uint32_t q = 0; q < 4; ++q ){
+        encode( node.first_child + q, level - 1, i0 + (q & 1)*half, j0 + (q >> 1)*half, encoder );
+    }
+}
+
+template<size_t dimension, typename cell_t>
+bool QuadTree<dimension,cell_t>::decode( Decoder& decoder, const uint32_t level, std::vector<Node>& pool, Node& node ){
+    bool branch;
+    if( ! decoder.flag(branch) ){
+        return false;
+    }else if( ! branch ){
+        node.first_child = 0;
+        return decoder.values( &node.value, 1 );
+    }else if( 0 == level ){
+        // single cells cannot split
+        return false;
+    }
+
+    bool raw = false;
+    if( (block_height == level) && (! decoder.flag(raw)) ){
+        return false;
+    }
+    if( raw ){
+        std::vector<cell_t> tile( block_size * block_size );
+        if( ! decoder.values( tile.data(), tile.size() ) ){
+            return false;
+        }
+        node = build< index::RowMajorIndex<block_size> >( tile.data(), 0, 0, block_size, pool );
+        return true;
+    }
+
+    Node children[4];
+    for( uint32_t q = 0; q < 4; ++q ){
+        if( ! decode( decoder, level - 1, pool, children[q] ) ){
+            return false;
+        }
+    }
+    node = join( children, pool );
+    return true;
+}
+
+template<size_t dimension, typename cell_t>
+size_t QuadTree<dimension,cell_t>::subtree_size( const uint32_t at ) const {
+    const uint32_t first = nodes_[at].first_child;
+    if( 0 == first ){
+        return 1;
+    }
+    return 1 + subtree_size(first) + subtree_size(first + 1) + subtree_size(first + 2) + subtree_size(first + 3);
+}
+
+template<size_t dimension, typename cell_t>
+uint32_t QuadTree<dimension,cell_t>::allocate( const cell_t value ){
+    uint32_t first;
+    if( free_.empty() ){
+        first = static_cast<uint32_t>( nodes_.size() );
+        nodes_.resize( nodes_.size() + 4 );
+    }else{
+        first = free_.back();
+        free_.pop_back();
+    }
+    std::fill( nodes_.begin() + first, nodes_.begin() + first + 4, Node{ 0, value } );
+    return first;
+}
+
+template<size_t dimension, typename cell_t>
+void QuadTree<dimension,cell_t>::release( const uint32_t first_child ){
+    free_.push_back( first_child );
+}
+
+template<size_t dimension, typename cell_t>
+bool QuadTree<dimension,cell_t>::fill( const cell_t value ){
+    nodes_.assign( 1, Node{ 0, value } );
+    free_.clear();
+    dirty_tiles_.mark_all();
+    return true;
+}
+
+template<size_t dimension, typename cell_t>
+cell_t QuadTree<dimension,cell_t>::get( const Eigen::Vector2d& p ) const {
+    if( (p.x() < 0) || (p.y() < 0) ){
+        return default_value;
+    }
+    const double scale = inverse_precision();
+    const uint32_t i = static_cast<uint32_t>( p.x()*scale );
+    const uint32_t j = static_cast<uint32_t>( p.y()*scale );
+    if( (dimension <= i) || (dimension <= j) ){
+        return default_value;
+    }
+    return get( i, j );
+}
+
+template<size_t dimension, typename cell_t>
+cell_t QuadTree<dimension,cell_t>::get( const uint32_t i, const uint32_t j ) const {
+    uint32_t at = 0;
+    for( uint32_t level = height; 0 != nodes_[at].first_child; ){
+        --level;
+        at = nodes_[at].first_child + detail::quadrant( i, j, level );
+    }
+    return nodes_[at].value;
+}
+
+template<size_t dimension, typename cell_t>
+size_t QuadTree<dimension,cell_t>::leaf_count() const {
+    // each branch replaced one leaf with four
+    return 1 + 3*((node_count() - 1) / 4);
+}
+
+template<size_t dimension, typename cell_t>
+double QuadTree<dimension,cell_t>::precision() const {
+    return width() / dimension;
+}
+
+template<size_t dimension, typename cell_t>
+void QuadTree<dimension,cell_t>::print_contents() const {
+    fmt::print( "============ ============ Quad-Tree-Layer Contents ============ ============\n" );
+    fmt::print( "    {} nodes; {} leaves\n", node_count(), leaf_count() );
+    for( size_t j = dimension - 1; j < dimension; --j ){
+        for( size_t i = 0; i < dimension; ++i ){
+            const auto value = get( static_cast<uint32_t>(i), static_cast<uint32_t>(j) );
+            if( 0 == (i%8) ){
+                fmt::print(" ");
+            }
+            if( 0 < value ){
+                fmt::print(" {:2X}", static_cast<int>(value) );
+            }else{
+                fmt::print(" --");
+            }
+        }
+        if( 0 == (j%8) ){
+            fmt::print("\n");
+        }
+        fmt::print("\n");
+    }
+    fmt::print( "============ ============ ============ ============ ============ ============\n" );
+}
+
+template<size_t dimension, typename cell_t>
+void QuadTree<dimension,cell_t>::reset() {
+    fill( default_value );
+}
+
+template<size_t dimension, typename cell_t>
+bool QuadTree<dimension,cell_t>::store( const Eigen::Vector2d& p, const cell_t value ){
+    if( (p.x() < 0) || (p.y() < 0) ){
+        return false;
+    }
+    const double scale = inverse_precision();
+    const uint32_t i = static_cast<uint32_t>( p.x()*scale );
+    const uint32_t j = static_cast<uint32_t>( p.y()*scale );
+    if( (dimension <= i) || (dimension <= j) ){
+        return false;
+    }
+    return store( i, j, value );
+}
+
+template<size_t dimension, typename cell_t>
+bool QuadTree<dimension,cell_t>::store( const uint32_t i, const uint32_t j, const cell_t value ){
+    // descend to the cell; splitting leaves on the way down
+    uint32_t path[height + 1];
+    uint32_t depth = 0;
+    uint32_t at = 0;
+    for( uint32_t level = height; ; --level ){
+        path[depth++] = at;
+        if( 0 == nodes_[at].first_child ){
+            const cell_t current = nodes_[at].value;
+            if( detail::same_bits(current, value) ){
+                return true;
+            }else if( 0 == level ){
+                nodes_[at].value = value;
+                break;
+            }
+            const uint32_t first = allocate( current );
+            nodes_[at].first_child = first;
+        }
+        at = nodes_[at].first_child + detail::quadrant( i, j, level - 1 );
+    }
+    dirty_tiles_.mark( i, j );
+
+    // ... and collapse four equal leaves on the way back up
+    for( uint32_t k = depth - 1; 0 < k; --k ){
+        Node& parent = nodes_[ path[k - 1] ];
+        const uint32_t first = parent.first_child;
+        for( uint32_t q = 0; q < 4; ++q ){
+            const Node& child = nodes_[ first + q ];
+            if( (0 != child.first_child) || (! detail::same_bits(child.value, value)) ){
+                return true;
+            }
+        }
+        parent = { 0, value };
+        release( first );
+    }
+    return true;
+}
+
+template<size_t dimension, typename cell_t>
+bool QuadTree<dimension,cell_t>::write( std::ostream& sink ) const {
+    Encoder encoder;
+    encoder.values.reserve( leaf_count() );
+    encode( 0, height, 0, 0, encoder );
+
+    const uint8_t header[4] = { encoding_version, static_cast<uint8_t>(sizeof(cell_t)), static_cast<uint8_t>(height), static_cast<uint8_t>(block_height) };
+    const uint64_t value_count = encoder.values.size();
+    sink.write( magic, sizeof(magic) );
+    sink.write( reinterpret_cast<const char*>(header), sizeof(header) );
+    sink.write( reinterpret_cast<const char*>(&encoder.flag_count), sizeof(encoder.flag_count) );
+    sink.write( reinterpret_cast<const char*>(&value_count), sizeof(value_count) );
+    sink.write( reinterpret_cast<const char*>(encoder.flags.data()), encoder.flags.size() );
+    sink.write( reinterpret_cast<const char*>(encoder.values.data()), encoder.values.size() * sizeof(cell_t) );
+    return static_cast<bool>( sink );
+}
+
+template<size_t dimension, typename cell_t>
+bool QuadTree<dimension,cell_t>::load( std::istream& source ){
+    char leader[sizeof(magic)];
+    uint8_t header[4];
+    uint64_t flag_count;
+    uint64_t value_count;
+    source.read( leader, sizeof(leader) );
+    source.read( reinterpret_cast<char*>(header), sizeof(header) );
+    source.read( reinterpret_cast<char*>(&flag_count), sizeof(flag_count) );
+    source.read( reinterpret_cast<char*>(&value_count), sizeof(value_count) );
+    if( (! source) || (0 != std::memcmp(leader, magic, sizeof(magic))) || (encoding_version != header[0])
+            || (sizeof(cell_t) != header[1]) || (height != header[2]) || (block_height != header[3]) ){
+        return false;
+    }
+
+    // a full tree has fewer than two flags per cell; so a larger count is corrupt, rather than merely large
+    if( 2*dimension*dimension < flag_count ){
+        return false;
+    }
+    Decoder decoder{ source, std::vector<uint8_t>( (flag_count + 7) / 8 ), flag_count, 0, value_count, std::vector<cell_t>( 4096 ), 0, 0 };
+    if( ! source.read( reinterpret_cast<char*>(decoder.flags.data()), decoder.flags.size() ) ){
+        return false;
+    }
+
+    std::vector<Node> pool( 1 );
+    Node root;
+    if( (! decode( decoder, height, pool, root )) || (flag_count != decoder.next_flag)
+            || (0 != decoder.unread) || (decoder.next_value != decoder.chunk_end) ){
+        return false;
+    }
+    pool[0] = root;
+    nodes_.swap( pool );
+    free_.clear();
+    dirty_tiles_.mark_all();
+    return true;
+}
+
+template<size_t dimension, typename cell_t>
+std::string QuadTree<dimension,cell_t>::type() const {
+    return type_;
+}
+
+} // namespace chartbox::layer
@@ -0,0 +1,318 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include "index/z-order-index.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+#include "layer/test-fixtures.hpp"
+
+#include "quad-tree-layer.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+namespace chartbox::layer {
+
+typedef QuadTree<256> QuadTree256;
+typedef FixedGrid< index::RowMajorIndex<256> > FixedGrid256;
+
+static const AlignedBox2d bounds( Vector2d(0,0), Vector2d(256,256) );
+
+// every shade the scattered boxes are written with
+static const std::vector<uint8_t> shades = { 0x00, 0x40, 0x80, 0xC0 };
+
+// builds a tree the slow way: one `store(...)` per cell
+template<typename tree_t, typename grid_t>
+static void store_each( tree_t& tree, const grid_t& grid ){
+    for( uint32_t j = 0; j < grid_t::dimension; ++j ){
+        for( uint32_t i = 0; i < grid_t::dimension; ++i ){
+            tree.store( i, j, grid.data()[ grid.lookup(i, j) ] );
+        }
+    }
+}
+
+template<typename tree_t, typename grid_t>
+static void expect_same_cells( const tree_t& tree, const grid_t& grid ){
+    for( uint32_t j = 0; j < grid_t::dimension; ++j ){
+        for( uint32_t i = 0; i < grid_t::dimension; ++i ){
+            ASSERT_EQ( tree.get(i, j), grid.data()[ grid.lookup(i, j) ] ) << "    @@ (" << i << ", " << j << ")";
+        }
+    }
+}
+
+// the JSON encoding of the legacy `QuadNode::to_json()`: a number for a leaf; else an object of four quadrants
+template<typename tree_t>
+static std::string to_json_text( const tree_t& tree, const uint32_t at = 0 ){
+    const auto& node = tree.nodes()[at];
+    if( 0 == node.first_child ){
+        return std::to_string( node.value );
+    }
+    const uint32_t first = node.first_child;
+    return "{\"NE\":" + to_json_text(tree, first + 3) + ",\"NW\":" + to_json_text(tree, first + 2)
+         + ",\"SE\":" + to_json_text(tree, first + 1) + ",\"SW\":" + to_json_text(tree, first) + "}";
+}
+
+template<typename tree_t>
+static std::string encode( const tree_t& tree ){
+    std::ostringstream sink;
+    EXPECT_TRUE( tree.write(sink) );
+    return sink.str();
+}
+
+TEST( QuadTree, Construct ){
+    QuadTreeLayer tree( bounds );
+    EXPECT_DOUBLE_EQ( tree.precision(), 2.0 );
+    EXPECT_EQ( tree.node_count(), 1 );
+    EXPECT_EQ( tree.get({3, 3}), QuadTreeLayer::default_value );
+    EXPECT_EQ( tree.get({-3, 3}), QuadTreeLayer::default_value );
+    EXPECT_EQ( QuadTreeLayer::height, 7 );
+    EXPECT_EQ( tree.type(), "QuadTreeLayer" );
+}
+
+TEST( QuadTree, StoreSplitsThenCollapses ){
+    QuadTree256 tree( bounds );
+    tree.fill( 0 );
+
+    EXPECT_TRUE( tree.store( Vector2d(10.5, 20.5), 0x99 ) );
+    EXPECT_EQ( tree.get({10.5, 20.5}), 0x99 );
+    EXPECT_EQ( tree.get({11.5, 20.5}), 0 );
+    // one split at each level
+    EXPECT_EQ( tree.node_count(), 1 + 4*QuadTree256::height );
+    EXPECT_EQ( tree.leaf_count(), 1 + 3*QuadTree256::height );
+
+    // writing it back collapses the whole path
+    EXPECT_TRUE( tree.store( Vector2d(10.5, 20.5), 0 ) );
+    EXPECT_EQ( tree.node_count(), 1 );
+
+    // ... and the freed nodes are reused
+    const size_t pool = tree.nodes().size();
+    EXPECT_TRUE( tree.store( Vector2d(200.5, 3.5), 0x99 ) );
+    EXPECT_EQ( tree.nodes().size(), pool );
+
+    EXPECT_FALSE( tree.store( Vector2d(256.5, 3.5), 0x99 ) );
+    EXPECT_FALSE( tree.store( Vector2d(-0.5, 3.5), 0x99 ) );
+}
+
+TEST( QuadTree, FillArea ){
+    QuadTree256 tree( bounds );
+    tree.fill( 0 );
+
+    // a block aligned to one quadrant of the root is a single leaf
+    EXPECT_TRUE( tree.fill( AlignedBox2d(Vector2d(128,0), Vector2d(256,128)), 0x99 ) );
+    EXPECT_EQ( tree.node_count(), 5 );
+    EXPECT_EQ( tree.get({200, 20}), 0x99 );
+    EXPECT_EQ( tree.get({20, 200}), 0 );
+}
+
+TEST( QuadTree, RecordsChangedWrites ){
+    QuadTree256 tree( bounds );
+    EXPECT_EQ( tree.version(), 0 );
+    tree.fill( 0 );
+    uint64_t since = tree.version();
+    EXPECT_LT( 0, since );
+
+    // rewriting the same value is not a change; even inside a uniform leaf
+    tree.store( {5.5, 5.5}, 0 );
+    EXPECT_EQ( tree.version(), since );
+
+    tree.fill( AlignedBox2d(Vector2d(40, 70), Vector2d(50, 74)), 0x99 );
+    std::vector<AlignedBox2d> areas;
+    tree.collect_changes( since, areas );
+    EXPECT_EQ( since, tree.version() );
+    ASSERT_EQ( areas.size(), 1 );
+    EXPECT_TRUE( areas[0].isApprox(AlignedBox2d(Vector2d(32, 64), Vector2d(64, 80))) );
+
+    // a store which collapses the tree is still a change
+    tree.fill( AlignedBox2d(Vector2d(40, 70), Vector2d(50, 74)), 0 );
+    EXPECT_EQ( tree.node_count(), 1 );
+    areas.clear();
+    tree.collect_changes( since, areas );
+    ASSERT_EQ( areas.size(), 1 );
+
+    // loading replaces every cell
+    std::istringstream source( encode(tree) );
+    ASSERT_TRUE( tree.load(source) );
+    areas.clear();
+    tree.collect_changes( since, areas );
+    ASSERT_EQ( areas.size(), 16 );
+    EXPECT_TRUE( areas[0].isApprox(AlignedBox2d(Vector2d(0, 0), Vector2d(256, 16))) );
+}
+
+TEST( QuadTree, BuildUniformGrid ){
+    FixedGrid256 grid( bounds );
+    grid.fill( 0x33 );
+
+    QuadTree256 tree( bounds, grid );
+    EXPECT_EQ( tree.node_count(), 1 );
+    EXPECT_EQ( tree.get(255, 255), 0x33 );
+}
+
+TEST( QuadTree, BuildMatchesStores ){
+    for( uint32_t seed = 1; seed < 6; ++seed ){
+        FixedGrid256 grid( bounds );
+        scatter( grid, seed, 30, shades );
+
+        QuadTree256 stored( bounds );
+        store_each( stored, grid );
+
+        QuadTree256 built( bounds, grid, 1 );
+        expect_same_cells( built, grid );
+
+        // both trees are fully pruned; and a pruned tree is unique
+        EXPECT_EQ( built.node_count(), stored.node_count() ) << "    @@ seed: " << seed;
+        // and the bottom-up build never allocated a node that it later discarded
+        EXPECT_EQ( built.nodes().size(), built.node_count() );
+        EXPECT_LT( built.node_count(), 256*256/4 );
+    }
+}
+
+TEST( QuadTree, BuildInParallel ){
+    FixedGrid256 grid( bounds );
+    scatter( grid, 7, 30, shades );
+
+    const QuadTree256 serial( bounds, grid, 1 );
+    for( const size_t threads : {2, 3, 4, 16, 64} ){
+        const QuadTree256 parallel( bounds, grid, threads );
+        expect_same_cells( parallel, grid );
+        EXPECT_EQ( parallel.node_count(), serial.node_count() ) << "    @@ threads: " << threads;
+        EXPECT_EQ( parallel.nodes().size(), parallel.node_count() );
+    }
+}
+
+TEST( QuadTree, BuildCheckerboard ){
+    // nothing merges: every cell is its own leaf
+    FixedGrid< index::RowMajorIndex<64> > grid( AlignedBox2d(Vector2d(0,0), Vector2d(64,64)) );
+    for( uint32_t j = 0; j < 64; ++j ){
+        for( uint32_t i = 0; i < 64; ++i ){
+            grid.data()[ grid.lookup(i, j) ] = ((i + j) & 1) ? 0x99 : 0;
+        }
+    }
+
+    const QuadTree<64> tree( AlignedBox2d(Vector2d(0,0), Vector2d(64,64)), grid, 4 );
+    expect_same_cells( tree, grid );
+    EXPECT_EQ( tree.leaf_count(), 64*64 );
+}
+
+TEST( QuadTree, BuildFromOtherLayouts ){
+    FixedGrid< index::ZOrderIndex<256> > grid( bounds );
+    scatter( grid, 11, 30, shades );
+
+    const QuadTree256 tree( bounds, grid, 4 );
+    expect_same_cells( tree, grid );
+}
+
+TEST( QuadTree, BuildFloatCells ){
+    typedef FixedGrid< index::RowMajorIndex<256>, float > FloatGrid256;
+    FloatGrid256 grid( bounds );
+    grid.fill( 4.5f );
+    grid.fill( AlignedBox2d(Vector2d(0,0), Vector2d(100,37)), -2.25f );
+
+    const QuadTree<256, float> tree( bounds, grid, 4 );
+    expect_same_cells( tree, grid );
+
+    QuadTree<256, float> stored( bounds );
+    store_each( stored, grid );
+    EXPECT_EQ( tree.node_count(), stored.node_count() );
+}
+
+TEST( QuadTree, EncodeRoundTrip ){
+    FixedGrid256 grid( bounds );
+    scatter( grid, 3, 30, shades );
+    const QuadTree256 source( bounds, grid );
+    const std::string encoded = encode( source );
+
+    // followed by other data; which the load leaves unread
+    QuadTree256 loaded( bounds );
+    std::istringstream stream( encoded + "tail" );
+    ASSERT_TRUE( loaded.load(stream) );
+    expect_same_cells( loaded, grid );
+    EXPECT_EQ( loaded.node_count(), source.node_count() );
+    std::string tail;
+    stream >> tail;
+    EXPECT_EQ( tail, "tail" );
+
+    // header, one or two bits per node, and one byte per leaf
+    EXPECT_LE( encoded.size(), 24 + (2*source.node_count() + 7)/8 + source.leaf_count() );
+
+    const std::string json = to_json_text( source );
+    EXPECT_LT( 4*encoded.size(), json.size() );
+    RecordProperty( "binary_bytes", static_cast<int>(encoded.size()) );
+    RecordProperty( "json_bytes", static_cast<int>(json.size()) );
+}
+
+TEST( QuadTree, EncodeRawBlocks ){
+    // a checkerboard has a leaf for every cell; so every block is written raw, in one byte per cell
+    FixedGrid< index::RowMajorIndex<64> > grid( AlignedBox2d(Vector2d(0,0), Vector2d(64,64)) );
+    for( uint32_t j = 0; j < 64; ++j ){
+        for( uint32_t i = 0; i < 64; ++i ){
+            grid.data()[ grid.lookup(i, j) ] = ((i + j) & 1) ? 0x99 : static_cast<uint8_t>(i);
+        }
+    }
+    const QuadTree<64> source( AlignedBox2d(Vector2d(0,0), Vector2d(64,64)), grid );
+    const std::string encoded = encode( source );
+    EXPECT_LT( encoded.size(), 24 + 64*64 + 8 );
+
+    QuadTree<64> loaded( AlignedBox2d(Vector2d(0,0), Vector2d(64,64)) );
+    std::istringstream stream( encoded );
+    ASSERT_TRUE( loaded.load(stream) );
+    expect_same_cells( loaded, grid );
+    EXPECT_EQ( loaded.node_count(), source.node_count() );
+}
+
+TEST( QuadTree, EncodeFloatCells ){
+    typedef FixedGrid< index::RowMajorIndex<256>, float > FloatGrid256;
+    FloatGrid256 grid( bounds );
+    grid.fill( 4.5f );
+    grid.fill( AlignedBox2d(Vector2d(3,0), Vector2d(100,37)), -2.25f );
+    const QuadTree<256, float> source( bounds, grid );
+
+    QuadTree<256, float> loaded( bounds );
+    std::istringstream stream( encode(source) );
+    ASSERT_TRUE( loaded.load(stream) );
+    expect_same_cells( loaded, grid );
+}
+
+TEST( QuadTree, LoadRejectsBadInput ){
+    FixedGrid256 grid( bounds );
+    scatter( grid, 5, 30, shades );
+    const QuadTree256 source( bounds, grid );
+    const std::string encoded = encode( source );
+
+    QuadTree256 loaded( bounds );
+    loaded.fill( 0x21 );
+
+    // truncated
+    for( const size_t length : {size_t(0), size_t(10), size_t(30), encoded.size() - 1} ){
+        std::istringstream stream( encoded.substr(0, length) );
+        EXPECT_FALSE( loaded.load(stream) ) << "    @@ length: " << length;
+    }
+
+    // wrong dimension, and wrong cell type
+    {
+        QuadTreeLayer other( bounds );
+        std::istringstream stream( encoded );
+        EXPECT_FALSE( other.load(stream) );
+    }{
+        QuadTree<256, uint16_t> other( bounds );
+        std::istringstream stream( encoded );
+        EXPECT_FALSE( other.load(stream) );
+    }
+
+    // not an encoding at all
+    {
+        std::istringstream stream( to_json_text(source) );
+        EXPECT_FALSE( loaded.load(stream) );
+    }
+
+    // ... and the failures left the tree as it was
+    EXPECT_EQ( loaded.node_count(), 1 );
+    EXPECT_EQ( loaded.get(17, 17), 0x21 );
+}
+
+} // namespace chartbox::layer
@@ -0,0 +1,38 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+namespace chartbox::layer {
+
+/// \brief clear the layer, then fill `box_count` seeded random boxes over it; each with one of `values`
+///
+/// Boxes are up to 2/5 of the layer wide, and may hang off its edges; so the layer gets both wide uniform regions,
+/// and ragged, clipped edges.  The same seed writes the same boxes into any layer of the same size -- so the
+/// layer tests use it to compare layer types cell by cell.  The layer is expected to span from the origin.
+template<typename layer_t>
+void scatter( layer_t& layer, const uint32_t seed, const size_t box_count, const std::vector<typename layer_t::cell_t>& values ){
+    using Eigen::AlignedBox2d;
+    using Eigen::Vector2d;
+
+    const double width = layer_t::dimension * layer.precision();
+    std::mt19937 generator( seed );
+    std::uniform_real_distribution<double> corner( -width / 10, width );
+    std::uniform_real_distribution<double> size( 0, 0.4 * width );
+    std::uniform_int_distribution<size_t> pick( 0, values.size() - 1 );
+
+    layer.fill( layer_t::clear_value );
+    for( size_t count = 0; count < box_count; ++count ){
+        const Vector2d low( corner(generator), corner(generator) );
+        const Vector2d high = low + Vector2d( size(generator), size(generator) );
+        layer.fill( AlignedBox2d(low, high), values[pick(generator)] );
+    }
+}
+
+} // namespace chartbox::layer
@@ -0,0 +1,13 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <cstdint>
+
+#include "tile-world.hpp"
+
+namespace chartbox::layer {
+
+// stock shapes; others are instantiated on-demand, from the header
+template class TileWorld<uint8_t, 64>;
+template class TileWorld<uint8_t, 32>;
+
+} // namespace chartbox::layer
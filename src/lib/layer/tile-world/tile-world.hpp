@@ -0,0 +1,224 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include "chart-box/chart-layer-interface.hpp"
+#include "layer/grid-tree/grid-node.hpp"
+
+namespace chartbox::layer {
+
+/// \brief sparse layer over a world of any extent: square tiles are allocated only where they are written
+///
+/// Unlike the other layers -- which cover one local frame, of at most 16384 cells across (see `FrameMapping`) --
+/// this layer may cover a whole coastline.  Its memory grows with the number of written tiles, rather than
+/// with its extent; and is capped by `max_tiles`.
+///
+/// Tiles are `node::TileNode`s; stored densely while mixed, or as a single value while uniform.  A tile which
+/// returns to the background value is released.  Tiles are found through an open-addressing (linear-probing)
+/// hash map, keyed by their integer tile coordinates; in front of which a small direct-mapped cache holds the
+/// most recently touched tile of each 8 x 8 neighborhood -- so runs of nearby queries skip the hash entirely.
+///
+/// Changes are recorded per tile, as for the other layers (see `collect_changes(...)`); but in a sparse map
+/// rather than in an `index::DirtyTiles` -- whose dense table of stamps could not span the world.
+///
+/// \warning reads update the lookup cache; so concurrent readers must each use their own layer
+///
+/// \param cell_t_ - cell type
+/// \param tile_width_ - width of each tile, in cells; a power of two
+template<typename cell_t_ = uint8_t, size_t tile_width_ = 64>
+class TileWorld : public chartbox::ChartLayerInterface< cell_t_, TileWorld<cell_t_, tile_width_>> {
+public:
+    typedef cell_t_ cell_t;
+    typedef node::TileNode<cell_t, tile_width_> tile_t;
+
+    /// \brief width of each tile, in cells
+    constexpr static size_t tile_width = tile_width_;
+    constexpr static uint32_t tile_shift = tile_t::shift;
+
+    /// \brief number of slots in the lookup cache; one per tile of an 8 x 8 neighborhood
+    constexpr static size_t cache_size = 64;
+
+    constexpr static cell_t default_value = CellTraits<cell_t>::default_value;
+    constexpr static cell_t blocking_threshold = CellTraits<cell_t>::blocking_threshold;
+
+public:
+    TileWorld() = delete;
+
+    /// \brief construct an empty world; initially every cell is `default_value`
+    ///
+    /// \param _bounds - extent of this world, in its frame; truncated to 2^32 - 1 cells across
+    /// \param _precision - width of each cell
+    /// \param _max_tiles - writes which would allocate more tiles than this fail
+    TileWorld( const Eigen::AlignedBox2d& _bounds, const double _precision, const size_t _max_tiles = 65536 );
+
+    /// \brief override from ChartLayerInterface: sets every cell, and releases every tile
+    bool fill( const cell_t value );
+
+    bool fill( const Eigen::AlignedBox2d& area, const cell_t value ){
+        return super().fill( area, value ); }
+
+    bool fill( std::unique_ptr<OGRPolygon> source, cell_t value ){
+        return super().fill( std::move(source), value ); }
+
+    /// \brief override from ChartLayerInterface: one tile lookup per tile the span crosses
+    bool fill_span( const uint32_t j, const uint32_t i_begin, const uint32_t i_end, const cell_t value );
+
+    cell_t get( const Eigen::Vector2d& p ) const;
+
+    /// \warning does not check bounds
+    cell_t get( const uint32_t i, const uint32_t j ) const;
+
+    /// \warning does not check bounds
+    inline cell_t get( const index::Index2u& cell ) const {
+        return get( cell.i, cell.j ); }
+
+    /// \warning does not check bounds
+    inline bool blocked( const uint32_t i, const uint32_t j ) const {
+        return ( blocking_threshold <= get(i, j) ); }
+
+    /// \brief number of tiles currently allocated
+    inline size_t tile_count() const { return tile_count_; }
+
+    inline size_t max_tiles() const { return max_tiles_; }
+
+    /// \brief bytes held by the hash map, the tiles and their cells, and the change stamps
+    /// \note the stamps' per-node overhead is estimated
+    size_t memory_usage() const;
+
+    inline double precision() const { return precision_; }
+
+    /// \brief override from ChartLayerInterface: cells per unit of distance
+    inline double inverse_precision() const { return inverse_precision_; }
+
+    /// \brief Prints a summary of each allocated tile to stdout
+    void print_contents() const;
+
+    /// \brief version of the most recent write; increases with every write which changes a cell
+    inline uint64_t version() const { return version_; }
+
+    /// \brief Collect the areas modified since a given version; and advance that version to the current one
+    ///
+    /// Changes are tracked per tile; so each area is a run of whole tiles along a row of tiles, clipped to
+    /// the world.  After a fill of the whole world, the single area is the whole world.
+    ///
+    /// \param since - in: the version this consumer last processed; out: the current version
+    /// \param areas - appended with the modified areas, in the layer's frame
+    void collect_changes( uint64_t& since, std::vector<Eigen::AlignedBox2d>& areas ) const;
+
+    void reset();
+
+    bool store( const Eigen::Vector2d& p, const cell_t value );
+
+    /// \return false if the write needed a new tile, but `max_tiles` are already allocated
+    /// \warning does not check bounds
+    bool store( const uint32_t i, const uint32_t j, const cell_t value );
+
+    /// \warning does not check bounds
+    inline bool store( const index::Index2u& cell, const cell_t value ){
+        return store( cell.i, cell.j, value ); }
+
+    std::string type() const;
+
+    inline double width() const { return this->bounds_.sizes().maxCoeff(); }
+
+private:
+    constexpr static uint64_t empty_key = std::numeric_limits<uint64_t>::max();
+    constexpr static uint32_t absent = std::numeric_limits<uint32_t>::max();
+
+    struct Slot {
+        uint64_t key;
+        /// index into `tiles_`
+        uint32_t tile;
+    };
+
+    inline static uint64_t key_of( const uint32_t i, const uint32_t j ){
+        return ( static_cast<uint64_t>(j >> tile_shift) << 32 ) | (i >> tile_shift); }
+
+    /// \brief neighboring tiles map to distinct cache slots
+    inline static size_t cache_slot( const uint64_t key ){
+        return ( ((key >> 32) & 7) << 3 ) | (key & 7); }
+
+    inline size_t home_of( const uint64_t key ) const {
+        // Fibonacci hashing: the high bits of the product are well-mixed
+        return static_cast<size_t>( (key * 0x9E3779B97F4A7C15ull) >> (64 - slot_bits_) ); }
+
+    /// \return index of the tile with this key; or `absent`
+    uint32_t find( const uint64_t key ) const;
+
+    /// \brief allocate a tile, of the background value, for a key which has none
+    /// \return index of the new tile; or `absent`, if `max_tiles` are already allocated
+    uint32_t insert( const uint64_t key );
+
+    /// \brief release the tile with this key, if it has returned to the background value
+    void release_if_background( const uint64_t key, const uint32_t tile );
+
+    /// \brief set every cell to `value`, by releasing every tile; without recording a change
+    void release_all( const cell_t value );
+
+    /// \brief record a write which changed a cell of the tile with this key
+    inline void mark( const uint64_t key ){
+        stamps_[key] = ++version_; }
+
+    void rehash( const uint32_t bits );
+
+private:
+    /// \brief name of this layer's type
+    constexpr static char type_[] = "TileWorldLayer";
+
+    const double precision_;
+    const double inverse_precision_;
+    const size_t max_tiles_;
+
+    /// \brief number of cells along each dimension of this world
+    const uint32_t columns_;
+    const uint32_t rows_;
+
+    /// \brief value of every cell outside an allocated tile
+    cell_t background_;
+
+    /// \brief open-addressing hash map from tile keys to tiles; a power-of-two size, at most half full
+    std::vector<Slot> slots_;
+    uint32_t slot_bits_;
+
+    /// \brief pool of tiles; released tiles are recycled through `free_tiles_`
+    std::vector<tile_t> tiles_;
+    std::vector<uint32_t> free_tiles_;
+    size_t tile_count_ = 0;
+
+    /// \brief direct-mapped cache of recent lookups; including lookups of absent tiles
+    mutable std::array<Slot, cache_size> cache_;
+
+    uint64_t version_ = 0;
+
+    /// \brief version of the last fill of the whole world
+    uint64_t filled_version_ = 0;
+
+    /// \brief version of the last write to each tile since that fill; by tile key.  Kept after a tile is released.
+    std::unordered_map<uint64_t, uint64_t> stamps_;
+
+    chartbox::ChartLayerInterface< cell_t, TileWorld<cell_t, tile_width>>& super() {
+        return *static_cast<chartbox::ChartLayerInterface< cell_t, TileWorld<cell_t, tile_width>>*>(this);
+    }
+
+    const chartbox::ChartLayerInterface< cell_t, TileWorld<cell_t, tile_width>>& super() const {
+        return *static_cast<const chartbox::ChartLayerInterface< cell_t, TileWorld<cell_t, tile_width>>*>(this);
+    }
+};
+
+/// \brief the default world layer: byte-cells, in 64 x 64 tiles
+typedef TileWorld<> TileWorldLayer;
+
+} // namespace chartbox::layer
+
+#include "tile-world.inl"
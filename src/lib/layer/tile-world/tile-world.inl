@@ -0,0 +1,330 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// NOTE: This is the template-class implementation -- which is included from the header file.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <fmt/core.h>
+
+namespace chartbox::layer {
+
+namespace detail {
+
+/// \brief number of cells across an extent; truncated to fit a uint32 cell index
+inline uint32_t world_cells( const double extent, const double precision ){
+    const double cells = std::ceil( extent / precision );
+    if( ! (0 < cells) ){
+        return 0;
+    }
+    return static_cast<uint32_t>( std::min( cells, static_cast<double>(std::numeric_limits<uint32_t>::max()) ) );
+}
+
+} // namespace detail
+
+template<typename cell_t, size_t tile_width>
+TileWorld<cell_t,tile_width>::TileWorld( const Eigen::AlignedBox2d& _bounds, const double _precision, const size_t _max_tiles )
+    : chartbox::ChartLayerInterface< cell_t, TileWorld<cell_t, tile_width>>(_bounds)
+    , precision_(_precision)
+    , inverse_precision_(1.0 / _precision)
+    , max_tiles_(_max_tiles)
+    , columns_( detail::world_cells(_bounds.sizes().x(), _precision) )
+    , rows_( detail::world_cells(_bounds.sizes().y(), _precision) )
+{
+    release_all( default_value );
+}
+
+template<typename cell_t, size_t tile_width>
+void TileWorld<cell_t,tile_width>::collect_changes( uint64_t& since, std::vector<Eigen::AlignedBox2d>& areas ) const {
+    if( since < filled_version_ ){
+        areas.emplace_back( Eigen::Vector2d(0, 0), Eigen::Vector2d(columns_, rows_) * precision_ );
+        since = version_;
+        return;
+    }
+
+    // keys order tiles by row, then by column; so adjacent tiles of a row are adjacent keys
+    std::vector<uint64_t> keys;
+    for( const auto& [key, stamp] : stamps_ ){
+        if( since < stamp ){
+            keys.push_back( key );
+        }
+    }
+    std::sort( keys.begin(), keys.end() );
+
+    for( size_t k = 0; k < keys.size(); ){
+        const uint64_t first = keys[k];
+        uint64_t last = first;
+        for( ++k; (k < keys.size()) && (last + 1 == keys[k]); ++k ){
+            last = keys[k];
+        }
+
+        const uint64_t tile_j = first >> 32;
+        const uint64_t i_begin = (first & 0xFFFFFFFF) << tile_shift;
+        const uint64_t i_end = std::min<uint64_t>( ((last & 0xFFFFFFFF) + 1) << tile_shift, columns_ );
+        const uint64_t j_begin = tile_j << tile_shift;
+        const uint64_t j_end = std::min<uint64_t>( (tile_j + 1) << tile_shift, rows_ );
+        areas.emplace_back( Eigen::Vector2d(i_begin, j_begin) * precision_, Eigen::Vector2d(i_end, j_end) * precision_ );
+    }
+    since = version_;
+}
+
+template<typename cell_t, size_t tile_width>
+bool TileWorld<cell_t,tile_width>::fill( const cell_t value ){
+    release_all( value );
+    filled_version_ = ++version_;
+    return true;
+}
+
+template<typename cell_t, size_t tile_width>
+void TileWorld<cell_t,tile_width>::release_all( const cell_t value ){
+    background_ = value;
+
+    slot_bits_ = 4;
+    std::vector<Slot>( size_t(1) << slot_bits_, Slot{empty_key, absent} ).swap( slots_ );
+    std::vector<tile_t>().swap( tiles_ );
+    std::vector<uint32_t>().swap( free_tiles_ );
+    tile_count_ = 0;
+
+    cache_.fill( Slot{empty_key, absent} );
+    // a fill of the whole world supersedes every tile's stamp
+    std::unordered_map<uint64_t, uint64_t>().swap( stamps_ );
+}
+
+template<typename cell_t, size_t tile_width>
+bool TileWorld<cell_t,tile_width>::fill_span( const uint32_t j, const uint32_t i_begin, const uint32_t i_end, const cell_t value ){
+    uint32_t i = i_begin;
+    while( i < i_end ){
+        // the remainder of the span within this tile
+        const uint64_t tile_end = std::min<uint64_t>( i_end, (static_cast<uint64_t>(i >> tile_shift) + 1) << tile_shift );
+        const uint64_t key = key_of( i, j );
+
+        uint32_t tile = find( key );
+        if( absent == tile ){
+            if( node::detail::same_bits(value, background_) ){
+                i = static_cast<uint32_t>( tile_end );
+                continue;
+            }
+            tile = insert( key );
+            if( absent == tile ){
+                return false;
+            }
+        }
+
+        bool changed = false;
+        for( ; i < tile_end; ++i ){
+            changed |= tiles_[tile].store( i, j, value );
+        }
+        if( changed ){
+            mark( key );
+            release_if_background( key, tile );
+        }
+    }
+    return true;
+}
+
+template<typename cell_t, size_t tile_width>
+uint32_t TileWorld<cell_t,tile_width>::find( const uint64_t key ) const {
+    Slot& cached = cache_[ cache_slot(key) ];
+    if( key == cached.key ){
+        return cached.tile;
+    }
+
+    const size_t mask = slots_.size() - 1;
+    for( size_t index = home_of(key); ; index = (index + 1) & mask ){
+        const Slot& slot = slots_[index];
+        if( key == slot.key ){
+            cached = slot;
+            return slot.tile;
+        }else if( empty_key == slot.key ){
+            // absent tiles are cached too; so repeated reads of open water skip the probe
+            cached = Slot{ key, absent };
+            return absent;
+        }
+    }
+}
+
+template<typename cell_t, size_t tile_width>
+cell_t TileWorld<cell_t,tile_width>::get( const Eigen::Vector2d& p ) const {
+    if( (p.x() < 0) || (p.y() < 0) ){
+        return default_value;
+    }
+    const double x = p.x() * inverse_precision_;
+    const double y = p.y() * inverse_precision_;
+    if( (columns_ <= x) || (rows_ <= y) ){
+        return default_value;
+    }
+    return get( static_cast<uint32_t>(x), static_cast<uint32_t>(y) );
+}
+
+template<typename cell_t, size_t tile_width>
+cell_t TileWorld<cell_t,tile_width>::get( const uint32_t i, const uint32_t j ) const {
+    const uint32_t tile = find( key_of(i, j) );
+    return ( absent == tile ) ? background_ : tiles_[tile].get( i, j );
+}
+
+template<typename cell_t, size_t tile_width>
+uint32_t TileWorld<cell_t,tile_width>::insert( const uint64_t key ){
+    if( max_tiles_ <= tile_count_ ){
+        return absent;
+    }
+    // keep the map at most half-full; so probes stay short
+    if( slots_.size() < 2 * (tile_count_ + 1) ){
+        rehash( slot_bits_ + 1 );
+    }
+
+    uint32_t tile;
+    if( free_tiles_.empty() ){
+        tile = static_cast<uint32_t>( tiles_.size() );
+        tiles_.emplace_back( background_ );
+    }else{
+        tile = free_tiles_.back();
+        free_tiles_.pop_back();
+        tiles_[tile].fill( background_ );
+    }
+
+    const size_t mask = slots_.size() - 1;
+    size_t index = home_of( key );
+    while( empty_key != slots_[index].key ){
+        index = (index + 1) & mask;
+    }
+    slots_[index] = Slot{ key, tile };
+    ++tile_count_;
+
+    cache_[ cache_slot(key) ] = Slot{ key, tile };
+    return tile;
+}
+
+template<typename cell_t, size_t tile_width>
+size_t TileWorld<cell_t,tile_width>::memory_usage() const {
+    size_t bytes = sizeof(*this)
+                 + slots_.capacity() * sizeof(Slot)
+                 + tiles_.capacity() * sizeof(tile_t)
+                 + free_tiles_.capacity() * sizeof(uint32_t)
+                 + stamps_.bucket_count() * sizeof(void*)
+                 + stamps_.size() * (sizeof(std::pair<const uint64_t, uint64_t>) + sizeof(void*));
+    for( const auto& tile : tiles_ ){
+        bytes += tile.memory_usage() - sizeof(tile_t);
+    }
+    return bytes;
+}
+
+template<typename cell_t, size_t tile_width>
+void TileWorld<cell_t,tile_width>::print_contents() const {
+    fmt::print( "============ ============ Tile-World-Layer Contents ============ ============\n" );
+    fmt::print( "    {} x {} cells; {} x {} tiles; {} allocated; {} bytes\n",
+                columns_, rows_, tile_width, tile_width, tile_count_, memory_usage() );
+    for( const auto& slot : slots_ ){
+        if( empty_key == slot.key ){
+            continue;
+        }
+        const tile_t& tile = tiles_[slot.tile];
+        fmt::print( "    tile ({}, {}): ", slot.key & 0xFFFFFFFF, slot.key >> 32 );
+        if( tile.uniform() ){
+            fmt::print( "uniform {:2X}\n", static_cast<int>(tile.value()) );
+        }else{
+            fmt::print( "mixed\n" );
+        }
+    }
+    fmt::print( "============ ============ ============ ============ ============ ============\n" );
+}
+
+template<typename cell_t, size_t tile_width>
+void TileWorld<cell_t,tile_width>::rehash( const uint32_t bits ){
+    std::vector<Slot> previous( size_t(1) << bits, Slot{empty_key, absent} );
+    previous.swap( slots_ );
+    slot_bits_ = bits;
+
+    const size_t mask = slots_.size() - 1;
+    for( const auto& slot : previous ){
+        if( empty_key == slot.key ){
+            continue;
+        }
+        size_t index = home_of( slot.key );
+        while( empty_key != slots_[index].key ){
+            index = (index + 1) & mask;
+        }
+        slots_[index] = slot;
+    }
+    // the cache maps keys to tiles -- not to slots -- so it remains valid
+}
+
+template<typename cell_t, size_t tile_width>
+void TileWorld<cell_t,tile_width>::release_if_background( const uint64_t key, const uint32_t tile ){
+    const tile_t& node = tiles_[tile];
+    if( (! node.uniform()) || (! node::detail::same_bits(node.value(), background_)) ){
+        return;
+    }
+
+    const size_t mask = slots_.size() - 1;
+    size_t hole = home_of( key );
+    while( key != slots_[hole].key ){
+        hole = (hole + 1) & mask;
+    }
+
+    // backward-shift deletion: pull each later entry of this probe run back into the hole, unless that
+    // would move it before its home slot.  No tombstones; so probe lengths never degrade.
+    for( size_t next = (hole + 1) & mask; empty_key != slots_[next].key; next = (next + 1) & mask ){
+        const size_t home = home_of( slots_[next].key );
+        if( ((next - home) & mask) >= ((next - hole) & mask) ){
+            slots_[hole] = slots_[next];
+            hole = next;
+        }
+    }
+    slots_[hole] = Slot{ empty_key, absent };
+
+    free_tiles_.push_back( tile );
+    --tile_count_;
+    cache_[ cache_slot(key) ] = Slot{ key, absent };
+}
+
+template<typename cell_t, size_t tile_width>
+void TileWorld<cell_t,tile_width>::reset() {
+    fill( default_value );
+}
+
+template<typename cell_t, size_t tile_width>
+bool TileWorld<cell_t,tile_width>::store( const Eigen::Vector2d& p, const cell_t value ){
+    if( (p.x() < 0) || (p.y() < 0) ){
+        return false;
+    }
+    const double x = p.x() * inverse_precision_;
+    const double y = p.y() * inverse_precision_;
+    if( (columns_ <= x) || (rows_ <= y) ){
+        return false;
+    }
+    return store( static_cast<uint32_t>(x), static_cast<uint32_t>(y), value );
+}
+
+template<typename cell_t, size_t tile_width>
+bool TileWorld<cell_t,tile_width>::store( const uint32_t i, const uint32_t j, const cell_t value ){
+    const uint64_t key = key_of( i, j );
+    uint32_t tile = find( key );
+    if( absent == tile ){
+        if( node::detail::same_bits(value, background_) ){
+            return true;
+        }
+        tile = insert( key );
+        if( absent == tile ){
+            return false;
+        }
+    }
+
+    if( tiles_[tile].store(i, j, value) ){
+        mark( key );
+        release_if_background( key, tile );
+    }
+    return true;
+}
+
+template<typename cell_t, size_t tile_width>
+std::string TileWorld<cell_t,tile_width>::type() const {
+    return type_;
+}
+
+} // namespace chartbox::layer
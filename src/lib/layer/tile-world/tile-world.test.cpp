@@ -0,0 +1,237 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include "layer/fixed-grid/fixed-grid.hpp"
+
+#include "tile-world.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+namespace chartbox::layer {
+
+// 8 x 8 tiles; so small areas still cross many tiles
+typedef TileWorld<uint8_t, 8> TileWorld8;
+typedef FixedGrid< index::RowMajorIndex<64> > FixedGrid64;
+
+// a stretch of coast: far wider than any single local frame
+static const AlignedBox2d coast( Vector2d(0,0), Vector2d(2'000'000, 1'500'000) );
+
+TEST( TileWorld, Construct ){
+    TileWorldLayer world( coast, 1.0 );
+    EXPECT_DOUBLE_EQ( world.precision(), 1.0 );
+    EXPECT_DOUBLE_EQ( world.width(), 2'000'000 );
+    EXPECT_EQ( world.tile_count(), 0 );
+    EXPECT_LT( world.memory_usage(), 4096 );
+    EXPECT_EQ( world.get({3, 3}), TileWorldLayer::default_value );
+    EXPECT_EQ( world.get({1'999'999.5, 1'499'999.5}), TileWorldLayer::default_value );
+    EXPECT_EQ( world.get({-3, 3}), TileWorldLayer::default_value );
+    EXPECT_EQ( world.type(), "TileWorldLayer" );
+}
+
+TEST( TileWorld, SparseWritesFarApart ){
+    TileWorldLayer world( coast, 1.0 );
+    world.fill( 0 );
+
+    EXPECT_TRUE( world.store( Vector2d(10.5, 20.5), 0x99 ) );
+    EXPECT_TRUE( world.store( Vector2d(1'999'990.5, 1'499'990.5), 0x88 ) );
+    EXPECT_TRUE( world.store( Vector2d(1'000'000.5, 20.5), 0x77 ) );
+    EXPECT_EQ( world.tile_count(), 3 );
+
+    EXPECT_EQ( world.get({10.5, 20.5}), 0x99 );
+    EXPECT_EQ( world.get({11.5, 20.5}), 0 );
+    EXPECT_EQ( world.get({1'999'990.5, 1'499'990.5}), 0x88 );
+    EXPECT_EQ( world.get({1'000'000.5, 20.5}), 0x77 );
+    EXPECT_EQ( world.get({500'000.5, 20.5}), 0 );
+    EXPECT_TRUE( world.blocked( 10, 20 ) );
+    EXPECT_FALSE( world.blocked( 11, 20 ) );
+
+    // three 64 x 64 tiles of bytes; independent of the extent
+    EXPECT_LT( world.memory_usage(), 3 * 64 * 64 + 4096 );
+
+    EXPECT_FALSE( world.store( Vector2d(2'000'000.5, 3.5), 0x99 ) );
+    EXPECT_FALSE( world.store( Vector2d(-0.5, 3.5), 0x99 ) );
+}
+
+TEST( TileWorld, BackgroundReleasesTiles ){
+    TileWorldLayer world( coast, 1.0 );
+    world.fill( 0 );
+    const size_t empty_bytes = world.memory_usage();
+
+    EXPECT_TRUE( world.fill( AlignedBox2d(Vector2d(100, 100), Vector2d(300, 140)), 0x40 ) );
+    EXPECT_EQ( world.get({150, 120}), 0x40 );
+    EXPECT_EQ( world.get({150, 150}), 0 );
+    EXPECT_LT( 0, world.tile_count() );
+
+    // writing it back releases every tile
+    EXPECT_TRUE( world.fill( AlignedBox2d(Vector2d(100, 100), Vector2d(300, 140)), 0 ) );
+    EXPECT_EQ( world.tile_count(), 0 );
+    EXPECT_EQ( world.get({150, 120}), 0 );
+
+    // ... and refill recycles them
+    EXPECT_TRUE( world.store( Vector2d(10.5, 20.5), 0x99 ) );
+    EXPECT_EQ( world.tile_count(), 1 );
+
+    world.fill( 0x11 );
+    EXPECT_EQ( world.tile_count(), 0 );
+    EXPECT_EQ( world.get({10.5, 20.5}), 0x11 );
+    EXPECT_EQ( world.memory_usage(), empty_bytes );
+}
+
+TEST( TileWorld, TileBudget ){
+    TileWorld8 world( coast, 1.0, 4 );
+    world.fill( 0 );
+
+    for( uint32_t tile = 0; tile < 4; ++tile ){
+        EXPECT_TRUE( world.store( 1000 * tile, 0, 0x99 ) );
+    }
+    EXPECT_EQ( world.tile_count(), 4 );
+    const size_t full_bytes = world.memory_usage();
+
+    // a fifth tile is refused; writes into existing tiles -- or of the background -- still succeed
+    EXPECT_FALSE( world.store( 5000, 0, 0x99 ) );
+    EXPECT_EQ( world.get( 5000, 0 ), 0 );
+    EXPECT_TRUE( world.store( 1, 1, 0x99 ) );
+    EXPECT_TRUE( world.store( 5000, 0, 0 ) );
+    EXPECT_EQ( world.tile_count(), 4 );
+    EXPECT_EQ( world.memory_usage(), full_bytes );
+
+    // freeing a tile makes room
+    EXPECT_TRUE( world.store( 0, 0, 0 ) );
+    EXPECT_TRUE( world.store( 1, 1, 0 ) );
+    EXPECT_EQ( world.tile_count(), 3 );
+    EXPECT_TRUE( world.store( 5000, 0, 0x99 ) );
+    EXPECT_EQ( world.get( 5000, 0 ), 0x99 );
+}
+
+TEST( TileWorld, RecordsChangedWrites ){
+    TileWorld8 world( coast, 1.0 );
+    EXPECT_EQ( world.version(), 0 );
+    world.fill( 0 );
+    uint64_t since = 0;
+    std::vector<AlignedBox2d> areas;
+    world.collect_changes( since, areas );
+    EXPECT_EQ( since, world.version() );
+    ASSERT_EQ( areas.size(), 1 );
+    EXPECT_TRUE( areas[0].isApprox(coast) );
+
+    // rewriting the background is not a change
+    world.store( {5.5, 5.5}, 0 );
+    EXPECT_EQ( world.version(), since );
+
+    // ... but writing a new value is; through either store
+    EXPECT_TRUE( world.store( {1'000'005.5, 5.5}, 0x99 ) );
+    EXPECT_LT( since, world.version() );
+    areas.clear();
+    world.collect_changes( since, areas );
+    ASSERT_EQ( areas.size(), 1 );
+    EXPECT_TRUE( areas[0].isApprox(AlignedBox2d(Vector2d(1'000'000, 0), Vector2d(1'000'008, 8))) );
+    world.store( 1'000'005, 5, 0 );
+    areas.clear();
+    world.collect_changes( since, areas );
+    EXPECT_EQ( areas.size(), 1 );
+
+    // changes are tracked per 8x8 tile; as runs along each row of tiles -- including the tiles which were released
+    world.fill( AlignedBox2d(Vector2d(10, 20), Vector2d(30, 22)), 0x99 );
+    world.fill( AlignedBox2d(Vector2d(10, 20), Vector2d(30, 22)), 0 );
+    EXPECT_EQ( world.tile_count(), 0 );
+    areas.clear();
+    world.collect_changes( since, areas );
+    EXPECT_EQ( since, world.version() );
+    ASSERT_EQ( areas.size(), 1 );
+    EXPECT_TRUE( areas[0].isApprox(AlignedBox2d(Vector2d(8, 16), Vector2d(32, 24))) );
+
+    // nothing written since
+    areas.clear();
+    world.collect_changes( since, areas );
+    EXPECT_TRUE( areas.empty() );
+
+    // tiles at the edge of the world are clipped to it
+    TileWorld8 small( AlignedBox2d(Vector2d(0, 0), Vector2d(100, 50)), 1.0 );
+    since = small.version();
+    small.store( {99.5, 49.5}, 0x99 );
+    areas.clear();
+    small.collect_changes( since, areas );
+    ASSERT_EQ( areas.size(), 1 );
+    EXPECT_TRUE( areas[0].isApprox(AlignedBox2d(Vector2d(96, 48), Vector2d(100, 50))) );
+}
+
+TEST( TileWorld, MatchesReference ){
+    // many tiles, written and erased at random: exercises rehashing, backward-shift deletion, and the cache
+    TileWorld8 world( coast, 1.0, 1 << 20 );
+    world.fill( 0 );
+    std::map<std::pair<uint32_t, uint32_t>, uint8_t> reference;
+
+    std::mt19937 generator( 7 );
+    std::uniform_int_distribution<uint32_t> column( 0, 4095 );
+    std::uniform_int_distribution<int> value( 0, 2 );
+    for( size_t count = 0; count < 200'000; ++count ){
+        const uint32_t i = column( generator );
+        const uint32_t j = column( generator ) / 4;
+        const uint8_t cell = static_cast<uint8_t>( 0x40 * value(generator) );
+        ASSERT_TRUE( world.store( i, j, cell ) );
+        reference[{i, j}] = cell;
+
+        if( 0 == (count % 1000) ){
+            const uint32_t probe_i = column( generator );
+            const uint32_t probe_j = column( generator ) / 4;
+            const auto found = reference.find( {probe_i, probe_j} );
+            ASSERT_EQ( world.get( probe_i, probe_j ), (reference.end() == found) ? 0 : found->second );
+        }
+    }
+
+    size_t written = 0;
+    for( const auto& [index, cell] : reference ){
+        ASSERT_EQ( world.get( index.first, index.second ), cell ) << "    @@ (" << index.first << ", " << index.second << ")";
+        written += ( 0 < cell );
+    }
+    EXPECT_LT( 0, written );
+
+    // erasing every cell releases every tile
+    for( const auto& [index, cell] : reference ){
+        ASSERT_TRUE( world.store( index.first, index.second, 0 ) );
+    }
+    EXPECT_EQ( world.tile_count(), 0 );
+    for( const auto& [index, cell] : reference ){
+        ASSERT_EQ( world.get( index.first, index.second ), 0 );
+    }
+}
+
+TEST( TileWorld, MatchesFixedGrid ){
+    const AlignedBox2d bounds( Vector2d(0,0), Vector2d(64,64) );
+    for( uint32_t seed = 1; seed < 6; ++seed ){
+        TileWorld8 world( bounds, 1.0 );
+        FixedGrid64 grid( bounds );
+        world.fill( 0 );
+        grid.fill( 0 );
+
+        std::mt19937 generator( seed );
+        std::uniform_real_distribution<double> corner( -8, 64 );
+        std::uniform_real_distribution<double> size( 0, 30 );
+        std::uniform_int_distribution<int> value( 0, 3 );
+        for( size_t count = 0; count < 40; ++count ){
+            const Vector2d low( corner(generator), corner(generator) );
+            const AlignedBox2d area( low, low + Vector2d(size(generator), size(generator)) );
+            const uint8_t cell = static_cast<uint8_t>( 0x40 * value(generator) );
+            world.fill( area, cell );
+            grid.fill( area, cell );
+        }
+
+        for( uint32_t j = 0; j < 64; ++j ){
+            for( uint32_t i = 0; i < 64; ++i ){
+                ASSERT_EQ( world.get(i, j), grid.data()[ grid.lookup(i, j) ] ) << "    @@ seed: " << seed << " (" << i << ", " << j << ")";
+            }
+        }
+        EXPECT_LE( world.tile_count(), 64 );
+    }
+}
+
+} // namespace chartbox::layer
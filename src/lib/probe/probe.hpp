@@ -0,0 +1,350 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+
+/// \brief Hot-path instrumentation: scoped timers and counters, each with a log2 histogram
+///
+/// Probes are placed with the `CHARTBOX_PROBE_*` macros below.  Unless `CHARTBOX_ENABLE_PROBES` is defined
+/// (CMake option: `CHARTBOX_PROBES`) every macro expands to nothing, and its arguments are not evaluated.
+///
+/// Each thread records into its own slots, without locks or atomic read-modify-writes; `snapshot()` sums
+/// the slots of every thread -- including those which have exited.  Sites with the same name share a slot.
+///
+/// Usage:
+///     CHARTBOX_PROBE_SCOPE( "layer.fill.area" );            // time this scope
+///     CHARTBOX_PROBE_COUNT( "geojson.vertices", count );    // record one value
+///     CHARTBOX_PROBE_TALLY( expansions, "astar.expansions" );   // in a loop: count into a local ...
+///     CHARTBOX_PROBE_INCREMENT( expansions );                   // ... and record it when the scope exits
+namespace chartbox::probe {
+
+enum Kind : uint8_t {
+    Timer=0,     // values are durations, in nanoseconds
+    Counter=1,   // values are unitless counts
+};
+
+/// \brief maximum number of distinct probe names; later names are recorded into slot 0 ("probe.overflow")
+constexpr size_t max_sites = 128;
+
+/// \brief bucket k holds the values in [2^(k-1), 2^k); bucket 0 holds zeros; the last bucket is open-ended
+constexpr size_t bucket_count = 32;
+
+#ifdef CHARTBOX_ENABLE_PROBES
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+/// \brief the totals of one probe, across every thread
+struct Summary {
+    std::string name;
+    Kind kind;
+    uint64_t count;     ///< number of recorded values
+    uint64_t total;     ///< sum of the recorded values
+    uint64_t minimum;
+    uint64_t maximum;
+    std::array<uint64_t, bucket_count> buckets;
+
+    inline double mean() const { return (0 == count) ? 0. : static_cast<double>(total) / count; }
+};
+
+inline size_t bucket_of( const uint64_t value ){
+    const size_t width = (0 == value) ? 0 : (64 - __builtin_clzll(value));
+    return (width < bucket_count) ? width : (bucket_count - 1);
+}
+
+/// \brief accumulator of one probe, in one thread
+///
+/// Only the owning thread writes; so plain load-and-store (rather than `fetch_add`) suffices, and the
+/// atomics only keep concurrent snapshots well-defined.
+struct Slot {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> minimum{ std::numeric_limits<uint64_t>::max() };
+    std::atomic<uint64_t> maximum{0};
+    std::array<std::atomic<uint64_t>, bucket_count> buckets{};
+
+    inline void record( const uint64_t value ){
+        constexpr auto relaxed = std::memory_order_relaxed;
+        count.store( count.load(relaxed) + 1, relaxed );
+        total.store( total.load(relaxed) + value, relaxed );
+        if( value < minimum.load(relaxed) ){ minimum.store( value, relaxed ); }
+        if( maximum.load(relaxed) < value ){ maximum.store( value, relaxed ); }
+        auto& bucket = buckets[ bucket_of(value) ];
+        bucket.store( bucket.load(relaxed) + 1, relaxed );
+    }
+
+    /// \brief add this slot's values into the summary
+    inline void add_to( Summary& summary ) const {
+        constexpr auto relaxed = std::memory_order_relaxed;
+        summary.count += count.load(relaxed);
+        summary.total += total.load(relaxed);
+        summary.minimum = std::min( summary.minimum, minimum.load(relaxed) );
+        summary.maximum = std::max( summary.maximum, maximum.load(relaxed) );
+        for( size_t k = 0; k < bucket_count; ++k ){
+            summary.buckets[k] += buckets[k].load(relaxed);
+        }
+    }
+
+    /// \brief fold another slot into this one (only while its owner cannot write to it)
+    inline void merge( const Slot& other ){
+        Summary sum{ "", Counter, 0, 0, std::numeric_limits<uint64_t>::max(), 0, {} };
+        add_to( sum );
+        other.add_to( sum );
+        restore( sum );
+    }
+
+    inline void restore( const Summary& sum ){
+        constexpr auto relaxed = std::memory_order_relaxed;
+        count.store( sum.count, relaxed );
+        total.store( sum.total, relaxed );
+        minimum.store( sum.minimum, relaxed );
+        maximum.store( sum.maximum, relaxed );
+        for( size_t k = 0; k < bucket_count; ++k ){
+            buckets[k].store( sum.buckets[k], relaxed );
+        }
+    }
+
+    inline void clear(){
+        restore({ "", Counter, 0, 0, std::numeric_limits<uint64_t>::max(), 0, {} });
+    }
+};
+
+typedef std::array<Slot, max_sites> ThreadSlots;
+
+/// \brief process-wide list of probe names, and of the slots of each thread
+class Registry {
+public:
+    static Registry& instance(){
+        static Registry registry;
+        return registry;
+    }
+
+    /// \brief the slot index for the given name; called once per probe site
+    uint32_t enroll( const char* name, const Kind kind ){
+        const std::lock_guard<std::mutex> lock( mutex_ );
+        for( uint32_t site = 0; site < names_.size(); ++site ){
+            if( names_[site] == name ){
+                return site;
+            }
+        }
+        if( max_sites <= names_.size() ){
+            return 0;
+        }
+        names_.emplace_back( name );
+        kinds_.push_back( kind );
+        return static_cast<uint32_t>( names_.size() - 1 );
+    }
+
+    void attach( ThreadSlots* slots ){
+        const std::lock_guard<std::mutex> lock( mutex_ );
+        threads_.push_back( slots );
+    }
+
+    /// \brief keep the totals of an exiting thread
+    void detach( ThreadSlots* slots ){
+        const std::lock_guard<std::mutex> lock( mutex_ );
+        for( size_t site = 0; site < max_sites; ++site ){
+            retired_[site].merge( (*slots)[site] );
+        }
+        threads_.erase( std::find(threads_.begin(), threads_.end(), slots) );
+    }
+
+    std::vector<Summary> snapshot() const {
+        const std::lock_guard<std::mutex> lock( mutex_ );
+        std::vector<Summary> summaries;
+        for( uint32_t site = 0; site < names_.size(); ++site ){
+            Summary summary{ names_[site], kinds_[site], 0, 0, std::numeric_limits<uint64_t>::max(), 0, {} };
+            retired_[site].add_to( summary );
+            for( const ThreadSlots* slots : threads_ ){
+                (*slots)[site].add_to( summary );
+            }
+            if( 0 < summary.count ){
+                summaries.push_back( summary );
+            }
+        }
+        return summaries;
+    }
+
+    /// \warning values recorded concurrently with a reset may be partially kept
+    void reset(){
+        const std::lock_guard<std::mutex> lock( mutex_ );
+        for( size_t site = 0; site < max_sites; ++site ){
+            retired_[site].clear();
+            for( ThreadSlots* slots : threads_ ){
+                (*slots)[site].clear();
+            }
+        }
+    }
+
+private:
+    Registry()
+        : names_({"probe.overflow"})
+        , kinds_({Counter})
+    {}
+
+    mutable std::mutex mutex_;
+    std::vector<std::string> names_;
+    std::vector<Kind> kinds_;
+    std::vector<ThreadSlots*> threads_;
+    ThreadSlots retired_;
+};
+
+/// \brief the calling thread's slots; attached to the registry on first use, and detached on thread exit
+inline ThreadSlots& local_slots(){
+    struct Local {
+        Local() : slots( new ThreadSlots() ) { Registry::instance().attach( slots ); }
+        ~Local(){ Registry::instance().detach( slots ); delete slots; }
+        ThreadSlots* slots;
+    };
+    thread_local Local local;
+    return *local.slots;
+}
+
+inline uint32_t enroll( const char* name, const Kind kind ){
+    return Registry::instance().enroll( name, kind );
+}
+
+inline void record( const uint32_t site, const uint64_t value ){
+    local_slots()[site].record( value );
+}
+
+/// \brief records the lifetime of this object, in nanoseconds
+class ScopedTimer {
+public:
+    explicit ScopedTimer( const uint32_t site )
+        : site_(site)
+        , start_( std::chrono::steady_clock::now() )
+    {}
+
+    ~ScopedTimer(){
+        const auto elapsed = std::chrono::steady_clock::now() - start_;
+        record( site_, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() );
+    }
+
+private:
+    const uint32_t site_;
+    const std::chrono::steady_clock::time_point start_;
+};
+
+/// \brief counts events into a local variable, and records the total once, when it goes out of scope
+class Tally {
+public:
+    explicit Tally( const uint32_t site ) : site_(site) {}
+
+    ~Tally(){ record( site_, count_ ); }
+
+    inline Tally& operator++(){ ++count_; return *this; }
+    inline Tally& operator+=( const uint64_t count ){ count_ += count; return *this; }
+
+private:
+    const uint32_t site_;
+    uint64_t count_ = 0;
+};
+
+// ====================================== Dump API ======================================
+// These are always available; while probes are disabled they report nothing.
+
+/// \brief totals of every probe which recorded at least one value, in order of first use
+inline std::vector<Summary> snapshot(){
+    return enabled ? Registry::instance().snapshot() : std::vector<Summary>();
+}
+
+/// \brief discard every recorded value
+inline void reset(){
+    if( enabled ){
+        Registry::instance().reset();
+    }
+}
+
+/// \brief all of the probes, as a JSON document:
+///     {"probes": [{"name": ..., "kind": "timer"|"counter", "count": ..., "total": ..., "min": ..., "max": ...,
+///                  "mean": ..., "histogram": [[<exclusive upper bound of bucket>, <count>], ...]}, ...]}
+inline std::string to_json(){
+    std::string text = "{\"probes\": [";
+    const auto summaries = snapshot();
+    for( size_t index = 0; index < summaries.size(); ++index ){
+        const Summary& each = summaries[index];
+        text += fmt::format( "{}\n  {{\"name\": \"{}\", \"kind\": \"{}\", \"count\": {}, \"total\": {}, \"min\": {}, \"max\": {}, \"mean\": {:.1f}, \"histogram\": [",
+                             (0 == index) ? "" : ",", each.name, (Timer == each.kind) ? "timer" : "counter",
+                             each.count, each.total, each.minimum, each.maximum, each.mean() );
+        bool first = true;
+        for( size_t k = 0; k < bucket_count; ++k ){
+            if( 0 < each.buckets[k] ){
+                // (the last bucket is open-ended)
+                const uint64_t bound = (k + 1 < bucket_count) ? (uint64_t(1) << k) : std::numeric_limits<uint64_t>::max();
+                text += fmt::format( "{}[{}, {}]", first ? "" : ", ", bound, each.buckets[k] );
+                first = false;
+            }
+        }
+        text += "]}";
+    }
+    text += "\n]}\n";
+    return text;
+}
+
+/// \brief print a table of all the probes; timers are shown in microseconds
+inline void print( std::FILE* sink = stdout ){
+    if( ! enabled ){
+        fmt::print( sink, "<< probes disabled; reconfigure with -DCHARTBOX_PROBES=ON\n" );
+        return;
+    }
+    fmt::print( sink, "============ ============ Probes ============ ============\n" );
+    fmt::print( sink, "{:<32} {:>10} {:>14} {:>12} {:>12} {:>12}\n", "name", "count", "total", "mean", "min", "max" );
+    for( const auto& each : snapshot() ){
+        const double scale = (Timer == each.kind) ? 1e-3 : 1.;
+        fmt::print( sink, "{:<32} {:>10} {:>14.1f} {:>12.3f} {:>12.3f} {:>12.3f}{}\n", each.name, each.count,
+                    each.total * scale, each.mean() * scale, each.minimum * scale, each.maximum * scale,
+                    (Timer == each.kind) ? "  (us)" : "" );
+    }
+}
+
+} // namespace chartbox::probe
+
+#define CHARTBOX_PROBE_CONCAT_( a, b ) a##b
+#define CHARTBOX_PROBE_CONCAT( a, b ) CHARTBOX_PROBE_CONCAT_( a, b )
+
+#ifdef CHARTBOX_ENABLE_PROBES
+
+/// \brief time from here to the end of the enclosing scope
+#define CHARTBOX_PROBE_SCOPE( name ) \
+    static const uint32_t CHARTBOX_PROBE_CONCAT(probe_site_, __LINE__) = ::chartbox::probe::enroll( name, ::chartbox::probe::Timer ); \
+    const ::chartbox::probe::ScopedTimer CHARTBOX_PROBE_CONCAT(probe_timer_, __LINE__)( CHARTBOX_PROBE_CONCAT(probe_site_, __LINE__) )
+
+/// \brief record one value
+#define CHARTBOX_PROBE_COUNT( name, value ) \
+    do { \
+        static const uint32_t probe_site = ::chartbox::probe::enroll( name, ::chartbox::probe::Counter ); \
+        ::chartbox::probe::record( probe_site, static_cast<uint64_t>(value) ); \
+    } while( false )
+
+/// \brief declare a local counter `variable`; its total is recorded at the end of the enclosing scope
+#define CHARTBOX_PROBE_TALLY( variable, name ) \
+    static const uint32_t CHARTBOX_PROBE_CONCAT(variable, _site) = ::chartbox::probe::enroll( name, ::chartbox::probe::Counter ); \
+    ::chartbox::probe::Tally variable( CHARTBOX_PROBE_CONCAT(variable, _site) )
+
+#define CHARTBOX_PROBE_INCREMENT( variable ) ( ++variable )
+#define CHARTBOX_PROBE_ADD( variable, count ) ( variable += static_cast<uint64_t>(count) )
+
+#else
+
+#define CHARTBOX_PROBE_SCOPE( name ) static_cast<void>(0)
+#define CHARTBOX_PROBE_COUNT( name, value ) static_cast<void>(0)
+#define CHARTBOX_PROBE_TALLY( variable, name ) static_cast<void>(0)
+#define CHARTBOX_PROBE_INCREMENT( variable ) static_cast<void>(0)
+#define CHARTBOX_PROBE_ADD( variable, count ) static_cast<void>(0)
+
+#endif
@@ -0,0 +1,96 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// (usually set by the `CHARTBOX_PROBES` cmake option)
+#define CHARTBOX_ENABLE_PROBES
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "probe.hpp"
+
+namespace chartbox::probe {
+
+static const Summary* find( const std::vector<Summary>& summaries, const std::string& name ){
+    for( const auto& each : summaries ){
+        if( each.name == name ){
+            return &each;
+        }
+    }
+    return nullptr;
+}
+
+static void expand( const size_t count ){
+    CHARTBOX_PROBE_SCOPE( "test.expand" );
+    CHARTBOX_PROBE_TALLY( expansions, "test.expansions" );
+    for( size_t k = 0; k < count; ++k ){
+        CHARTBOX_PROBE_INCREMENT( expansions );
+    }
+}
+
+TEST( Probe, BucketOf ){
+    EXPECT_EQ( bucket_of(0), 0 );
+    EXPECT_EQ( bucket_of(1), 1 );
+    EXPECT_EQ( bucket_of(2), 2 );
+    EXPECT_EQ( bucket_of(3), 2 );
+    EXPECT_EQ( bucket_of(1024), 11 );
+    EXPECT_EQ( bucket_of(~uint64_t(0)), bucket_count - 1 );
+}
+
+TEST( Probe, TimerAndTally ){
+    reset();
+    expand( 10 );
+    expand( 30 );
+
+    const auto summaries = snapshot();
+    const Summary* timer = find( summaries, "test.expand" );
+    ASSERT_NE( timer, nullptr );
+    EXPECT_EQ( timer->kind, Timer );
+    EXPECT_EQ( timer->count, 2 );
+
+    const Summary* tally = find( summaries, "test.expansions" );
+    ASSERT_NE( tally, nullptr );
+    EXPECT_EQ( tally->kind, Counter );
+    EXPECT_EQ( tally->count, 2 );
+    EXPECT_EQ( tally->total, 40 );
+    EXPECT_EQ( tally->minimum, 10 );
+    EXPECT_EQ( tally->maximum, 30 );
+    EXPECT_EQ( tally->buckets[bucket_of(10)], 1 );
+    EXPECT_EQ( tally->buckets[bucket_of(30)], 1 );
+}
+
+TEST( Probe, SumsAcrossThreads ){
+    reset();
+    std::vector<std::thread> workers;
+    for( size_t t = 0; t < 4; ++t ){
+        workers.emplace_back( [](){
+            for( size_t k = 0; k < 100; ++k ){
+                CHARTBOX_PROBE_COUNT( "test.threads", 2 );
+            }} );
+    }
+    for( auto& each : workers ){
+        each.join();
+    }
+
+    // every worker has exited; so their totals come from the retired slots
+    const auto summaries = snapshot();
+    const Summary* counter = find( summaries, "test.threads" );
+    ASSERT_NE( counter, nullptr );
+    EXPECT_EQ( counter->count, 400 );
+    EXPECT_EQ( counter->total, 800 );
+
+    reset();
+    EXPECT_EQ( find(snapshot(), "test.threads"), nullptr );
+}
+
+TEST( Probe, Json ){
+    reset();
+    CHARTBOX_PROBE_COUNT( "test.json", 5 );
+    const std::string text = to_json();
+    EXPECT_NE( text.find("\"name\": \"test.json\", \"kind\": \"counter\", \"count\": 1, \"total\": 5"), std::string::npos ) << text;
+    EXPECT_NE( text.find("\"histogram\": [[8, 1]]"), std::string::npos ) << text;
+}
+
+} // namespace chartbox::probe
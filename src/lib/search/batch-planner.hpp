@@ -0,0 +1,115 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include "chart-box/geometry/path.hpp"
+
+#include "hpa-star.hpp"
+
+namespace chartbox::search {
+
+/// \brief Plans batches of independent queries over one chart, on a pool of worker threads
+///
+/// ## Implementation Specifics
+/// Each worker owns one planner -- and so one search workspace -- for its whole lifetime; so a batch
+/// allocates nothing but its results.  Workers claim queries one at a time from a shared counter, which
+/// balances long and short queries across the pool without any up-front partitioning.
+///
+/// Every planner holds the layer by `const` reference: the chart is only read, and may be shared by any
+/// number of workers.  It must not be modified while a batch is running; between batches, report any
+/// changes to each planner through `for_each_planner(...)`.
+///
+/// \param planner_t - any planner with a `planner_t(const layer_t&)` constructor, a
+///                    `chart::geometry::Path compute(const Eigen::Vector2d&, const Eigen::Vector2d&)` method,
+///                    and a `size_t expansions() const` count of the cells its last `compute(...)` expanded
+///
+/// \warning `plan_batch(...)` may only be called from one thread at a time
+template<typename layer_t, typename planner_t = HierarchicalAStar<layer_t>>
+class BatchPlanner {
+public:
+    typedef std::pair<Eigen::Vector2d, Eigen::Vector2d> Query;
+
+    struct Result {
+        /// \brief the found path; or an empty path, if no path exists
+        chart::geometry::Path path;
+        /// \brief length of the path -- the cost each planner minimizes -- in the layer's units; infinite if no path exists
+        double cost;
+        /// \brief number of cells the planner expanded for this query
+        size_t expansions;
+        /// \brief wall-clock time spent planning this query, in microseconds
+        double elapsed;
+        /// \brief index of the worker which planned this query
+        uint32_t worker;
+    };
+
+public:
+    BatchPlanner() = delete;
+
+    /// \brief start the given number of workers, each with its own planner for the given layer
+    BatchPlanner( const layer_t& layer, size_t thread_count = std::thread::hardware_concurrency() );
+
+    /// \brief stop and join every worker
+    ~BatchPlanner();
+
+    /// \brief Plan each query, in parallel, and wait for all of them
+    ///
+    /// \param queries - (start, goal) pairs
+    /// \param count - number of queries
+    /// \return one result per query, in the same order
+    std::vector<Result> plan_batch( const Query* queries, const size_t count );
+
+    inline std::vector<Result> plan_batch( const std::vector<Query>& queries ){
+        return plan_batch( queries.data(), queries.size() ); }
+
+    /// \brief Apply the given function to every worker's planner; e.g. to report a change to the chart
+    ///
+    /// \warning only call between batches
+    template<typename function_t>
+    void for_each_planner( function_t&& function ){
+        for( auto& planner : planners_ ){
+            function( *planner );
+        }
+    }
+
+    inline size_t thread_count() const { return threads_.size(); }
+
+private:
+    /// \brief body of each worker thread
+    void run( const uint32_t worker );
+
+private:
+    const layer_t& layer_;
+
+    /// \brief one per worker
+    std::vector<std::unique_ptr<planner_t>> planners_;
+    std::vector<std::thread> threads_;
+
+    // the current batch; guarded by `mutex_`, except for the claim counter
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable finish_;
+    uint64_t batch_ = 0;
+    size_t busy_ = 0;
+    bool stopping_ = false;
+    const Query* queries_ = nullptr;
+    size_t count_ = 0;
+    Result* results_ = nullptr;
+    std::atomic<size_t> next_{0};
+
+}; // class BatchPlanner
+
+} // namespace chartbox::search
+
+#include "batch-planner.inl"
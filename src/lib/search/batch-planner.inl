@@ -0,0 +1,104 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// NOTE: This is the template-class implementation --
+//       It is not compiled until referenced, even though it contains the
+//       function implementations.
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "probe/probe.hpp"
+
+using chartbox::search::BatchPlanner;
+
+template<typename layer_t, typename planner_t>
+BatchPlanner<layer_t,planner_t>::BatchPlanner( const layer_t& _layer, size_t thread_count )
+    : layer_(_layer)
+{
+    thread_count = std::max<size_t>( 1, thread_count );
+    for( size_t worker = 0; worker < thread_count; ++worker ){
+        planners_.push_back( std::make_unique<planner_t>(layer_) );
+    }
+    for( size_t worker = 0; worker < thread_count; ++worker ){
+        threads_.emplace_back( &BatchPlanner::run, this, static_cast<uint32_t>(worker) );
+    }
+}
+
+template<typename layer_t, typename planner_t>
+BatchPlanner<layer_t,planner_t>::~BatchPlanner(){
+    {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        stopping_ = true;
+    }
+    start_.notify_all();
+    for( auto& thread : threads_ ){
+        thread.join();
+    }
+}
+
+template<typename layer_t, typename planner_t>
+std::vector<typename BatchPlanner<layer_t,planner_t>::Result> BatchPlanner<layer_t,planner_t>::plan_batch( const Query* queries, const size_t count ){
+    CHARTBOX_PROBE_SCOPE( "batch.plan" );
+    std::vector<Result> results( count );
+    if( 0 == count ){
+        return results;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        queries_ = queries;
+        count_ = count;
+        results_ = results.data();
+        next_.store( 0, std::memory_order_relaxed );
+        busy_ = threads_.size();
+        ++batch_;
+    }
+    start_.notify_all();
+
+    std::unique_lock<std::mutex> lock( mutex_ );
+    finish_.wait( lock, [this]{ return 0 == busy_; } );
+    return results;
+}
+
+template<typename layer_t, typename planner_t>
+void BatchPlanner<layer_t,planner_t>::run( const uint32_t worker ){
+    planner_t& planner = *planners_[worker];
+    uint64_t finished = 0;
+
+    while( true ){
+        const Query* queries;
+        size_t count;
+        Result* results;
+        {
+            std::unique_lock<std::mutex> lock( mutex_ );
+            start_.wait( lock, [this, finished]{ return stopping_ || (finished != batch_); } );
+            if( stopping_ ){
+                return;
+            }
+            finished = batch_;
+            queries = queries_;
+            count = count_;
+            results = results_;
+        }
+
+        // each result is written by exactly one worker; and published to the caller by the mutex below
+        for( size_t k = next_.fetch_add(1, std::memory_order_relaxed); k < count; k = next_.fetch_add(1, std::memory_order_relaxed) ){
+            const auto start = std::chrono::steady_clock::now();
+            results[k].path = planner.compute( queries[k].first, queries[k].second );
+            results[k].elapsed = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count();
+            results[k].cost = results[k].path.empty() ? std::numeric_limits<double>::infinity() : results[k].path.length();
+            results[k].expansions = planner.expansions();
+            results[k].worker = worker;
+        }
+
+        std::lock_guard<std::mutex> lock( mutex_ );
+        if( 0 == --busy_ ){
+            finish_.notify_one();
+        }
+    }
+}
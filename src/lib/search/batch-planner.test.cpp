@@ -0,0 +1,93 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <cmath>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include "chart-box/geometry/path.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+
+#include "batch-planner.hpp"
+#include "hpa-star.hpp"
+#include "theta-star.hpp"
+#include "test-fixtures.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+using chart::geometry::Path;
+using chartbox::layer::FixedGridLayer;
+
+namespace chartbox::search {
+
+static const AlignedBox2d bounds( Vector2d(0,0), Vector2d(128,128) );
+
+static std::vector<std::pair<Vector2d,Vector2d>> make_queries( const size_t count ){
+    std::mt19937 generator( 55 );
+    std::uniform_int_distribution<uint32_t> index( 0, 127 );
+    std::vector<std::pair<Vector2d,Vector2d>> queries;
+    for( size_t k = 0; k < count; ++k ){
+        queries.emplace_back( Vector2d(index(generator) + 0.5, index(generator) + 0.5),
+                              Vector2d(index(generator) + 0.5, index(generator) + 0.5) );
+    }
+    return queries;
+}
+
+TEST( SearchBatchPlanner, MatchesSequential ){
+    FixedGridLayer layer( bounds );
+    scatter( layer, 55 );
+    const auto queries = make_queries( 200 );
+
+    HierarchicalAStar<FixedGridLayer> sequential( layer );
+    BatchPlanner<FixedGridLayer> batch( layer, 4 );
+    ASSERT_EQ( batch.thread_count(), 4 );
+
+    // the workspaces are reused across batches
+    for( size_t round = 0; round < 3; ++round ){
+        const auto results = batch.plan_batch( queries );
+        ASSERT_EQ( results.size(), queries.size() );
+        std::set<uint32_t> workers;
+        for( size_t k = 0; k < queries.size(); ++k ){
+            const Path expected = sequential.compute( queries[k].first, queries[k].second );
+            ASSERT_EQ( expected.size(), results[k].path.size() ) << "    @ query " << k;
+            EXPECT_DOUBLE_EQ( expected.length(), results[k].path.length() ) << "    @ query " << k;
+            EXPECT_EQ( sequential.expansions(), results[k].expansions ) << "    @ query " << k;
+            if( expected.empty() ){
+                EXPECT_TRUE( std::isinf(results[k].cost) ) << "    @ query " << k;
+            }else{
+                EXPECT_DOUBLE_EQ( expected.length(), results[k].cost ) << "    @ query " << k;
+            }
+            EXPECT_LE( 0, results[k].elapsed );
+            EXPECT_LT( results[k].worker, 4 );
+            workers.insert( results[k].worker );
+        }
+        EXPECT_LE( 1, workers.size() );
+    }
+}
+
+TEST( SearchBatchPlanner, OtherPlannersAndUpdates ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    const std::vector<std::pair<Vector2d,Vector2d>> queries = {{ {10.5, 10.5}, {120.5, 10.5} }};
+
+    BatchPlanner<FixedGridLayer, LazyThetaStar<FixedGridLayer>> theta( layer, 2 );
+    EXPECT_EQ( theta.plan_batch(queries)[0].path.size(), 2 );
+    EXPECT_TRUE( theta.plan_batch(nullptr, 0).empty() );
+
+    // a change between batches is reported to every worker's planner
+    BatchPlanner<FixedGridLayer> hierarchical( layer, 3 );
+    const AlignedBox2d wall( Vector2d(70, 0), Vector2d(71, 128) );
+    layer.fill( wall, 0x99 );
+    hierarchical.for_each_planner( [&wall]( HierarchicalAStar<FixedGridLayer>& planner ){ planner.update(wall); } );
+    for( const auto& result : hierarchical.plan_batch(std::vector<std::pair<Vector2d,Vector2d>>(6, queries[0])) ){
+        EXPECT_TRUE( result.path.empty() );
+        EXPECT_TRUE( std::isinf(result.cost) );
+    }
+}
+
+} // namespace chartbox::search
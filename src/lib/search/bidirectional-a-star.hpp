@@ -0,0 +1,129 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include "chart-box/geometry/path.hpp"
+
+#include "grid-neighbors.hpp"
+
+namespace chartbox::search {
+
+/// \brief Bidirectional A*: searches from the start and the goal at once, until the two searches meet
+///
+/// ## Implementation Specifics
+/// Two A* searches run over the same 8-connected grid: forward from the start (towards the goal), and
+/// backward from the goal (towards the start).  Whenever one search closes a cell which the other search
+/// has already closed, the sum of the two costs is a complete path; the cheapest of these is the best
+/// meeting cost.  A search stops once its cheapest open entry can no longer beat the best meeting cost;
+/// as soon as either search stops, the best meeting is optimal.
+///
+/// Each cell's closed-flags (one per direction) share one atomic word, which also holds a search
+/// generation; and the best meeting cost and cell share another.  So the two directions may also run on
+/// two threads, without locks: each reads only the other's costs of cells the other has already closed.
+///
+/// ### See Also:
+///   - Pohl; "Bi-directional Search" (1971)
+///   - Goldberg, Harrelson; "Computing the Shortest Path: A* Search Meets Graph Theory" (2005)
+///
+/// \warning the layer is only read; but it must outlive this planner
+template<typename layer_t>
+class BidirectionalAStar {
+public:
+    BidirectionalAStar() = delete;
+
+    /// \brief allocate the search workspace for the given layer
+    ///
+    /// \param threaded - if true, run the backward search on a second thread; else, alternate the two
+    ///                   searches on the calling thread
+    BidirectionalAStar( const layer_t& layer, const bool threaded = false );
+
+    /// \brief Find a path between the two given points
+    ///
+    /// \param start - location to start searching from
+    /// \param goal - location to search to
+    /// \return the found path; or an empty path, if no path exists
+    chart::geometry::Path compute( const Eigen::Vector2d& start, const Eigen::Vector2d& goal );
+
+    /// \brief number of cells expanded by the most recent search, in both directions
+    inline size_t expansions() const { return frontiers_[0].expansions + frontiers_[1].expansions; }
+
+    inline bool threaded() const { return threaded_; }
+
+public:
+    constexpr static size_t dimension = layer_t::dimension;
+
+private:
+    constexpr static uint32_t forward = 0;
+    constexpr static uint32_t backward = 1;
+
+    /// \brief per-cell search state of one direction; interleaved, so that each visit touches one cache line
+    struct Node {
+        cost_t cost;
+        uint32_t previous;
+        /// cost and previous are only valid while this matches the current generation
+        uint32_t generation;
+    };
+
+    /// \brief the search workspace of one direction
+    struct Frontier {
+        std::vector<Node> nodes;
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> upcoming;
+        /// the cell this direction searches towards
+        uint32_t target;
+        size_t expansions;
+    };
+
+    /// \brief run one direction until it stops, or the other direction has
+    void search( const uint32_t direction );
+
+    /// \brief expand the cheapest open cell of one direction
+    /// \return false if this direction should stop
+    bool step( const uint32_t direction );
+
+    /// \brief mark the cell closed in the given direction; and record a meeting, if the other direction already has
+    void close( const uint32_t direction, const uint32_t cell );
+
+    /// \brief push every passable neighbor of the (closed) cell which this step improves
+    void expand( const uint32_t direction, const uint32_t cell );
+
+    inline bool is_closed( const uint32_t direction, const uint32_t cell ) const {
+        const uint32_t word = closed_[cell].load( std::memory_order_relaxed );
+        return ((word >> 2) == current_generation_) && (0 != (word & (1 << direction)));
+    }
+
+    /// \brief record a meeting, if it is cheaper than the best meeting so far
+    void meet( const cost_t cost, const uint32_t cell );
+
+    /// \brief cost of the best meeting so far; infinite if the searches have not met
+    cost_t best_cost() const;
+
+private:
+    const layer_t& layer_;
+    const bool threaded_;
+
+    Frontier frontiers_[2];
+
+    /// per cell: `(generation << 2) | (backward-closed << 1) | forward-closed`
+    std::vector<std::atomic<uint32_t>> closed_;
+    uint32_t current_generation_ = 0;
+
+    /// `(cost-bits << 32) | cell` -- a non-negative float's bits order the same as its value
+    std::atomic<uint64_t> best_;
+
+    /// set by whichever direction stops first
+    std::atomic<bool> stopped_;
+
+}; // class BidirectionalAStar
+
+} // namespace chartbox::search
+
+#include "bidirectional-a-star.inl"
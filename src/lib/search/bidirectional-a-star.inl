@@ -0,0 +1,215 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// NOTE: This is the template-class implementation --
+//       It is not compiled until referenced, even though it contains the
+//       function implementations.
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "probe/probe.hpp"
+
+using chartbox::search::BidirectionalAStar;
+
+template<typename layer_t>
+BidirectionalAStar<layer_t>::BidirectionalAStar( const layer_t& _layer, const bool _threaded )
+    : layer_(_layer)
+    , threaded_(_threaded)
+    , closed_( dimension * dimension )
+{
+    for( Frontier& frontier : frontiers_ ){
+        frontier.nodes.resize( dimension * dimension, {0, 0, 0} );
+        frontier.expansions = 0;
+    }
+    for( auto& word : closed_ ){
+        word.store( 0, std::memory_order_relaxed );
+    }
+    best_.store( 0, std::memory_order_relaxed );
+    stopped_.store( false, std::memory_order_relaxed );
+}
+
+template<typename layer_t>
+chart::geometry::Path BidirectionalAStar<layer_t>::compute( const Eigen::Vector2d& start_point, const Eigen::Vector2d& goal_point ){
+    CHARTBOX_PROBE_SCOPE( "bidirectional.compute" );
+    frontiers_[forward].expansions = 0;
+    frontiers_[backward].expansions = 0;
+
+    uint32_t si, sj, gi, gj;
+    if( (! to_cell(layer_, start_point, si, sj)) || (! to_cell(layer_, goal_point, gi, gj)) ){
+        return {};
+    }else if( is_blocked(layer_, si, sj) || is_blocked(layer_, gi, gj) ){
+        return {};
+    }
+    const uint32_t start = sj*dimension + si;
+    const uint32_t goal = gj*dimension + gi;
+
+    // the generation shares its word with two flags; so it wraps early
+    if( (1u << 30) <= ++current_generation_ ){
+        current_generation_ = 1;
+        for( auto& word : closed_ ){
+            word.store( 0, std::memory_order_relaxed );
+        }
+        for( Frontier& frontier : frontiers_ ){
+            for( Node& node : frontier.nodes ){
+                node.generation = 0;
+            }
+        }
+    }
+    const cost_t infinity = std::numeric_limits<cost_t>::infinity();
+    uint32_t infinity_bits;
+    std::memcpy( &infinity_bits, &infinity, sizeof(infinity_bits) );
+    best_.store( (static_cast<uint64_t>(infinity_bits) << 32) | start, std::memory_order_relaxed );
+    stopped_.store( false, std::memory_order_relaxed );
+
+    frontiers_[forward].target = goal;
+    frontiers_[backward].target = start;
+    for( const uint32_t direction : {forward, backward} ){
+        Frontier& frontier = frontiers_[direction];
+        frontier.upcoming = {};
+        const uint32_t root = frontiers_[1 - direction].target;
+        frontier.nodes[root] = { 0, root, current_generation_ };
+    }
+
+    // Close both roots before either search starts: then, whichever search stops first, every optimal path
+    // has either met the other search already, or still has a cell on this search's queue.
+    close( forward, start );
+    expand( forward, start );
+    close( backward, goal );
+    expand( backward, goal );
+
+    if( threaded_ ){
+        std::thread helper( &BidirectionalAStar::search, this, backward );
+        search( forward );
+        helper.join();
+    }else{
+        // alternate, favoring the direction with the smaller frontier
+        while( true ){
+            const uint32_t direction = (frontiers_[forward].upcoming.size() <= frontiers_[backward].upcoming.size()) ? forward : backward;
+            if( ! step(direction) ){
+                break;
+            }
+        }
+    }
+
+    CHARTBOX_PROBE_COUNT( "bidirectional.expansions", expansions() );
+
+    const uint64_t best = best_.load( std::memory_order_relaxed );
+    if( std::numeric_limits<cost_t>::infinity() == best_cost() ){
+        return {};
+    }
+
+    // forward: from the meeting back to the start; backward: from the meeting on to the goal
+    const uint32_t meeting = static_cast<uint32_t>( best & 0xffffffff );
+    std::vector<uint32_t> cells;
+    for( uint32_t cell = meeting; cell != start; cell = frontiers_[forward].nodes[cell].previous ){
+        cells.push_back( cell );
+    }
+    cells.push_back( start );
+    std::reverse( cells.begin(), cells.end() );
+    for( uint32_t cell = meeting; cell != goal; ){
+        cell = frontiers_[backward].nodes[cell].previous;
+        cells.push_back( cell );
+    }
+    return to_path( layer_, cells );
+}
+
+template<typename layer_t>
+void BidirectionalAStar<layer_t>::search( const uint32_t direction ){
+    while( (! stopped_.load(std::memory_order_relaxed)) && step(direction) );
+    stopped_.store( true, std::memory_order_relaxed );
+}
+
+template<typename layer_t>
+bool BidirectionalAStar<layer_t>::step( const uint32_t direction ){
+    Frontier& frontier = frontiers_[direction];
+    while( ! frontier.upcoming.empty() ){
+        const QueueEntry next = frontier.upcoming.top();
+        if( is_closed(direction, next.cell) ){
+            frontier.upcoming.pop();
+            continue;  // stale entry
+        }else if( best_cost() <= next.priority ){
+            return false;  // no remaining path through this direction's frontier can beat the best meeting
+        }
+        frontier.upcoming.pop();
+        close( direction, next.cell );
+        expand( direction, next.cell );
+        return true;
+    }
+    // exhausted: every reachable cell is closed; so if the searches can meet, they have
+    return false;
+}
+
+template<typename layer_t>
+void BidirectionalAStar<layer_t>::close( const uint32_t direction, const uint32_t cell ){
+    const uint32_t flag = 1u << direction;
+    const uint32_t fresh = current_generation_ << 2;
+    uint32_t word = closed_[cell].load( std::memory_order_relaxed );
+    uint32_t updated;
+    do {
+        updated = ((word >> 2) == current_generation_) ? (word | flag) : (fresh | flag);
+    } while( ! closed_[cell].compare_exchange_weak(word, updated, std::memory_order_acq_rel, std::memory_order_relaxed) );
+
+    // the other direction's cost is final, and published by its own exchange
+    const uint32_t other = 1 - direction;
+    if( ((word >> 2) == current_generation_) && (0 != (word & (1u << other))) ){
+        meet( frontiers_[direction].nodes[cell].cost + frontiers_[other].nodes[cell].cost, cell );
+    }
+}
+
+template<typename layer_t>
+void BidirectionalAStar<layer_t>::expand( const uint32_t direction, const uint32_t at ){
+    Frontier& frontier = frontiers_[direction];
+    ++frontier.expansions;
+
+    const uint32_t i = at % dimension;
+    const uint32_t j = at / dimension;
+    const uint32_t ti = frontier.target % dimension;
+    const uint32_t tj = frontier.target / dimension;
+    const cost_t cost_at = frontier.nodes[at].cost;
+
+    // steps are symmetric; so the backward search follows the same steps, in reverse
+    const uint8_t steps = passable_steps( layer_, i, j );
+    for( size_t k = 0; k < eight_neighbors.size(); ++k ){
+        const GridStep& step = eight_neighbors[k];
+        if( 0 == ((steps >> k) & 1) ){
+            continue;
+        }
+        const uint32_t ni = i + step.di;
+        const uint32_t nj = j + step.dj;
+        const uint32_t neighbor = nj*dimension + ni;
+        if( is_closed(direction, neighbor) ){
+            continue;
+        }
+        const cost_t cost_to_neighbor = cost_at + step.cost;
+        Node& node = frontier.nodes[neighbor];
+        if( (node.generation != current_generation_) || (cost_to_neighbor < node.cost) ){
+            node = { cost_to_neighbor, at, current_generation_ };
+            frontier.upcoming.push({ cost_to_neighbor + octile_distance(ni, nj, ti, tj), neighbor });
+        }
+    }
+}
+
+template<typename layer_t>
+void BidirectionalAStar<layer_t>::meet( const cost_t cost, const uint32_t cell ){
+    uint32_t cost_bits;
+    std::memcpy( &cost_bits, &cost, sizeof(cost_bits) );
+    const uint64_t candidate = (static_cast<uint64_t>(cost_bits) << 32) | cell;
+
+    uint64_t best = best_.load( std::memory_order_relaxed );
+    while( (candidate >> 32) < (best >> 32) ){
+        if( best_.compare_exchange_weak(best, candidate, std::memory_order_relaxed) ){
+            return;
+        }
+    }
+}
+
+template<typename layer_t>
+chartbox::search::cost_t BidirectionalAStar<layer_t>::best_cost() const {
+    const uint32_t cost_bits = static_cast<uint32_t>( best_.load(std::memory_order_relaxed) >> 32 );
+    cost_t cost;
+    std::memcpy( &cost, &cost_bits, sizeof(cost) );
+    return cost;
+}
@@ -0,0 +1,100 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include "chart-box/geometry/path.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+
+#include "bidirectional-a-star.hpp"
+#include "hpa-star.hpp"
+#include "test-fixtures.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+using chart::geometry::Path;
+using chartbox::layer::FixedGridLayer;
+
+namespace chartbox::search {
+
+static const AlignedBox2d bounds( Vector2d(0,0), Vector2d(128,128) );
+
+static void expect_matches_astar( const bool threaded ){
+    FixedGridLayer layer( bounds );
+    scatter( layer, 55 );
+    HierarchicalAStar<FixedGridLayer> reference( layer );
+    BidirectionalAStar<FixedGridLayer> search( layer, threaded );
+    ASSERT_EQ( search.threaded(), threaded );
+
+    std::mt19937 generator( 55 );
+    std::uniform_int_distribution<uint32_t> index( 0, 127 );
+    size_t found = 0;
+    for( size_t query = 0; query < 200; ++query ){
+        const Vector2d start( index(generator) + 0.5, index(generator) + 0.5 );
+        const Vector2d goal( index(generator) + 0.5, index(generator) + 0.5 );
+        const Path expected = reference.compute_flat( start, goal );
+        const Path actual = search.compute( start, goal );
+        ASSERT_EQ( expected.empty(), actual.empty() ) << "    @ query " << query;
+        if( ! expected.empty() ){
+            EXPECT_NEAR( expected.length(), actual.length(), 1e-3 ) << "    @ query " << query;
+            EXPECT_DOUBLE_EQ( start.x(), actual[0].x() );
+            EXPECT_DOUBLE_EQ( goal.y(), actual[actual.size() - 1].y() );
+            ++found;
+        }
+    }
+    EXPECT_LT( 100, found );
+}
+
+TEST( SearchBidirectionalAStar, MatchesAStar ){
+    expect_matches_astar( false );
+}
+
+TEST( SearchBidirectionalAStar, MatchesAStarThreaded ){
+    expect_matches_astar( true );
+}
+
+TEST( SearchBidirectionalAStar, ExpandsLessBehindAWall ){
+    // a cup around the goal, open away from the start: unidirectional A* floods the inside of the cup
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    layer.fill( AlignedBox2d(Vector2d(64, 16), Vector2d(66, 112)), 0x99 );
+    layer.fill( AlignedBox2d(Vector2d(64, 16), Vector2d(120, 18)), 0x99 );
+    layer.fill( AlignedBox2d(Vector2d(64, 110), Vector2d(120, 112)), 0x99 );
+
+    const Vector2d start( 10.5, 64.5 );
+    const Vector2d goal( 80.5, 64.5 );
+    HierarchicalAStar<FixedGridLayer> reference( layer );
+    BidirectionalAStar<FixedGridLayer> search( layer );
+
+    const Path expected = reference.compute_flat( start, goal );
+    const Path actual = search.compute( start, goal );
+    ASSERT_FALSE( actual.empty() );
+    EXPECT_NEAR( expected.length(), actual.length(), 1e-3 );
+    EXPECT_LT( search.expansions(), reference.expansions() );
+}
+
+TEST( SearchBidirectionalAStar, Endpoints ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    layer.fill( AlignedBox2d(Vector2d(60, 0), Vector2d(62, 128)), 0x99 );
+
+    for( const bool threaded : {false, true} ){
+        BidirectionalAStar<FixedGridLayer> search( layer, threaded );
+        // separated by the wall
+        EXPECT_TRUE( search.compute({10.5, 10.5}, {100.5, 10.5}).empty() );
+        EXPECT_LT( search.expansions(), 128 * 128 );
+        // blocked, or outside the layer
+        EXPECT_TRUE( search.compute({10.5, 10.5}, {60.5, 10.5}).empty() );
+        EXPECT_TRUE( search.compute({10.5, 10.5}, {200.5, 10.5}).empty() );
+        // the same cell
+        EXPECT_EQ( search.compute({10.5, 10.5}, {10.7, 10.2}).size(), 1 );
+        // still usable afterwards
+        EXPECT_EQ( search.compute({10.5, 10.5}, {40.5, 10.5}).size(), 2 );
+    }
+}
+
+} // namespace chartbox::search
@@ -0,0 +1,133 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include "chart-box/geometry/path.hpp"
+
+#include "grid-neighbors.hpp"
+
+namespace chartbox::search {
+
+/// \brief Cost-to-go field: the shortest-path cost from every cell of a grid layer to one goal
+///
+/// Once built, a path from any start is found by descending the field, in time proportional to the path's
+/// length -- so many starts which share a goal (e.g. a harbour entrance) share one search.
+///
+/// ## Implementation Specifics
+/// Costs are integers: 70 per orthogonal step and 99 per diagonal step (99/70 is within 0.01% of sqrt(2)),
+/// over the same 8-connected grid as A*.  The field is built with Dial's algorithm -- a Dijkstra search
+/// whose priority queue is a ring of buckets, one per cost value, so every push and pop is O(1).
+///
+/// Changes to the layer are patched in place: cells whose cost depended on a changed cell are invalidated,
+/// and the search is resumed from the edge of the invalidated region.
+///
+/// \warning the layer is only read, but any modification must be reported through `update(...)` or `refresh()`
+template<typename layer_t>
+class CostToGo {
+public:
+    typedef uint32_t field_t;
+
+    constexpr static size_t dimension = layer_t::dimension;
+
+    /// \brief cost of cells which cannot reach the goal
+    constexpr static field_t unreachable = std::numeric_limits<field_t>::max();
+
+    constexpr static field_t orthogonal_step = 70;
+    constexpr static field_t diagonal_step = 99;
+
+public:
+    CostToGo() = delete;
+
+    /// \brief allocate the field for the given layer; every cell is unreachable until `build(...)`
+    CostToGo( const layer_t& layer );
+
+    /// \brief compute the field towards the given goal, from scratch
+    ///
+    /// \return false if the goal is outside the layer, or blocked
+    bool build( const Eigen::Vector2d& goal );
+
+    /// \brief Find a path from the given start to the goal, by descending the field
+    ///
+    /// \return the found path; or an empty path, if the start cannot reach the goal
+    chart::geometry::Path path_from( const Eigen::Vector2d& start ) const;
+
+    /// \brief patch the field after cells overlapping the given area were modified
+    ///
+    /// \note this also marks every change the layer has recorded so far as seen; so report all of them
+    void update( const Eigen::AlignedBox2d& area );
+
+    /// \brief patch the field with every change the layer reports, since the field was last built, updated or refreshed
+    ///
+    /// Falls back to a complete rebuild if more than 1/4 of the layer has changed.
+    void refresh();
+
+    /// \brief cost-to-go from the given location, in the layer's units
+    /// \return infinity, if the location cannot reach the goal (or is outside the layer)
+    double get( const Eigen::Vector2d& p ) const;
+
+    /// \brief raw cost-to-go of cell (i,j), in steps of `orthogonal_step` per cell width
+    /// \warning does not check bounds
+    inline field_t cost( const uint32_t i, const uint32_t j ) const { return field_[j*dimension + i]; }
+
+    /// \brief number of cells settled by the most recent `build(...)`, `update(...)` or `refresh()`
+    inline size_t expansions() const { return expansions_; }
+
+    inline double precision() const { return layer_.precision(); }
+
+private:
+    /// \brief each step in `eight_neighbors` order; in field units
+    constexpr static field_t step_cost( const size_t k ){
+        return (0 == (k & 1)) ? orthogonal_step : diagonal_step; }
+
+    /// \brief ring of buckets: at least one more than the largest step
+    constexpr static size_t bucket_count = 128;
+    static_assert( diagonal_step < bucket_count, "Every step must fit within the ring of buckets!" );
+
+    /// \brief the cheapest cost of the cell through its neighbors' current costs
+    field_t lookahead( const uint32_t cell ) const;
+
+    /// \brief append every cell overlapping the area, and their neighbors
+    void cells_around( const Eigen::AlignedBox2d& area, std::vector<uint32_t>& cells ) const;
+
+    /// \brief bring the field up to date after the given cells were modified
+    void repair( const std::vector<uint32_t>& cells );
+
+    /// \brief invalidate every cell whose cost depended on the given (modified) cells
+    void invalidate( const std::vector<uint32_t>& cells, std::vector<uint32_t>& invalidated );
+
+    /// \brief Dial's algorithm: settle every cell reachable from the seeds, lowering costs as it goes
+    ///
+    /// \param seeds - (cost, cell) pairs; each cell's field entry must already hold that cost
+    void propagate( std::vector<std::pair<field_t, uint32_t>>& seeds );
+
+    /// \brief bit k is set if `eight_neighbors[k]` can be traversed in both directions
+    uint8_t steps_from( const uint32_t cell ) const;
+
+private:
+    const layer_t& layer_;
+
+    std::vector<field_t> field_;
+
+    /// \brief search workspace: cells queued at each cost, modulo `bucket_count`
+    std::vector<std::vector<uint32_t>> buckets_;
+
+    bool built_ = false;
+    uint32_t goal_ = 0;
+    /// layer version at the last build, update or refresh
+    uint64_t version_ = 0;
+
+    size_t expansions_ = 0;
+
+}; // class CostToGo
+
+} // namespace chartbox::search
+
+#include "cost-to-go.inl"
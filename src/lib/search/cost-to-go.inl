@@ -0,0 +1,292 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// NOTE: This is the template-class implementation --
+//       It is not compiled until referenced, even though it contains the
+//       function implementations.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "probe/probe.hpp"
+
+using chartbox::search::CostToGo;
+
+template<typename layer_t>
+CostToGo<layer_t>::CostToGo( const layer_t& _layer )
+    : layer_(_layer)
+    , field_( dimension * dimension, unreachable )
+    , buckets_( bucket_count )
+{}
+
+template<typename layer_t>
+bool CostToGo<layer_t>::build( const Eigen::Vector2d& goal_point ){
+    CHARTBOX_PROBE_SCOPE( "costtogo.build" );
+    expansions_ = 0;
+    std::fill( field_.begin(), field_.end(), unreachable );
+    built_ = false;
+
+    uint32_t gi, gj;
+    if( (! to_cell(layer_, goal_point, gi, gj)) || is_blocked(layer_, gi, gj) ){
+        return false;
+    }
+
+    goal_ = gj*dimension + gi;
+    version_ = layer_.version();
+    built_ = true;
+
+    field_[goal_] = 0;
+    std::vector<std::pair<field_t, uint32_t>> seeds = {{ 0, goal_ }};
+    propagate( seeds );
+    return true;
+}
+
+template<typename layer_t>
+chart::geometry::Path CostToGo<layer_t>::path_from( const Eigen::Vector2d& start_point ) const {
+    uint32_t si, sj;
+    if( (! built_) || (! to_cell(layer_, start_point, si, sj)) || (unreachable == field_[sj*dimension + si]) ){
+        return {};
+    }
+
+    std::vector<uint32_t> cells( 1, sj*dimension + si );
+    for( uint32_t at = cells.back(); at != goal_; at = cells.back() ){
+        const uint32_t i = at % dimension;
+        const uint32_t j = at / dimension;
+        const uint8_t steps = steps_from( at );
+        field_t best = unreachable;
+        uint32_t next = at;
+        for( size_t k = 0; k < eight_neighbors.size(); ++k ){
+            const GridStep& step = eight_neighbors[k];
+            const uint32_t neighbor = (j + step.dj)*dimension + (i + step.di);
+            if( (0 != ((steps >> k) & 1)) && (unreachable != field_[neighbor]) && (field_[neighbor] + step_cost(k) < best) ){
+                best = field_[neighbor] + step_cost(k);
+                next = neighbor;
+            }
+        }
+        // every step descends; so a longer walk means the field is out of date
+        if( (unreachable == best) || (dimension * dimension < cells.size()) ){
+            return {};
+        }
+        cells.push_back( next );
+    }
+    return to_path( layer_, cells );
+}
+
+template<typename layer_t>
+void CostToGo<layer_t>::update( const Eigen::AlignedBox2d& area ){
+    expansions_ = 0;
+    if( ! built_ ){
+        return;
+    }
+    std::vector<uint32_t> cells;
+    cells_around( area, cells );
+    repair( cells );
+    // reported; so the next `refresh()` need not repair it again
+    version_ = layer_.version();
+}
+
+template<typename layer_t>
+void CostToGo<layer_t>::refresh(){
+    expansions_ = 0;
+    if( ! built_ ){
+        return;
+    }
+
+    std::vector<Eigen::AlignedBox2d> areas;
+    layer_.collect_changes( version_, areas );
+    version_ = layer_.version();
+
+    double changed = 0;
+    for( const auto& area : areas ){
+        changed += area.volume();
+    }
+    const double cell_area = precision() * precision();
+    if( (dimension * dimension) / 4 < (changed / cell_area) ){
+        build( to_location(layer_, goal_ % dimension, goal_ / dimension) );
+        return;
+    }
+
+    std::vector<uint32_t> cells;
+    for( const auto& area : areas ){
+        cells_around( area, cells );
+    }
+    repair( cells );
+}
+
+template<typename layer_t>
+double CostToGo<layer_t>::get( const Eigen::Vector2d& p ) const {
+    uint32_t i, j;
+    if( (! to_cell(layer_, p, i, j)) || (unreachable == cost(i, j)) ){
+        return std::numeric_limits<double>::infinity();
+    }
+    return cost(i, j) * precision() / orthogonal_step;
+}
+
+template<typename layer_t>
+void CostToGo<layer_t>::cells_around( const Eigen::AlignedBox2d& area, std::vector<uint32_t>& cells ) const {
+    if( area.isEmpty() ){
+        return;
+    }
+    // one more cell on every side: a change also opens or closes the diagonal steps which cut its corners
+    const double limit = static_cast<double>( dimension );
+    const uint32_t i_min = static_cast<uint32_t>( std::clamp(std::floor(area.min().x() / precision()) - 1, 0.0, limit) );
+    const uint32_t j_min = static_cast<uint32_t>( std::clamp(std::floor(area.min().y() / precision()) - 1, 0.0, limit) );
+    const uint32_t i_max = static_cast<uint32_t>( std::clamp(std::ceil(area.max().x() / precision()) + 1, 0.0, limit) );
+    const uint32_t j_max = static_cast<uint32_t>( std::clamp(std::ceil(area.max().y() / precision()) + 1, 0.0, limit) );
+
+    for( uint32_t j = j_min; j < j_max; ++j ){
+        for( uint32_t i = i_min; i < i_max; ++i ){
+            cells.push_back( j*dimension + i );
+        }
+    }
+}
+
+template<typename layer_t>
+void CostToGo<layer_t>::repair( const std::vector<uint32_t>& cells ){
+    CHARTBOX_PROBE_SCOPE( "costtogo.repair" );
+    std::vector<uint32_t> invalidated;
+    invalidate( cells, invalidated );
+
+    // resume the search from every cell which can now do better than its recorded cost: the edge of the
+    // invalidated region, and any newly opened cells or steps
+    std::vector<std::pair<field_t, uint32_t>> seeds;
+    const auto reseed = [this, &seeds]( const uint32_t cell ){
+        const field_t best = lookahead( cell );
+        if( best < field_[cell] ){
+            field_[cell] = best;
+            seeds.emplace_back( best, cell );
+        }
+    };
+    for( const uint32_t cell : cells ){
+        reseed( cell );
+    }
+    for( const uint32_t cell : invalidated ){
+        reseed( cell );
+    }
+
+    propagate( seeds );
+}
+
+template<typename layer_t>
+typename CostToGo<layer_t>::field_t CostToGo<layer_t>::lookahead( const uint32_t cell ) const {
+    const uint32_t i = cell % dimension;
+    const uint32_t j = cell / dimension;
+    if( is_blocked(layer_, i, j) ){
+        return unreachable;
+    }else if( cell == goal_ ){
+        return 0;
+    }
+
+    const uint8_t steps = passable_steps( layer_, i, j );
+    field_t best = unreachable;
+    for( size_t k = 0; k < eight_neighbors.size(); ++k ){
+        const GridStep& step = eight_neighbors[k];
+        if( 0 == ((steps >> k) & 1) ){
+            continue;
+        }
+        const field_t through = field_[(j + step.dj)*dimension + (i + step.di)];
+        if( unreachable != through ){
+            best = std::min( best, through + step_cost(k) );
+        }
+    }
+    return best;
+}
+
+template<typename layer_t>
+void CostToGo<layer_t>::invalidate( const std::vector<uint32_t>& cells, std::vector<uint32_t>& invalidated ){
+    // a cell is still valid while some neighbor supports its cost; otherwise, it is reset to unreachable,
+    // and each neighbor which may have depended on it is checked in turn
+    std::vector<std::pair<uint32_t, field_t>> upcoming;
+    const auto check = [&]( const uint32_t cell ){
+        if( (unreachable != field_[cell]) && (field_[cell] < lookahead(cell)) ){
+            upcoming.emplace_back( cell, field_[cell] );
+            invalidated.push_back( cell );
+            field_[cell] = unreachable;
+        }
+    };
+
+    for( const uint32_t cell : cells ){
+        check( cell );
+    }
+
+    while( ! upcoming.empty() ){
+        const auto [cell, previous] = upcoming.back();
+        upcoming.pop_back();
+
+        const int64_t i = cell % dimension;
+        const int64_t j = cell / dimension;
+        for( size_t k = 0; k < eight_neighbors.size(); ++k ){
+            const GridStep& step = eight_neighbors[k];
+            const int64_t ni = i + step.di;
+            const int64_t nj = j + step.dj;
+            if( (ni < 0) || (static_cast<int64_t>(dimension) <= ni) || (nj < 0) || (static_cast<int64_t>(dimension) <= nj) ){
+                continue;
+            }
+            const uint32_t neighbor = static_cast<uint32_t>( nj*dimension + ni );
+            if( field_[neighbor] == previous + step_cost(k) ){
+                check( neighbor );
+            }
+        }
+    }
+}
+
+template<typename layer_t>
+void CostToGo<layer_t>::propagate( std::vector<std::pair<field_t, uint32_t>>& seeds ){
+    if( seeds.empty() ){
+        return;
+    }
+    std::sort( seeds.begin(), seeds.end() );
+
+    size_t pending = 0;
+    size_t next_seed = 0;
+    field_t current = seeds.front().first;
+    while( true ){
+        // seeds enter the ring once they fall within its window
+        for( ; (next_seed < seeds.size()) && (seeds[next_seed].first < current + bucket_count); ++next_seed ){
+            buckets_[ seeds[next_seed].first % bucket_count ].push_back( seeds[next_seed].second );
+            ++pending;
+        }
+        if( 0 == pending ){
+            if( next_seed == seeds.size() ){
+                return;
+            }
+            current = seeds[next_seed].first;
+            continue;
+        }
+
+        std::vector<uint32_t>& bucket = buckets_[ current % bucket_count ];
+        while( ! bucket.empty() ){
+            const uint32_t at = bucket.back();
+            bucket.pop_back();
+            --pending;
+            if( field_[at] != current ){
+                continue;  // stale: since lowered
+            }
+            ++expansions_;
+
+            const uint32_t i = at % dimension;
+            const uint32_t j = at / dimension;
+            const uint8_t steps = steps_from( at );
+            for( size_t k = 0; k < eight_neighbors.size(); ++k ){
+                const GridStep& step = eight_neighbors[k];
+                const uint32_t neighbor = (j + step.dj)*dimension + (i + step.di);
+                const field_t through = current + step_cost(k);
+                if( (0 != ((steps >> k) & 1)) && (through < field_[neighbor]) ){
+                    field_[neighbor] = through;
+                    buckets_[ through % bucket_count ].push_back( neighbor );
+                    ++pending;
+                }
+            }
+        }
+        ++current;
+    }
+}
+
+template<typename layer_t>
+uint8_t CostToGo<layer_t>::steps_from( const uint32_t cell ) const {
+    const uint32_t i = cell % dimension;
+    const uint32_t j = cell / dimension;
+    return is_blocked(layer_, i, j) ? 0 : passable_steps( layer_, i, j );
+}
@@ -0,0 +1,165 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <cmath>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include "chart-box/geometry/path.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+
+#include "cost-to-go.hpp"
+#include "hpa-star.hpp"
+#include "test-fixtures.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+using chart::geometry::Path;
+using chartbox::layer::FixedGridLayer;
+
+namespace chartbox::search {
+
+static const AlignedBox2d bounds( Vector2d(0,0), Vector2d(128,128) );
+
+static void expect_same_field( const CostToGo<FixedGridLayer>& actual, const CostToGo<FixedGridLayer>& expected ){
+    size_t differences = 0;
+    for( uint32_t j = 0; j < FixedGridLayer::dimension; ++j ){
+        for( uint32_t i = 0; i < FixedGridLayer::dimension; ++i ){
+            differences += ( actual.cost(i, j) != expected.cost(i, j) ) ? 1 : 0;
+        }
+    }
+    EXPECT_EQ( differences, 0 );
+}
+
+TEST( SearchCostToGo, OpenWater ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    CostToGo<FixedGridLayer> field( layer );
+    ASSERT_TRUE( field.build({64.5, 64.5}) );
+
+    EXPECT_DOUBLE_EQ( field.get({64.5, 64.5}), 0 );
+    EXPECT_DOUBLE_EQ( field.get({64.5, 74.5}), 10 );
+    EXPECT_NEAR( field.get({74.5, 74.5}), 10 * std::sqrt(2.0), 1e-3 );
+
+    const Path path = field.path_from( {10.5, 64.5} );
+    ASSERT_EQ( path.size(), 2 );
+    EXPECT_DOUBLE_EQ( path[1].x(), 64.5 );
+}
+
+TEST( SearchCostToGo, MatchesAStar ){
+    FixedGridLayer layer( bounds );
+    scatter( layer, 55 );
+    HierarchicalAStar<FixedGridLayer> reference( layer );
+    CostToGo<FixedGridLayer> field( layer );
+
+    const Vector2d goal( 3.5, 125.5 );
+    layer.fill( AlignedBox2d(Vector2d(0, 120), Vector2d(8, 128)), FixedGridLayer::clear_value );
+    ASSERT_TRUE( field.build(goal) );
+
+    std::mt19937 generator( 55 );
+    std::uniform_int_distribution<uint32_t> index( 0, 127 );
+    size_t found = 0;
+    for( size_t query = 0; query < 64; ++query ){
+        const Vector2d start( index(generator) + 0.5, index(generator) + 0.5 );
+        const Path expected = reference.compute_flat( start, goal );
+        const Path actual = field.path_from( start );
+        ASSERT_EQ( expected.empty(), actual.empty() ) << "    @ query " << query;
+        if( ! expected.empty() ){
+            EXPECT_NEAR( expected.length(), actual.length(), 1e-3 * expected.length() ) << "    @ query " << query;
+            EXPECT_NEAR( expected.length(), field.get(start), 1e-3 * expected.length() ) << "    @ query " << query;
+            ++found;
+        }
+    }
+    EXPECT_LT( 32, found );
+}
+
+TEST( SearchCostToGo, PatchesMatchRebuild ){
+    FixedGridLayer layer( bounds );
+    scatter( layer, 7 );
+    layer.fill( AlignedBox2d(Vector2d(60, 60), Vector2d(68, 68)), FixedGridLayer::clear_value );
+    const Vector2d goal( 64.5, 64.5 );
+
+    CostToGo<FixedGridLayer> patched( layer );
+    CostToGo<FixedGridLayer> rebuilt( layer );
+    ASSERT_TRUE( patched.build(goal) );
+
+    std::mt19937 generator( 7 );
+    std::uniform_int_distribution<uint32_t> corner( 0, 124 );
+    for( size_t round = 0; round < 24; ++round ){
+        const double x = corner(generator);
+        const double y = corner(generator);
+        const AlignedBox2d area( Vector2d(x, y), Vector2d(x + 4, y + 4) );
+        layer.fill( area, (0 == (round % 3)) ? FixedGridLayer::clear_value : 0x99 );
+
+        if( 0 == (round % 2) ){
+            patched.update( area );
+        }else{
+            patched.refresh();
+        }
+        rebuilt.build( goal );
+        expect_same_field( patched, rebuilt );
+        if( area.contains(goal) ){
+            continue;
+        }
+        EXPECT_LT( patched.expansions(), rebuilt.expansions() ) << "    @ round " << round;
+    }
+}
+
+TEST( SearchCostToGo, RefreshRepairsEachChangeOnce ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    CostToGo<FixedGridLayer> field( layer );
+    ASSERT_TRUE( field.build({10.5, 10.5}) );
+
+    layer.store( {40.5, 40.5}, 0x99 );
+    field.refresh();
+    EXPECT_LT( 0, field.expansions() );
+    // no new writes: nothing to repair
+    field.refresh();
+    EXPECT_EQ( field.expansions(), 0 );
+
+    // changes already reported through `update(...)` are not repaired again; even once, together, they cover
+    // more than the 1/4 of the layer which would force a rebuild
+    for( uint32_t row = 0; row < 40; ++row ){
+        const AlignedBox2d area( Vector2d(4, 64 + row), Vector2d(127, 65 + row) );
+        layer.fill( area, (0 == (row % 2)) ? 0x99 : FixedGridLayer::clear_value );
+        field.update( area );
+    }
+    field.refresh();
+    EXPECT_EQ( field.expansions(), 0 );
+
+    // one new single-cell change per refresh: each repair stays local
+    CostToGo<FixedGridLayer> rebuilt( layer );
+    for( uint32_t step = 0; step < 16; ++step ){
+        layer.store( {100.5 + step, 20.5}, 0x99 );
+        field.refresh();
+        rebuilt.build( {10.5, 10.5} );
+        EXPECT_LT( field.expansions(), rebuilt.expansions() / 4 ) << "    @ step " << step;
+    }
+    expect_same_field( field, rebuilt );
+}
+
+TEST( SearchCostToGo, BlockedGoal ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    layer.store( {5.5, 5.5}, 0x99 );
+    CostToGo<FixedGridLayer> field( layer );
+
+    EXPECT_FALSE( field.build({5.5, 5.5}) );
+    EXPECT_FALSE( field.build({500.5, 5.5}) );
+    EXPECT_TRUE( field.path_from({50.5, 50.5}).empty() );
+
+    // blocking the goal after the build leaves nothing reachable; until it clears again
+    ASSERT_TRUE( field.build({20.5, 20.5}) );
+    layer.store( {20.5, 20.5}, 0x99 );
+    field.refresh();
+    EXPECT_TRUE( std::isinf(field.get({50.5, 50.5})) );
+    layer.store( {20.5, 20.5}, FixedGridLayer::clear_value );
+    field.refresh();
+    EXPECT_NEAR( field.get({50.5, 20.5}), 30, 1e-9 );
+}
+
+} // namespace chartbox::search
@@ -0,0 +1,139 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include "chart-box/geometry/path.hpp"
+
+#include "grid-neighbors.hpp"
+
+namespace chartbox::search {
+
+/// \brief D* Lite: incremental replanning over the cells of a grid layer
+///
+/// ## Implementation Specifics
+/// Searches backwards, from the goal towards the start, over the same 8-connected grid as A*.  Each cell
+/// keeps its cost-to-goal (`g`) and a one-step lookahead of it (`rhs`) between calls.  When cells of the
+/// layer change, only those cells and their neighbors are re-examined; and the search repairs just the
+/// costs which the change invalidates -- typically a small fraction of a full search.  Moving the start
+/// (e.g. as the vessel advances along its path) is also cheap: the queue is not reordered, but its keys
+/// are offset by the distance moved.
+///
+/// A new goal discards all state, and the next call searches from scratch.
+///
+/// ### See Also:
+///   - Koenig, Likhachev; "D* Lite" (2002)
+///
+/// \warning the layer is only read, but any modification must be reported through `update(...)`
+template<typename layer_t>
+class DStarLite {
+public:
+    DStarLite() = delete;
+
+    /// \brief allocate the search state for the given layer
+    DStarLite( const layer_t& layer );
+
+    /// \brief Find a path between the two given points; reusing the previous search, if the goal is unchanged
+    ///
+    /// \param start - location to start searching from
+    /// \param goal - location to search to
+    /// \return the found path; or an empty path, if no path exists
+    chart::geometry::Path compute( const Eigen::Vector2d& start, const Eigen::Vector2d& goal );
+
+    /// \brief report modified cells, given as `j*dimension + i`.  Takes effect on the next `compute(...)`.
+    void update( const std::vector<uint32_t>& cells );
+
+    /// \brief report that every cell overlapping the area may have been modified
+    void update( const Eigen::AlignedBox2d& area );
+
+    /// \brief discard all search state; the next `compute(...)` searches from scratch
+    void reset();
+
+    /// \brief number of cells expanded by the most recent `compute(...)`
+    inline size_t expansions() const { return expansions_; }
+
+public:
+    constexpr static size_t dimension = layer_t::dimension;
+
+private:
+    /// \brief lexicographic priority: (min(g,rhs) + h + offset, min(g,rhs))
+    struct Key {
+        cost_t first;
+        cost_t second;
+
+        inline bool operator<( const Key& rhs ) const {
+            return (first < rhs.first) || ((first == rhs.first) && (second < rhs.second)); }
+        inline bool operator==( const Key& rhs ) const {
+            return (first == rhs.first) && (second == rhs.second); }
+    };
+
+    struct Entry {
+        Key key;
+        uint32_t cell;
+
+        inline bool operator>( const Entry& rhs ) const {
+            return rhs.key < key; }
+    };
+
+    Key calculate_key( const uint32_t cell ) const;
+
+    /// \brief heuristic distance from the current start
+    cost_t heuristic( const uint32_t cell ) const;
+
+    /// \brief recompute the cell's `rhs` from its neighbors; and (re)queue it if it is inconsistent
+    void update_cell( const uint32_t cell );
+
+    /// \brief queue the cell if it is inconsistent (`g != rhs`); or remove it, if it is not
+    void requeue( const uint32_t cell );
+
+    /// \brief (re)queue the cell with its current `key_`
+    void enqueue( const uint32_t cell );
+
+    void dequeue( const uint32_t cell );
+
+    /// \brief update the cell and each of its neighbors
+    void update_around( const uint32_t cell );
+
+    void compute_shortest_path();
+
+    /// \brief walk from the start down the cost-to-goal gradient
+    bool extract( std::vector<uint32_t>& cells ) const;
+
+    /// \brief bit k is set if `eight_neighbors[k]` can be traversed in both directions
+    uint8_t steps_from( const uint32_t cell ) const;
+
+private:
+    const layer_t& layer_;
+
+    std::vector<cost_t> g_;
+    std::vector<cost_t> rhs_;
+    /// key of each cell's current queue entry; entries with any other key are stale
+    std::vector<Key> key_;
+    std::vector<uint8_t> queued_;
+    size_t queued_count_ = 0;
+
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue_;
+
+    /// cells reported by `update(...)`, but not yet re-examined
+    std::vector<uint32_t> pending_;
+
+    bool initialized_ = false;
+    uint32_t start_ = 0;
+    uint32_t goal_ = 0;
+    /// start at the time the queued keys were computed
+    uint32_t last_start_ = 0;
+    cost_t key_offset_ = 0;
+
+    size_t expansions_ = 0;
+
+}; // class DStarLite
+
+} // namespace chartbox::search
+
+#include "d-star-lite.inl"
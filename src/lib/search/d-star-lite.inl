@@ -0,0 +1,296 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// NOTE: This is the template-class implementation --
+//       It is not compiled until referenced, even though it contains the
+//       function implementations.
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "probe/probe.hpp"
+
+using chartbox::search::DStarLite;
+
+template<typename layer_t>
+DStarLite<layer_t>::DStarLite( const layer_t& _layer )
+    : layer_(_layer)
+    , g_( dimension * dimension )
+    , rhs_( dimension * dimension )
+    , key_( dimension * dimension )
+    , queued_( dimension * dimension, 0 )
+{}
+
+template<typename layer_t>
+chart::geometry::Path DStarLite<layer_t>::compute( const Eigen::Vector2d& start_point, const Eigen::Vector2d& goal_point ){
+    CHARTBOX_PROBE_SCOPE( "dstar.compute" );
+    expansions_ = 0;
+
+    uint32_t si, sj, gi, gj;
+    if( (! to_cell(layer_, start_point, si, sj)) || (! to_cell(layer_, goal_point, gi, gj)) ){
+        return {};
+    }else if( is_blocked(layer_, si, sj) || is_blocked(layer_, gi, gj) ){
+        return {};
+    }
+
+    const uint32_t start = sj*dimension + si;
+    const uint32_t goal = gj*dimension + gi;
+
+    if( (! initialized_) || (goal != goal_) ){
+        constexpr cost_t infinity = std::numeric_limits<cost_t>::infinity();
+        std::fill( g_.begin(), g_.end(), infinity );
+        std::fill( rhs_.begin(), rhs_.end(), infinity );
+        std::fill( queued_.begin(), queued_.end(), 0 );
+        queued_count_ = 0;
+        queue_ = {};
+        pending_.clear();
+
+        goal_ = goal;
+        start_ = start;
+        last_start_ = start;
+        key_offset_ = 0;
+        rhs_[goal] = 0;
+        key_[goal] = calculate_key( goal );
+        enqueue( goal );
+        initialized_ = true;
+    }
+
+    // queued keys were computed from the previous start; rather than re-key the queue, raise every later key
+    // by the distance moved -- which keeps the queued keys lower bounds
+    start_ = start;
+    key_offset_ += octile_distance( last_start_ % dimension, last_start_ / dimension, si, sj );
+    last_start_ = start;
+
+    for( const uint32_t cell : pending_ ){
+        update_around( cell );
+    }
+    pending_.clear();
+
+    compute_shortest_path();
+
+    std::vector<uint32_t> cells;
+    if( ! extract(cells) ){
+        return {};
+    }
+    return to_path( layer_, cells );
+}
+
+template<typename layer_t>
+void DStarLite<layer_t>::update( const std::vector<uint32_t>& cells ){
+    pending_.insert( pending_.end(), cells.begin(), cells.end() );
+}
+
+template<typename layer_t>
+void DStarLite<layer_t>::update( const Eigen::AlignedBox2d& area ){
+    if( area.isEmpty() ){
+        return;
+    }
+    const double precision = layer_.precision();
+    const double limit = static_cast<double>( dimension );
+    const uint32_t i_min = static_cast<uint32_t>( std::clamp(std::floor(area.min().x() / precision), 0.0, limit) );
+    const uint32_t j_min = static_cast<uint32_t>( std::clamp(std::floor(area.min().y() / precision), 0.0, limit) );
+    const uint32_t i_max = static_cast<uint32_t>( std::clamp(std::ceil(area.max().x() / precision), 0.0, limit) );
+    const uint32_t j_max = static_cast<uint32_t>( std::clamp(std::ceil(area.max().y() / precision), 0.0, limit) );
+
+    for( uint32_t j = j_min; j < j_max; ++j ){
+        for( uint32_t i = i_min; i < i_max; ++i ){
+            pending_.push_back( j*dimension + i );
+        }
+    }
+}
+
+template<typename layer_t>
+void DStarLite<layer_t>::reset(){
+    initialized_ = false;
+}
+
+template<typename layer_t>
+typename DStarLite<layer_t>::Key DStarLite<layer_t>::calculate_key( const uint32_t cell ) const {
+    const cost_t least = std::min( g_[cell], rhs_[cell] );
+    return { least + heuristic(cell) + key_offset_, least };
+}
+
+template<typename layer_t>
+chartbox::search::cost_t DStarLite<layer_t>::heuristic( const uint32_t cell ) const {
+    return octile_distance( start_ % dimension, start_ / dimension, cell % dimension, cell / dimension );
+}
+
+template<typename layer_t>
+uint8_t DStarLite<layer_t>::steps_from( const uint32_t cell ) const {
+    const uint32_t i = cell % dimension;
+    const uint32_t j = cell / dimension;
+    // steps are symmetric: each is passable iff both ends, and (for diagonals) both corners, are clear
+    return is_blocked(layer_, i, j) ? 0 : passable_steps( layer_, i, j );
+}
+
+template<typename layer_t>
+void DStarLite<layer_t>::update_cell( const uint32_t cell ){
+    if( cell != goal_ ){
+        const uint32_t i = cell % dimension;
+        const uint32_t j = cell / dimension;
+        const uint8_t steps = steps_from( cell );
+        cost_t best = std::numeric_limits<cost_t>::infinity();
+        for( size_t k = 0; k < eight_neighbors.size(); ++k ){
+            const GridStep& step = eight_neighbors[k];
+            if( 0 != ((steps >> k) & 1) ){
+                best = std::min( best, step.cost + g_[(j + step.dj)*dimension + (i + step.di)] );
+            }
+        }
+        rhs_[cell] = best;
+    }
+    requeue( cell );
+}
+
+template<typename layer_t>
+void DStarLite<layer_t>::requeue( const uint32_t cell ){
+    if( g_[cell] != rhs_[cell] ){
+        const Key key = calculate_key( cell );
+        if( queued_[cell] && (key == key_[cell]) ){
+            return;
+        }
+        key_[cell] = key;
+        enqueue( cell );
+    }else{
+        dequeue( cell );
+    }
+}
+
+template<typename layer_t>
+void DStarLite<layer_t>::enqueue( const uint32_t cell ){
+    if( ! queued_[cell] ){
+        queued_[cell] = 1;
+        ++queued_count_;
+    }
+    queue_.push({ key_[cell], cell });
+
+    // the heap only drops stale entries as they reach the top; so between searches, it keeps growing.
+    if( (2 * queued_count_ < queue_.size()) && (dimension * dimension < queue_.size()) ){
+        std::vector<Entry> live;
+        live.reserve( 2 * queued_count_ );
+        for( uint32_t index = 0; index < dimension * dimension; ++index ){
+            if( queued_[index] ){
+                live.push_back({ key_[index], index });
+            }
+        }
+        queue_ = decltype(queue_)( std::greater<Entry>(), std::move(live) );
+    }
+}
+
+template<typename layer_t>
+void DStarLite<layer_t>::dequeue( const uint32_t cell ){
+    if( queued_[cell] ){
+        queued_[cell] = 0;
+        --queued_count_;
+    }
+}
+
+template<typename layer_t>
+void DStarLite<layer_t>::update_around( const uint32_t cell ){
+    const int64_t i = cell % dimension;
+    const int64_t j = cell / dimension;
+    // a change to one cell may also open or close the diagonal steps which cut its corners; and those
+    // steps are all between its neighbors.
+    for( int64_t nj = std::max<int64_t>(0, j - 1); nj <= std::min<int64_t>(dimension - 1, j + 1); ++nj ){
+        for( int64_t ni = std::max<int64_t>(0, i - 1); ni <= std::min<int64_t>(dimension - 1, i + 1); ++ni ){
+            update_cell( static_cast<uint32_t>(nj*dimension + ni) );
+        }
+    }
+}
+
+template<typename layer_t>
+void DStarLite<layer_t>::compute_shortest_path(){
+    CHARTBOX_PROBE_TALLY( expansions, "dstar.expansions" );
+    constexpr cost_t infinity = std::numeric_limits<cost_t>::infinity();
+
+    while( true ){
+        // drop stale entries: cells since made consistent, or re-queued with another key
+        while( (! queue_.empty()) && ((! queued_[queue_.top().cell]) || (! (queue_.top().key == key_[queue_.top().cell]))) ){
+            queue_.pop();
+        }
+        if( queue_.empty() ){
+            return;
+        }
+
+        const Entry top = queue_.top();
+        if( (! (top.key < calculate_key(start_))) && (rhs_[start_] == g_[start_]) ){
+            return;
+        }
+
+        const uint32_t at = top.cell;
+        queue_.pop();
+        const Key current = calculate_key( at );
+        if( top.key < current ){
+            // queued before the start last moved
+            key_[at] = current;
+            queue_.push({ current, at });
+            continue;
+        }
+
+        dequeue( at );
+        ++expansions_;
+        CHARTBOX_PROBE_INCREMENT( expansions );
+
+        const uint32_t i = at % dimension;
+        const uint32_t j = at / dimension;
+        const uint8_t steps = steps_from( at );
+        if( rhs_[at] < g_[at] ){
+            // lowered: a neighbor's lookahead can only improve, by stepping through this cell
+            g_[at] = rhs_[at];
+            for( size_t k = 0; k < eight_neighbors.size(); ++k ){
+                const GridStep& step = eight_neighbors[k];
+                const uint32_t neighbor = (j + step.dj)*dimension + (i + step.di);
+                if( (0 != ((steps >> k) & 1)) && (neighbor != goal_) && (step.cost + g_[at] < rhs_[neighbor]) ){
+                    rhs_[neighbor] = step.cost + g_[at];
+                    requeue( neighbor );
+                }
+            }
+        }else{
+            // raised: only neighbors whose lookahead went through this cell must search their neighbors again
+            const cost_t previous = g_[at];
+            g_[at] = infinity;
+            requeue( at );
+            for( size_t k = 0; k < eight_neighbors.size(); ++k ){
+                const GridStep& step = eight_neighbors[k];
+                const uint32_t neighbor = (j + step.dj)*dimension + (i + step.di);
+                if( (0 != ((steps >> k) & 1)) && (rhs_[neighbor] == step.cost + previous) ){
+                    update_cell( neighbor );
+                }
+            }
+        }
+    }
+}
+
+template<typename layer_t>
+bool DStarLite<layer_t>::extract( std::vector<uint32_t>& cells ) const {
+    if( std::isinf(g_[start_]) ){
+        return false;
+    }
+
+    cells.push_back( start_ );
+    for( uint32_t at = start_; at != goal_; ){
+        const uint32_t i = at % dimension;
+        const uint32_t j = at / dimension;
+        const uint8_t steps = steps_from( at );
+        cost_t best = std::numeric_limits<cost_t>::infinity();
+        uint32_t next = at;
+        for( size_t k = 0; k < eight_neighbors.size(); ++k ){
+            const GridStep& step = eight_neighbors[k];
+            const uint32_t neighbor = (j + step.dj)*dimension + (i + step.di);
+            if( (0 != ((steps >> k) & 1)) && (step.cost + g_[neighbor] < best) ){
+                best = step.cost + g_[neighbor];
+                next = neighbor;
+            }
+        }
+        // each step must descend; so a path longer than the layer can only be a cycle of stale costs
+        if( std::isinf(best) || (dimension * dimension < cells.size()) ){
+            return false;
+        }
+        cells.push_back( next );
+        at = next;
+    }
+    return true;
+}
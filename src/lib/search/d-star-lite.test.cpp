@@ -0,0 +1,125 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include "chart-box/geometry/path.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+
+#include "d-star-lite.hpp"
+#include "hpa-star.hpp"
+#include "test-fixtures.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+using chart::geometry::Path;
+using chartbox::layer::FixedGridLayer;
+
+namespace chartbox::search {
+
+static const AlignedBox2d bounds( Vector2d(0,0), Vector2d(128,128) );
+
+TEST( SearchDStarLite, MatchesAStar ){
+    FixedGridLayer layer( bounds );
+    scatter( layer, 55 );
+    HierarchicalAStar<FixedGridLayer> reference( layer );
+    DStarLite<FixedGridLayer> search( layer );
+
+    std::mt19937 generator( 55 );
+    std::uniform_int_distribution<uint32_t> index( 0, 127 );
+    size_t found = 0;
+    for( size_t query = 0; query < 32; ++query ){
+        const Vector2d start( index(generator) + 0.5, index(generator) + 0.5 );
+        const Vector2d goal( index(generator) + 0.5, index(generator) + 0.5 );
+        const Path expected = reference.compute_flat( start, goal );
+        const Path actual = search.compute( start, goal );
+        ASSERT_EQ( expected.empty(), actual.empty() ) << "    @ query " << query;
+        if( ! expected.empty() ){
+            EXPECT_NEAR( expected.length(), actual.length(), 1e-3 ) << "    @ query " << query;
+            ++found;
+        }
+    }
+    EXPECT_LT( 16, found );
+}
+
+TEST( SearchDStarLite, RepairsAfterChanges ){
+    FixedGridLayer layer( bounds );
+    scatter( layer, 7 );
+    layer.fill( AlignedBox2d(Vector2d(0, 0), Vector2d(8, 8)), FixedGridLayer::clear_value );
+    layer.fill( AlignedBox2d(Vector2d(120, 120), Vector2d(128, 128)), FixedGridLayer::clear_value );
+    HierarchicalAStar<FixedGridLayer> reference( layer );
+    DStarLite<FixedGridLayer> search( layer );
+
+    Vector2d start( 2.5, 2.5 );
+    const Vector2d goal( 125.5, 125.5 );
+    const Path initial = search.compute( start, goal );
+    ASSERT_FALSE( initial.empty() );
+    const size_t initial_expansions = search.expansions();
+
+    std::mt19937 generator( 7 );
+    for( size_t round = 0; round < 12; ++round ){
+        // drop a small obstacle onto the current path, away from both ends
+        const Path current = search.compute( start, goal );
+        ASSERT_FALSE( current.empty() );
+        const Vector2d& waypoint = current[ current.size() / 2 ];
+        const AlignedBox2d area( waypoint - Vector2d(2, 2), waypoint + Vector2d(2, 2) );
+        if( area.contains(start) || area.contains(goal) ){
+            continue;
+        }
+        layer.fill( area, (0 == (round % 3)) ? FixedGridLayer::clear_value : 0x99 );
+        search.update( area );
+
+        // and advance the start a little way along the old path
+        if( (1 < current.size()) && (! area.contains(current[1])) && (0 == (generator() % 2)) ){
+            start = current[1];
+        }
+
+        const Path expected = reference.compute_flat( start, goal );
+        const Path actual = search.compute( start, goal );
+        ASSERT_EQ( expected.empty(), actual.empty() ) << "    @ round " << round;
+        EXPECT_NEAR( expected.length(), actual.length(), 1e-3 ) << "    @ round " << round;
+        EXPECT_LT( search.expansions(), initial_expansions ) << "    @ round " << round;
+    }
+}
+
+TEST( SearchDStarLite, ClosedAndReopened ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    // wall along x = 70, with a gap at y = [100, 104)
+    layer.fill( AlignedBox2d(Vector2d(70, 0), Vector2d(71, 100)), 0x99 );
+    layer.fill( AlignedBox2d(Vector2d(70, 104), Vector2d(71, 128)), 0x99 );
+    DStarLite<FixedGridLayer> search( layer );
+
+    const Path open = search.compute( {10.5, 10.5}, {120.5, 10.5} );
+    ASSERT_FALSE( open.empty() );
+
+    const AlignedBox2d gap( Vector2d(70, 100), Vector2d(71, 104) );
+    layer.fill( gap, 0x99 );
+    search.update( gap );
+    EXPECT_TRUE( search.compute( {10.5, 10.5}, {120.5, 10.5} ).empty() );
+
+    layer.fill( gap, FixedGridLayer::clear_value );
+    search.update( gap );
+    const Path reopened = search.compute( {10.5, 10.5}, {120.5, 10.5} );
+    EXPECT_NEAR( open.length(), reopened.length(), 1e-3 );
+}
+
+TEST( SearchDStarLite, BlockedEndpoints ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    layer.store( {5.5, 5.5}, 0x99 );
+    DStarLite<FixedGridLayer> search( layer );
+
+    EXPECT_TRUE( search.compute( {5.5, 5.5}, {50.5, 50.5} ).empty() );
+    EXPECT_TRUE( search.compute( {50.5, 50.5}, {5.5, 5.5} ).empty() );
+    EXPECT_TRUE( search.compute( {50.5, 50.5}, {500.5, 5.5} ).empty() );
+
+    const Path same = search.compute( {50.5, 50.5}, {50.7, 50.2} );
+    ASSERT_EQ( same.size(), 1 );
+}
+
+} // namespace chartbox::search
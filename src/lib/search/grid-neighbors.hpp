@@ -0,0 +1,134 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include "chart-box/geometry/path.hpp"
+
+namespace chartbox::search {
+
+typedef float cost_t;
+
+constexpr cost_t orthogonal_cost = 1.0f;
+constexpr cost_t diagonal_cost = 1.41421356f;
+
+/// \brief one move on an 8-connected grid
+struct GridStep {
+    int32_t di;
+    int32_t dj;
+    cost_t cost;
+};
+
+/// \brief ordered counter-clockwise, starting from east
+constexpr std::array<GridStep, 8> eight_neighbors = {{
+    { 1,  0, orthogonal_cost}, { 1,  1, diagonal_cost},
+    { 0,  1, orthogonal_cost}, {-1,  1, diagonal_cost},
+    {-1,  0, orthogonal_cost}, {-1, -1, diagonal_cost},
+    { 0, -1, orthogonal_cost}, { 1, -1, diagonal_cost} }};
+
+/// \brief entry for a min-heap of cells: `std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>>`
+struct QueueEntry {
+    cost_t priority;
+    uint32_t cell;
+
+    inline bool operator>( const QueueEntry& rhs ) const {
+        return priority > rhs.priority; }
+};
+
+/// \brief admissible & consistent heuristic for 8-connected grids
+inline cost_t octile_distance( const uint32_t i0, const uint32_t j0, const uint32_t i1, const uint32_t j1 ){
+    const uint32_t di = (i0 < i1) ? (i1 - i0) : (i0 - i1);
+    const uint32_t dj = (j0 < j1) ? (j1 - j0) : (j0 - j1);
+    const uint32_t diagonal = std::min(di, dj);
+    const uint32_t straight = std::max(di, dj) - diagonal;
+    return static_cast<cost_t>(straight) * orthogonal_cost + static_cast<cost_t>(diagonal) * diagonal_cost;
+}
+
+/// \warning does not check bounds
+template<typename layer_t>
+inline bool is_blocked( const layer_t& layer, const uint32_t i, const uint32_t j ){
+    return layer.blocked( i, j );
+}
+
+/// \brief test if a step from (i,j) is in-bounds and passable.
+///
+/// Diagonal steps may not cut the corner of a blocked cell.
+template<typename layer_t>
+inline bool can_step( const layer_t& layer, const uint32_t i, const uint32_t j, const GridStep& step ){
+    constexpr int64_t dimension = static_cast<int64_t>(layer_t::dimension);
+    const int64_t ni = static_cast<int64_t>(i) + step.di;
+    const int64_t nj = static_cast<int64_t>(j) + step.dj;
+    if( (ni < 0) || (dimension <= ni) || (nj < 0) || (dimension <= nj) ){
+        return false;
+    }else if( is_blocked(layer, ni, nj) ){
+        return false;
+    }else if( (0 != step.di) && (0 != step.dj) ){
+        return ! ( is_blocked(layer, ni, j) || is_blocked(layer, i, nj) );
+    }
+    return true;
+}
+
+/// \brief every step from (i,j) which `can_step(...)` would allow, at once
+///
+/// \return bit k is set if `eight_neighbors[k]` is in-bounds and passable
+template<typename layer_t>
+inline uint8_t passable_steps( const layer_t& layer, const uint32_t i, const uint32_t j ){
+    const uint32_t clear = static_cast<uint8_t>( ~layer.blocked_neighbors(i, j) );
+    // a diagonal (odd bit) also needs both of the orthogonal neighbors on either side of it
+    const uint32_t before = ((clear << 1) | (clear >> 7)) & 0xff;
+    const uint32_t after = ((clear >> 1) | (clear << 7)) & 0xff;
+    return static_cast<uint8_t>( (clear & 0x55) | (clear & before & after & 0xaa) );
+}
+
+/// \brief convert a layer-local location into cell indices
+/// \return false if the location is outside of the layer
+template<typename layer_t>
+inline bool to_cell( const layer_t& layer, const Eigen::Vector2d& location, uint32_t& i, uint32_t& j ){
+    const double scale = layer.inverse_precision();
+    const double x = location.x() * scale;
+    const double y = location.y() * scale;
+    if( (x < 0) || (layer_t::dimension <= x) || (y < 0) || (layer_t::dimension <= y) ){
+        return false;
+    }
+    i = static_cast<uint32_t>(x);
+    j = static_cast<uint32_t>(y);
+    return true;
+}
+
+/// \brief location of the center of the given cell
+template<typename layer_t>
+inline Eigen::Vector2d to_location( const layer_t& layer, const uint32_t i, const uint32_t j ){
+    const double precision = layer.precision();
+    return { (i + 0.5) * precision, (j + 0.5) * precision };
+}
+
+/// \brief convert a sequence of cell ids (`j*dimension + i`) into a path, dropping intermediate points of straight runs
+template<typename layer_t>
+chart::geometry::Path to_path( const layer_t& layer, const std::vector<uint32_t>& cells ){
+    constexpr uint32_t dimension = layer_t::dimension;
+    chart::geometry::Path path;
+    for( size_t k = 0; k < cells.size(); ++k ){
+        const uint32_t i = cells[k] % dimension;
+        const uint32_t j = cells[k] / dimension;
+        if( (0 < k) && (k + 1 < cells.size()) ){
+            const int64_t s0i = static_cast<int64_t>(i) - (cells[k-1] % dimension);
+            const int64_t s0j = static_cast<int64_t>(j) - (cells[k-1] / dimension);
+            const int64_t s1i = static_cast<int64_t>(cells[k+1] % dimension) - i;
+            const int64_t s1j = static_cast<int64_t>(cells[k+1] / dimension) - j;
+            if( (s0i == s1i) && (s0j == s1j) ){
+                continue;
+            }
+        }
+        path.push_back( to_location(layer, i, j) );
+    }
+    return path;
+}
+
+} // namespace chartbox::search
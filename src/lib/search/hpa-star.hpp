@@ -0,0 +1,150 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include "chart-box/geometry/path.hpp"
+
+#include "grid-neighbors.hpp"
+
+namespace chartbox::search {
+
+/// \brief Hierarchical path-finding A* (HPA*) over square tiles of a grid layer
+///
+/// ## Implementation Specifics
+/// The layer is partitioned into `tile_dimension` x `tile_dimension` tiles (by default, the size of a
+/// `Tile1k`).  Along each shared tile border, every maximal run of cells which is clear on both sides
+/// forms an "entrance", represented by one or two transition cell-pairs.  Transition cells are the nodes
+/// of an abstract graph.  Each tile caches the shortest-path cost between every pair of its own
+/// transition cells ("intra-edges"), computed with a Dijkstra search confined to that tile.
+///
+/// A query connects the start and goal cells to the transition cells of their own tiles, searches the
+/// (small) abstract graph, and then refines each abstract hop with an A* search confined to the one tile
+/// it crosses; tiles away from the chosen corridor are never searched.
+///
+/// ### See Also:
+///   - Botea, Müller, Schaeffer; "Near Optimal Hierarchical Path-Finding" (2004)
+///
+/// \warning the layer is only read, but any modification must be reported through `update(...)`
+template<typename layer_t, size_t tile_dimension = 32>
+class HierarchicalAStar {
+public:
+    HierarchicalAStar() = delete;
+
+    /// \brief build the complete abstract graph for the given layer
+    HierarchicalAStar( const layer_t& layer );
+
+    /// \brief Find a path between the two given points
+    ///
+    /// \param start - location to start searching from
+    /// \param goal - location to search to
+    /// \return the found path; or an empty path, if no path exists
+    chart::geometry::Path compute( const Eigen::Vector2d& start, const Eigen::Vector2d& goal );
+
+    /// \brief Reference implementation: the same low-level A*, run over the entire layer.
+    chart::geometry::Path compute_flat( const Eigen::Vector2d& start, const Eigen::Vector2d& goal );
+
+    /// \brief recompute the abstract graph from scratch
+    void rebuild();
+
+    /// \brief recompute the cached edges of every tile overlapping the (modified) area
+    void update( const Eigen::AlignedBox2d& area );
+
+    /// \brief recompute the cached edges of one tile
+    ///
+    /// The transitions on this tile's borders are recomputed, and its intra-edges are re-searched.
+    /// A neighboring tile's intra-edges are only re-searched if the set of transition cells on its
+    /// side of the shared border actually changed.
+    void update_tile( const uint32_t tile_i, const uint32_t tile_j );
+
+    /// \brief number of cells expanded by the low-level A* during the most recent `compute(...)` or `compute_flat(...)`
+    inline size_t expansions() const { return expansions_; }
+
+    /// \brief total number of abstract-graph nodes (transition cells)
+    size_t node_count() const;
+
+    /// \brief total number of abstract-graph edges (inter- & intra-tile)
+    size_t edge_count() const;
+
+public:
+    constexpr static size_t dimension = layer_t::dimension;
+    constexpr static size_t tiles_per_side = dimension / tile_dimension;
+
+    static_assert( 0 == (dimension % tile_dimension), "Tiles must evenly divide the layer!" );
+
+    /// \brief entrances narrower than this are represented by a single transition (in the middle)
+    constexpr static size_t maximum_entrance_width = 6;
+
+private:
+    struct Edge {
+        uint32_t to;   ///< cell id
+        cost_t cost;
+    };
+
+    struct Transition {
+        uint32_t from; ///< cell id inside this tile
+        uint32_t to;   ///< cell id inside the neighboring tile
+    };
+
+    struct TileCache {
+        std::vector<Transition> transitions;
+        /// keyed by the source transition cell id
+        std::unordered_map<uint32_t, std::vector<Edge>> edges;
+    };
+
+    /// \brief defines a rectangular subset of the layer, in cell indices: [i_min, i_max) x [j_min, j_max)
+    struct Window {
+        uint32_t i_min, j_min, i_max, j_max;
+
+        inline bool contains( uint32_t i, uint32_t j ) const {
+            return (i_min <= i) && (i < i_max) && (j_min <= j) && (j < j_max); }
+    };
+
+    Window tile_window( const uint32_t tile_i, const uint32_t tile_j ) const;
+
+    TileCache& tile_of( const uint32_t cell );
+
+    /// \brief recompute the transitions along the border between two adjacent tiles
+    void link_tiles( const uint32_t tile_i, const uint32_t tile_j, const bool east );
+
+    /// \brief re-search the intra-edges of one tile
+    void connect_tile( const uint32_t tile_i, const uint32_t tile_j );
+
+    /// \brief Dijkstra from `from`, confined to `window`, recording the cost to each of `targets`
+    std::vector<Edge> search_costs( const Window& window, const uint32_t from, const std::vector<uint32_t>& targets );
+
+    /// \brief A*, confined to `window`, appending the resulting cells (excluding `from`) to `route`
+    bool search_route( const Window& window, const uint32_t from, const uint32_t to, std::vector<uint32_t>& route );
+
+    /// \brief A* over the abstract graph
+    bool search_abstract( const uint32_t start, const uint32_t goal, std::vector<uint32_t>& route );
+
+    static std::vector<uint32_t> transition_cells( const TileCache& tile );
+
+private:
+    const layer_t& layer_;
+
+    std::vector<TileCache> tiles_;
+
+    // low-level search workspace; sized for the entire layer, and reused between searches
+    std::vector<cost_t> cost_;
+    std::vector<uint32_t> previous_;
+    std::vector<uint32_t> generation_;
+    uint32_t current_generation_ = 0;
+    size_t expansions_ = 0;
+
+    // temporary edges connecting the start and goal cells into the abstract graph, for the current query
+    std::vector<Edge> start_edges_;
+    std::unordered_map<uint32_t, cost_t> goal_edges_;
+
+}; // class HierarchicalAStar
+
+} // namespace chartbox::search
+
+#include "hpa-star.inl"
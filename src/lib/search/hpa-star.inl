@@ -0,0 +1,470 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// NOTE: This is the template-class implementation --
+//       It is not compiled until referenced, even though it contains the
+//       function implementations.
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "probe/probe.hpp"
+
+using chartbox::search::HierarchicalAStar;
+
+template<typename layer_t, size_t tile_dimension>
+HierarchicalAStar<layer_t,tile_dimension>::HierarchicalAStar( const layer_t& _layer )
+    : layer_(_layer)
+    , cost_( dimension * dimension )
+    , previous_( dimension * dimension )
+    , generation_( dimension * dimension, 0 )
+{
+    rebuild();
+}
+
+template<typename layer_t, size_t tile_dimension>
+chart::geometry::Path HierarchicalAStar<layer_t,tile_dimension>::compute( const Eigen::Vector2d& start_point, const Eigen::Vector2d& goal_point ){
+    CHARTBOX_PROBE_SCOPE( "hpa.compute" );
+    expansions_ = 0;
+    uint32_t si, sj, gi, gj;
+    if( (! to_cell(layer_, start_point, si, sj)) || (! to_cell(layer_, goal_point, gi, gj)) ){
+        return {};
+    }else if( is_blocked(layer_, si, sj) || is_blocked(layer_, gi, gj) ){
+        return {};
+    }
+
+    const uint32_t start = sj*dimension + si;
+    const uint32_t goal = gj*dimension + gi;
+    if( start == goal ){
+        return to_path( layer_, {start} );
+    }
+
+    // (1) temporarily connect the start and goal into the abstract graph
+    const uint32_t start_tile = (sj / tile_dimension) * tiles_per_side + (si / tile_dimension);
+    const uint32_t goal_tile = (gj / tile_dimension) * tiles_per_side + (gi / tile_dimension);
+
+    std::vector<uint32_t> start_targets = transition_cells( tiles_[start_tile] );
+    if( start_tile == goal_tile ){
+        start_targets.push_back( goal );
+    }
+    start_edges_ = search_costs( tile_window(si / tile_dimension, sj / tile_dimension), start, start_targets );
+
+    goal_edges_.clear();
+    for( const Edge& edge : search_costs( tile_window(gi / tile_dimension, gj / tile_dimension), goal, transition_cells(tiles_[goal_tile])) ){
+        goal_edges_[edge.to] = edge.cost;
+    }
+
+    // (2) search the abstract graph
+    std::vector<uint32_t> abstract_route;
+    if( ! search_abstract(start, goal, abstract_route) ){
+        return {};
+    }
+
+    // (3) refine each hop, within the one tile that it crosses
+    std::vector<uint32_t> route = { start };
+    for( size_t k = 1; k < abstract_route.size(); ++k ){
+        const uint32_t from = abstract_route[k-1];
+        const uint32_t to = abstract_route[k];
+        const uint32_t ti = (from % dimension) / tile_dimension;
+        const uint32_t tj = (from / dimension) / tile_dimension;
+        const Window window = tile_window( ti, tj );
+        if( window.contains(to % dimension, to / dimension) ){
+            if( ! search_route(window, from, to, route) ){
+                return {};  // cache is out-of-date!
+            }
+        }else{
+            // inter-tile edge: the cells are adjacent
+            route.push_back( to );
+        }
+    }
+
+    return to_path( layer_, route );
+}
+
+template<typename layer_t, size_t tile_dimension>
+chart::geometry::Path HierarchicalAStar<layer_t,tile_dimension>::compute_flat( const Eigen::Vector2d& start_point, const Eigen::Vector2d& goal_point ){
+    CHARTBOX_PROBE_SCOPE( "astar.compute" );
+    expansions_ = 0;
+    uint32_t si, sj, gi, gj;
+    if( (! to_cell(layer_, start_point, si, sj)) || (! to_cell(layer_, goal_point, gi, gj)) ){
+        return {};
+    }else if( is_blocked(layer_, si, sj) || is_blocked(layer_, gi, gj) ){
+        return {};
+    }
+
+    const uint32_t start = sj*dimension + si;
+    std::vector<uint32_t> route = { start };
+    const Window everything = { 0, 0, dimension, dimension };
+    if( search_route(everything, start, gj*dimension + gi, route) ){
+        return to_path( layer_, route );
+    }
+    return {};
+}
+
+template<typename layer_t, size_t tile_dimension>
+size_t HierarchicalAStar<layer_t,tile_dimension>::edge_count() const {
+    size_t count = 0;
+    for( const TileCache& tile : tiles_ ){
+        count += tile.transitions.size();
+        for( const auto& each : tile.edges ){
+            count += each.second.size();
+        }
+    }
+    return count;
+}
+
+template<typename layer_t, size_t tile_dimension>
+void HierarchicalAStar<layer_t,tile_dimension>::connect_tile( const uint32_t tile_i, const uint32_t tile_j ){
+    TileCache& tile = tiles_[ tile_j * tiles_per_side + tile_i ];
+    const Window window = tile_window( tile_i, tile_j );
+    const std::vector<uint32_t> cells = transition_cells( tile );
+
+    tile.edges.clear();
+    for( const uint32_t from : cells ){
+        tile.edges[from] = search_costs( window, from, cells );
+    }
+}
+
+template<typename layer_t, size_t tile_dimension>
+bool HierarchicalAStar<layer_t,tile_dimension>::search_abstract( const uint32_t start, const uint32_t goal, std::vector<uint32_t>& route ){
+    const uint32_t gi = goal % dimension;
+    const uint32_t gj = goal / dimension;
+
+    // the abstract graph is small -- a hash-map is sufficient
+    std::unordered_map<uint32_t, std::pair<cost_t,uint32_t>> visited;   // => (cost-spent, previous)
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> upcoming;
+
+    CHARTBOX_PROBE_TALLY( expansions, "hpa.abstract.expansions" );
+
+    visited[start] = { 0, start };
+    upcoming.push({ octile_distance(start % dimension, start / dimension, gi, gj), start });
+
+    while( ! upcoming.empty() ){
+        const QueueEntry next = upcoming.top();
+        upcoming.pop();
+
+        const uint32_t at = next.cell;
+        if( at == goal ){
+            route.clear();
+            for( uint32_t cell = goal; cell != start; cell = visited[cell].second ){
+                route.push_back( cell );
+            }
+            route.push_back( start );
+            std::reverse( route.begin(), route.end() );
+            return true;
+        }
+
+        const cost_t cost_spent = visited[at].first;
+        if( (cost_spent + octile_distance(at % dimension, at / dimension, gi, gj)) < next.priority ){
+            continue;  // stale entry
+        }
+        CHARTBOX_PROBE_INCREMENT( expansions );
+
+        auto relax = [&]( const uint32_t to, const cost_t edge_cost ){
+            const cost_t cost_to_neighbor = cost_spent + edge_cost;
+            auto found = visited.find(to);
+            if( (visited.end() == found) || (cost_to_neighbor < found->second.first) ){
+                visited[to] = { cost_to_neighbor, at };
+                upcoming.push({ cost_to_neighbor + octile_distance(to % dimension, to / dimension, gi, gj), to });
+            }
+        };
+
+        if( at == start ){
+            for( const Edge& edge : start_edges_ ){
+                relax( edge.to, edge.cost );
+            }
+        }
+
+        const TileCache& tile = tile_of( at );
+        for( const Transition& transition : tile.transitions ){
+            if( transition.from == at ){
+                relax( transition.to, orthogonal_cost );
+            }
+        }
+        auto intra = tile.edges.find( at );
+        if( tile.edges.end() != intra ){
+            for( const Edge& edge : intra->second ){
+                relax( edge.to, edge.cost );
+            }
+        }
+
+        auto to_goal = goal_edges_.find( at );
+        if( goal_edges_.end() != to_goal ){
+            relax( goal, to_goal->second );
+        }
+    }
+
+    return false;
+}
+
+template<typename layer_t, size_t tile_dimension>
+std::vector<typename HierarchicalAStar<layer_t,tile_dimension>::Edge>
+HierarchicalAStar<layer_t,tile_dimension>::search_costs( const Window& window, const uint32_t from, const std::vector<uint32_t>& targets ){
+    ++current_generation_;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> upcoming;
+
+    // stop early, once every target is settled
+    std::vector<uint32_t> unsettled = targets;
+    std::sort( unsettled.begin(), unsettled.end() );
+    size_t remaining = unsettled.size();
+
+    cost_[from] = 0;
+    generation_[from] = current_generation_;
+    upcoming.push({ 0, from });
+
+    while( (0 < remaining) && (! upcoming.empty()) ){
+        const QueueEntry next = upcoming.top();
+        upcoming.pop();
+        const uint32_t at = next.cell;
+        if( cost_[at] < next.priority ){
+            continue;  // stale entry
+        }else if( std::binary_search(unsettled.begin(), unsettled.end(), at) ){
+            --remaining;
+        }
+
+        const uint32_t i = at % dimension;
+        const uint32_t j = at / dimension;
+        const uint8_t steps = passable_steps( layer_, i, j );
+        for( size_t k = 0; k < eight_neighbors.size(); ++k ){
+            const GridStep& step = eight_neighbors[k];
+            const uint32_t ni = i + step.di;
+            const uint32_t nj = j + step.dj;
+            if( (0 == ((steps >> k) & 1)) || (! window.contains(ni, nj)) ){
+                continue;
+            }
+            const uint32_t neighbor = nj*dimension + ni;
+            const cost_t cost_to_neighbor = next.priority + step.cost;
+            if( (generation_[neighbor] != current_generation_) || (cost_to_neighbor < cost_[neighbor]) ){
+                generation_[neighbor] = current_generation_;
+                cost_[neighbor] = cost_to_neighbor;
+                upcoming.push({ cost_to_neighbor, neighbor });
+            }
+        }
+    }
+
+    std::vector<Edge> edges;
+    for( const uint32_t target : targets ){
+        if( (target != from) && (generation_[target] == current_generation_) ){
+            edges.push_back({ target, cost_[target] });
+        }
+    }
+    return edges;
+}
+
+template<typename layer_t, size_t tile_dimension>
+bool HierarchicalAStar<layer_t,tile_dimension>::search_route( const Window& window, const uint32_t from, const uint32_t to, std::vector<uint32_t>& route ){
+    ++current_generation_;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> upcoming;
+
+    const uint32_t gi = to % dimension;
+    const uint32_t gj = to / dimension;
+
+    CHARTBOX_PROBE_TALLY( expansions, "astar.expansions" );
+    CHARTBOX_PROBE_TALLY( pushes, "astar.heap.pushes" );
+    CHARTBOX_PROBE_TALLY( pops, "astar.heap.pops" );
+    CHARTBOX_PROBE_TALLY( blocked, "astar.blocked_steps" );
+
+    cost_[from] = 0;
+    previous_[from] = from;
+    generation_[from] = current_generation_;
+    CHARTBOX_PROBE_INCREMENT( pushes );
+    upcoming.push({ octile_distance(from % dimension, from / dimension, gi, gj), from });
+
+    while( ! upcoming.empty() ){
+        const QueueEntry next = upcoming.top();
+        upcoming.pop();
+        CHARTBOX_PROBE_INCREMENT( pops );
+        const uint32_t at = next.cell;
+        const uint32_t i = at % dimension;
+        const uint32_t j = at / dimension;
+
+        if( at == to ){
+            const size_t route_start = route.size();
+            for( uint32_t cell = to; cell != from; cell = previous_[cell] ){
+                route.push_back( cell );
+            }
+            std::reverse( route.begin() + route_start, route.end() );
+            return true;
+        }else if( (cost_[at] + octile_distance(i, j, gi, gj)) < next.priority ){
+            continue;  // stale entry
+        }
+
+        const uint8_t steps = passable_steps( layer_, i, j );
+        ++expansions_;
+        CHARTBOX_PROBE_INCREMENT( expansions );
+        CHARTBOX_PROBE_ADD( blocked, eight_neighbors.size() - __builtin_popcount(steps) );
+        for( size_t k = 0; k < eight_neighbors.size(); ++k ){
+            const GridStep& step = eight_neighbors[k];
+            const uint32_t ni = i + step.di;
+            const uint32_t nj = j + step.dj;
+            if( (0 == ((steps >> k) & 1)) || (! window.contains(ni, nj)) ){
+                continue;
+            }
+            const uint32_t neighbor = nj*dimension + ni;
+            const cost_t cost_to_neighbor = cost_[at] + step.cost;
+            if( (generation_[neighbor] != current_generation_) || (cost_to_neighbor < cost_[neighbor]) ){
+                generation_[neighbor] = current_generation_;
+                cost_[neighbor] = cost_to_neighbor;
+                previous_[neighbor] = at;
+                CHARTBOX_PROBE_INCREMENT( pushes );
+                upcoming.push({ cost_to_neighbor + octile_distance(ni, nj, gi, gj), neighbor });
+            }
+        }
+    }
+
+    return false;
+}
+
+template<typename layer_t, size_t tile_dimension>
+void HierarchicalAStar<layer_t,tile_dimension>::link_tiles( const uint32_t tile_i, const uint32_t tile_j, const bool east ){
+    TileCache& near = tiles_[ tile_j * tiles_per_side + tile_i ];
+    TileCache& far = east ? tiles_[ tile_j * tiles_per_side + tile_i + 1 ] : tiles_[ (tile_j + 1) * tiles_per_side + tile_i ];
+    const Window far_window = east ? tile_window(tile_i + 1, tile_j) : tile_window(tile_i, tile_j + 1);
+    const Window near_window = tile_window( tile_i, tile_j );
+
+    // discard the previous transitions across this border
+    auto crosses_into = []( const Window& window ){
+        return [window]( const Transition& t ){ return window.contains(t.to % dimension, t.to / dimension); }; };
+    near.transitions.erase( std::remove_if(near.transitions.begin(), near.transitions.end(), crosses_into(far_window)), near.transitions.end() );
+    far.transitions.erase( std::remove_if(far.transitions.begin(), far.transitions.end(), crosses_into(near_window)), far.transitions.end() );
+
+    // scan along the border for runs of cells which are clear on both sides
+    const uint32_t offset = east ? near_window.i_max - 1 : near_window.j_max - 1;
+    const uint32_t border_start = east ? near_window.j_min : near_window.i_min;
+    auto near_cell = [=]( uint32_t k ) -> uint32_t { return east ? (k*dimension + offset) : (offset*dimension + k); };
+    auto far_cell = [=]( uint32_t k ) -> uint32_t { return east ? (k*dimension + offset + 1) : ((offset + 1)*dimension + k); };
+    auto is_clear = [&]( uint32_t k ){
+        return east ? !( is_blocked(layer_, offset, k) || is_blocked(layer_, offset + 1, k) )
+                    : !( is_blocked(layer_, k, offset) || is_blocked(layer_, k, offset + 1) ); };
+    auto add_transition = [&]( uint32_t k ){
+        near.transitions.push_back({ near_cell(k), far_cell(k) });
+        far.transitions.push_back({ far_cell(k), near_cell(k) });
+    };
+
+    uint32_t k = border_start;
+    const uint32_t border_end = border_start + tile_dimension;
+    while( k < border_end ){
+        if( ! is_clear(k) ){
+            ++k;
+            continue;
+        }
+        const uint32_t run_start = k;
+        while( (k < border_end) && is_clear(k) ){
+            ++k;
+        }
+        const uint32_t run_width = k - run_start;
+        if( run_width < maximum_entrance_width ){
+            add_transition( run_start + run_width/2 );
+        }else{
+            add_transition( run_start );
+            add_transition( k - 1 );
+        }
+    }
+}
+
+template<typename layer_t, size_t tile_dimension>
+size_t HierarchicalAStar<layer_t,tile_dimension>::node_count() const {
+    size_t count = 0;
+    for( const TileCache& tile : tiles_ ){
+        count += transition_cells(tile).size();
+    }
+    return count;
+}
+
+template<typename layer_t, size_t tile_dimension>
+void HierarchicalAStar<layer_t,tile_dimension>::rebuild(){
+    CHARTBOX_PROBE_SCOPE( "hpa.rebuild" );
+    tiles_.assign( tiles_per_side * tiles_per_side, {} );
+
+    for( uint32_t tile_j = 0; tile_j < tiles_per_side; ++tile_j ){
+        for( uint32_t tile_i = 0; tile_i < tiles_per_side; ++tile_i ){
+            if( tile_i + 1 < tiles_per_side ){
+                link_tiles( tile_i, tile_j, true );
+            }
+            if( tile_j + 1 < tiles_per_side ){
+                link_tiles( tile_i, tile_j, false );
+            }
+        }
+    }
+
+    for( uint32_t tile_j = 0; tile_j < tiles_per_side; ++tile_j ){
+        for( uint32_t tile_i = 0; tile_i < tiles_per_side; ++tile_i ){
+            connect_tile( tile_i, tile_j );
+        }
+    }
+}
+
+template<typename layer_t, size_t tile_dimension>
+typename HierarchicalAStar<layer_t,tile_dimension>::TileCache& HierarchicalAStar<layer_t,tile_dimension>::tile_of( const uint32_t cell ){
+    const uint32_t tile_i = (cell % dimension) / tile_dimension;
+    const uint32_t tile_j = (cell / dimension) / tile_dimension;
+    return tiles_[ tile_j * tiles_per_side + tile_i ];
+}
+
+template<typename layer_t, size_t tile_dimension>
+typename HierarchicalAStar<layer_t,tile_dimension>::Window HierarchicalAStar<layer_t,tile_dimension>::tile_window( const uint32_t tile_i, const uint32_t tile_j ) const {
+    return { static_cast<uint32_t>(tile_i * tile_dimension),
+             static_cast<uint32_t>(tile_j * tile_dimension),
+             static_cast<uint32_t>((tile_i + 1) * tile_dimension),
+             static_cast<uint32_t>((tile_j + 1) * tile_dimension) };
+}
+
+template<typename layer_t, size_t tile_dimension>
+std::vector<uint32_t> HierarchicalAStar<layer_t,tile_dimension>::transition_cells( const TileCache& tile ){
+    std::vector<uint32_t> cells;
+    for( const Transition& transition : tile.transitions ){
+        cells.push_back( transition.from );
+    }
+    std::sort( cells.begin(), cells.end() );
+    cells.erase( std::unique(cells.begin(), cells.end()), cells.end() );
+    return cells;
+}
+
+template<typename layer_t, size_t tile_dimension>
+void HierarchicalAStar<layer_t,tile_dimension>::update( const Eigen::AlignedBox2d& area ){
+    const double tile_width = tile_dimension * layer_.precision();
+    const double limit = static_cast<double>(tiles_per_side - 1);
+    const uint32_t i_min = static_cast<uint32_t>( std::clamp(std::floor(area.min().x() / tile_width), 0.0, limit) );
+    const uint32_t j_min = static_cast<uint32_t>( std::clamp(std::floor(area.min().y() / tile_width), 0.0, limit) );
+    const uint32_t i_max = static_cast<uint32_t>( std::clamp(std::floor(area.max().x() / tile_width), 0.0, limit) );
+    const uint32_t j_max = static_cast<uint32_t>( std::clamp(std::floor(area.max().y() / tile_width), 0.0, limit) );
+
+    for( uint32_t tile_j = j_min; tile_j <= j_max; ++tile_j ){
+        for( uint32_t tile_i = i_min; tile_i <= i_max; ++tile_i ){
+            update_tile( tile_i, tile_j );
+        }
+    }
+}
+
+template<typename layer_t, size_t tile_dimension>
+void HierarchicalAStar<layer_t,tile_dimension>::update_tile( const uint32_t tile_i, const uint32_t tile_j ){
+    CHARTBOX_PROBE_SCOPE( "hpa.update_tile" );
+    if( (tiles_per_side <= tile_i) || (tiles_per_side <= tile_j) ){
+        return;
+    }
+
+    // (tile_i, tile_j) of each neighbor, and which border is shared
+    struct Border { uint32_t link_i; uint32_t link_j; bool east; uint32_t neighbor_i; uint32_t neighbor_j; };
+    std::vector<Border> borders;
+    if( 0 < tile_i ){                     borders.push_back({ tile_i - 1, tile_j, true,  tile_i - 1, tile_j }); }
+    if( tile_i + 1 < tiles_per_side ){    borders.push_back({ tile_i, tile_j,     true,  tile_i + 1, tile_j }); }
+    if( 0 < tile_j ){                     borders.push_back({ tile_i, tile_j - 1, false, tile_i, tile_j - 1 }); }
+    if( tile_j + 1 < tiles_per_side ){    borders.push_back({ tile_i, tile_j,     false, tile_i, tile_j + 1 }); }
+
+    for( const Border& border : borders ){
+        const TileCache& neighbor = tiles_[ border.neighbor_j * tiles_per_side + border.neighbor_i ];
+        const std::vector<uint32_t> before = transition_cells( neighbor );
+
+        link_tiles( border.link_i, border.link_j, border.east );
+
+        if( before != transition_cells(neighbor) ){
+            connect_tile( border.neighbor_i, border.neighbor_j );
+        }
+    }
+
+    connect_tile( tile_i, tile_j );
+}
@@ -0,0 +1,132 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <cmath>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include "chart-box/geometry/path.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+
+#include "hpa-star.hpp"
+
+using Eigen::Vector2d;
+
+using chart::geometry::Path;
+using chartbox::layer::FixedGridLayer;
+
+namespace chartbox::search {
+
+static const Eigen::AlignedBox2d bounds( Vector2d(0,0), Vector2d(128,128) );
+
+TEST( SearchHPAStar, OpenWater ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+
+    HierarchicalAStar<FixedGridLayer> search( layer );
+    EXPECT_EQ( search.tiles_per_side, 4 );
+    EXPECT_LT( 0, search.node_count() );
+
+    const Path path = search.compute( {2.5, 2.5}, {120.5, 100.5} );
+    ASSERT_FALSE( path.empty() );
+    EXPECT_DOUBLE_EQ( path[0].x(), 2.5 );
+    EXPECT_DOUBLE_EQ( path[0].y(), 2.5 );
+    EXPECT_DOUBLE_EQ( path[path.size()-1].x(), 120.5 );
+    EXPECT_DOUBLE_EQ( path[path.size()-1].y(), 100.5 );
+
+    const Path flat = search.compute_flat( {2.5, 2.5}, {120.5, 100.5} );
+    ASSERT_FALSE( flat.empty() );
+    EXPECT_NEAR( path.length(), flat.length(), 0.05 * flat.length() );
+}
+
+TEST( SearchHPAStar, SameTile ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    HierarchicalAStar<FixedGridLayer> search( layer );
+
+    const Path path = search.compute( {2.5, 2.5}, {10.5, 2.5} );
+    ASSERT_EQ( path.size(), 2 );
+    EXPECT_DOUBLE_EQ( path.length(), 8.0 );
+}
+
+TEST( SearchHPAStar, RouteThroughGap ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    // wall along x = 70, with a gap at y = [100, 104)
+    layer.fill( Eigen::AlignedBox2d(Vector2d(70, 0), Vector2d(71, 100)), 0x99 );
+    layer.fill( Eigen::AlignedBox2d(Vector2d(70, 104), Vector2d(71, 128)), 0x99 );
+
+    HierarchicalAStar<FixedGridLayer> search( layer );
+
+    const Path path = search.compute( {10.5, 10.5}, {120.5, 10.5} );
+    ASSERT_FALSE( path.empty() );
+    for( const auto& point : Path(path) ){
+        ASSERT_EQ( layer.get(point), FixedGridLayer::clear_value );
+    }
+
+    // the route must pass through the gap
+    bool crossed = false;
+    for( size_t k = 1; k < path.size(); ++k ){
+        if( (path[k-1].x() < 70) && (71 <= path[k].x()) ){
+            EXPECT_LE( 100, path[k].y() );
+            EXPECT_LT( path[k].y(), 104 );
+            crossed = true;
+        }
+    }
+    EXPECT_TRUE( crossed );
+
+    // now close the gap, and update only the affected tiles
+    const Eigen::AlignedBox2d gap( Vector2d(70, 100), Vector2d(71, 104) );
+    layer.fill( gap, 0x99 );
+    search.update( gap );
+    EXPECT_TRUE( search.compute( {10.5, 10.5}, {120.5, 10.5} ).empty() );
+    EXPECT_TRUE( search.compute_flat( {10.5, 10.5}, {120.5, 10.5} ).empty() );
+
+    // ... and re-open it
+    layer.fill( gap, FixedGridLayer::clear_value );
+    search.update( gap );
+    EXPECT_FALSE( search.compute( {10.5, 10.5}, {120.5, 10.5} ).empty() );
+}
+
+TEST( SearchHPAStar, BlockedEndpoints ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    layer.store( {5.5, 5.5}, 0x99 );
+    HierarchicalAStar<FixedGridLayer> search( layer );
+
+    EXPECT_TRUE( search.compute( {5.5, 5.5}, {50.5, 50.5} ).empty() );
+    EXPECT_TRUE( search.compute( {50.5, 50.5}, {5.5, 5.5} ).empty() );
+    EXPECT_TRUE( search.compute( {50.5, 50.5}, {500.5, 5.5} ).empty() );
+}
+
+TEST( SearchHPAStar, NearOptimalOnRandomObstacles ){
+    std::mt19937 generator(55);
+    std::bernoulli_distribution obstacle(0.2);
+    std::uniform_real_distribution<double> coordinate(0, 128);
+
+    FixedGridLayer layer( bounds );
+    for( size_t offset = 0; offset < FixedGridLayer::dimension * FixedGridLayer::dimension; ++offset ){
+        layer.data()[offset] = obstacle(generator) ? 0x99 : FixedGridLayer::clear_value;
+    }
+    HierarchicalAStar<FixedGridLayer> search( layer );
+
+    size_t found = 0;
+    for( size_t trial = 0; trial < 50; ++trial ){
+        const Vector2d start( coordinate(generator), coordinate(generator) );
+        const Vector2d goal( coordinate(generator), coordinate(generator) );
+
+        const Path flat = search.compute_flat( start, goal );
+        const Path path = search.compute( start, goal );
+        ASSERT_EQ( flat.empty(), path.empty() );
+        if( ! flat.empty() ){
+            EXPECT_LE( flat.length() - 1e-3, path.length() );
+            EXPECT_LE( path.length(), 1.2 * flat.length() + 2 );
+            ++found;
+        }
+    }
+    EXPECT_LT( 0, found );
+}
+
+} // namespace chartbox::search
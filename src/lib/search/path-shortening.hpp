@@ -0,0 +1,46 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include "chart-box/geometry/path.hpp"
+
+namespace chartbox::search {
+
+/// \brief Remove every waypoint which can be skipped without losing line of sight ("string pulling")
+///
+/// Starting from the first waypoint, each anchor connects directly to the furthest following waypoint which
+/// it can still see; every waypoint in between is dropped.  The endpoints are always kept.  Each segment of
+/// the result is either a segment of the input, or was checked clear -- and the result is never longer.
+///
+/// \param layer - any layer providing `segment_free(...)`
+/// \param path - waypoints, in the layer's frame
+/// \return the shortened path
+template<typename layer_t>
+chart::geometry::Path shorten_path( const layer_t& layer, const chart::geometry::Path& path ){
+    if( path.size() < 3 ){
+        return path;
+    }
+
+    std::vector<Eigen::Vector2d> points = { path[0] };
+    size_t anchor = 0;
+    size_t next = 1;
+    while( next + 1 < path.size() ){
+        if( layer.segment_free(path[anchor], path[next + 1]) ){
+            ++next;
+        }else{
+            points.push_back( path[next] );
+            anchor = next;
+            ++next;
+        }
+    }
+    points.push_back( path[path.size() - 1] );
+
+    return chart::geometry::Path( points );
+}
+
+} // namespace chartbox::search
@@ -0,0 +1,30 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+
+#include <Eigen/Geometry>
+
+namespace chartbox::search {
+
+/// \brief clear the layer, then drop 48 seeded 8x8 obstacle blocks over it
+///
+/// Shared by the search tests; the layer is expected to span 128 x 128 from the origin.
+template<typename layer_t>
+void scatter( layer_t& layer, const uint32_t seed ){
+    using Eigen::AlignedBox2d;
+    using Eigen::Vector2d;
+
+    layer.fill( layer_t::clear_value );
+    std::mt19937 generator( seed );
+    std::uniform_int_distribution<uint32_t> corner( 0, 120 );
+    for( size_t count = 0; count < 48; ++count ){
+        const double x = corner(generator);
+        const double y = corner(generator);
+        layer.fill( AlignedBox2d(Vector2d(x, y), Vector2d(x + 8, y + 8)), 0x99 );
+    }
+}
+
+} // namespace chartbox::search
@@ -0,0 +1,81 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include "chart-box/geometry/path.hpp"
+
+#include "grid-neighbors.hpp"
+
+namespace chartbox::search {
+
+/// \brief Lazy Theta*: any-angle path-finding over the cells of a grid layer
+///
+/// ## Implementation Specifics
+/// Expands the same 8-connected grid as A*, but a cell's parent may be any earlier cell -- not just one of
+/// its neighbors.  Each generated cell optimistically inherits the parent of the cell which generated it,
+/// and the line of sight between the two is only checked once the cell is expanded.  If the check fails,
+/// the cell falls back to the best of its already-expanded neighbors.  The resulting paths are chains of
+/// straight segments between cell centers, with no intermediate grid-aligned elbows.
+///
+/// Line of sight is answered by the layer's `segment_free(...)`.  Following its convention, a segment may
+/// graze the corner of a blocked cell, but never crosses its interior.
+///
+/// ### See Also:
+///   - Nash, Koenig, Tovey; "Lazy Theta*: Any-Angle Path Planning and Path Length Analysis in 3D" (2010)
+///
+/// \warning the layer is only read; but it must outlive this planner
+template<typename layer_t>
+class LazyThetaStar {
+public:
+    LazyThetaStar() = delete;
+
+    /// \brief allocate the search workspace for the given layer
+    LazyThetaStar( const layer_t& layer );
+
+    /// \brief Find an any-angle path between the two given points
+    ///
+    /// \param start - location to start searching from
+    /// \param goal - location to search to
+    /// \return the found path, through cell centers; or an empty path, if no path exists
+    chart::geometry::Path compute( const Eigen::Vector2d& start, const Eigen::Vector2d& goal );
+
+    /// \brief number of cells expanded by the most recent search
+    inline size_t expansions() const { return expansions_; }
+
+    /// \brief number of line-of-sight checks made by the most recent search
+    inline size_t sight_checks() const { return sight_checks_; }
+
+public:
+    constexpr static size_t dimension = layer_t::dimension;
+
+private:
+    /// \brief straight-line distance between two cells, in cells
+    static cost_t distance( const uint32_t from, const uint32_t to );
+
+    bool line_of_sight( const uint32_t from, const uint32_t to );
+
+private:
+    const layer_t& layer_;
+
+    // search workspace; sized for the entire layer, and reused between searches
+    std::vector<cost_t> cost_;
+    std::vector<uint32_t> parent_;
+    /// generation at which each cell was last touched; and whether it has been expanded since
+    std::vector<uint32_t> generation_;
+    std::vector<uint8_t> closed_;
+    uint32_t current_generation_ = 0;
+
+    size_t expansions_ = 0;
+    size_t sight_checks_ = 0;
+
+}; // class LazyThetaStar
+
+} // namespace chartbox::search
+
+#include "theta-star.inl"
@@ -0,0 +1,142 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// NOTE: This is the template-class implementation --
+//       It is not compiled until referenced, even though it contains the
+//       function implementations.
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <vector>
+
+using chartbox::search::LazyThetaStar;
+
+template<typename layer_t>
+LazyThetaStar<layer_t>::LazyThetaStar( const layer_t& _layer )
+    : layer_(_layer)
+    , cost_( dimension * dimension )
+    , parent_( dimension * dimension )
+    , generation_( dimension * dimension, 0 )
+    , closed_( dimension * dimension, 0 )
+{}
+
+template<typename layer_t>
+chart::geometry::Path LazyThetaStar<layer_t>::compute( const Eigen::Vector2d& start_point, const Eigen::Vector2d& goal_point ){
+    expansions_ = 0;
+    sight_checks_ = 0;
+
+    uint32_t si, sj, gi, gj;
+    if( (! to_cell(layer_, start_point, si, sj)) || (! to_cell(layer_, goal_point, gi, gj)) ){
+        return {};
+    }else if( is_blocked(layer_, si, sj) || is_blocked(layer_, gi, gj) ){
+        return {};
+    }
+
+    const uint32_t start = sj*dimension + si;
+    const uint32_t goal = gj*dimension + gi;
+
+    ++current_generation_;
+    auto touch = [this]( const uint32_t cell ){
+        if( generation_[cell] != current_generation_ ){
+            generation_[cell] = current_generation_;
+            cost_[cell] = std::numeric_limits<cost_t>::infinity();
+            closed_[cell] = 0;
+        }
+    };
+
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> upcoming;
+    touch( start );
+    cost_[start] = 0;
+    parent_[start] = start;
+    upcoming.push({ distance(start, goal), start });
+
+    while( ! upcoming.empty() ){
+        const uint32_t at = upcoming.top().cell;
+        upcoming.pop();
+        if( closed_[at] ){
+            continue;  // stale entry
+        }
+
+        const uint32_t i = at % dimension;
+        const uint32_t j = at / dimension;
+
+        // the parent was assumed visible when this cell was generated; verify it now, or fall back to
+        // the best neighbor which has already been expanded.  (the cell's generator is always one.)
+        const uint8_t steps = passable_steps( layer_, i, j );
+        if( ! line_of_sight(parent_[at], at) ){
+            cost_[at] = std::numeric_limits<cost_t>::infinity();
+            for( size_t k = 0; k < eight_neighbors.size(); ++k ){
+                const GridStep& step = eight_neighbors[k];
+                if( 0 == ((steps >> k) & 1) ){
+                    continue;
+                }
+                const uint32_t neighbor = (j + step.dj)*dimension + (i + step.di);
+                if( (generation_[neighbor] == current_generation_) && closed_[neighbor] && (cost_[neighbor] + step.cost < cost_[at]) ){
+                    cost_[at] = cost_[neighbor] + step.cost;
+                    parent_[at] = neighbor;
+                }
+            }
+        }
+
+        if( at == goal ){
+            std::vector<Eigen::Vector2d> points;
+            for( uint32_t cell = goal; cell != start; cell = parent_[cell] ){
+                points.push_back( to_location(layer_, cell % dimension, cell / dimension) );
+            }
+            points.push_back( to_location(layer_, si, sj) );
+            std::reverse( points.begin(), points.end() );
+            return chart::geometry::Path( points );
+        }
+
+        closed_[at] = 1;
+        ++expansions_;
+
+        const uint32_t source = parent_[at];
+        for( size_t k = 0; k < eight_neighbors.size(); ++k ){
+            const GridStep& step = eight_neighbors[k];
+            if( 0 == ((steps >> k) & 1) ){
+                continue;
+            }
+            const uint32_t neighbor = (j + step.dj)*dimension + (i + step.di);
+            touch( neighbor );
+            if( closed_[neighbor] ){
+                continue;
+            }
+
+            // optimistically connect straight to this cell's parent
+            const cost_t cost_to_neighbor = cost_[source] + distance(source, neighbor);
+            if( cost_to_neighbor < cost_[neighbor] ){
+                cost_[neighbor] = cost_to_neighbor;
+                parent_[neighbor] = source;
+                upcoming.push({ cost_to_neighbor + distance(neighbor, goal), neighbor });
+            }
+        }
+    }
+
+    return {};
+}
+
+template<typename layer_t>
+chartbox::search::cost_t LazyThetaStar<layer_t>::distance( const uint32_t from, const uint32_t to ){
+    const double di = static_cast<double>(from % dimension) - static_cast<double>(to % dimension);
+    const double dj = static_cast<double>(from / dimension) - static_cast<double>(to / dimension);
+    return static_cast<cost_t>( std::hypot(di, dj) );
+}
+
+template<typename layer_t>
+bool LazyThetaStar<layer_t>::line_of_sight( const uint32_t from, const uint32_t to ){
+    const uint32_t i0 = from % dimension;
+    const uint32_t j0 = from / dimension;
+    const uint32_t i1 = to % dimension;
+    const uint32_t j1 = to / dimension;
+
+    // between adjacent (clear) cells, the segment can at most graze the corner of another cell
+    if( (std::max(i0, i1) - std::min(i0, i1) <= 1) && (std::max(j0, j1) - std::min(j0, j1) <= 1) ){
+        return true;
+    }
+
+    ++sight_checks_;
+    return layer_.segment_free( to_location(layer_, i0, j0), to_location(layer_, i1, j1) );
+}
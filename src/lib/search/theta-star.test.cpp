@@ -0,0 +1,137 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <cmath>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include "chart-box/geometry/path.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+
+#include "hpa-star.hpp"
+#include "path-shortening.hpp"
+#include "theta-star.hpp"
+
+using Eigen::Vector2d;
+
+using chart::geometry::Path;
+using chartbox::layer::FixedGridLayer;
+
+namespace chartbox::search {
+
+static const Eigen::AlignedBox2d bounds( Vector2d(0,0), Vector2d(128,128) );
+
+// every segment of the path must be clear
+static void expect_clear( const FixedGridLayer& layer, const Path& path ){
+    for( size_t k = 1; k < path.size(); ++k ){
+        EXPECT_TRUE( layer.segment_free(path[k-1], path[k]) ) << "    @ segment " << k;
+    }
+}
+
+TEST( SearchLazyThetaStar, OpenWaterIsStraight ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    LazyThetaStar<FixedGridLayer> search( layer );
+
+    // not a multiple of 45 degrees; so A* would need an elbow
+    const Path path = search.compute( {2.5, 2.5}, {120.5, 40.5} );
+    ASSERT_EQ( path.size(), 2 );
+    EXPECT_DOUBLE_EQ( path[0].x(), 2.5 );
+    EXPECT_DOUBLE_EQ( path[1].y(), 40.5 );
+    EXPECT_NEAR( path.length(), std::hypot(118.0, 38.0), 1e-6 );
+
+    const Path same = search.compute( {2.5, 2.5}, {2.7, 2.2} );
+    ASSERT_EQ( same.size(), 1 );
+}
+
+TEST( SearchLazyThetaStar, AroundWall ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    // wall along x = 70, with a gap at y = [100, 104)
+    layer.fill( Eigen::AlignedBox2d(Vector2d(70, 0), Vector2d(71, 100)), 0x99 );
+    layer.fill( Eigen::AlignedBox2d(Vector2d(70, 104), Vector2d(71, 128)), 0x99 );
+    LazyThetaStar<FixedGridLayer> search( layer );
+
+    const Path path = search.compute( {10.5, 10.5}, {120.5, 10.5} );
+    ASSERT_EQ( path.size(), 4 );
+    expect_clear( layer, path );
+
+    // optimal: two straight legs, touching the gap's bottom corners
+    const double optimal = std::hypot(59.5, 89.5) + 1.0 + std::hypot(49.5, 89.5);
+    EXPECT_LE( optimal - 1e-3, path.length() );
+    EXPECT_LE( path.length(), optimal + 1.5 );
+
+    // close the gap
+    layer.fill( Eigen::AlignedBox2d(Vector2d(70, 100), Vector2d(71, 104)), 0x99 );
+    EXPECT_TRUE( search.compute( {10.5, 10.5}, {120.5, 10.5} ).empty() );
+}
+
+TEST( SearchLazyThetaStar, BlockedEndpoints ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    layer.store( {5.5, 5.5}, 0x99 );
+    LazyThetaStar<FixedGridLayer> search( layer );
+
+    EXPECT_TRUE( search.compute( {5.5, 5.5}, {50.5, 50.5} ).empty() );
+    EXPECT_TRUE( search.compute( {50.5, 50.5}, {5.5, 5.5} ).empty() );
+    EXPECT_TRUE( search.compute( {50.5, 50.5}, {500.5, 5.5} ).empty() );
+}
+
+TEST( SearchLazyThetaStar, NoLongerThanAStar ){
+    std::mt19937 generator(55);
+    std::bernoulli_distribution obstacle(0.2);
+    std::uniform_real_distribution<double> coordinate(0, 128);
+
+    FixedGridLayer layer( bounds );
+    for( size_t offset = 0; offset < FixedGridLayer::dimension * FixedGridLayer::dimension; ++offset ){
+        layer.data()[offset] = obstacle(generator) ? 0x99 : FixedGridLayer::clear_value;
+    }
+    layer.rebuild_occupancy();
+    HierarchicalAStar<FixedGridLayer> grid( layer );
+    LazyThetaStar<FixedGridLayer> search( layer );
+
+    size_t found = 0;
+    for( size_t trial = 0; trial < 50; ++trial ){
+        const Vector2d start( coordinate(generator), coordinate(generator) );
+        const Vector2d goal( coordinate(generator), coordinate(generator) );
+
+        const Path flat = grid.compute_flat( start, goal );
+        const Path path = search.compute( start, goal );
+        ASSERT_EQ( flat.empty(), path.empty() );
+        if( ! flat.empty() ){
+            expect_clear( layer, path );
+            EXPECT_LE( path.length(), flat.length() + 1e-3 );
+
+            const Path shortened = shorten_path( layer, flat );
+            expect_clear( layer, shortened );
+            EXPECT_LE( shortened.size(), flat.size() );
+            EXPECT_LE( shortened.length(), flat.length() + 1e-3 );
+            ++found;
+        }
+    }
+    EXPECT_LT( 0, found );
+}
+
+TEST( SearchPathShortening, DropsVisibleWaypoints ){
+    FixedGridLayer layer( bounds );
+    layer.fill( FixedGridLayer::clear_value );
+    layer.fill( Eigen::AlignedBox2d(Vector2d(40, 0), Vector2d(50, 60)), 0x99 );
+
+    // a staircase under the obstacle, then around its corner
+    const Path stairs = { {10.5, 10.5}, {20.5, 10.5}, {20.5, 20.5}, {30.5, 20.5}, {30.5, 70.5}, {60.5, 70.5}, {60.5, 10.5} };
+    const Path shortened = shorten_path( layer, stairs );
+    ASSERT_EQ( shortened.size(), 4 );
+    EXPECT_DOUBLE_EQ( shortened[0].x(), 10.5 );
+    EXPECT_DOUBLE_EQ( shortened[1].x(), 30.5 );
+    EXPECT_DOUBLE_EQ( shortened[1].y(), 70.5 );
+    EXPECT_DOUBLE_EQ( shortened[2].x(), 60.5 );
+    EXPECT_DOUBLE_EQ( shortened[3].y(), 10.5 );
+    expect_clear( layer, shortened );
+
+    // short paths pass through
+    EXPECT_EQ( shorten_path( layer, Path({{1.5, 1.5}, {100.5, 100.5}}) ).size(), 2 );
+}
+
+} // namespace chartbox::search
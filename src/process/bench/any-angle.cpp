@@ -0,0 +1,111 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// Compares grid A* against any-angle planning: Lazy Theta*, and A* followed by line-of-sight shortening.
+//
+// Each benchmark is registered as:  `AnyAngle/<chart>/<planner>`
+// Besides the time per query, each reports the mean path `length` (in the chart's units) and `waypoints`.
+//
+// The `BlockIsland` chart is loaded from `data/block-island/`; so run from the repository root.
+// Results are recorded in `docs/any_angle.md`.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <Eigen/Geometry>
+#include <fmt/core.h>
+
+#include "chart-box/chart-box.hpp"
+#include "io/chart-geojson-loader.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+#include "search/hpa-star.hpp"
+#include "search/path-shortening.hpp"
+#include "search/theta-star.hpp"
+
+#include "scenarios.hpp"
+
+using chart::geometry::Path;
+using chartbox::layer::FixedGridLayer;
+
+namespace {
+
+constexpr uint32_t seed = 55;
+constexpr size_t query_count = 64;
+
+enum Planner { AStar, AStarShortened, LazyTheta };
+
+const FixedGridLayer* block_island(){
+    static std::unique_ptr<chartbox::ChartBox> box;
+    if( ! box ){
+        GDALAllRegister();
+        box = std::make_unique<chartbox::ChartBox>();
+        chartbox::io::GeoJSONLoader<FixedGridLayer> loader( box->mapping(), box->get_boundary_layer() );
+        if( ! loader.load_file("data/block-island/boundary.polygon.geojson") ){
+            return nullptr;
+        }
+    }
+    return &box->get_boundary_layer();
+}
+
+/// \brief scattered obstacles, as by `chartbox::bench::scatter(...)`; built on first use
+const FixedGridLayer* scattered(){
+    static std::unique_ptr<FixedGridLayer> layer;
+    if( ! layer ){
+        layer = chartbox::bench::make_scattered<FixedGridLayer>( seed );
+    }
+    return layer.get();
+}
+
+void any_angle( benchmark::State& state, const FixedGridLayer* (*chart)(), const Planner planner ){
+    const FixedGridLayer* layer = chart();
+    if( nullptr == layer ){
+        state.SkipWithError( "could not load the chart" );
+        return;
+    }
+    const auto queries = chartbox::bench::connected_queries( *layer, seed, query_count );
+    if( queries.empty() ){
+        state.SkipWithError( "no connected queries in this chart" );
+        return;
+    }
+
+    chartbox::search::HierarchicalAStar<FixedGridLayer> grid( *layer );
+    chartbox::search::LazyThetaStar<FixedGridLayer> theta( *layer );
+
+    double length = 0;
+    size_t waypoints = 0;
+    size_t index = 0;
+    for( auto _ : state ){
+        const auto& query = queries[ index++ % queries.size() ];
+        Path path;
+        if( LazyTheta == planner ){
+            path = theta.compute( query.first, query.second );
+        }else{
+            path = grid.compute_flat( query.first, query.second );
+            if( AStarShortened == planner ){
+                path = chartbox::search::shorten_path( *layer, path );
+            }
+        }
+        length += path.length();
+        waypoints += path.size();
+    }
+
+    state.counters["length"] = benchmark::Counter( length / state.iterations() );
+    state.counters["waypoints"] = benchmark::Counter( static_cast<double>(waypoints) / state.iterations() );
+}
+
+void register_chart( const char* chart_name, const FixedGridLayer* (*chart)() ){
+    const auto name = [chart_name](const char* planner){
+        return fmt::format( "AnyAngle/{}/{}", chart_name, planner ); };
+
+    benchmark::RegisterBenchmark( name("AStar").c_str(), any_angle, chart, AStar )->Unit( benchmark::kMicrosecond );
+    benchmark::RegisterBenchmark( name("AStarShortened").c_str(), any_angle, chart, AStarShortened )->Unit( benchmark::kMicrosecond );
+    benchmark::RegisterBenchmark( name("LazyThetaStar").c_str(), any_angle, chart, LazyTheta )->Unit( benchmark::kMicrosecond );
+}
+
+} // namespace
+
+void register_any_angle(){
+    register_chart( "BlockIsland", block_island );
+    register_chart( "Scattered", scattered );
+}
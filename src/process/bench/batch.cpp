@@ -0,0 +1,65 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// Measures how batch planning scales with the number of worker threads.
+//
+// Each benchmark is registered as:  `Batch/HPAStar/<threads>`
+// Each iteration plans one batch of 256 random, connected queries over a 1024 x 1024 layer; and reports
+// `items_per_second` as queries per (wall-clock) second.
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <Eigen/Geometry>
+
+#include "index/row-major-index.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+#include "search/batch-planner.hpp"
+#include "search/hpa-star.hpp"
+
+#include "scenarios.hpp"
+
+using chartbox::bench::Query;
+using chartbox::layer::FixedGrid;
+
+namespace {
+
+constexpr uint32_t seed = 55;
+constexpr size_t dimension = 1024;
+constexpr size_t batch_size = 256;
+
+typedef FixedGrid< chartbox::index::RowMajorIndex<dimension> > Grid;
+
+/// \brief scattered obstacles, as by `chartbox::bench::scatter(...)`; built on first use
+const Grid& scattered(){
+    static std::unique_ptr<Grid> layer;
+    if( ! layer ){
+        layer = chartbox::bench::make_scattered<Grid>( seed );
+    }
+    return *layer;
+}
+
+/// \brief random pairs of clear cell centers, which are connected
+const std::vector<Query>& queries(){
+    static const std::vector<Query> queries = chartbox::bench::connected_queries( scattered(), seed, batch_size );
+    return queries;
+}
+
+template<typename planner_t>
+void batch( benchmark::State& state ){
+    chartbox::search::BatchPlanner<Grid, planner_t> planner( scattered(), state.range(0) );
+    const auto& batch = queries();
+
+    for( auto _ : state ){
+        benchmark::DoNotOptimize( planner.plan_batch(batch) );
+    }
+    state.SetItemsProcessed( state.iterations() * batch.size() );
+}
+
+} // namespace
+
+void register_batch(){
+    benchmark::RegisterBenchmark( "Batch/HPAStar", batch<chartbox::search::HierarchicalAStar<Grid>> )
+        ->Arg( 1 )->Arg( 2 )->Arg( 4 )->Arg( 8 )->UseRealTime()->Unit( benchmark::kMillisecond );
+}
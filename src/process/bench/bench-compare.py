@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+# GPL v3 (c) 2021, Daniel Williams
+"""Compare two JSON outputs of `chartbox_bench`, and flag the regressions
+
+Usage:
+    bench-compare.py <before.json> <after.json> [<threshold>]
+
+Prints one row per benchmark present in both files: the mean cost before and after, and their ratio.
+Repeated runs (`--benchmark_repetitions`) are averaged.
+A benchmark regresses if it became slower by more than `threshold` (default: 0.10, i.e. 10%).
+Exits with 1 if any benchmark regressed; so it may gate a local build.
+"""
+
+import json
+import sys
+
+DEFAULT_THRESHOLD = 0.10
+
+
+def metric(benchmark):
+    """cost per item (ns) if the benchmark counts items; else the time per iteration (ns)"""
+    if 'items_per_second' in benchmark:
+        return 1e9 / benchmark['items_per_second']
+    scale = {'ns': 1., 'us': 1e3, 'ms': 1e6, 's': 1e9}[benchmark['time_unit']]
+    return benchmark['real_time'] * scale
+
+
+def load(path):
+    """mean cost of each benchmark; across its repetitions, if it was repeated"""
+    with open(path) as source:
+        results = json.load(source)
+    repetitions = {}
+    for benchmark in results['benchmarks']:
+        # skip the aggregates (mean, median, stddev) of repeated runs, and the skipped benchmarks
+        if benchmark.get('run_type', 'iteration') != 'iteration' or benchmark.get('error_occurred'):
+            continue
+        repetitions.setdefault(benchmark.get('run_name', benchmark['name']), []).append(metric(benchmark))
+    return {name: sum(costs) / len(costs) for name, costs in repetitions.items()}
+
+
+def main(argv):
+    if len(argv) < 3:
+        print(__doc__)
+        return 1
+    before = load(argv[1])
+    after = load(argv[2])
+    threshold = float(argv[3]) if 3 < len(argv) else DEFAULT_THRESHOLD
+
+    names = [name for name in after if name in before]
+    width = max([len(name) for name in names] + [len('Benchmark')])
+    print('{:<{w}}  {:>12}  {:>12}  {:>7}'.format('Benchmark', 'Before (ns)', 'After (ns)', 'Ratio', w=width))
+
+    regressions = []
+    for name in names:
+        ratio = after[name] / before[name]
+        flag = ''
+        if 1 + threshold < ratio:
+            flag = '  << slower'
+            regressions.append(name)
+        elif ratio < 1 - threshold:
+            flag = '  >> faster'
+        print('{:<{w}}  {:>12.4g}  {:>12.4g}  {:>7.3f}{}'.format(name, before[name], after[name], ratio, flag, w=width))
+
+    for name in sorted(set(before) ^ set(after)):
+        print('?? only in {}: {}'.format('before' if name in before else 'after', name))
+
+    if regressions:
+        print('!! {} of {} benchmarks regressed by more than {:.0%}'.format(len(regressions), len(names), threshold))
+        return 1
+    print('>> no regressions beyond {:.0%}, in {} benchmarks'.format(threshold, len(names)))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,161 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// Compares unidirectional A* against bidirectional A*, on long transits.
+//
+// Each benchmark is registered as:  `Bidirectional/<chart>/<planner>`
+// Besides the time per query, each reports the mean number of cells `expanded` per query.
+//
+// The `Massachusetts` chart is loaded from `data/massachusetts/`; so run from the repository root.
+// Results are recorded in `docs/bidirectional.md`.
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <Eigen/Geometry>
+#include <fmt/core.h>
+
+#include <gdal_priv.h>
+#include <ogrsf_frmts.h>
+
+#include "index/row-major-index.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+#include "search/bidirectional-a-star.hpp"
+#include "search/hpa-star.hpp"
+
+#include "scenarios.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+using chartbox::layer::FixedGrid;
+
+namespace {
+
+constexpr uint32_t seed = 55;
+constexpr size_t dimension = 1024;
+constexpr size_t query_count = 16;
+
+typedef FixedGrid< chartbox::index::RowMajorIndex<dimension> > Grid;
+
+enum Planner { AStar, Bidirectional, BidirectionalThreaded };
+
+/// \brief translate a ring into the layer's frame, as the exterior of a new polygon
+std::unique_ptr<OGRPolygon> to_layer( const OGRLinearRing& ring, const OGREnvelope& extent ){
+    OGRLinearRing local;
+    for( const OGRPoint& point : ring ){
+        local.addPoint( point.getX() - extent.MinX, point.getY() - extent.MinY );
+    }
+    auto polygon = std::make_unique<OGRPolygon>();
+    polygon->addRing( &local );
+    return polygon;
+}
+
+/// \brief the navigable area of the Massachusetts coast: clear inside each polygon, but blocked within its holes
+const Grid* massachusetts(){
+    static AlignedBox2d bounds;
+    static std::unique_ptr<Grid> layer;
+    if( layer ){
+        return layer.get();
+    }
+
+    GDALAllRegister();
+    auto* dataset = static_cast<GDALDataset*>( GDALOpenEx("data/massachusetts/navigation_area_100k.shp", GDAL_OF_VECTOR, nullptr, nullptr, nullptr) );
+    if( nullptr == dataset ){
+        return nullptr;
+    }
+    OGRLayer* source = dataset->GetLayer( 0 );
+    OGREnvelope extent;
+    if( (nullptr == source) || (OGRERR_NONE != source->GetExtent(&extent)) ){
+        GDALClose( dataset );
+        return nullptr;
+    }
+
+    const double side = std::max( extent.MaxX - extent.MinX, extent.MaxY - extent.MinY );
+    bounds = AlignedBox2d( Vector2d(0, 0), Vector2d(side, side) );
+    layer = std::make_unique<Grid>( bounds );
+    layer->fill( Grid::default_value );
+
+    std::vector<const OGRPolygon*> polygons;
+    source->ResetReading();
+    for( OGRFeature* feature = source->GetNextFeature(); nullptr != feature; feature = source->GetNextFeature() ){
+        const OGRGeometry* geometry = feature->GetGeometryRef();
+        polygons.clear();
+        if( (nullptr != geometry) && (wkbPolygon == wkbFlatten(geometry->getGeometryType())) ){
+            polygons.push_back( geometry->toPolygon() );
+        }else if( (nullptr != geometry) && (wkbMultiPolygon == wkbFlatten(geometry->getGeometryType())) ){
+            for( const OGRPolygon* polygon : *geometry->toMultiPolygon() ){
+                polygons.push_back( polygon );
+            }
+        }
+        for( const OGRPolygon* polygon : polygons ){
+            layer->fill( to_layer(*polygon->getExteriorRing(), extent), Grid::clear_value );
+            for( int k = 0; k < polygon->getNumInteriorRings(); ++k ){
+                layer->fill( to_layer(*polygon->getInteriorRing(k), extent), Grid::default_value );
+            }
+        }
+        OGRFeature::DestroyFeature( feature );
+    }
+
+    GDALClose( dataset );
+    return layer.get();
+}
+
+/// \brief scattered obstacles, as by `chartbox::bench::scatter(...)`; built on first use
+const Grid* scattered(){
+    static std::unique_ptr<Grid> layer;
+    if( ! layer ){
+        layer = chartbox::bench::make_scattered<Grid>( seed );
+    }
+    return layer.get();
+}
+
+void bidirectional( benchmark::State& state, const Grid* (*chart)(), const Planner planner ){
+    const Grid* layer = chart();
+    if( nullptr == layer ){
+        state.SkipWithError( "could not load the chart" );
+        return;
+    }
+    // long transits: at least half the layer apart
+    const auto queries = chartbox::bench::connected_queries( *layer, seed, query_count, (dimension / 2) * layer->precision() );
+    if( queries.empty() ){
+        state.SkipWithError( "no connected queries in this chart" );
+        return;
+    }
+
+    chartbox::search::HierarchicalAStar<Grid> unidirectional( *layer );
+    chartbox::search::BidirectionalAStar<Grid> search( *layer, BidirectionalThreaded == planner );
+
+    size_t expanded = 0;
+    size_t index = 0;
+    for( auto _ : state ){
+        const auto& query = queries[ index++ % queries.size() ];
+        if( AStar == planner ){
+            benchmark::DoNotOptimize( unidirectional.compute_flat(query.first, query.second) );
+            expanded += unidirectional.expansions();
+        }else{
+            benchmark::DoNotOptimize( search.compute(query.first, query.second) );
+            expanded += search.expansions();
+        }
+    }
+
+    state.counters["expanded"] = benchmark::Counter( static_cast<double>(expanded) / state.iterations() );
+}
+
+void register_chart( const char* chart_name, const Grid* (*chart)() ){
+    const auto name = [chart_name](const char* planner){
+        return fmt::format( "Bidirectional/{}/{}", chart_name, planner ); };
+
+    benchmark::RegisterBenchmark( name("AStar").c_str(), bidirectional, chart, AStar )->Unit( benchmark::kMillisecond )->UseRealTime();
+    benchmark::RegisterBenchmark( name("Bidirectional").c_str(), bidirectional, chart, Bidirectional )->Unit( benchmark::kMillisecond )->UseRealTime();
+    benchmark::RegisterBenchmark( name("BidirectionalThreaded").c_str(), bidirectional, chart, BidirectionalThreaded )->Unit( benchmark::kMillisecond )->UseRealTime();
+}
+
+} // namespace
+
+void register_bidirectional(){
+    register_chart( "Massachusetts", massachusetts );
+    register_chart( "Scattered", scattered );
+}
@@ -0,0 +1,94 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// Compares the batched, fixed-point `FixedGrid::sample_bilinear(...)` against the scalar
+// `chart::geometry::interpolate_bilinear(...)`, sampling the same random points of the same layer.
+//
+// Each benchmark is registered as:  `Bilinear/<method>`
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <Eigen/Geometry>
+
+#include "chart-box/geometry/interpolate.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+using chartbox::layer::FixedGridLayer;
+
+namespace {
+
+constexpr uint32_t seed = 55;
+constexpr size_t point_count = 4096;
+
+const AlignedBox2d bounds( Vector2d(0,0), Vector2d(1024, 1024) );
+
+std::unique_ptr<FixedGridLayer> make_depths(){
+    auto layer = std::make_unique<FixedGridLayer>( bounds );
+    std::mt19937 generator( seed );
+    std::uniform_int_distribution<int> depth( 0, 255 );
+    for( size_t offset = 0; offset < FixedGridLayer::dimension * FixedGridLayer::dimension; ++offset ){
+        layer->data()[offset] = static_cast<uint8_t>( depth(generator) );
+    }
+    return layer;
+}
+
+std::vector<Vector2d> make_points(){
+    std::mt19937 generator( seed + 1 );
+    // stay a half-cell inside the edges, where the scalar interpolation is defined
+    std::uniform_real_distribution<double> coordinate( 4, 1020 );
+    std::vector<Vector2d> points( point_count );
+    for( auto& p : points ){
+        p = { coordinate(generator), coordinate(generator) };
+    }
+    return points;
+}
+
+void scalar( benchmark::State& state ){
+    typedef chart::geometry::Sample<uint8_t> Sample;
+    const auto layer = make_depths();
+    const auto points = make_points();
+    const double precision = layer->precision();
+
+    for( auto _ : state ){
+        uint32_t sum = 0;
+        for( const auto& p : points ){
+            // the four surrounding cell centers
+            const double x0 = (std::floor(p.x() / precision - 0.5) + 0.5) * precision;
+            const double y0 = (std::floor(p.y() / precision - 0.5) + 0.5) * precision;
+            const Vector2d sw( x0, y0 );
+            const Vector2d se( x0 + precision, y0 );
+            const Vector2d nw( x0, y0 + precision );
+            const Vector2d ne( x0 + precision, y0 + precision );
+            sum += chart::geometry::interpolate_bilinear<uint8_t>( p, Sample{ne, layer->get(ne)}, Sample{nw, layer->get(nw)},
+                                                                      Sample{sw, layer->get(sw)}, Sample{se, layer->get(se)} );
+        }
+        benchmark::DoNotOptimize( sum );
+    }
+    state.SetItemsProcessed( state.iterations() * points.size() );
+}
+
+void batch( benchmark::State& state ){
+    const auto layer = make_depths();
+    const auto points = make_points();
+    std::vector<float> values( points.size() );
+
+    for( auto _ : state ){
+        layer->sample_bilinear( points.data(), points.size(), values.data() );
+        benchmark::DoNotOptimize( values.data() );
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed( state.iterations() * points.size() );
+}
+
+} // namespace
+
+void register_bilinear(){
+    benchmark::RegisterBenchmark( "Bilinear/Scalar", scalar );
+    benchmark::RegisterBenchmark( "Bilinear/Batch", batch );
+}
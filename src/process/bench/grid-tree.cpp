@@ -0,0 +1,156 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// Compares the N-ary `GridTree` layers against the `QuadTree` layer and the dense `FixedGrid` layer, on the same
+// coast-like chart: wide uniform regions, with ragged edges.
+//
+// Each benchmark is registered as:  `GridTree/<layer>/<operation>/<dimension>`; where the operations are
+// random-cell reads (`Get`), and random-cell writes (`Store`: each cell is written, then restored).
+// Each reports the layer's `nodes` and `bytes`.
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <Eigen/Geometry>
+#include <fmt/core.h>
+
+#include "index/row-major-index.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+#include "layer/grid-tree/grid-tree.hpp"
+#include "layer/quad-tree/quad-tree-layer.hpp"
+
+#include "scenarios.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+using chartbox::layer::FixedGrid;
+using chartbox::layer::GridTree;
+using chartbox::layer::QuadTree;
+
+namespace {
+
+constexpr uint32_t seed = 55;
+constexpr size_t query_count = 4096;
+
+enum Operation { Get, Store };
+
+template<size_t dimension>
+using Grid = FixedGrid< chartbox::index::RowMajorIndex<dimension> >;
+
+/// \brief a few large obstacles, as along a coast
+template<size_t dimension>
+std::unique_ptr<Grid<dimension>> make_grid(){
+    auto layer = std::make_unique<Grid<dimension>>( chartbox::bench::bounds_of<dimension>() );
+    layer->fill( Grid<dimension>::clear_value );
+
+    std::mt19937 generator( seed );
+    std::uniform_real_distribution<double> corner( 0, dimension );
+    std::uniform_real_distribution<double> size( 0, dimension / 8.0 );
+    for( size_t count = 0; count < 64; ++count ){
+        const Vector2d low( corner(generator), corner(generator) );
+        layer->fill( AlignedBox2d(low, low + Vector2d(size(generator), size(generator))), 0x99 );
+    }
+    return layer;
+}
+
+/// \brief copy of the grid, in the layer under test
+template<typename layer_t>
+std::unique_ptr<layer_t> make_layer(){
+    constexpr size_t dimension = layer_t::dimension;
+    const auto grid = make_grid<dimension>();
+    if constexpr ( std::is_same_v<layer_t, Grid<dimension>> ){
+        return std::make_unique<layer_t>( *grid );
+    }else{
+        auto layer = std::make_unique<layer_t>( chartbox::bench::bounds_of<dimension>() );
+        for( uint32_t j = 0; j < dimension; ++j ){
+            for( uint32_t i = 0; i < dimension; ++i ){
+                layer->store( i, j, grid->data()[ grid->lookup(i, j) ] );
+            }
+        }
+        return layer;
+    }
+}
+
+// uniform accessors, by cell index
+template<typename layer_t>
+inline uint8_t get_cell( const layer_t& layer, const uint32_t i, const uint32_t j ){
+    return layer.get( i, j ); }
+
+template<size_t dimension>
+inline uint8_t get_cell( const Grid<dimension>& layer, const uint32_t i, const uint32_t j ){
+    return layer.data()[ layer.lookup(i, j) ]; }
+
+template<typename layer_t>
+inline void store_cell( layer_t& layer, const uint32_t i, const uint32_t j, const uint8_t value ){
+    layer.store( i, j, value ); }
+
+template<size_t dimension>
+inline void store_cell( Grid<dimension>& layer, const uint32_t i, const uint32_t j, const uint8_t value ){
+    layer.data()[ layer.lookup(i, j) ] = value; }
+
+template<typename layer_t>
+size_t node_count( const layer_t& layer ){ return layer.node_count(); }
+
+template<size_t dimension>
+size_t node_count( const Grid<dimension>& /*layer*/ ){ return 1; }
+
+template<typename layer_t>
+size_t memory_usage( const layer_t& layer ){ return layer.memory_usage(); }
+
+template<size_t dimension>
+size_t memory_usage( const Grid<dimension>& /*layer*/ ){ return dimension * dimension; }
+
+template<typename layer_t>
+void operation( benchmark::State& state, const Operation operation ){
+    const auto layer = make_layer<layer_t>();
+
+    std::mt19937 generator( seed + 1 );
+    std::uniform_int_distribution<uint32_t> index( 0, layer_t::dimension - 1 );
+    std::vector<std::pair<uint32_t, uint32_t>> cells( query_count );
+    for( auto& cell : cells ){
+        cell = { index(generator), index(generator) };
+    }
+
+    for( auto _ : state ){
+        uint32_t sum = 0;
+        for( const auto& [i, j] : cells ){
+            const uint8_t value = get_cell( *layer, i, j );
+            if( Store == operation ){
+                store_cell( *layer, i, j, value ^ 0x99 );
+                store_cell( *layer, i, j, value );
+            }
+            sum += value;
+        }
+        benchmark::DoNotOptimize( sum );
+    }
+    state.SetItemsProcessed( state.iterations() * cells.size() );
+    state.counters["nodes"] = benchmark::Counter( static_cast<double>(node_count(*layer)) );
+    state.counters["bytes"] = benchmark::Counter( static_cast<double>(memory_usage(*layer)) );
+}
+
+template<typename layer_t>
+void register_layer( const char* layer_name ){
+    const auto name = [layer_name](const char* operation){
+        return fmt::format( "GridTree/{}/{}/{}", layer_name, operation, layer_t::dimension ); };
+
+    benchmark::RegisterBenchmark( name("Get").c_str(), operation<layer_t>, Get );
+    benchmark::RegisterBenchmark( name("Store").c_str(), operation<layer_t>, Store );
+}
+
+} // namespace
+
+void register_grid_tree(){
+    register_layer< Grid<1024> >( "FixedGrid" );
+    register_layer< QuadTree<1024> >( "QuadTree" );
+    register_layer< GridTree<4, 4> >( "GridTree4" );
+    register_layer< GridTree<32, 1> >( "GridTree32" );
+
+    register_layer< Grid<4096> >( "FixedGrid" );
+    register_layer< QuadTree<4096> >( "QuadTree" );
+    register_layer< GridTree<16, 2> >( "GridTree16" );
+}
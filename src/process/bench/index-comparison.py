@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+# GPL v3 (c) 2021, Daniel Williams
+"""Regenerate the cell-ordering table in `docs/index_comparison.md`
+
+Usage:
+    index-comparison.py <path/to/chartbox_bench> [<path/to/index_comparison.md>]
+
+Runs the `Layout/...` benchmarks, and replaces everything between the GENERATED markers with the results.
+"""
+
+import json
+import os
+import platform
+import subprocess
+import sys
+import tempfile
+
+BEGIN_MARKER = '<!-- BEGIN GENERATED: index-comparison.py -->'
+END_MARKER = '<!-- END GENERATED: index-comparison.py -->'
+
+WORKLOADS = {
+    # name: (description, metric)
+    'RandomGet': ('random `get(Vector2d)` point lookups', 'ns / lookup'),
+    'Fill':      ('64x64 `fill(AlignedBox2d)`', 'ns / cell'),
+    'Neighbors': ('8-neighborhood scan of every cell', 'ns / cell'),
+    'Raycast':   ('DDA walk along random segments, until blocked', 'ns / cell'),
+    'AStar':     ('8-connected A*, corner-to-corner', 'ms / search'),
+}
+POLICIES = ['RowMajor', 'ZOrder', 'Hilbert', 'Blocked']
+
+
+def run(executable):
+    with tempfile.TemporaryDirectory() as scratch:
+        output = os.path.join(scratch, 'layout.json')
+        subprocess.run([executable, '--benchmark_filter=^Layout/',
+                        '--benchmark_out=' + output, '--benchmark_out_format=json'],
+                       check=True, stdout=subprocess.DEVNULL)
+        with open(output) as source:
+            return json.load(source)
+
+
+def metric(benchmark):
+    if 'items_per_second' in benchmark:
+        return 1e9 / benchmark['items_per_second']
+    scale = {'ns': 1e-6, 'us': 1e-3, 'ms': 1., 's': 1e3}[benchmark['time_unit']]
+    return benchmark['real_time'] * scale
+
+
+def render(results):
+    measured = {}
+    for benchmark in results['benchmarks']:
+        _, workload, policy, dimension = benchmark['name'].split('/')
+        measured[(workload, policy, int(dimension))] = metric(benchmark)
+
+    context = results['context']
+    lines = ['Generated by `src/process/bench/index-comparison.py`; do not edit by hand.', '',
+             '- Host: {} ({} x {} MHz)'.format(platform.machine(), context['num_cpus'], context['mhz_per_cpu']),
+             '- Build: {} (benchmark library: {} build)'.format(context.get('chartbox_build_type', 'unknown'),
+                                                                 context.get('library_build_type', 'unknown')),
+             '- Date: {}'.format(context['date']), '',
+             'Each cell is the mean cost; the parenthesized value is relative to row-major (lower is better).', '']
+
+    for dimension in sorted({key[2] for key in measured}):
+        lines += ['### {0} x {0}'.format(dimension), '',
+                  '| Workload | Metric | ' + ' | '.join(POLICIES) + ' |',
+                  '|:---------|:-------|' + '|'.join(['-------:'] * len(POLICIES)) + '|']
+        for workload, (description, unit) in WORKLOADS.items():
+            reference = measured.get((workload, 'RowMajor', dimension))
+            cells = []
+            for policy in POLICIES:
+                value = measured.get((workload, policy, dimension))
+                if value is None:
+                    cells.append('--')
+                elif reference:
+                    cells.append('{:.3g} ({:.2f})'.format(value, value / reference))
+                else:
+                    cells.append('{:.3g}'.format(value))
+            lines.append('| {} | {} | {} |'.format(description, unit, ' | '.join(cells)))
+        lines.append('')
+    return '\n'.join(lines)
+
+
+def main(argv):
+    if len(argv) < 2:
+        print(__doc__)
+        return 1
+    document = argv[2] if 2 < len(argv) else os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), '..', '..', '..', 'docs', 'index_comparison.md')
+
+    results = run(argv[1])
+    if 'release' != results['context'].get('chartbox_build_type'):
+        print('!! refusing to publish timings from a non-release build: ' + argv[1])
+        return 1
+    table = render(results)
+
+    with open(document) as source:
+        text = source.read()
+    if BEGIN_MARKER not in text or END_MARKER not in text:
+        print('!! could not find the GENERATED markers in: ' + document)
+        return 1
+    head = text[:text.index(BEGIN_MARKER) + len(BEGIN_MARKER)]
+    tail = text[text.index(END_MARKER):]
+    with open(document, 'w') as sink:
+        sink.write(head + '\n' + table + '\n' + tail)
+    print('>> wrote: ' + document)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
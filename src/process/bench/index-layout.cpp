@@ -0,0 +1,198 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// Compares the cell-ordering policies in `src/lib/index/` under the same workloads.
+//
+// Each benchmark is registered as:  `Layout/<workload>/<policy>/<dimension>`
+// `index-comparison.py` parses the JSON output of these benchmarks into `docs/index_comparison.md`
+
+#include <cstdint>
+#include <memory>
+
+#include <benchmark/benchmark.h>
+#include <Eigen/Geometry>
+#include <fmt/core.h>
+
+#include "index/blocked-index.hpp"
+#include "index/hilbert-index.hpp"
+#include "index/row-major-index.hpp"
+#include "index/z-order-index.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+#include "search/hpa-star.hpp"
+
+#include "scenarios.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+using chartbox::layer::FixedGrid;
+
+namespace {
+
+constexpr uint32_t seed = 55;
+
+template<typename layer_t>
+void random_get( benchmark::State& state ){
+    const auto layer = chartbox::bench::make_scattered<layer_t>( seed );
+    const auto points = chartbox::bench::random_points<layer_t::dimension>( seed, 1 << 16 );
+
+    for( auto _ : state ){
+        uint32_t sum = 0;
+        for( const auto& p : points ){
+            sum += layer->get( p );
+        }
+        benchmark::DoNotOptimize( sum );
+    }
+    state.SetItemsProcessed( state.iterations() * points.size() );
+}
+
+template<typename layer_t>
+void fill_box( benchmark::State& state ){
+    constexpr size_t dimension = layer_t::dimension;
+    auto layer = chartbox::bench::make_scattered<layer_t>( seed );
+    const auto corners = chartbox::bench::random_points<dimension - 64>( seed, 64 );
+
+    size_t index = 0;
+    for( auto _ : state ){
+        const Vector2d& corner = corners[ index++ % corners.size() ];
+        layer->fill( AlignedBox2d(corner, corner + Vector2d(64, 64)), 0x42 );
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed( state.iterations() * 64 * 64 );
+}
+
+/// \brief read every cell's 8-neighborhood; e.g. as in a dilation, or an A* expansion
+template<typename layer_t>
+void neighbors( benchmark::State& state ){
+    constexpr uint32_t dimension = layer_t::dimension;
+    const auto layer = chartbox::bench::make_scattered<layer_t>( seed );
+    const auto* cells = layer->data();
+
+    for( auto _ : state ){
+        uint32_t blocked = 0;
+        for( uint32_t j = 1; j < (dimension - 1); ++j ){
+            for( uint32_t i = 1; i < (dimension - 1); ++i ){
+                for( uint32_t dj = j - 1; dj <= j + 1; ++dj ){
+                    for( uint32_t di = i - 1; di <= i + 1; ++di ){
+                        blocked += (layer_t::blocking_threshold <= cells[layer->lookup(di, dj)]) ? 1 : 0;
+                    }
+                }
+            }
+        }
+        benchmark::DoNotOptimize( blocked );
+    }
+    state.SetItemsProcessed( state.iterations() * (dimension - 2) * (dimension - 2) );
+}
+
+/// \brief walk cells along random segments until the first blocked cell (integer DDA)
+template<typename layer_t>
+void raycast( benchmark::State& state ){
+    constexpr size_t dimension = layer_t::dimension;
+    const auto layer = chartbox::bench::make_scattered<layer_t>( seed );
+    const auto starts = chartbox::bench::random_points<dimension>( seed, 1024 );
+    const auto ends = chartbox::bench::random_points<dimension>( seed + 1, 1024 );
+    const auto* cells = layer->data();
+
+    size_t visited = 0;
+    for( auto _ : state ){
+        for( size_t k = 0; k < starts.size(); ++k ){
+            int64_t i = static_cast<int64_t>( starts[k].x() );
+            int64_t j = static_cast<int64_t>( starts[k].y() );
+            const int64_t i1 = static_cast<int64_t>( ends[k].x() );
+            const int64_t j1 = static_cast<int64_t>( ends[k].y() );
+            const int64_t di = std::abs(i1 - i);
+            const int64_t dj = -std::abs(j1 - j);
+            const int64_t si = (i < i1) ? 1 : -1;
+            const int64_t sj = (j < j1) ? 1 : -1;
+            int64_t error = di + dj;
+            while( cells[layer->lookup(i, j)] < layer_t::blocking_threshold ){
+                ++visited;
+                if( (i == i1) && (j == j1) ){
+                    break;
+                }
+                const int64_t twice = 2 * error;
+                if( dj <= twice ){ error += dj; i += si; }
+                if( twice <= di ){ error += di; j += sj; }
+            }
+        }
+    }
+    benchmark::DoNotOptimize( visited );
+    state.SetItemsProcessed( visited );
+}
+
+template<typename layer_t>
+void astar( benchmark::State& state ){
+    constexpr double dimension = layer_t::dimension;
+    const auto layer = chartbox::bench::make_scattered<layer_t>( seed );
+    chartbox::search::HierarchicalAStar<layer_t> search( *layer );
+
+    const Vector2d start( 0.5, 0.5 );
+    const Vector2d goal( dimension - 0.5, dimension - 0.5 );
+    layer->store( start, layer_t::clear_value );
+    layer->store( goal, layer_t::clear_value );
+    for( auto _ : state ){
+        benchmark::DoNotOptimize( search.compute_flat( start, goal ) );
+    }
+}
+
+template<typename index_t>
+void register_layout(){
+    typedef FixedGrid<index_t> layer_t;
+    const auto name = [](const char* workload){
+        return fmt::format( "Layout/{}/{}/{}", workload, index_t::name, index_t::dimension ); };
+
+    benchmark::RegisterBenchmark( name("RandomGet").c_str(), random_get<layer_t> );
+    benchmark::RegisterBenchmark( name("Fill").c_str(), fill_box<layer_t> );
+    benchmark::RegisterBenchmark( name("Neighbors").c_str(), neighbors<layer_t> );
+    benchmark::RegisterBenchmark( name("Raycast").c_str(), raycast<layer_t> );
+    benchmark::RegisterBenchmark( name("AStar").c_str(), astar<layer_t> )->Unit( benchmark::kMillisecond );
+}
+
+template<size_t dimension>
+void register_layouts(){
+    register_layout< chartbox::index::RowMajorIndex<dimension> >();
+    register_layout< chartbox::index::ZOrderIndex<dimension> >();
+    register_layout< chartbox::index::HilbertIndex<dimension> >();
+    register_layout< chartbox::index::BlockedIndex<dimension> >();
+}
+
+} // namespace
+
+// defined in `any-angle.cpp`, `batch.cpp`, `bidirectional.cpp`, `bilinear.cpp`, `grid-tree.cpp`, `quad-tree.cpp`, `replan.cpp`, `suite.cpp` and `tile-world.cpp`
+void register_any_angle();
+void register_batch();
+void register_bidirectional();
+void register_bilinear();
+void register_grid_tree();
+void register_quad_tree();
+void register_replan();
+void register_suite();
+void register_tile_world();
+
+int main( int argc, char** argv ){
+    register_layouts<128>();
+    register_layouts<1024>();
+    register_any_angle();
+    register_batch();
+    register_bidirectional();
+    register_bilinear();
+    register_grid_tree();
+    register_quad_tree();
+    register_replan();
+    register_suite();
+    register_tile_world();
+
+    // the library's own `library_build_type` describes how Google Benchmark was built; not this program
+#ifdef NDEBUG
+    benchmark::AddCustomContext( "chartbox_build_type", "release" );
+#else
+    benchmark::AddCustomContext( "chartbox_build_type", "debug" );
+#endif
+
+    benchmark::Initialize( &argc, argv );
+    if( benchmark::ReportUnrecognizedArguments(argc, argv) ){
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,161 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// Compares building a quadtree from a grid one `store(...)` at a time, against the bottom-up build; and
+// compares the binary encoding of a tree against the JSON encoding of the legacy `WorldTree`.
+//
+// Each benchmark is registered as:  `QuadTree/<method>/<dimension>`, where the bottom-up build runs on
+// one thread (`BottomUp`), and on every core (`BottomUpParallel`).  Each reports the resultant node count.
+//
+// The encodings are registered as:  `QuadTree/<Write|Load><Binary|JSON>/<dimension>`; each reports the
+// encoded size, in `bytes`.  `LoadJSON` only parses the text into a document -- which is a lower bound on
+// the time to load a tree from it.
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+#include <Eigen/Geometry>
+#include <fmt/core.h>
+
+#include <cpl_json.h>
+
+#include "index/row-major-index.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+#include "layer/quad-tree/quad-tree-layer.hpp"
+
+#include "scenarios.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+using chartbox::layer::FixedGrid;
+using chartbox::layer::QuadTree;
+
+namespace {
+
+constexpr uint32_t seed = 55;
+
+enum Method { Store, BottomUp, BottomUpParallel };
+
+template<size_t dimension>
+using Grid = FixedGrid< chartbox::index::RowMajorIndex<dimension> >;
+
+/// \brief a few large obstacles, as along a coast: wide uniform regions, with ragged edges
+template<size_t dimension>
+std::unique_ptr<Grid<dimension>> make_layer(){
+    auto layer = std::make_unique<Grid<dimension>>( chartbox::bench::bounds_of<dimension>() );
+    layer->fill( Grid<dimension>::clear_value );
+
+    std::mt19937 generator( seed );
+    std::uniform_real_distribution<double> corner( 0, dimension );
+    std::uniform_real_distribution<double> size( 0, dimension / 8.0 );
+    for( size_t count = 0; count < 64; ++count ){
+        const Vector2d low( corner(generator), corner(generator) );
+        layer->fill( AlignedBox2d(low, low + Vector2d(size(generator), size(generator))), 0x99 );
+    }
+    return layer;
+}
+
+template<size_t dimension>
+void build( benchmark::State& state, const Method method ){
+    typedef QuadTree<dimension> Tree;
+    const auto grid = make_layer<dimension>();
+
+    size_t nodes = 0;
+    for( auto _ : state ){
+        if( Store == method ){
+            Tree tree( chartbox::bench::bounds_of<dimension>() );
+            for( uint32_t j = 0; j < dimension; ++j ){
+                for( uint32_t i = 0; i < dimension; ++i ){
+                    tree.store( i, j, grid->data()[ grid->lookup(i, j) ] );
+                }
+            }
+            nodes = tree.node_count();
+        }else{
+            const size_t threads = ( BottomUp == method ) ? 1 : std::thread::hardware_concurrency();
+            const Tree tree( chartbox::bench::bounds_of<dimension>(), *grid, threads );
+            nodes = tree.node_count();
+        }
+        benchmark::DoNotOptimize( nodes );
+    }
+    state.SetItemsProcessed( state.iterations() * dimension * dimension );
+    state.counters["nodes"] = benchmark::Counter( static_cast<double>(nodes) );
+}
+
+/// \brief the encoding of the legacy `QuadNode::to_json()`: a number for a leaf; else an object of four quadrants
+template<typename tree_t>
+void to_json( const tree_t& tree, const uint32_t at, std::string& text ){
+    const auto& node = tree.nodes()[at];
+    if( 0 == node.first_child ){
+        text += std::to_string( node.value );
+        return;
+    }
+    const uint32_t first = node.first_child;
+    text += "{\"NE\":";  to_json( tree, first + 3, text );
+    text += ",\"NW\":";  to_json( tree, first + 2, text );
+    text += ",\"SE\":";  to_json( tree, first + 1, text );
+    text += ",\"SW\":";  to_json( tree, first, text );
+    text += "}";
+}
+
+enum Encoding { WriteBinary, LoadBinary, WriteJSON, LoadJSON };
+
+template<size_t dimension>
+void encoding( benchmark::State& state, const Encoding encoding ){
+    typedef QuadTree<dimension> Tree;
+    const auto grid = make_layer<dimension>();
+    const Tree source( chartbox::bench::bounds_of<dimension>(), *grid );
+
+    std::ostringstream sink;
+    source.write( sink );
+    const std::string binary = sink.str();
+    std::string json;
+    to_json( source, 0, json );
+
+    Tree loaded( chartbox::bench::bounds_of<dimension>() );
+    for( auto _ : state ){
+        if( WriteBinary == encoding ){
+            std::ostringstream each;
+            source.write( each );
+            benchmark::DoNotOptimize( each.tellp() );
+        }else if( LoadBinary == encoding ){
+            std::istringstream each( binary );
+            benchmark::DoNotOptimize( loaded.load(each) );
+        }else if( WriteJSON == encoding ){
+            std::string each;
+            to_json( source, 0, each );
+            benchmark::DoNotOptimize( each.data() );
+        }else{
+            CPLJSONDocument document;
+            benchmark::DoNotOptimize( document.LoadMemory(json) );
+        }
+    }
+    const bool is_binary = ( (WriteBinary == encoding) || (LoadBinary == encoding) );
+    state.counters["bytes"] = benchmark::Counter( static_cast<double>(is_binary ? binary.size() : json.size()) );
+}
+
+template<size_t dimension>
+void register_dimension(){
+    const auto name = [](const char* method){
+        return fmt::format( "QuadTree/{}/{}", method, dimension ); };
+
+    benchmark::RegisterBenchmark( name("Store").c_str(), build<dimension>, Store )->Unit( benchmark::kMicrosecond );
+    benchmark::RegisterBenchmark( name("BottomUp").c_str(), build<dimension>, BottomUp )->Unit( benchmark::kMicrosecond );
+    benchmark::RegisterBenchmark( name("BottomUpParallel").c_str(), build<dimension>, BottomUpParallel )->Unit( benchmark::kMicrosecond )->UseRealTime();
+
+    benchmark::RegisterBenchmark( name("WriteBinary").c_str(), encoding<dimension>, WriteBinary )->Unit( benchmark::kMicrosecond );
+    benchmark::RegisterBenchmark( name("LoadBinary").c_str(), encoding<dimension>, LoadBinary )->Unit( benchmark::kMicrosecond );
+    benchmark::RegisterBenchmark( name("WriteJSON").c_str(), encoding<dimension>, WriteJSON )->Unit( benchmark::kMicrosecond );
+    benchmark::RegisterBenchmark( name("LoadJSON").c_str(), encoding<dimension>, LoadJSON )->Unit( benchmark::kMicrosecond );
+}
+
+} // namespace
+
+void register_quad_tree(){
+    register_dimension<1024>();
+    register_dimension<4096>();
+}
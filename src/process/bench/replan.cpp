@@ -0,0 +1,106 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// Compares replanning after small, local changes to the chart: D* Lite's incremental repair, against a full A* search.
+//
+// Each benchmark is registered as:  `Replan/<planner>/<dimension>`
+// Each iteration toggles one 4x4 obstacle on the (original) path -- alternately blocking and clearing it -- and then
+// replans between the same two corners.  Only the report of the change, and the replan itself, are timed.
+// D* Lite searches back from the goal; so a change near the goal invalidates more of its state than one near the start.
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <Eigen/Geometry>
+#include <fmt/core.h>
+
+#include "index/row-major-index.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+#include "search/d-star-lite.hpp"
+#include "search/hpa-star.hpp"
+
+#include "scenarios.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+using chart::geometry::Path;
+using chartbox::layer::FixedGrid;
+
+namespace {
+
+constexpr uint32_t seed = 55;
+
+template<size_t dimension>
+using Grid = FixedGrid< chartbox::index::RowMajorIndex<dimension> >;
+
+enum Planner { AStar, DStarLite };
+
+/// \brief scattered obstacles; but keep the two corners clear
+template<size_t dimension>
+std::unique_ptr<Grid<dimension>> make_layer(){
+    return chartbox::bench::make_scattered< Grid<dimension> >( seed, {
+        AlignedBox2d( Vector2d(0, 0), Vector2d(16, 16) ),
+        AlignedBox2d( Vector2d(dimension - 16, dimension - 16), Vector2d(dimension, dimension) ) } );
+}
+
+template<size_t dimension>
+void replan( benchmark::State& state, const Planner planner ){
+    auto layer = make_layer<dimension>();
+    const Vector2d start( 2.5, 2.5 );
+    const Vector2d goal( dimension - 2.5, dimension - 2.5 );
+
+    chartbox::search::HierarchicalAStar< Grid<dimension> > full( *layer );
+    chartbox::search::DStarLite< Grid<dimension> > incremental( *layer );
+
+    // the interior waypoints of the original path are where a change is most likely to matter
+    const Path original = full.compute_flat( start, goal );
+    std::vector<AlignedBox2d> changes;
+    for( size_t k = 1; k + 1 < original.size(); ++k ){
+        changes.emplace_back( original[k] - Vector2d(2, 2), original[k] + Vector2d(2, 2) );
+    }
+    if( changes.empty() ){
+        state.SkipWithError( "no path between the corners" );
+        return;
+    }
+    incremental.compute( start, goal );
+
+    size_t expansions = 0;
+    size_t iteration = 0;
+    for( auto _ : state ){
+        state.PauseTiming();
+        const AlignedBox2d& area = changes[ (iteration / 2) % changes.size() ];
+        layer->fill( area, (0 == (iteration % 2)) ? 0x99 : Grid<dimension>::clear_value );
+        ++iteration;
+        state.ResumeTiming();
+
+        if( DStarLite == planner ){
+            incremental.update( area );
+            benchmark::DoNotOptimize( incremental.compute(start, goal) );
+            expansions += incremental.expansions();
+        }else{
+            benchmark::DoNotOptimize( full.compute_flat(start, goal) );
+        }
+    }
+
+    if( DStarLite == planner ){
+        state.counters["expansions"] = benchmark::Counter( static_cast<double>(expansions) / state.iterations() );
+    }
+}
+
+template<size_t dimension>
+void register_dimension(){
+    const auto name = [](const char* planner){
+        return fmt::format( "Replan/{}/{}", planner, dimension ); };
+
+    benchmark::RegisterBenchmark( name("AStar").c_str(), replan<dimension>, AStar )->Unit( benchmark::kMicrosecond );
+    benchmark::RegisterBenchmark( name("DStarLite").c_str(), replan<dimension>, DStarLite )->Unit( benchmark::kMicrosecond );
+}
+
+} // namespace
+
+void register_replan(){
+    register_dimension<256>();
+    register_dimension<1024>();
+}
@@ -0,0 +1,95 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// Synthetic charts and queries, shared by the benchmarks in this directory.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include "search/hpa-star.hpp"
+
+namespace chartbox::bench {
+
+typedef std::pair<Eigen::Vector2d,Eigen::Vector2d> Query;
+
+/// \brief square bounds of `dimension` units, from the origin
+///
+/// The layers hold a reference to their bounds; so they must outlive them.
+template<size_t dimension>
+const Eigen::AlignedBox2d& bounds_of(){
+    static const Eigen::AlignedBox2d bounds( Eigen::Vector2d(0,0), Eigen::Vector2d(dimension, dimension) );
+    return bounds;
+}
+
+/// \brief scatter 8x8 obstacles over ~25% of the layer
+///
+/// \param cleared - areas to clear again afterwards; e.g. the corners a query starts and ends in
+template<typename layer_t>
+void scatter( layer_t& layer, const uint32_t seed, const std::vector<Eigen::AlignedBox2d>& cleared = {} ){
+    constexpr size_t dimension = layer_t::dimension;
+    layer.fill( layer_t::clear_value );
+
+    std::mt19937 generator( seed );
+    std::uniform_int_distribution<uint32_t> corner( 0, dimension - 8 );
+    for( size_t count = 0; count < (dimension * dimension) / 256; ++count ){
+        const double x = corner(generator);
+        const double y = corner(generator);
+        layer.fill( Eigen::AlignedBox2d(Eigen::Vector2d(x, y), Eigen::Vector2d(x + 8, y + 8)), 0x99 );
+    }
+    for( const auto& area : cleared ){
+        layer.fill( area, layer_t::clear_value );
+    }
+}
+
+/// \brief new layer over `bounds_of<dimension>()`, scattered as by `scatter(...)`
+template<typename layer_t>
+std::unique_ptr<layer_t> make_scattered( const uint32_t seed, const std::vector<Eigen::AlignedBox2d>& cleared = {} ){
+    auto layer = std::make_unique<layer_t>( bounds_of<layer_t::dimension>() );
+    scatter( *layer, seed, cleared );
+    return layer;
+}
+
+/// \brief uniformly random points within the square of `dimension` units, from the origin
+template<size_t dimension>
+std::vector<Eigen::Vector2d> random_points( const uint32_t seed, const size_t count ){
+    std::mt19937 generator( seed );
+    std::uniform_real_distribution<double> coordinate( 0, dimension );
+    std::vector<Eigen::Vector2d> points( count );
+    for( auto& p : points ){
+        p = { coordinate(generator), coordinate(generator) };
+    }
+    return points;
+}
+
+/// \brief random pairs of clear cell centers, which are connected
+///
+/// \param separation - minimum distance between the start and goal of each query
+/// \return up to `count` queries; fewer if the layer is too sparsely connected to find them
+template<typename layer_t>
+std::vector<Query> connected_queries( const layer_t& layer, const uint32_t seed, const size_t count, const double separation = 0 ){
+    chartbox::search::HierarchicalAStar<layer_t> search( layer );
+    std::mt19937 generator( seed );
+    std::uniform_int_distribution<uint32_t> index( 0, layer_t::dimension - 1 );
+    const double precision = layer.precision();
+
+    std::vector<Query> queries;
+    for( size_t attempt = 0; (queries.size() < count) && (attempt < 1000 * count); ++attempt ){
+        const Eigen::Vector2d start( (index(generator) + 0.5) * precision, (index(generator) + 0.5) * precision );
+        const Eigen::Vector2d goal( (index(generator) + 0.5) * precision, (index(generator) + 0.5) * precision );
+        if( (start - goal).norm() < separation ){
+            continue;
+        }
+        if( ! search.compute(start, goal).empty() ){
+            queries.emplace_back( start, goal );
+        }
+    }
+    return queries;
+}
+
+} // namespace chartbox::bench
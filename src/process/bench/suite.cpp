@@ -0,0 +1,299 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// Regression suite: one benchmark per public operation of the layers, loaders, writers and searches.
+//
+// Each benchmark is registered as:  `<component>/<operation>/<dimension>`, e.g. `Layer/Get/1024`
+// Save the JSON output of two builds (e.g. with `make bench`), and compare them with `bench-compare.py`:
+//     chartbox_bench --benchmark_filter='^(Layer|Load|Write|Search|Pyramid)/' --benchmark_out=before.json --benchmark_out_format=json
+//
+// The `Load/GeoJSON` benchmark reads `data/block-island/`; so run from the repository root.
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <Eigen/Geometry>
+#include <fmt/core.h>
+
+#include <gdal.h>
+#include <ogr_geometry.h>
+
+#include "chart-box/chart-box.hpp"
+#include "index/row-major-index.hpp"
+#include "io/chart-geojson-loader.hpp"
+#include "io/chart-png-writer.hpp"
+#include "layer/fixed-grid/fixed-grid.hpp"
+#include "layer/pyramid/layer-pyramid.hpp"
+#include "search/cost-to-go.hpp"
+#include "search/hpa-star.hpp"
+
+#include "scenarios.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+using chartbox::layer::FixedGrid;
+
+namespace {
+
+constexpr uint32_t seed = 55;
+
+template<size_t dimension>
+using Grid = FixedGrid< chartbox::index::RowMajorIndex<dimension> >;
+
+/// \brief an irregular 64-sided star, centered in the layer, spanning most of it
+OGRPolygon make_star( const double dimension ){
+    std::mt19937 generator( seed );
+    std::uniform_real_distribution<double> radius( 0.2 * dimension, 0.45 * dimension );
+
+    OGRLinearRing ring;
+    constexpr size_t vertex_count = 64;
+    for( size_t k = 0; k < vertex_count; ++k ){
+        const double angle = 2 * M_PI * k / vertex_count;
+        const double r = radius( generator );
+        ring.addPoint( dimension/2 + r * std::cos(angle), dimension/2 + r * std::sin(angle) );
+    }
+    ring.closeRings();
+
+    OGRPolygon polygon;
+    polygon.addRing( &ring );
+    return polygon;
+}
+
+// ====================================== Layer ======================================
+
+template<size_t dimension>
+void layer_get( benchmark::State& state ){
+    const auto layer = chartbox::bench::make_scattered< Grid<dimension> >( seed );
+    const auto points = chartbox::bench::random_points<dimension>( seed, 1 << 16 );
+
+    for( auto _ : state ){
+        uint32_t sum = 0;
+        for( const auto& p : points ){
+            sum += layer->get( p );
+        }
+        benchmark::DoNotOptimize( sum );
+    }
+    state.SetItemsProcessed( state.iterations() * points.size() );
+}
+
+/// \brief about half of these writes flip a cell between clear and blocked; and so update the occupancy tables
+template<size_t dimension>
+void layer_store( benchmark::State& state ){
+    auto layer = chartbox::bench::make_scattered< Grid<dimension> >( seed );
+    const auto points = chartbox::bench::random_points<dimension>( seed, 1 << 12 );
+
+    uint8_t value = 0;
+    for( auto _ : state ){
+        for( const auto& p : points ){
+            layer->store( p, value++ );
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed( state.iterations() * points.size() );
+}
+
+/// \brief every write flips a cell between clear and blocked; so each one updates the occupancy tables
+template<size_t dimension>
+void layer_store_flip( benchmark::State& state ){
+    // (the obstacles make no difference to this cost; and are slow to draw on the largest layers)
+    auto layer = std::make_unique<Grid<dimension>>( chartbox::bench::bounds_of<dimension>() );
+    layer->fill( Grid<dimension>::clear_value );
+    const auto points = chartbox::bench::random_points<dimension>( seed, 1 << 12 );
+
+    bool blocked = false;
+    for( auto _ : state ){
+        blocked = ! blocked;
+        for( const auto& p : points ){
+            layer->store( p, blocked ? 0x99 : Grid<dimension>::clear_value );
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed( state.iterations() * points.size() );
+}
+
+/// \brief overwrite every cell with one value
+template<size_t dimension>
+void layer_fill( benchmark::State& state ){
+    auto layer = chartbox::bench::make_scattered< Grid<dimension> >( seed );
+
+    uint8_t value = 0;
+    for( auto _ : state ){
+        layer->fill( value++ );
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed( state.iterations() * dimension * dimension );
+}
+
+template<size_t dimension>
+void layer_fill_polygon( benchmark::State& state ){
+    auto layer = chartbox::bench::make_scattered< Grid<dimension> >( seed );
+    const OGRPolygon star = make_star( dimension );
+
+    for( auto _ : state ){
+        layer->fill( std::make_unique<OGRPolygon>(star), Grid<dimension>::clear_value );
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed( state.iterations() * dimension * dimension );
+}
+
+// ====================================== I/O ======================================
+
+/// \brief each iteration loads into a fresh chart; the chart's construction is included in the time
+void load_geojson( benchmark::State& state ){
+    GDALAllRegister();
+    for( auto _ : state ){
+        chartbox::ChartBox box;
+        chartbox::io::GeoJSONLoader<chartbox::ChartBox::boundary_layer_t> loader( box.mapping(), box.get_boundary_layer() );
+        if( ! loader.load_file("data/block-island/boundary.polygon.geojson") ){
+            state.SkipWithError( "could not load the chart" );
+            return;
+        }
+    }
+}
+
+template<size_t dimension>
+void write_png( benchmark::State& state ){
+    auto layer = chartbox::bench::make_scattered< Grid<dimension> >( seed );
+    chartbox::io::PNGWriter< Grid<dimension> > writer( *layer );
+    const auto path = std::filesystem::temp_directory_path() / fmt::format( "chartbox-bench-{}.png", dimension );
+
+    for( auto _ : state ){
+        if( ! writer.write_to_path(path.string()) ){
+            state.SkipWithError( "could not write the image" );
+            return;
+        }
+    }
+    std::filesystem::remove( path );
+    state.SetItemsProcessed( state.iterations() * dimension * dimension );
+}
+
+// ====================================== Search ======================================
+
+/// \param hierarchical - if true, plan through the abstract graph; else run the flat, 8-connected A*
+template<size_t dimension>
+void search( benchmark::State& state, const bool hierarchical ){
+    const auto layer = chartbox::bench::make_scattered< Grid<dimension> >( seed );
+    const auto queries = chartbox::bench::connected_queries( *layer, seed, 16 );
+    if( queries.empty() ){
+        state.SkipWithError( "no connected queries in this layer" );
+        return;
+    }
+    chartbox::search::HierarchicalAStar< Grid<dimension> > planner( *layer );
+
+    size_t index = 0;
+    for( auto _ : state ){
+        const auto& query = queries[ index++ % queries.size() ];
+        if( hierarchical ){
+            benchmark::DoNotOptimize( planner.compute(query.first, query.second) );
+        }else{
+            benchmark::DoNotOptimize( planner.compute_flat(query.first, query.second) );
+        }
+    }
+}
+
+/// \brief build a cost-to-go field towards the center of the layer
+template<size_t dimension>
+void cost_to_go_build( benchmark::State& state ){
+    auto layer = chartbox::bench::make_scattered< Grid<dimension> >( seed );
+    const Vector2d goal( dimension/2 + 0.5, dimension/2 + 0.5 );
+    layer->fill( AlignedBox2d(goal - Vector2d(1, 1), goal + Vector2d(1, 1)), Grid<dimension>::clear_value );
+    chartbox::search::CostToGo< Grid<dimension> > field( *layer );
+
+    for( auto _ : state ){
+        benchmark::DoNotOptimize( field.build(goal) );
+    }
+    state.SetItemsProcessed( state.iterations() * dimension * dimension );
+}
+
+/// \brief descend a built cost-to-go field, from random starts
+template<size_t dimension>
+void cost_to_go_path( benchmark::State& state ){
+    auto layer = chartbox::bench::make_scattered< Grid<dimension> >( seed );
+    const Vector2d goal( dimension/2 + 0.5, dimension/2 + 0.5 );
+    layer->fill( AlignedBox2d(goal - Vector2d(1, 1), goal + Vector2d(1, 1)), Grid<dimension>::clear_value );
+    chartbox::search::CostToGo< Grid<dimension> > field( *layer );
+    field.build( goal );
+    const auto starts = chartbox::bench::random_points<dimension>( seed, 256 );
+
+    size_t index = 0;
+    for( auto _ : state ){
+        benchmark::DoNotOptimize( field.path_from(starts[ index++ % starts.size() ]) );
+    }
+}
+
+// ====================================== Pyramid ======================================
+
+template<size_t dimension>
+void pyramid_build( benchmark::State& state ){
+    auto layer = chartbox::bench::make_scattered< Grid<dimension> >( seed );
+    chartbox::layer::LayerPyramid< Grid<dimension> > pyramid( *layer );
+
+    for( auto _ : state ){
+        pyramid.build( 1 );
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed( state.iterations() * dimension * dimension );
+}
+
+/// \brief classify random boxes, up to 1/4 of the layer's width on a side
+template<size_t dimension>
+void pyramid_classify( benchmark::State& state ){
+    auto layer = chartbox::bench::make_scattered< Grid<dimension> >( seed );
+    const chartbox::layer::LayerPyramid< Grid<dimension> > pyramid( *layer );
+    const auto corners = chartbox::bench::random_points<dimension>( seed, 1024 );
+    const auto sizes = chartbox::bench::random_points<dimension / 4>( seed + 1, 1024 );
+
+    std::vector<AlignedBox2d> areas;
+    for( size_t k = 0; k < corners.size(); ++k ){
+        areas.emplace_back( corners[k], corners[k] + sizes[k] );
+    }
+
+    for( auto _ : state ){
+        size_t partial = 0;
+        for( const auto& area : areas ){
+            partial += ( chartbox::layer::Partial == pyramid.classify(area) ) ? 1 : 0;
+        }
+        benchmark::DoNotOptimize( partial );
+    }
+    state.SetItemsProcessed( state.iterations() * areas.size() );
+}
+
+template<size_t dimension>
+void register_dimension(){
+    const auto name = [](const char* component, const char* operation){
+        return fmt::format( "{}/{}/{}", component, operation, dimension ); };
+
+    benchmark::RegisterBenchmark( name("Layer", "Get").c_str(), layer_get<dimension> );
+    benchmark::RegisterBenchmark( name("Layer", "Store").c_str(), layer_store<dimension> );
+    benchmark::RegisterBenchmark( name("Layer", "StoreFlip").c_str(), layer_store_flip<dimension> );
+    benchmark::RegisterBenchmark( name("Layer", "Fill").c_str(), layer_fill<dimension> );
+    benchmark::RegisterBenchmark( name("Layer", "FillPolygon").c_str(), layer_fill_polygon<dimension> );
+    benchmark::RegisterBenchmark( name("Write", "PNG").c_str(), write_png<dimension> )->Unit( benchmark::kMicrosecond );
+    benchmark::RegisterBenchmark( name("Search", "AStar").c_str(), search<dimension>, false )->Unit( benchmark::kMicrosecond );
+    benchmark::RegisterBenchmark( name("Search", "HPAStar").c_str(), search<dimension>, true )->Unit( benchmark::kMicrosecond );
+    benchmark::RegisterBenchmark( name("Search", "CostToGoBuild").c_str(), cost_to_go_build<dimension> )->Unit( benchmark::kMicrosecond );
+    benchmark::RegisterBenchmark( name("Search", "CostToGoPath").c_str(), cost_to_go_path<dimension> )->Unit( benchmark::kMicrosecond );
+    benchmark::RegisterBenchmark( name("Pyramid", "Build").c_str(), pyramid_build<dimension> );
+    benchmark::RegisterBenchmark( name("Pyramid", "Classify").c_str(), pyramid_classify<dimension> );
+}
+
+} // namespace
+
+void register_suite(){
+    register_dimension<128>();
+    register_dimension<256>();
+    register_dimension<512>();
+    register_dimension<1024>();
+
+    // single writes are where the occupancy tables' cost grows with the layer
+    benchmark::RegisterBenchmark( "Layer/StoreFlip/4096", layer_store_flip<4096> );
+
+    // the chart's layers have a fixed size
+    benchmark::RegisterBenchmark( fmt::format("Load/GeoJSON/{}", chartbox::ChartBox::boundary_layer_t::dimension).c_str(), load_geojson )
+        ->Unit( benchmark::kMillisecond );
+}
@@ -0,0 +1,109 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+// Measures the sparse `TileWorld` layer on a stretch of coast far wider than any single local frame: 1000 km x
+// 100 km, at 1 m; with land drawn only along a ragged shoreline.
+//
+// Each benchmark is registered as:  `TileWorld/<operation>/<pattern>`; where the operations are cell reads
+// (`Get`), and cell writes (`Store`: each cell is written, then restored); and the patterns are runs of 64
+// neighboring cells (`Sequential`), or independent cells near the shore (`Random`).
+// Each reports the layer's allocated `tiles` and `bytes`.
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <Eigen/Geometry>
+#include <fmt/core.h>
+
+#include "layer/tile-world/tile-world.hpp"
+
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
+
+using chartbox::layer::TileWorldLayer;
+
+namespace {
+
+constexpr uint32_t seed = 56;
+constexpr size_t query_count = 4096;
+constexpr size_t run_length = 64;
+
+/// \brief length of the shoreline, in cells
+constexpr uint32_t shore_length = 65536;
+
+enum Operation { Get, Store };
+enum Pattern { Sequential, Random };
+
+/// \brief the layer holds a reference to its bounds; so they must outlive it
+const AlignedBox2d& coast(){
+    static const AlignedBox2d bounds( Vector2d(0,0), Vector2d(1'000'000, 100'000) );
+    return bounds;
+}
+
+/// \brief row of the shoreline at each column
+double shore( const double x ){
+    return 50'000 + 2'000 * std::sin( x / 20'000 );
+}
+
+std::unique_ptr<TileWorldLayer> make_world(){
+    auto world = std::make_unique<TileWorldLayer>( coast(), 1.0 );
+    world->fill( 0 );
+
+    std::mt19937 generator( seed );
+    std::uniform_real_distribution<double> height( 32, 200 );
+    for( double x = 0; x < shore_length; x += 256 ){
+        const Vector2d low( x, shore(x) );
+        world->fill( AlignedBox2d(low, low + Vector2d(256, height(generator))), 0x99 );
+    }
+    return world;
+}
+
+void operation( benchmark::State& state, const Operation operation, const Pattern pattern ){
+    const auto world = make_world();
+
+    std::mt19937 generator( seed + 1 );
+    std::uniform_int_distribution<uint32_t> column( 0, shore_length - run_length );
+    std::uniform_int_distribution<int> offset( -128, 256 );
+    std::vector<std::pair<uint32_t, uint32_t>> cells;
+    cells.reserve( query_count );
+    while( cells.size() < query_count ){
+        const uint32_t i = column( generator );
+        const uint32_t j = static_cast<uint32_t>( shore(i) + offset(generator) );
+        if( Sequential == pattern ){
+            for( uint32_t step = 0; step < run_length; ++step ){
+                cells.emplace_back( i + step, j );
+            }
+        }else{
+            cells.emplace_back( i, j );
+        }
+    }
+
+    for( auto _ : state ){
+        uint32_t sum = 0;
+        for( const auto& [i, j] : cells ){
+            const uint8_t value = world->get( i, j );
+            if( Store == operation ){
+                world->store( i, j, value ^ 0x99 );
+                world->store( i, j, value );
+            }
+            sum += value;
+        }
+        benchmark::DoNotOptimize( sum );
+    }
+    state.SetItemsProcessed( state.iterations() * cells.size() );
+    state.counters["tiles"] = benchmark::Counter( static_cast<double>(world->tile_count()) );
+    state.counters["bytes"] = benchmark::Counter( static_cast<double>(world->memory_usage()) );
+}
+
+} // namespace
+
+void register_tile_world(){
+    benchmark::RegisterBenchmark( "TileWorld/Get/Sequential", operation, Get, Sequential );
+    benchmark::RegisterBenchmark( "TileWorld/Get/Random", operation, Get, Random );
+    benchmark::RegisterBenchmark( "TileWorld/Store/Sequential", operation, Store, Sequential );
+    benchmark::RegisterBenchmark( "TileWorld/Store/Random", operation, Store, Random );
+}
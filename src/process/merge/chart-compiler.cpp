@@ -0,0 +1,522 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// may not be standard
+#include <sys/stat.h>
+
+#include <fmt/core.h>
+
+#include <cpl_json.h>
+#include <gdal_priv.h>
+#include <ogr_spatialref.h>
+#include <ogrsf_frmts.h>
+
+#include "io/chart-geojson-loader.hpp"
+#include "io/chart-png-writer.hpp"
+#include "io/chart-raster-loader.hpp"
+
+#include "probe/probe.hpp"
+
+#include "chart-compiler.hpp"
+
+using Eigen::Vector2d;
+
+using chartbox::merge::ChartCompiler;
+using chartbox::merge::Manifest;
+using chartbox::merge::Source;
+
+namespace {
+
+/// \brief create each missing directory along the path
+bool make_directories( const std::string& path ){
+    for( size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1) ){
+        const std::string prefix = path.substr( 0, slash );
+        if( (0 != mkdir(prefix.c_str(), 0755)) && (EEXIST != errno) ){
+            return false;
+        }
+        if( std::string::npos == slash ){
+            break;
+        }
+    }
+    struct stat status;
+    return (0 == stat(path.c_str(), &status)) && S_ISDIR(status.st_mode);
+}
+
+/// \brief the "bbox" of a GeoJSON document: `[west, south, east, north]`
+bool load_bounding_box( const std::string& path, Vector2d& min_lon_lat, Vector2d& max_lon_lat ){
+    CPLJSONDocument document;
+    if( ! document.Load(path) ){
+        return false;
+    }
+    const CPLJSONArray bbox = document.GetRoot().GetArray( "bbox" );
+    if( (! bbox.IsValid()) || (4 != bbox.Size()) ){
+        return false;
+    }
+    min_lon_lat = { bbox[0].ToDouble(NAN), bbox[1].ToDouble(NAN) };
+    max_lon_lat = { bbox[2].ToDouble(NAN), bbox[3].ToDouble(NAN) };
+    return min_lon_lat.allFinite() && max_lon_lat.allFinite();
+}
+
+} // namespace
+
+bool Manifest::load( const std::string& path, Manifest& manifest ){
+    CPLJSONDocument document;
+    if( ! document.Load(path) ){
+        fmt::print( stderr, "!! Could not load manifest: {}\n", path );
+        return false;
+    }
+    const CPLJSONObject root = document.GetRoot();
+    const size_t slash = path.find_last_of( '/' );
+    const std::string directory = (std::string::npos == slash) ? "" : path.substr( 0, slash + 1 );
+
+    const CPLJSONArray bounds = root.GetArray( "bounds" );
+    if( bounds.IsValid() ){
+        if( 4 != bounds.Size() ){
+            fmt::print( stderr, "!! Manifest 'bounds' must be: [west, south, east, north]\n" );
+            return false;
+        }
+        manifest.has_bounds = true;
+        manifest.min_lon_lat = { bounds[0].ToDouble(NAN), bounds[1].ToDouble(NAN) };
+        manifest.max_lon_lat = { bounds[2].ToDouble(NAN), bounds[3].ToDouble(NAN) };
+    }
+    manifest.output = root.GetString( "output", "chart" );
+    manifest.thread_count = static_cast<size_t>( std::max(0, root.GetInteger("threads", 0)) );
+
+    const CPLJSONArray sources = root.GetArray( "sources" );
+    if( (! sources.IsValid()) || (0 == sources.Size()) ){
+        fmt::print( stderr, "!! Manifest has no 'sources'\n" );
+        return false;
+    }
+    manifest.sources.clear();
+    for( int index = 0; index < sources.Size(); ++index ){
+        const CPLJSONObject each = sources[index];
+        Source source;
+        source.name = each.GetString( "name", std::to_string(index) );
+        source.path = each.GetString( "path", "" );
+        if( (! source.path.empty()) && ('/' != source.path[0]) ){
+            source.path = directory + source.path;
+        }
+        source.priority = each.GetInteger( "priority", 0 );
+
+        const std::string type = each.GetString( "type", "" );
+        if( "geojson" == type ){
+            source.type = Source::GeoJSON;
+        }else if( "shapefile" == type ){
+            source.type = Source::Shapefile;
+        }else if( "raster" == type ){
+            source.type = Source::Raster;
+        }else if( "points" == type ){
+            source.type = Source::Points;
+        }else{
+            fmt::print( stderr, "!! Source '{}' has unknown type: '{}'\n", source.name, type );
+            return false;
+        }
+
+        const std::string layer = each.GetString( "layer", "boundary" );
+        if( "boundary" == layer ){
+            source.target = Source::Boundary;
+        }else if( "contour" == layer ){
+            source.target = Source::Contour;
+        }else{
+            fmt::print( stderr, "!! Source '{}' has unknown layer: '{}'\n", source.name, layer );
+            return false;
+        }
+
+        const CPLJSONObject value = each.GetObj( "value" );
+        if( CPLJSONObject::Type::String == value.GetType() ){
+            if( "clear" == value.ToString() ){
+                source.value = ChartCompiler::boundary_layer_t::clear_value;
+            }else if( "blocked" == value.ToString() ){
+                source.value = ChartCompiler::blocked_value;
+            }else{
+                fmt::print( stderr, "!! Source '{}' has unknown value: '{}'\n", source.name, value.ToString() );
+                return false;
+            }
+        }else if( value.IsValid() ){
+            source.value = value.ToDouble( 0 );
+        }
+        // the default value marks the cells a source does not cover
+        if( (Source::Boundary == source.target) && (ChartCompiler::boundary_layer_t::default_value <= source.value) ){
+            fmt::print( stderr, "!! Source '{}': boundary values must be less than {}\n", source.name, ChartCompiler::boundary_layer_t::default_value );
+            return false;
+        }
+
+        const std::string method = each.GetString( "method", "bilinear" );
+        if( "nearest" == method ){
+            source.method = io::Resample::Nearest;
+        }else if( "bilinear" == method ){
+            source.method = io::Resample::Bilinear;
+        }else if( "minimum" == method ){
+            source.method = io::Resample::Minimum;
+        }else if( "maximum" == method ){
+            source.method = io::Resample::Maximum;
+        }else{
+            fmt::print( stderr, "!! Source '{}' has unknown method: '{}'\n", source.name, method );
+            return false;
+        }
+
+        manifest.sources.push_back( source );
+    }
+    return true;
+}
+
+ChartCompiler::ChartCompiler( const Manifest& _manifest )
+    : manifest_(_manifest)
+    , thread_count_( std::max<size_t>(1, (0 < _manifest.thread_count) ? _manifest.thread_count : std::thread::hardware_concurrency()) )
+    , load_thread_count_( std::max<size_t>(1, thread_count_ / std::clamp<size_t>(_manifest.sources.size(), 1, thread_count_)) )
+{
+    const auto frame = graph_.add( "frame", [this](){ return load_frame(); } );
+
+    std::vector<TaskGraph::TaskId> boundary_loads = { frame };
+    std::vector<TaskGraph::TaskId> contour_loads = { frame };
+    for( size_t index = 0; index < manifest_.sources.size(); ++index ){
+        const Source& source = manifest_.sources[index];
+        const auto load = graph_.add( "load " + source.name, [this, index](){ return load_source(index); }, {frame} );
+        (Source::Boundary == source.target ? boundary_loads : contour_loads).push_back( load );
+    }
+
+    const auto merge_boundary = graph_.add( "merge boundary", [this](){
+            return merge( boundary_scratch_, box_.get_boundary_layer() ); }, boundary_loads );
+    const auto merge_contour = graph_.add( "merge contour", [this](){
+            return merge( contour_scratch_, box_.get_contour_layer() ); }, contour_loads );
+
+    graph_.add( "write boundary", [this](){
+            io::PNGWriter<boundary_layer_t> writer( box_.get_boundary_layer() );
+            return writer.write_to_path( manifest_.output + "/boundary.png" ); }, {merge_boundary} );
+    graph_.add( "write contour", [this](){
+            io::PNGWriter<contour_layer_t> writer( box_.get_contour_layer() );
+            return writer.write_to_path( manifest_.output + "/contour.tif" ); }, {merge_contour} );
+}
+
+bool ChartCompiler::compile(){
+    CHARTBOX_PROBE_SCOPE( "compiler.compile" );
+    const bool succeeded = graph_.run( thread_count_ );
+    return write_package( succeeded ) && succeeded;
+}
+
+bool ChartCompiler::load_frame(){
+    Vector2d min_lon_lat = manifest_.min_lon_lat;
+    Vector2d max_lon_lat = manifest_.max_lon_lat;
+    if( ! manifest_.has_bounds ){
+        const auto first = std::find_if( manifest_.sources.begin(), manifest_.sources.end(),
+                                         [](const Source& source){ return Source::GeoJSON == source.type; } );
+        if( (manifest_.sources.end() == first) || (! load_bounding_box(first->path, min_lon_lat, max_lon_lat)) ){
+            fmt::print( stderr, "!! Manifest has no 'bounds'; and no GeoJSON source with a 'bbox'\n" );
+            return false;
+        }
+    }
+    if( ! box_.mapping().move_local_bounds(min_lon_lat, max_lon_lat) ){
+        return false;
+    }
+    if( ! make_directories(manifest_.output) ){
+        fmt::print( stderr, "!! Could not create output directory: {}\n", manifest_.output );
+        return false;
+    }
+
+    // each load needs its own transforms; and constructing a frame is not thread-safe
+    const size_t count = manifest_.sources.size();
+    frames_.clear();
+    frames_.resize( count );
+    boundary_scratch_.clear();
+    boundary_scratch_.resize( count );
+    contour_scratch_.clear();
+    contour_scratch_.resize( count );
+    for( size_t index = 0; index < count; ++index ){
+        frames_[index] = std::make_unique<FrameMapping>();
+        if( ! frames_[index]->move_local_bounds(min_lon_lat, max_lon_lat) ){
+            return false;
+        }
+        if( Source::Boundary == manifest_.sources[index].target ){
+            boundary_scratch_[index] = std::make_unique<boundary_layer_t>( box_.mapping().utm_bounds() );
+            boundary_scratch_[index]->fill( boundary_layer_t::default_value );
+        }else{
+            contour_scratch_[index] = std::make_unique<contour_layer_t>( box_.mapping().utm_bounds() );
+            contour_scratch_[index]->fill( contour_layer_t::default_value );
+        }
+    }
+    return true;
+}
+
+bool ChartCompiler::load_source( const size_t index ){
+    const Source& source = manifest_.sources[index];
+    bool loaded;
+    if( Source::Boundary == source.target ){
+        loaded = load_into( source, *frames_[index], *boundary_scratch_[index] );
+    }else{
+        loaded = load_into( source, *frames_[index], *contour_scratch_[index] );
+    }
+    if( ! loaded ){
+        fmt::print( stderr, "!! Could not load source '{}' from: {}\n", source.name, source.path );
+    }
+    return loaded;
+}
+
+template<typename layer_t>
+bool ChartCompiler::load_into( const Source& source, FrameMapping& mapping, layer_t& layer ){
+    const auto value = static_cast<typename layer_t::cell_t>( source.value );
+    switch( source.type ){
+        case Source::GeoJSON: {
+            // the chart's bounds are already set; so the document's bounds are not used
+            io::GeoJSONLoader<layer_t> loader( mapping, layer, value, false );
+            return loader.load_file( source.path );
+        }
+        case Source::Shapefile:
+            return load_shapefile( source, mapping, layer );
+        case Source::Raster: {
+            io::RasterLoader<layer_t> loader( mapping, layer, source.method, load_thread_count_ );
+            return loader.load_file( source.path );
+        }
+        case Source::Points:
+            return load_points( source, mapping, layer );
+    }
+    return false;
+}
+
+template<typename layer_t>
+bool ChartCompiler::load_shapefile( const Source& source, FrameMapping& mapping, layer_t& layer ){
+    auto* dataset = static_cast<GDALDataset*>( GDALOpenEx(source.path.c_str(), GDAL_OF_VECTOR | GDAL_OF_READONLY, nullptr, nullptr, nullptr) );
+    if( nullptr == dataset ){
+        return false;
+    }
+    OGRLayer* features = dataset->GetLayer( 0 );
+    if( nullptr == features ){
+        GDALClose( dataset );
+        return false;
+    }
+
+    // without a spatial reference, the source is assumed to already be in the chart's UTM frame
+    std::unique_ptr<OGRCoordinateTransformation, decltype(&OGRCoordinateTransformation::DestroyCT)> to_utm( nullptr, &OGRCoordinateTransformation::DestroyCT );
+    if( nullptr != features->GetSpatialRef() ){
+        OGRSpatialReference from( *features->GetSpatialRef() );
+        OGRSpatialReference to( mapping.utm_frame() );
+        from.SetAxisMappingStrategy( OAMS_TRADITIONAL_GIS_ORDER );
+        to.SetAxisMappingStrategy( OAMS_TRADITIONAL_GIS_ORDER );
+        if( ! from.IsSame(&to) ){
+            to_utm.reset( OGRCreateCoordinateTransformation(&from, &to) );
+            if( ! to_utm ){
+                GDALClose( dataset );
+                return false;
+            }
+        }
+    }
+
+    // translate a ring into the layer's frame, as the exterior of a new polygon
+    const Vector2d& origin = mapping.utm_bounds().min();
+    std::vector<double> xs;
+    std::vector<double> ys;
+    const auto to_layer = [&]( const OGRLinearRing& ring ) -> std::unique_ptr<OGRPolygon> {
+        xs.clear();
+        ys.clear();
+        for( const OGRPoint& point : ring ){
+            xs.push_back( point.getX() );
+            ys.push_back( point.getY() );
+        }
+        if( to_utm && (! to_utm->Transform(static_cast<int>(xs.size()), xs.data(), ys.data())) ){
+            return nullptr;
+        }
+        OGRLinearRing local;
+        for( size_t k = 0; k < xs.size(); ++k ){
+            local.addPoint( xs[k] - origin.x(), ys[k] - origin.y() );
+        }
+        auto polygon = std::make_unique<OGRPolygon>();
+        polygon->addRing( &local );
+        return polygon;
+    };
+
+    // inside each polygon: the source's value; inside its holes: not covered by this source
+    const auto value = static_cast<typename layer_t::cell_t>( source.value );
+    bool loaded = true;
+    std::vector<const OGRPolygon*> polygons;
+    features->ResetReading();
+    for( OGRFeature* feature = features->GetNextFeature(); (nullptr != feature) && loaded; feature = features->GetNextFeature() ){
+        const OGRGeometry* geometry = feature->GetGeometryRef();
+        polygons.clear();
+        if( (nullptr != geometry) && (wkbPolygon == wkbFlatten(geometry->getGeometryType())) ){
+            polygons.push_back( geometry->toPolygon() );
+        }else if( (nullptr != geometry) && (wkbMultiPolygon == wkbFlatten(geometry->getGeometryType())) ){
+            for( const OGRPolygon* polygon : *geometry->toMultiPolygon() ){
+                polygons.push_back( polygon );
+            }
+        }
+        for( const OGRPolygon* polygon : polygons ){
+            auto exterior = to_layer( *polygon->getExteriorRing() );
+            loaded = loaded && exterior && layer.fill( std::move(exterior), value );
+            for( int k = 0; loaded && (k < polygon->getNumInteriorRings()); ++k ){
+                auto hole = to_layer( *polygon->getInteriorRing(k) );
+                loaded = hole && layer.fill( std::move(hole), layer_t::default_value );
+            }
+        }
+        OGRFeature::DestroyFeature( feature );
+    }
+
+    GDALClose( dataset );
+    return loaded;
+}
+
+template<typename layer_t>
+bool ChartCompiler::load_points( const Source& source, FrameMapping& mapping, layer_t& layer ){
+    std::ifstream stream( source.path );
+    if( ! stream ){
+        return false;
+    }
+
+    typedef typename layer_t::cell_t cell_t;
+    const Vector2d& origin = mapping.utm_bounds().min();
+    const Vector2d extent = mapping.utm_bounds().sizes();
+    const auto value = static_cast<cell_t>( source.value );
+
+    std::string line;
+    size_t line_number = 0;
+    size_t point_count = 0;
+    while( std::getline(stream, line) ){
+        ++line_number;
+        if( line.empty() || ('#' == line[0]) ){
+            continue;
+        }
+        std::istringstream fields( line );
+        double easting, northing, z;
+        if( ! (fields >> easting >> northing >> z) ){
+            fmt::print( stderr, "!! {}:{}: expected: easting northing value\n", source.path, line_number );
+            return false;
+        }
+        const Vector2d local( easting - origin.x(), northing - origin.y() );
+        if( (local.x() < 0) || (local.y() < 0) || (extent.x() <= local.x()) || (extent.y() <= local.y()) ){
+            continue;
+        }
+
+        // the boundary marks each point's cell; the contour keeps the shallowest point in each cell -- depths
+        // are negative elevations, so the shallowest is the highest
+        // (written through `store(...)`, which keeps the layer's occupancy counts and changed tiles current)
+        const cell_t cell = layer.get( local );
+        if( Source::Boundary == source.target ){
+            layer.store( local, value );
+        }else{
+            const cell_t depth = static_cast<cell_t>( z );
+            layer.store( local, (layer_t::default_value == cell) ? depth : std::max(cell, depth) );
+        }
+        ++point_count;
+    }
+    CHARTBOX_PROBE_COUNT( "compiler.points", point_count );
+    return true;
+}
+
+template<typename layer_t>
+bool ChartCompiler::merge( const std::vector<std::unique_ptr<layer_t>>& scratch, layer_t& destination ){
+    typedef typename layer_t::cell_t cell_t;
+    constexpr size_t dimension = layer_t::dimension;
+    const double precision = destination.precision();
+
+    std::vector<cell_t> cells( dimension * dimension, layer_t::default_value );
+    std::vector<int> priorities( dimension * dimension, std::numeric_limits<int>::lowest() );
+    for( size_t index = 0; index < scratch.size(); ++index ){
+        if( ! scratch[index] ){
+            continue;
+        }
+        const layer_t& layer = *scratch[index];
+        const int priority = manifest_.sources[index].priority;
+        for( size_t j = 0; j < dimension; ++j ){
+            for( size_t i = 0; i < dimension; ++i ){
+                const cell_t value = layer.get({ (i + 0.5) * precision, (j + 0.5) * precision });
+                const size_t offset = j*dimension + i;
+                if( layer_t::default_value == value ){
+                    continue;  // not covered by this source
+                }else if( priorities[offset] < priority ){
+                    cells[offset] = value;
+                    priorities[offset] = priority;
+                }else if( priorities[offset] == priority ){
+                    cells[offset] = std::max( cells[offset], value );
+                }
+            }
+        }
+    }
+    return destination.fill( cells );
+}
+
+bool ChartCompiler::write_package( const bool succeeded ){
+    CPLJSONDocument document;
+    CPLJSONObject root = document.GetRoot();
+    root.Add( "succeeded", succeeded );
+
+    const auto& global = box_.mapping().global_bounds();
+    CPLJSONArray bounds;
+    for( const double each : {global.min().x(), global.min().y(), global.max().x(), global.max().y()} ){
+        bounds.Add( each );
+    }
+    root.Add( "bounds", bounds );
+
+    const auto& utm = box_.mapping().utm_bounds();
+    CPLJSONArray utm_bounds;
+    for( const double each : {utm.min().x(), utm.min().y(), utm.max().x(), utm.max().y()} ){
+        utm_bounds.Add( each );
+    }
+    root.Add( "utm_bounds", utm_bounds );
+
+    CPLJSONArray layers;
+    const auto add_layer = [&layers]( const char* name, const char* path, const size_t dimension, const double precision ){
+        CPLJSONObject layer;
+        layer.Add( "name", name );
+        layer.Add( "path", path );
+        layer.Add( "dimension", static_cast<int>(dimension) );
+        layer.Add( "precision", precision );
+        layers.Add( layer );
+    };
+    add_layer( "boundary", "boundary.png", boundary_layer_t::dimension, box_.get_boundary_layer().precision() );
+    add_layer( "contour", "contour.tif", contour_layer_t::dimension, box_.get_contour_layer().precision() );
+    root.Add( "layers", layers );
+
+    CPLJSONArray sources;
+    for( const Source& source : manifest_.sources ){
+        CPLJSONObject each;
+        each.Add( "name", source.name );
+        each.Add( "path", source.path );
+        each.Add( "layer", (Source::Boundary == source.target) ? "boundary" : "contour" );
+        each.Add( "priority", source.priority );
+        sources.Add( each );
+    }
+    root.Add( "sources", sources );
+
+    CPLJSONArray stages;
+    for( const auto& timing : graph_.timings() ){
+        CPLJSONObject stage;
+        stage.Add( "name", timing.name );
+        stage.Add( "worker", static_cast<int>(timing.worker) );
+        stage.Add( "start", timing.start );
+        stage.Add( "seconds", timing.finish - timing.start );
+        stage.Add( "status", timing.skipped ? "skipped" : (timing.succeeded ? "ok" : "failed") );
+        stages.Add( stage );
+    }
+    root.Add( "stages", stages );
+
+    const std::string path = manifest_.output + "/chart.json";
+    if( ! document.Save(path) ){
+        fmt::print( stderr, "!! Could not write chart package: {}\n", path );
+        return false;
+    }
+    return true;
+}
+
+void ChartCompiler::print_timings( std::FILE* sink ) const {
+    double wall = 0;
+    double busy = 0;
+    fmt::print( sink, "============ ============ Stages ============ ============\n" );
+    fmt::print( sink, "{:<32} {:>8} {:>10} {:>10} {:>8}\n", "stage", "worker", "start", "seconds", "status" );
+    for( const auto& timing : graph_.timings() ){
+        const double seconds = timing.finish - timing.start;
+        fmt::print( sink, "{:<32} {:>8} {:>10.3f} {:>10.3f} {:>8}\n", timing.name, timing.worker, timing.start, seconds,
+                    timing.skipped ? "skipped" : (timing.succeeded ? "ok" : "failed") );
+        wall = std::max( wall, timing.finish );
+        busy += seconds;
+    }
+    fmt::print( sink, "<< {} stages on {} threads: {:.3f} s wall, {:.3f} s busy\n", graph_.size(), thread_count_, wall, busy );
+}
@@ -0,0 +1,158 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include "chart-box.hpp"
+#include "io/chart-raster-loader.hpp"
+
+#include "task-graph.hpp"
+
+namespace chartbox::merge {
+
+/// \brief one input of a chart build
+struct Source {
+    enum Type { GeoJSON, Shapefile, Raster, Points };
+    enum Target { Boundary, Contour };
+
+    std::string name;
+    Type type;
+    std::string path;
+    Target target;
+
+    /// where two sources cover the same cell, the higher priority wins
+    int priority = 0;
+
+    /// written inside each polygon (GeoJSON, Shapefile), or at each point (Points, into the boundary layer)
+    double value = 0;
+
+    /// how a raster is resampled onto the layer
+    io::Resample method = io::Resample::Bilinear;
+};
+
+/// \brief describes a chart build; loaded from a JSON file:
+///
+/// ```
+/// {
+///     "bounds": [ west, south, east, north ],    // optional; else the "bbox" of the first GeoJSON source
+///     "output": "build/block-island",             // directory to write the packaged chart into
+///     "threads": 4,                               // optional; else one per core
+///     "sources": [
+///         { "name": "coast", "type": "geojson", "path": "...", "layer": "boundary", "value": "clear" },
+///         { "name": "soundings", "type": "raster", "path": "...", "layer": "contour", "priority": 1, "method": "maximum" },
+///         ...
+///     ]
+/// }
+/// ```
+///
+/// Source types are `geojson`, `shapefile`, `raster` and `points` (text lines of: `easting northing value`,
+/// in the chart's UTM frame).  Boundary values may also be given as `"clear"` or `"blocked"`.
+struct Manifest {
+    bool has_bounds = false;
+    Eigen::Vector2d min_lon_lat;
+    Eigen::Vector2d max_lon_lat;
+
+    std::string output;
+    size_t thread_count = 0;
+
+    std::vector<Source> sources;
+
+    /// \brief parse a manifest file
+    ///
+    /// Relative source paths are relative to the manifest's directory; but the output path is relative to
+    /// the working directory.
+    /// \return false (and reports why) if the manifest is invalid
+    static bool load( const std::string& path, Manifest& manifest );
+};
+
+/// \brief Builds a chart from many sources at once
+///
+/// ## Implementation Specifics
+/// The build is a dependency graph of stages, on a pool of threads (see `TaskGraph`):
+///
+///     frame --> load <source> (each) --> merge <layer> (each) --> write <layer> (each)
+///
+/// Each source loads into its own scratch layer, through its own `FrameMapping` (neither GDAL's coordinate
+/// transforms, nor the layers, may be shared between threads); so every source loads concurrently.  A raster
+/// load also reads its blocks in parallel; but only on its share of the build's threads.  Then
+/// each layer merges its sources, cell by cell:
+///   - a cell takes the value of the highest-priority source which covers it;
+///   - between sources of equal priority, a cell takes the higher value: in the boundary layer, the more-blocked
+///     value; and in the contour layer -- whose depths are negative elevations -- the shallower depth;
+///   - cells no source covers keep the layer's `default_value`.
+///
+/// Finally, the layers are written into the output directory -- the boundary as a PNG, and the contour
+/// (real depths) as a GeoTIFF -- beside a `chart.json` which describes the chart, its sources, and the
+/// time each stage took.
+class ChartCompiler {
+public:
+    typedef ChartBox::boundary_layer_t boundary_layer_t;
+    typedef ChartBox::contour_layer_t contour_layer_t;
+
+    /// written for `"blocked"` boundary values
+    constexpr static uint8_t blocked_value = 0x99;
+
+public:
+    ChartCompiler( const Manifest& _manifest );
+
+    /// \brief run every stage of the build
+    /// \return true if every stage succeeded
+    bool compile();
+
+    /// \brief print the timing of each stage of the most recent build
+    void print_timings( std::FILE* sink ) const;
+
+    ChartBox& chart() { return box_; }
+
+private:
+    /// \brief move the chart to the manifest's bounds; and prepare one frame and scratch layer per source
+    bool load_frame();
+
+    bool load_source( const size_t index );
+
+    template<typename layer_t>
+    bool load_into( const Source& source, FrameMapping& mapping, layer_t& layer );
+
+    template<typename layer_t>
+    bool load_shapefile( const Source& source, FrameMapping& mapping, layer_t& layer );
+
+    template<typename layer_t>
+    bool load_points( const Source& source, FrameMapping& mapping, layer_t& layer );
+
+    /// \brief merge the scratch layers of every source with this target, into the chart's layer
+    template<typename layer_t>
+    bool merge( const std::vector<std::unique_ptr<layer_t>>& scratch, layer_t& destination );
+
+    bool write_package( const bool succeeded );
+
+private:
+    Manifest manifest_;
+    size_t thread_count_;
+
+    /// \brief threads each raster load may read blocks on
+    ///
+    /// Every load becomes ready at once (after the frame), and runs on one of the graph's threads; so the
+    /// graph's threads are shared among the loads which may run concurrently, rather than each load
+    /// starting another `thread_count_` of its own.
+    size_t load_thread_count_;
+
+    ChartBox box_;
+
+    /// one per source; each for that source's load only
+    std::vector<std::unique_ptr<FrameMapping>> frames_;
+    std::vector<std::unique_ptr<boundary_layer_t>> boundary_scratch_;
+    std::vector<std::unique_ptr<contour_layer_t>> contour_scratch_;
+
+    TaskGraph graph_;
+
+}; // class ChartCompiler
+
+} // namespace chartbox::merge
@@ -0,0 +1,76 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Geometry>
+
+#include <gdal.h>
+
+#include "chart-compiler.hpp"
+
+using Eigen::Vector2d;
+
+namespace chartbox::merge {
+
+// about Block Island
+static const Vector2d min_lon_lat( -71.661, 41.105 );
+static const Vector2d max_lon_lat( -71.475, 41.255 );
+
+/// \brief a points source for the contour layer, with one sounding at each given location (in the layer's frame)
+static Source write_soundings( const std::string& name, const Vector2d& origin, const std::vector<std::pair<Vector2d,double>>& soundings, const int priority = 0 ){
+    Source source;
+    source.name = name;
+    source.type = Source::Points;
+    source.path = testing::TempDir() + name + ".xyz";
+    source.target = Source::Contour;
+    source.priority = priority;
+
+    std::ofstream stream( source.path );
+    for( const auto& [location, depth] : soundings ){
+        stream << (origin.x() + location.x()) << ' ' << (origin.y() + location.y()) << ' ' << depth << '\n';
+    }
+    return source;
+}
+
+TEST( ChartCompiler, MergeContourKeepsShallowerDepth ){
+    GDALAllRegister();
+
+    FrameMapping frame;
+    ASSERT_TRUE( frame.move_local_bounds(min_lon_lat, max_lon_lat) );
+    const Vector2d origin = frame.utm_bounds().min();
+
+    // depths are negative elevations: -5 is shallower than -12
+    const Vector2d shared( 1000.5, 1000.5 );
+    const Vector2d single( 3000.5, 3000.5 );
+    const Vector2d outranked( 5000.5, 5000.5 );
+
+    Manifest manifest;
+    manifest.has_bounds = true;
+    manifest.min_lon_lat = min_lon_lat;
+    manifest.max_lon_lat = max_lon_lat;
+    manifest.output = testing::TempDir() + "chart-compiler.chart";
+    manifest.thread_count = 2;
+    manifest.sources = {
+        write_soundings( "deep", origin, {{shared, -12}, {single, -12}, {single, -7}, {outranked, -3}} ),
+        write_soundings( "shallow", origin, {{shared, -5}} ),
+        write_soundings( "surveyed", origin, {{outranked, -20}}, 1 ),
+    };
+
+    ChartCompiler compiler( manifest );
+    ASSERT_TRUE( compiler.compile() );
+    const auto& contour = compiler.chart().get_contour_layer();
+
+    // between sources of equal priority
+    EXPECT_FLOAT_EQ( contour.get(shared), -5 );
+    // between the points of one source, in one cell
+    EXPECT_FLOAT_EQ( contour.get(single), -7 );
+    // ... but a higher-priority source wins outright, even when deeper
+    EXPECT_FLOAT_EQ( contour.get(outranked), -20 );
+    // not covered by any source
+    EXPECT_EQ( contour.get({7000.5, 7000.5}), ChartCompiler::contour_layer_t::default_value );
+}
+
+} // namespace chartbox::merge
@@ -0,0 +1,169 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace chartbox::merge {
+
+/// \brief runs a dependency graph of tasks on a pool of threads
+///
+/// Each task starts as soon as every task it depends on has finished; independent tasks run concurrently.
+/// A task may only depend on tasks added before it; so the graph is acyclic by construction.
+///
+/// A task fails by returning false: then no task which (transitively) depends on it is started, but the
+/// rest of the graph still runs to completion.
+class TaskGraph {
+public:
+    typedef size_t TaskId;
+
+    /// \brief when, and where, one task ran
+    struct Timing {
+        std::string name;
+        /// seconds since `run()` started; both zero if the task was skipped
+        double start;
+        double finish;
+        /// index of the worker which ran this task
+        uint32_t worker;
+        bool succeeded;
+        /// true if the task never ran, because a dependency failed
+        bool skipped;
+    };
+
+public:
+    /// \brief add a task
+    ///
+    /// \param name - describes this task, in its timing
+    /// \param work - the task itself; returns false on failure
+    /// \param dependencies - tasks which must succeed before this task starts
+    /// \return this task's id; for use as a later task's dependency
+    TaskId add( std::string name, std::function<bool()> work, const std::vector<TaskId>& dependencies = {} ){
+        const TaskId id = tasks_.size();
+        tasks_.push_back({ std::move(name), std::move(work), {}, 0 });
+        for( const TaskId dependency : dependencies ){
+            if( dependency < id ){
+                tasks_[dependency].dependents.push_back( id );
+                ++tasks_[id].dependency_count;
+            }
+        }
+        return id;
+    }
+
+    /// \brief run every task, on up to `thread_count` threads -- including this one
+    ///
+    /// \return true if every task succeeded
+    bool run( const size_t thread_count ){
+        const std::lock_guard<std::mutex> run_lock( run_mutex_ );
+        timings_.assign( tasks_.size(), {"", 0, 0, 0, false, false} );
+        waiting_.resize( tasks_.size() );
+        poisoned_.assign( tasks_.size(), false );
+        ready_.clear();
+        for( TaskId id = 0; id < tasks_.size(); ++id ){
+            timings_[id].name = tasks_[id].name;
+            waiting_[id] = tasks_[id].dependency_count;
+            if( 0 == waiting_[id] ){
+                ready_.push_back( id );
+            }
+        }
+        remaining_ = tasks_.size();
+        succeeded_ = true;
+        epoch_ = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> helpers;
+        for( uint32_t worker = 1; worker < std::max<size_t>(1, thread_count); ++worker ){
+            helpers.emplace_back( &TaskGraph::work, this, worker );
+        }
+        work( 0 );
+        for( auto& helper : helpers ){
+            helper.join();
+        }
+        return succeeded_;
+    }
+
+    /// \brief timings of the most recent run; in the order the tasks were added
+    const std::vector<Timing>& timings() const { return timings_; }
+
+    size_t size() const { return tasks_.size(); }
+
+private:
+    struct Task {
+        std::string name;
+        std::function<bool()> work;
+        std::vector<TaskId> dependents;
+        size_t dependency_count;
+    };
+
+    /// \brief one worker: run ready tasks until every task has finished
+    void work( const uint32_t worker ){
+        std::unique_lock<std::mutex> lock( mutex_ );
+        while( true ){
+            changed_.wait( lock, [this](){ return (! ready_.empty()) || (0 == remaining_); } );
+            if( ready_.empty() ){
+                return;
+            }
+            const TaskId id = ready_.front();
+            ready_.pop_front();
+
+            Timing& timing = timings_[id];
+            timing.worker = worker;
+            if( poisoned_[id] ){
+                timing.skipped = true;
+            }else{
+                lock.unlock();
+                const double start = seconds_since_epoch();
+                const bool succeeded = tasks_[id].work();
+                const double finish = seconds_since_epoch();
+                lock.lock();
+                timing.start = start;
+                timing.finish = finish;
+                timing.succeeded = succeeded;
+            }
+
+            succeeded_ = succeeded_ && timing.succeeded;
+            for( const TaskId dependent : tasks_[id].dependents ){
+                poisoned_[dependent] = poisoned_[dependent] || (! timing.succeeded);
+                if( 0 == --waiting_[dependent] ){
+                    ready_.push_back( dependent );
+                }
+            }
+            --remaining_;
+            changed_.notify_all();
+        }
+    }
+
+    double seconds_since_epoch() const {
+        return std::chrono::duration<double>( std::chrono::steady_clock::now() - epoch_ ).count();
+    }
+
+private:
+    std::vector<Task> tasks_;
+
+    /// held for the whole of `run()`
+    std::mutex run_mutex_;
+
+    /// guards everything below
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<TaskId> ready_;
+    std::vector<size_t> waiting_;
+    std::vector<bool> poisoned_;
+    std::vector<Timing> timings_;
+    size_t remaining_ = 0;
+    bool succeeded_ = true;
+
+    std::chrono::steady_clock::time_point epoch_;
+
+}; // class TaskGraph
+
+} // namespace chartbox::merge
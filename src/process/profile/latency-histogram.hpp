@@ -0,0 +1,97 @@
+// GPL v3 (c) 2021, Daniel Williams
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace chartbox::profile {
+
+/// \brief HDR-style latency histogram: log-linear buckets, with a fixed relative precision
+///
+/// Values below `2^precision_bits` are counted exactly.  Above that, each power of two is split into
+/// `2^precision_bits` equal sub-buckets; so any recorded value is reported within `2^-precision_bits`
+/// (< 1%) of its true value -- from nanoseconds up to hours -- in a fixed ~58 kB of counts.
+///
+/// Not thread-safe: record into one histogram per thread, and `merge(...)` them afterwards.
+class LatencyHistogram {
+public:
+    constexpr static uint32_t precision_bits = 7;
+    constexpr static uint64_t sub_bucket_count = uint64_t(1) << precision_bits;
+    constexpr static size_t bucket_count = (65 - precision_bits) * sub_bucket_count;
+
+public:
+    LatencyHistogram()
+        : counts_( bucket_count, 0 )
+    {}
+
+    inline void record( const uint64_t value ){
+        ++counts_[ index_of(value) ];
+        ++count_;
+        total_ += value;
+        maximum_ = (maximum_ < value) ? value : maximum_;
+    }
+
+    void merge( const LatencyHistogram& other ){
+        for( size_t index = 0; index < bucket_count; ++index ){
+            counts_[index] += other.counts_[index];
+        }
+        count_ += other.count_;
+        total_ += other.total_;
+        maximum_ = (maximum_ < other.maximum_) ? other.maximum_ : maximum_;
+    }
+
+    inline uint64_t count() const { return count_; }
+    inline uint64_t maximum() const { return maximum_; }
+    inline double mean() const { return (0 == count_) ? 0. : static_cast<double>(total_) / count_; }
+
+    /// \brief the smallest recorded value which is at-or-above the given fraction of all values
+    ///
+    /// \param quantile - in [0, 1]; e.g. 0.999 for the 99.9th percentile
+    /// \return the upper edge of the bucket holding that value; or 0 if the histogram is empty
+    uint64_t percentile( const double quantile ) const {
+        if( 0 == count_ ){
+            return 0;
+        }
+        const double target = quantile * count_;
+        uint64_t seen = 0;
+        for( size_t index = 0; index < bucket_count; ++index ){
+            seen += counts_[index];
+            if( (0 < counts_[index]) && (target <= seen) ){
+                const uint64_t upper = upper_bound_of( index );
+                return (upper < maximum_) ? upper : maximum_;
+            }
+        }
+        return maximum_;
+    }
+
+    /// \brief bucket of the given value
+    inline static size_t index_of( const uint64_t value ){
+        if( value < sub_bucket_count ){
+            return static_cast<size_t>( value );
+        }
+        const uint32_t magnitude = 63 - __builtin_clzll( value );           // >= precision_bits
+        const uint32_t shift = magnitude - precision_bits;
+        const uint64_t mantissa = (value >> shift) - sub_bucket_count;     // in [0, sub_bucket_count)
+        return static_cast<size_t>( (shift + 1) * sub_bucket_count + mantissa );
+    }
+
+    /// \brief largest value which falls in the given bucket
+    inline static uint64_t upper_bound_of( const size_t index ){
+        if( index < sub_bucket_count ){
+            return index;
+        }
+        const uint32_t shift = static_cast<uint32_t>( index / sub_bucket_count ) - 1;
+        const uint64_t mantissa = (index % sub_bucket_count) + sub_bucket_count;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+private:
+    std::vector<uint64_t> counts_;
+    uint64_t count_ = 0;
+    uint64_t total_ = 0;
+    uint64_t maximum_ = 0;
+};
+
+} // namespace chartbox::profile
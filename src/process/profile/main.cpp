@@ -1,155 +1,304 @@
-// GPL v3 (c) 2020
+// GPL v3 (c) 2021, Daniel Williams
 
+// Concurrent query load generator: N threads issue a weighted mix of queries against one chart, and
+// report the latency percentiles and throughput of each kind of query.
+//
+// In closed-loop mode (the default) each thread issues its next query as soon as the last one returns.
+// In open-loop mode (`--rate`) queries are scheduled at fixed intervals, and each latency is measured
+// from the query's *scheduled* start; so a stalled thread is charged for the queries queued behind it.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
-#include <iostream>
+#include <iterator>
+#include <numeric>
 #include <random>
-#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
 
-#include <sys/stat.h> // may not be standard
+#include <getopt.h>
 
-using std::cerr;
+#include <Eigen/Geometry>
+#include <fmt/core.h>
 
-#include <cxxopts/cxxopts.hpp>
+#include <gdal.h>
 
-#include <Eigen/Geometry>
+#include "chart-box/chart-box.hpp"
+#include "io/chart-geojson-loader.hpp"
+#include "probe/probe.hpp"
+#include "search/hpa-star.hpp"
 
-#include <nlohmann/json.hpp>
-using nlohmann::json;
+#include "latency-histogram.hpp"
 
-// #include "node/quad_node.hpp"
-// #include "node/tile_node.hpp"
-#include "world_tree.hpp"
-#include "io/readers.hpp"
-#include "io/writers.hpp"
+using Eigen::AlignedBox2d;
+using Eigen::Vector2d;
 
-using namespace yggdrasil::io;
+using chartbox::ChartBox;
+using chartbox::profile::LatencyHistogram;
 
-using yggdrasil::grid::Grid;
-using yggdrasil::quadtree::Tree;
-using yggdrasil::WorldTree;
+typedef ChartBox::boundary_layer_t layer_t;
 
-constexpr double boundary_width = 4096.;
-constexpr double desired_precision = 1.0;
-// =====
-const json source = yggdrasil::generate_diamond(  boundary_width, desired_precision);
+namespace {
 
-constexpr size_t test_seed = 55;
-static std::mt19937 generator;
+enum QueryKind { Get=0, BatchGet=1, Raycast=2, Plan=3 };
+constexpr size_t query_kind_count = 4;
+const char* query_names[query_kind_count] = { "get", "batch", "raycast", "plan" };
 
+struct Options {
+    std::string input_path;           ///< GeoJSON boundary; if empty, generate a synthetic chart
+    size_t thread_count = std::max( 1u, std::thread::hardware_concurrency() );
+    double duration = 5.0;            ///< seconds
+    double rate = 0;                  ///< total queries per second, across all threads; 0 => closed-loop
+    size_t batch_size = 64;           ///< points per batch-get
+    std::vector<double> mix = { 70, 20, 9, 1 };   ///< relative weight of each QueryKind
+    std::string json_path;            ///< if set, also write the results here
+    uint32_t seed = 55;
+};
 
-cxxopts::Options command_line_options("Profiler", "Run metrics and speed tests of the Yggdrasil library");
+/// \brief results of one worker thread
+struct Results {
+    std::array<LatencyHistogram, query_kind_count> latencies;
+    uint64_t checksum = 0;    ///< sum of every value read; keeps the reads from being optimized out
+};
 
-void configure_parser_options(cxxopts::Options& opts){
-    // define command line options
-    opts.add_options()
-        // ("d,debug", "Enable debugging")
-        ("i,input", "input json path", cxxopts::value<std::string>())
-        ("c,count", "Iteration Count", cxxopts::value<size_t>())
-        ("o,image", "Output image filen name", cxxopts::value<std::string>())
-    ;
+void print_usage(){
+    fmt::print( "usage: profile [options]\n"
+                "    -i, --input <path>       load the boundary from this GeoJSON file (default: synthetic chart)\n"
+                "    -t, --threads <count>    worker threads (default: hardware concurrency)\n"
+                "    -d, --duration <secs>    length of the run (default: 5)\n"
+                "    -r, --rate <queries/s>   open-loop: total rate across all threads (default: closed-loop)\n"
+                "    -m, --mix <weights>      e.g. 'get=70,batch=20,raycast=9,plan=1'\n"
+                "    -b, --batch <count>      points per batch-get (default: 64)\n"
+                "    -j, --json <path>        also write the results as JSON\n"
+                "    -s, --seed <seed>\n" );
 }
 
-void profile_tree(const WorldTree& worldtree, const size_t iteration_limit){
-    const double max = worldtree.get_layout().get_x_max();
-    const double min = worldtree.get_layout().get_x_min();
+bool parse_mix( const std::string& text, std::vector<double>& mix ){
+    std::fill( mix.begin(), mix.end(), 0 );
+    size_t start = 0;
+    while( start < text.size() ){
+        const size_t comma = std::min( text.find(',', start), text.size() );
+        const std::string term = text.substr( start, comma - start );
+        const size_t equals = term.find('=');
+        if( std::string::npos == equals ){
+            return false;
+        }
+        const std::string name = term.substr( 0, equals );
+        const auto* found = std::find_if( std::begin(query_names), std::end(query_names), [&](const char* each){ return name == each; } );
+        if( std::end(query_names) == found ){
+            return false;
+        }
+        mix[ found - std::begin(query_names) ] = std::atof( term.c_str() + equals + 1 );
+        start = comma + 1;
+    }
+    return 0 < std::accumulate( mix.begin(), mix.end(), 0.0 );
+}
 
-    generator.seed(test_seed);
+bool parse_options( int argc, char* argv[], Options& options ){
+    const option long_options[] = {
+        { "input",    required_argument, nullptr, 'i' },
+        { "threads",  required_argument, nullptr, 't' },
+        { "duration", required_argument, nullptr, 'd' },
+        { "rate",     required_argument, nullptr, 'r' },
+        { "mix",      required_argument, nullptr, 'm' },
+        { "batch",    required_argument, nullptr, 'b' },
+        { "json",     required_argument, nullptr, 'j' },
+        { "seed",     required_argument, nullptr, 's' },
+        { "help",     no_argument,       nullptr, 'h' },
+        { nullptr, 0, nullptr, 0 } };
 
-    std::cout << ">> Starting testing:\n";
-    cell_value_t dump = 0;
-    
-    auto start = std::chrono::high_resolution_clock::now(); 
-    size_t iteration = 0;
-    for( iteration = 0; iteration < iteration_limit; ++iteration ){
-        const double x = static_cast<double>(generator()) / generator.max() * max + min;
+    int flag;
+    while( -1 != (flag = getopt_long(argc, argv, "i:t:d:r:m:b:j:s:h", long_options, nullptr)) ){
+        switch( flag ){
+            case 'i': options.input_path = optarg; break;
+            case 't': options.thread_count = std::max( 1, std::atoi(optarg) ); break;
+            case 'd': options.duration = std::atof(optarg); break;
+            case 'r': options.rate = std::atof(optarg); break;
+            case 'b': options.batch_size = std::max( 1, std::atoi(optarg) ); break;
+            case 'j': options.json_path = optarg; break;
+            case 's': options.seed = static_cast<uint32_t>( std::atoi(optarg) ); break;
+            case 'm':
+                if( ! parse_mix(optarg, options.mix) ){
+                    fmt::print( stderr, "!! could not parse the query mix: '{}'\n", optarg );
+                    return false;
+                }
+                break;
+            default:
+                print_usage();
+                return false;
+        }
+    }
+    return true;
+}
 
-        const double y = static_cast<double>(generator()) / generator.max() * max + min;
-        //std::cout << "random value: x: " << x << ", " << y << '\n';
+/// \brief scatter blocked boxes over ~25% of the layer, leaving the rest clear
+void generate_chart( layer_t& layer, const uint32_t seed ){
+    const double width = layer.width();
+    std::mt19937 generator( seed );
+    std::uniform_real_distribution<double> corner( 0, width );
+    const double size = width / 16;
 
-        dump = worldtree.classify({x,y});
-        //std::cout << "             =>: " << static_cast<int>(value) << '\n';
+    layer.fill( layer_t::clear_value );
+    for( size_t count = 0; count < 64; ++count ){
+        const Vector2d low( corner(generator), corner(generator) );
+        layer.fill( AlignedBox2d(low, low + Vector2d(size, size)), 0x99 );
     }
-    auto stop = std::chrono::high_resolution_clock::now(); 
-
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start).count(); 
-  
-    std::cout.imbue(std::locale(""));
-    std::cout << "<< Finished testing:\n";
-    std::cout << "   Ran " << iteration << " iterations in " << duration << " \u03BCs \n\n";
 }
 
+/// \brief issue queries until the deadline; recording the latency of each
+void run_worker( const layer_t& layer, const Options& options, const size_t thread_index,
+                 const std::chrono::steady_clock::time_point start, const std::chrono::steady_clock::time_point deadline,
+                 Results& results ){
+    std::mt19937 generator( options.seed + static_cast<uint32_t>(thread_index) );
+    std::uniform_real_distribution<double> coordinate( 0, layer.width() );
+    std::discrete_distribution<size_t> choose( options.mix.begin(), options.mix.end() );
+    auto random_point = [&](){ return Vector2d( coordinate(generator), coordinate(generator) ); };
+
+    // each planner holds its own workspace; so each thread needs its own
+    chartbox::search::HierarchicalAStar<layer_t> planner( layer );
+    std::vector<Vector2d> batch( options.batch_size );
+    std::this_thread::sleep_until( start );
+
+    const bool open_loop = (0 < options.rate);
+    const auto interval = std::chrono::nanoseconds( open_loop ? static_cast<int64_t>(1e9 * options.thread_count / options.rate) : 0 );
+    // stagger the threads' schedules across one interval
+    auto scheduled = start + (interval * static_cast<int64_t>(thread_index)) / static_cast<int64_t>(options.thread_count);
 
-int main(int argc, char* argv[]){
-    std::string filename;
-    std::unique_ptr<std::istream> document_stream;
-    size_t trial_size = 10;
-    
-    configure_parser_options(command_line_options);
-    auto result = command_line_options.parse(argc, argv);
-
-    // configure input:
-    if( 0 == result.count("input")){
-        cerr << "  ## using default input.\n";
-        // load default json source data
-        filename = "<default>";
-        document_stream.reset(new std::istringstream(source.dump()));
-    }else if( 0 < result.count("input")){
-        filename = result["opt"].as<std::string>();
-        cerr << "  ## File input; with:  " << filename << endl;
-
-        struct stat buf;
-        if( stat(filename.c_str(), &buf) == -1){
-            cerr << "!? could not find file!\n";
-            return -1;
+    while( true ){
+        if( open_loop ){
+            std::this_thread::sleep_until( scheduled );
+        }
+        const auto begin = open_loop ? scheduled : std::chrono::steady_clock::now();
+        if( deadline <= begin ){
+            break;
+        }
+
+        const QueryKind kind = static_cast<QueryKind>( choose(generator) );
+        switch( kind ){
+            case Get:
+                results.checksum += layer.get( random_point() );
+                break;
+            case BatchGet:
+                for( auto& p : batch ){
+                    p = random_point();
+                }
+                for( const auto& p : batch ){
+                    results.checksum += layer.get( p );
+                }
+                break;
+            case Raycast: {
+                Vector2d hit;
+                results.checksum += layer.raycast( random_point(), random_point(), hit ) ? 1 : 0;
+                break; }
+            case Plan:
+                results.checksum += planner.compute( random_point(), random_point() ).size();
+                break;
         }
-        std::ifstream document_stream = std::ifstream(filename);
-    }
 
-    if( 0 < result.count("count")){
-        trial_size = result["count"].as<size_t>();
-        cerr << "    ## Selected Trial Size: " << trial_size << endl;
+        const auto finish = std::chrono::steady_clock::now();
+        results.latencies[kind].record( std::chrono::duration_cast<std::chrono::nanoseconds>(finish - begin).count() );
+        scheduled += interval;
     }
+}
 
-    
-    WorldTree tree;
-    
-    bool write_output = false;
-    std::string output_path;
-    if( 0 < result.count("image")){
-        write_output = true;
-        output_path = result["image"].as<std::string>();
-        if( output_path.empty() ){
-            output_path = "worldtree.output.png";
+std::string to_json( const Options& options, const double elapsed, const std::array<LatencyHistogram, query_kind_count>& latencies ){
+    std::string text = fmt::format( "{{\"threads\": {}, \"duration\": {:.3f}, \"rate\": {}, \"batch\": {}, \"queries\": [",
+                                    options.thread_count, elapsed, options.rate, options.batch_size );
+    bool first = true;
+    for( size_t kind = 0; kind < query_kind_count; ++kind ){
+        const auto& histogram = latencies[kind];
+        if( 0 == histogram.count() ){
+            continue;
         }
-        cerr << "  ## Save output to: " << output_path << '\n';
+        text += fmt::format( "{}\n  {{\"kind\": \"{}\", \"count\": {}, \"throughput\": {:.1f}, \"mean_ns\": {:.1f}, "
+                             "\"p50_ns\": {}, \"p99_ns\": {}, \"p999_ns\": {}, \"max_ns\": {}}}",
+                             first ? "" : ",", query_names[kind], histogram.count(), histogram.count() / elapsed, histogram.mean(),
+                             histogram.percentile(0.5), histogram.percentile(0.99), histogram.percentile(0.999), histogram.maximum() );
+        first = false;
+    }
+    text += "\n]}\n";
+    return text;
+}
+
+} // namespace
+
+int main( int argc, char* argv[] ){
+    Options options;
+    if( ! parse_options(argc, argv, options) ){
+        return EXIT_FAILURE;
     }
 
     // ^^^^ Configuration
     // vvvv Execution
+    GDALAllRegister();
+    ChartBox box;
+    layer_t& layer = box.get_boundary_layer();
+
+    if( options.input_path.empty() ){
+        fmt::print( stderr, ">>> Generating synthetic chart ({0} x {0} cells)\n", layer_t::dimension );
+        generate_chart( layer, options.seed );
+    }else{
+        fmt::print( stderr, ">>> Loading boundary layer from path: {}\n", options.input_path );
+        chartbox::io::GeoJSONLoader<layer_t> loader( box.mapping(), layer );
+        if( ! loader.load_file(options.input_path) ){
+            fmt::print( stderr, "!!!! error while loading data:!!!!\n" );
+            return EXIT_FAILURE;
+        }
+    }
+
+    fmt::print( stderr, ">>> Running {} threads for {:.1f} s; {}\n", options.thread_count, options.duration,
+                (0 < options.rate) ? fmt::format("open-loop at {:.0f} queries/s", options.rate) : std::string("closed-loop") );
+
+    std::vector<Results> results( options.thread_count );
+    std::vector<std::thread> workers;
+    // leave time for each thread to build its planner, before the clock starts
+    const auto start = std::chrono::steady_clock::now() + std::chrono::milliseconds( 100 );
+    const auto deadline = start + std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::duration<double>(options.duration) );
+    for( size_t index = 0; index < options.thread_count; ++index ){
+        workers.emplace_back( [&, index](){
+            run_worker( layer, options, index, start, deadline, results[index] ); } );
+    }
+    for( auto& worker : workers ){
+        worker.join();
+    }
+    const double elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+    std::array<LatencyHistogram, query_kind_count> latencies;
+    LatencyHistogram overall;
+    for( const auto& each : results ){
+        for( size_t kind = 0; kind < query_kind_count; ++kind ){
+            latencies[kind].merge( each.latencies[kind] );
+            overall.merge( each.latencies[kind] );
+        }
+    }
+
+    fmt::print( "{:<8} {:>10} {:>12} {:>10} {:>10} {:>10} {:>10} {:>10}\n",
+                "query", "count", "queries/s", "mean(us)", "p50(us)", "p99(us)", "p999(us)", "max(us)" );
+    auto print_row = [elapsed]( const char* name, const LatencyHistogram& histogram ){
+        fmt::print( "{:<8} {:>10} {:>12.1f} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.2f}\n",
+                    name, histogram.count(), histogram.count() / elapsed, histogram.mean() * 1e-3,
+                    histogram.percentile(0.5) * 1e-3, histogram.percentile(0.99) * 1e-3,
+                    histogram.percentile(0.999) * 1e-3, histogram.maximum() * 1e-3 ); };
+    for( size_t kind = 0; kind < query_kind_count; ++kind ){
+        if( 0 < latencies[kind].count() ){
+            print_row( query_names[kind], latencies[kind] );
+        }
+    }
+    print_row( "all", overall );
 
-    cerr << ">> loading tree ... \n";
-    const auto start_load = std::chrono::high_resolution_clock::now(); 
-    
-    bool load_success;
-    load_success = load_from_json_stream(tree, *document_stream);
-    if(!load_success){
-        cerr << "!!!! error while loading into the tree!!!!\n";
-        cerr << tree.get_error();
-        return -1;
+    if( ! options.json_path.empty() ){
+        std::ofstream( options.json_path ) << to_json( options, elapsed, latencies );
+        fmt::print( stderr, "<<< Wrote results to: {}\n", options.json_path );
     }
-    const auto finish_load = std::chrono::high_resolution_clock::now(); 
-    const auto load_duration = static_cast<double>(std::chrono::duration_cast<std::chrono::milliseconds>(finish_load - start_load).count())/1000;
-    cerr << "<< Loaded in:   " << load_duration << " s \n";
-
-    
-    // tree.debug();
-    cerr << tree.summary();
-    profile_tree(tree, trial_size);
-
-    if(write_output){
-        cerr << "##>> writing output...\n";
-        to_png(tree, output_path);
+    if( chartbox::probe::enabled ){
+        chartbox::probe::print( stderr );
     }
 
-    return 0;
+    GDALDestroyDriverManager();
+    return EXIT_SUCCESS;
 }